@@ -0,0 +1,962 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rshex.h"
+#include "rsarrow.h"
+
+#include <errno.h>
+#include <string>
+#include <vector>
+
+#define RS_ARROW_PG_EPOCH_DAYS      10957               // Days from 1970-01-01 to 2000-01-01
+#define RS_ARROW_PG_EPOCH_MICROS    946684800000000LL   // Microseconds from 1970-01-01 to 2000-01-01
+#define RS_ARROW_MICROS_PER_DAY     86400000000LL
+
+// Kind of Arrow array built for a column
+#define RS_ARROW_BOOL        1
+#define RS_ARROW_INT16       2
+#define RS_ARROW_INT32       3
+#define RS_ARROW_INT64       4
+#define RS_ARROW_FLOAT32     5
+#define RS_ARROW_FLOAT64     6
+#define RS_ARROW_DECIMAL128  7
+#define RS_ARROW_DATE32      8
+#define RS_ARROW_TIMESTAMP   9
+#define RS_ARROW_UTF8        10
+#define RS_ARROW_BINARY      11
+
+// Column description, computed once per stream.
+typedef struct _RS_ARROW_COLUMN
+{
+    int   iKind;
+    int   iFormat;          // Text or binary format of the column in PGresult
+    short hSQLType;         // From mapPgTypeToSqlType
+    short hRsSpecialType;
+    int   iPrecision;
+    int   iScale;
+    int   iNullable;
+    RS_DESC_REC *pDescRec;  // IRD record
+    std::string szFormat;   // Arrow format string
+    std::string szName;
+} RS_ARROW_COLUMN;
+
+// Private data of the stream.
+typedef struct _RS_ARROW_STREAM
+{
+    RS_STMT_INFO *pStmt;
+    RS_RESULT_INFO *pResult;
+    std::vector<RS_ARROW_COLUMN> cols;
+    std::string szLastError;
+} RS_ARROW_STREAM;
+
+// Private data of a schema. Keeps format and name strings alive.
+typedef struct _RS_ARROW_SCHEMA_DATA
+{
+    std::string szFormat;
+    std::string szName;
+    std::vector<struct ArrowSchema *> children;
+} RS_ARROW_SCHEMA_DATA;
+
+// Private data of an array. Buffers are allocated with rs_malloc.
+typedef struct _RS_ARROW_ARRAY_DATA
+{
+    void *pBuffers[3];
+    const void *pBufferPtrs[3];
+    std::vector<struct ArrowArray *> children;
+} RS_ARROW_ARRAY_DATA;
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release callback of schema. Children are released first.
+//
+static void releaseArrowSchema(struct ArrowSchema *pSchema)
+{
+    RS_ARROW_SCHEMA_DATA *pData = (RS_ARROW_SCHEMA_DATA *)pSchema->private_data;
+
+    if(pData)
+    {
+        for(struct ArrowSchema *pChild : pData->children)
+        {
+            if(pChild->release)
+                pChild->release(pChild);
+            delete pChild;
+        }
+
+        delete pData;
+    }
+
+    pSchema->release = NULL;
+    pSchema->private_data = NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Initialize schema node with its own copy of format and name.
+//
+static RS_ARROW_SCHEMA_DATA *initArrowSchema(struct ArrowSchema *pSchema, const std::string &szFormat, const std::string &szName, int64_t flags)
+{
+    RS_ARROW_SCHEMA_DATA *pData = new RS_ARROW_SCHEMA_DATA();
+
+    pData->szFormat = szFormat;
+    pData->szName = szName;
+
+    memset(pSchema, 0, sizeof(struct ArrowSchema));
+    pSchema->format = pData->szFormat.c_str();
+    pSchema->name = pData->szName.c_str();
+    pSchema->flags = flags;
+    pSchema->release = releaseArrowSchema;
+    pSchema->private_data = pData;
+
+    return pData;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release callback of array. Children are released first.
+//
+static void releaseArrowArray(struct ArrowArray *pArray)
+{
+    RS_ARROW_ARRAY_DATA *pData = (RS_ARROW_ARRAY_DATA *)pArray->private_data;
+
+    if(pData)
+    {
+        for(struct ArrowArray *pChild : pData->children)
+        {
+            if(pChild->release)
+                pChild->release(pChild);
+            delete pChild;
+        }
+
+        for(int i = 0; i < 3; i++)
+            pData->pBuffers[i] = rs_free(pData->pBuffers[i]);
+
+        delete pData;
+    }
+
+    pArray->release = NULL;
+    pArray->private_data = NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Initialize array node. Buffers are attached by the caller.
+//
+static RS_ARROW_ARRAY_DATA *initArrowArray(struct ArrowArray *pArray, int64_t length, int64_t nBuffers)
+{
+    RS_ARROW_ARRAY_DATA *pData = new RS_ARROW_ARRAY_DATA();
+
+    memset(pData->pBuffers, 0, sizeof(pData->pBuffers));
+    memset(pData->pBufferPtrs, 0, sizeof(pData->pBufferPtrs));
+
+    memset(pArray, 0, sizeof(struct ArrowArray));
+    pArray->length = length;
+    pArray->n_buffers = nBuffers;
+    pArray->buffers = pData->pBufferPtrs;
+    pArray->release = releaseArrowArray;
+    pArray->private_data = pData;
+
+    return pData;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Days since 1970-01-01 of proleptic Gregorian date.
+//
+static int getArrowDaysFromCivil(int year, int month, int day)
+{
+    int era;
+    unsigned int yoe;
+    unsigned int doy;
+    unsigned int doe;
+
+    year -= (month <= 2);
+    era = ((year >= 0) ? year : year - 399) / 400;
+    yoe = (unsigned int)(year - era * 400);
+    doy = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + (int)doe - 719468;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Parse text DATE. Returns FALSE for values like infinity, which Arrow can't represent.
+//
+static int parseArrowDateText(const char *szBuf, int *piDays)
+{
+    int year, month, day;
+    int n = 0;
+
+    if(sscanf(szBuf, "%d-%d-%d%n", &year, &month, &day, &n) < 3)
+        return FALSE;
+
+    if(strstr(szBuf + n, "BC"))
+        year = 1 - year;
+
+    *piDays = getArrowDaysFromCivil(year, month, day);
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Parse text TIMESTAMP into microseconds since 1970-01-01. Returns FALSE for values like infinity.
+//
+static int parseArrowTimestampText(const char *szBuf, long long *pllMicros)
+{
+    int year, month, day, hour, minute, second;
+    long long llFraction = 0;
+    int iDigits = 0;
+    int n = 0;
+    const char *pTemp;
+
+    if(sscanf(szBuf, "%d-%d-%d %d:%d:%d%n", &year, &month, &day, &hour, &minute, &second, &n) < 6)
+        return FALSE;
+
+    pTemp = szBuf + n;
+
+    if(*pTemp == '.')
+    {
+        for(pTemp++; *pTemp >= '0' && *pTemp <= '9'; pTemp++)
+        {
+            if(iDigits < 6)
+            {
+                llFraction = llFraction * 10 + (*pTemp - '0');
+                iDigits++;
+            }
+        }
+    }
+
+    for(; iDigits < 6; iDigits++)
+        llFraction *= 10;
+
+    if(strstr(pTemp, "BC"))
+        year = 1 - year;
+
+    *pllMicros = getArrowDaysFromCivil(year, month, day) * RS_ARROW_MICROS_PER_DAY
+                    + ((hour * 3600LL) + (minute * 60LL) + second) * 1000000LL
+                    + llFraction;
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get integer value of SMALLINT, INTEGER or BIGINT column.
+//
+static long long getArrowIntegerVal(RS_ARROW_COLUMN &col, char *pColData, int iColDataLen)
+{
+    char szNumBuf[MAX_NUMBER_BUF_LEN + 1];
+
+    if(iColDataLen <= 0)
+        return 0;
+
+    if(IS_TEXT_FORMAT(col.iFormat))
+    {
+        makeNullTerminateIntVal(pColData, iColDataLen, szNumBuf, MAX_NUMBER_BUF_LEN + 1);
+        return strtoll(szNumBuf, NULL, 10);
+    }
+
+    switch(col.iKind)
+    {
+        case RS_ARROW_INT16:
+            return (short)(((pColData[0] & 255) << 8) + (pColData[1] & 255));
+
+        case RS_ARROW_INT32:
+            return getInt32FromBinary(pColData, 0);
+
+        default:
+            return getInt64FromBinary(pColData, 0);
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get floating point value of REAL or DOUBLE column.
+//
+static double getArrowDoubleVal(RS_ARROW_COLUMN &col, char *pColData, int iColDataLen)
+{
+    char szNumBuf[MAX_NUMBER_BUF_LEN + 1];
+
+    if(iColDataLen <= 0)
+        return 0.0;
+
+    if(IS_TEXT_FORMAT(col.iFormat))
+    {
+        makeNullTerminateIntVal(pColData, iColDataLen, szNumBuf, MAX_NUMBER_BUF_LEN + 1);
+        return strtod(szNumBuf, NULL);
+    }
+
+    if(col.iKind == RS_ARROW_FLOAT32)
+    {
+        int iVal = getInt32FromBinary(pColData, 0);
+        float fVal;
+
+        memcpy(&fVal, &iVal, sizeof(fVal));
+        return fVal;
+    }
+    else
+    {
+        long long llVal = getInt64FromBinary(pColData, 0);
+        double dVal;
+
+        memcpy(&dVal, &llVal, sizeof(dVal));
+        return dVal;
+    }
+}
+
+/*====================================================================================================================================================*/
+
+#ifdef RS_HAVE_INT128
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get NUMERIC value as 128 bit integer scaled to the column scale.
+//
+static __int128 getArrowDecimalVal(RS_ARROW_COLUMN &col, char *pColData, int iColDataLen)
+{
+    SQL_NUMERIC_STRUCT nVal;
+    unsigned __int128 mag = 0;
+    int iScale;
+    int i;
+
+    if(iColDataLen <= 0)
+        return 0;
+
+    if(IS_TEXT_FORMAT(col.iFormat))
+    {
+        char szNumBuf[MAX_NUMBER_BUF_LEN + 1];
+
+        makeNullTerminateIntVal(pColData, iColDataLen, szNumBuf, MAX_NUMBER_BUF_LEN + 1);
+        convertNumericStringToScaledInteger(szNumBuf, &nVal);
+    }
+    else
+        convertBinaryNumericToScaledInteger(pColData, iColDataLen, col.iPrecision, col.iScale, &nVal);
+
+    for(i = SQL_MAX_NUMERIC_LEN - 1; i >= 0; i--)
+        mag = (mag << 8) | nVal.val[i];
+
+    // Text values carry their own scale
+    for(iScale = nVal.scale; iScale < col.iScale; iScale++)
+        mag *= 10;
+
+    if(iScale > col.iScale)
+    {
+        unsigned int uiLastDigit = 0;
+
+        for(; iScale > col.iScale; iScale--)
+        {
+            uiLastDigit = (unsigned int)(mag % 10);
+            mag /= 10;
+        }
+
+        if(uiLastDigit >= 5)
+            mag++;
+    }
+
+    return (nVal.sign) ? (__int128)mag : -(__int128)mag;
+}
+
+#endif // RS_HAVE_INT128
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Make sure variable length data buffer can hold iMore bytes after iUsed.
+//
+static unsigned char *reserveArrowData(RS_ARROW_ARRAY_DATA *pData, size_t *piCapacity, size_t iUsed, size_t iMore)
+{
+    if(iUsed + iMore > *piCapacity)
+    {
+        size_t iNewCapacity = (*piCapacity) ? *piCapacity : 4096;
+        void *pNew;
+
+        while(iNewCapacity < iUsed + iMore)
+            iNewCapacity *= 2;
+
+        pNew = rs_realloc(pData->pBuffers[2], iNewCapacity);
+        if(pNew == NULL)
+            return NULL;
+
+        pData->pBuffers[2] = pNew;
+        *piCapacity = iNewCapacity;
+    }
+
+    return (unsigned char *)pData->pBuffers[2];
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get bytes of column value for utf8 or binary array.
+// Returns pointer to the bytes and sets *piLen. pBuf is used when value needs conversion.
+//
+static const char *getArrowVarLenVal(RS_ARROW_STREAM *pArrowStream, RS_ARROW_COLUMN &col, char *pColData, int iColDataLen,
+                                     char *pBuf, int iBufLen, int *piLen)
+{
+    if(col.iKind == RS_ARROW_BINARY)
+    {
+        *piLen = iColDataLen;
+        return pColData;
+    }
+
+    switch(col.hSQLType)
+    {
+        case SQL_CHAR:
+        case SQL_VARCHAR:
+        case SQL_LONGVARCHAR:
+        case SQL_WCHAR:
+        case SQL_WVARCHAR:
+        case SQL_WLONGVARCHAR:
+        {
+            // Data is UTF-8 in both formats
+            *piLen = iColDataLen;
+            return pColData;
+        }
+
+        default:
+        {
+            SQLLEN cbLenOffset = 0;
+            SQLLEN cbLenInd = 0;
+
+            if(IS_TEXT_FORMAT(col.iFormat))
+            {
+                *piLen = iColDataLen;
+                return pColData;
+            }
+
+            // Binary TIME, TIMETZ, INTERVAL etc. use the same text conversion as SQLGetData
+            pBuf[0] = '\0';
+            convertSQLDataToCData(pArrowStream->pStmt, pColData, iColDataLen, col.hSQLType, pBuf, iBufLen,
+                                  &cbLenOffset, &cbLenInd, SQL_C_CHAR, col.hRsSpecialType, col.iFormat, col.pDescRec);
+
+            *piLen = (int)strlen(pBuf);
+            return pBuf;
+        }
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Build child array of one column for iRows rows starting at iFirstRow of the rows in memory.
+// Returns 0 or errno value.
+//
+static int buildArrowColumn(RS_ARROW_STREAM *pArrowStream, RS_ARROW_COLUMN &col, int iCol, int iFirstRow, int iRows,
+                            struct ArrowArray *pArray)
+{
+    PGresult *pgResult = pArrowStream->pResult->pgResult;
+    int iVarLen = (col.iKind == RS_ARROW_UTF8 || col.iKind == RS_ARROW_BINARY);
+    RS_ARROW_ARRAY_DATA *pData = initArrowArray(pArray, iRows, (iVarLen) ? 3 : 2);
+    size_t iBitmapLen = ((size_t)iRows + 7) / 8;
+    size_t iWidth;
+    size_t iDataCapacity = 0;
+    size_t iDataLen = 0;
+    unsigned char *pValidity;
+    unsigned char *pValues = NULL;
+    int *piOffsets = NULL;
+    int64_t nullCount = 0;
+    char szBuf[MAX_TEMP_BUF_LEN];
+    int i;
+
+    switch(col.iKind)
+    {
+        case RS_ARROW_INT16:        iWidth = sizeof(short); break;
+        case RS_ARROW_INT32:
+        case RS_ARROW_DATE32:       iWidth = sizeof(int); break;
+        case RS_ARROW_FLOAT32:      iWidth = sizeof(float); break;
+        case RS_ARROW_FLOAT64:      iWidth = sizeof(double); break;
+        case RS_ARROW_DECIMAL128:   iWidth = 16; break;
+        case RS_ARROW_INT64:
+        case RS_ARROW_TIMESTAMP:    iWidth = sizeof(long long); break;
+        default:                    iWidth = 0; break;
+    }
+
+    pData->pBuffers[0] = pValidity = (unsigned char *)rs_calloc(iBitmapLen + 1, 1);
+
+    if(col.iKind == RS_ARROW_BOOL)
+        pData->pBuffers[1] = pValues = (unsigned char *)rs_calloc(iBitmapLen + 1, 1);
+    else
+    if(iWidth)
+        pData->pBuffers[1] = pValues = (unsigned char *)rs_calloc((size_t)iRows + 1, iWidth);
+    else
+    {
+        pData->pBuffers[1] = piOffsets = (int *)rs_malloc(((size_t)iRows + 1) * sizeof(int));
+        if(piOffsets)
+            piOffsets[0] = 0;
+        // Data buffer must not be NULL even if all values are empty
+        if(reserveArrowData(pData, &iDataCapacity, 0, 1) == NULL)
+            return ENOMEM;
+    }
+
+    if(pValidity == NULL || pData->pBuffers[1] == NULL)
+        return ENOMEM;
+
+    for(i = 0; i < iRows; i++)
+    {
+        int iRow = iFirstRow + i;
+        char *pColData;
+        int iColDataLen;
+        int iValid = TRUE;
+
+        if(PQgetisnull(pgResult, iRow, iCol))
+        {
+            nullCount++;
+            if(piOffsets)
+                piOffsets[i + 1] = (int)iDataLen;
+            continue;
+        }
+
+        pColData = PQgetvalue(pgResult, iRow, iCol);
+        iColDataLen = PQgetlength(pgResult, iRow, iCol);
+
+        switch(col.iKind)
+        {
+            case RS_ARROW_BOOL:
+            {
+                int iVal = (IS_TEXT_FORMAT(col.iFormat))
+                            ? (iColDataLen > 0 && (pColData[0] == 't' || pColData[0] == 'T' || pColData[0] == '1'))
+                            : (iColDataLen > 0 && pColData[0] == 1);
+
+                if(iVal)
+                    pValues[i >> 3] |= (unsigned char)(1 << (i & 7));
+                break;
+            }
+
+            case RS_ARROW_INT16:
+            {
+                ((short *)pValues)[i] = (short)getArrowIntegerVal(col, pColData, iColDataLen);
+                break;
+            }
+
+            case RS_ARROW_INT32:
+            {
+                ((int *)pValues)[i] = (int)getArrowIntegerVal(col, pColData, iColDataLen);
+                break;
+            }
+
+            case RS_ARROW_INT64:
+            {
+                ((long long *)pValues)[i] = getArrowIntegerVal(col, pColData, iColDataLen);
+                break;
+            }
+
+            case RS_ARROW_FLOAT32:
+            {
+                ((float *)pValues)[i] = (float)getArrowDoubleVal(col, pColData, iColDataLen);
+                break;
+            }
+
+            case RS_ARROW_FLOAT64:
+            {
+                ((double *)pValues)[i] = getArrowDoubleVal(col, pColData, iColDataLen);
+                break;
+            }
+
+#ifdef RS_HAVE_INT128
+            case RS_ARROW_DECIMAL128:
+            {
+                __int128 val = getArrowDecimalVal(col, pColData, iColDataLen);
+
+                memcpy(pValues + (i * iWidth), &val, iWidth);
+                break;
+            }
+#endif // RS_HAVE_INT128
+
+            case RS_ARROW_DATE32:
+            {
+                if(IS_TEXT_FORMAT(col.iFormat))
+                {
+                    makeNullTerminateIntVal(pColData, iColDataLen, szBuf, sizeof(szBuf));
+                    iValid = parseArrowDateText(szBuf, &((int *)pValues)[i]);
+                }
+                else
+                {
+                    int iDays = getInt32FromBinary(pColData, 0);
+
+                    // INT_MIN and INT_MAX are -infinity and infinity
+                    iValid = (iDays != INT_MIN && iDays != INT_MAX);
+                    if(iValid)
+                        ((int *)pValues)[i] = iDays + RS_ARROW_PG_EPOCH_DAYS;
+                }
+                break;
+            }
+
+            case RS_ARROW_TIMESTAMP:
+            {
+                if(IS_TEXT_FORMAT(col.iFormat))
+                {
+                    makeNullTerminateIntVal(pColData, iColDataLen, szBuf, sizeof(szBuf));
+                    iValid = parseArrowTimestampText(szBuf, &((long long *)pValues)[i]);
+                }
+                else
+                {
+                    long long llMicros = getInt64FromBinary(pColData, 0);
+
+                    // LLONG_MIN and LLONG_MAX are -infinity and infinity
+                    iValid = (llMicros != LLONG_MIN && llMicros != LLONG_MAX);
+                    if(iValid)
+                        ((long long *)pValues)[i] = llMicros + RS_ARROW_PG_EPOCH_MICROS;
+                }
+                break;
+            }
+
+            case RS_ARROW_UTF8:
+            case RS_ARROW_BINARY:
+            {
+                int iLen = 0;
+                const char *pVal = getArrowVarLenVal(pArrowStream, col, pColData, iColDataLen, szBuf, sizeof(szBuf), &iLen);
+                int iHex = (col.iKind == RS_ARROW_BINARY
+                            && !(col.hRsSpecialType == GEOMETRY
+                                 || (!IS_TEXT_FORMAT(col.iFormat)
+                                     && (col.hRsSpecialType == VARBYTE
+                                         || col.hRsSpecialType == GEOGRAPHY
+                                         || col.hRsSpecialType == GEOMETRYHEX))));
+                size_t iOutLen = (iHex) ? (size_t)(iLen / 2) : (size_t)iLen;
+                unsigned char *pDest;
+
+                if(iDataLen + iOutLen > INT_MAX)
+                {
+                    pArrowStream->szLastError = "Arrow batch has more than 2GB of variable length data in a column. Reduce SQL_ATTR_RS_ARROW_BATCH_ROWS.";
+                    return EOVERFLOW;
+                }
+
+                pDest = reserveArrowData(pData, &iDataCapacity, iDataLen, iOutLen);
+                if(pDest == NULL)
+                    return ENOMEM;
+
+                if(iHex)
+                    rsHexDecode(pVal, iOutLen, pDest + iDataLen);
+                else
+                if(iOutLen)
+                    memcpy(pDest + iDataLen, pVal, iOutLen);
+
+                iDataLen += iOutLen;
+                piOffsets[i + 1] = (int)iDataLen;
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        if(iValid)
+            pValidity[i >> 3] |= (unsigned char)(1 << (i & 7));
+        else
+            nullCount++;
+    }
+
+    pArray->null_count = nullCount;
+    for(i = 0; i < 3; i++)
+        pData->pBufferPtrs[i] = pData->pBuffers[i];
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Describe columns of the result for Arrow.
+//
+static void makeArrowColumns(RS_ARROW_STREAM *pArrowStream)
+{
+    RS_STMT_INFO *pStmt = pArrowStream->pStmt;
+    RS_RESULT_INFO *pResult = pArrowStream->pResult;
+    int iCol;
+
+    pArrowStream->cols.resize(pResult->iNumberOfCols);
+
+    for(iCol = 0; iCol < pResult->iNumberOfCols; iCol++)
+    {
+        RS_ARROW_COLUMN &col = pArrowStream->cols[iCol];
+        RS_DESC_REC *pDescRec = &pStmt->pIRD->pDescRecHead[iCol];
+
+        col.pDescRec = pDescRec;
+        col.hSQLType = mapPgTypeToSqlType(PQftype(pResult->pgResult, iCol), &col.hRsSpecialType, FALSE);
+        col.iFormat = PQfformat(pResult->pgResult, iCol);
+        col.iPrecision = pDescRec->iPrecision;
+        col.iScale = pDescRec->hScale;
+        col.iNullable = (pDescRec->hNullable != SQL_NO_NULLS);
+        col.szName = pDescRec->szName;
+
+        switch(col.hSQLType)
+        {
+            case SQL_BIT:           col.iKind = RS_ARROW_BOOL; col.szFormat = "b"; break;
+            case SQL_SMALLINT:      col.iKind = RS_ARROW_INT16; col.szFormat = "s"; break;
+            case SQL_INTEGER:       col.iKind = RS_ARROW_INT32; col.szFormat = "i"; break;
+            case SQL_BIGINT:        col.iKind = RS_ARROW_INT64; col.szFormat = "l"; break;
+            case SQL_REAL:          col.iKind = RS_ARROW_FLOAT32; col.szFormat = "f"; break;
+            case SQL_FLOAT:
+            case SQL_DOUBLE:        col.iKind = RS_ARROW_FLOAT64; col.szFormat = "g"; break;
+            case SQL_TYPE_DATE:     col.iKind = RS_ARROW_DATE32; col.szFormat = "tdD"; break;
+            case SQL_LONGVARBINARY: col.iKind = RS_ARROW_BINARY; col.szFormat = "z"; break;
+
+            case SQL_NUMERIC:
+            {
+#ifdef RS_HAVE_INT128
+                if(col.iPrecision > 0 && col.iPrecision <= 38
+                    && col.iScale >= 0 && col.iScale <= col.iPrecision)
+                {
+                    col.iKind = RS_ARROW_DECIMAL128;
+                    col.szFormat = "d:" + std::to_string(col.iPrecision) + "," + std::to_string(col.iScale);
+                    break;
+                }
+#endif // RS_HAVE_INT128
+
+                col.iKind = RS_ARROW_UTF8;
+                col.szFormat = "u";
+                break;
+            }
+
+            case SQL_TYPE_TIMESTAMP:
+            {
+                if(col.hRsSpecialType != TIMESTAMPTZOID)
+                {
+                    col.iKind = RS_ARROW_TIMESTAMP;
+                    col.szFormat = "tsu:";
+                }
+                else
+                if(!IS_TEXT_FORMAT(col.iFormat))
+                {
+                    // Binary TIMESTAMPTZ is UTC
+                    col.iKind = RS_ARROW_TIMESTAMP;
+                    col.szFormat = "tsu:UTC";
+                }
+                else
+                {
+                    // Text TIMESTAMPTZ is in session time zone with offset
+                    col.iKind = RS_ARROW_UTF8;
+                    col.szFormat = "u";
+                }
+                break;
+            }
+
+            default:
+            {
+                col.iKind = RS_ARROW_UTF8;
+                col.szFormat = "u";
+                break;
+            }
+        }
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// get_schema callback of the stream.
+//
+static int getArrowStreamSchema(struct ArrowArrayStream *pStream, struct ArrowSchema *pOut)
+{
+    RS_ARROW_STREAM *pArrowStream = (RS_ARROW_STREAM *)pStream->private_data;
+    RS_ARROW_SCHEMA_DATA *pData = initArrowSchema(pOut, "+s", "", 0);
+
+    pData->children.reserve(pArrowStream->cols.size());
+
+    for(RS_ARROW_COLUMN &col : pArrowStream->cols)
+    {
+        struct ArrowSchema *pChild = new struct ArrowSchema();
+
+        initArrowSchema(pChild, col.szFormat, col.szName, (col.iNullable) ? ARROW_FLAG_NULLABLE : 0);
+        pData->children.push_back(pChild);
+    }
+
+    pOut->n_children = (int64_t)pData->children.size();
+    pOut->children = (pOut->n_children) ? pData->children.data() : NULL;
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Remember the first statement error for get_last_error.
+//
+static void setArrowLastErrorFromStmt(RS_ARROW_STREAM *pArrowStream, const char *pDefaultMsg)
+{
+    RS_STMT_INFO *pStmt = pArrowStream->pStmt;
+
+    if(pStmt->pErrorList && pStmt->pErrorList->szErrMsg[0] != '\0')
+        pArrowStream->szLastError = pStmt->pErrorList->szErrMsg;
+    else
+        pArrowStream->szLastError = pDefaultMsg;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// get_next callback of the stream. Moves the cursor past the rows returned.
+// End of stream is an array with NULL release callback.
+//
+static int getArrowStreamNext(struct ArrowArrayStream *pStream, struct ArrowArray *pOut)
+{
+    RS_ARROW_STREAM *pArrowStream = (RS_ARROW_STREAM *)pStream->private_data;
+    RS_STMT_INFO *pStmt = pArrowStream->pStmt;
+    RS_RESULT_INFO *pResult = pArrowStream->pResult;
+    int iMaxRows = pStmt->pStmtAttr->iMaxRows;
+    int iBatchRows = pStmt->pStmtAttr->iArrowBatchRows;
+    int iFirstRow;
+    int iRows;
+    RS_ARROW_ARRAY_DATA *pData;
+
+    memset(pOut, 0, sizeof(struct ArrowArray));
+    pArrowStream->szLastError.clear();
+
+    if(pStmt->pResultHead != pResult)
+    {
+        pArrowStream->szLastError = "Result set of the statement changed after the Arrow stream was created.";
+        return EINVAL;
+    }
+
+    // Clear error list
+    pStmt->pErrorList = clearErrorList(pStmt->pErrorList);
+
+    // Read next batch from CSC file or streaming cursor, once rows in memory are consumed.
+    if((pResult->iCurRow + 1) >= pResult->iNumberOfRowsInMem
+        && !((iMaxRows > 0) && ((pResult->iCurRow + pResult->iRowOffset + 1) >= iMaxRows)))
+    {
+        if(RS_RESULT_INFO::readNextBatchOfRows(pStmt, pResult) == SQL_ERROR)
+        {
+            setArrowLastErrorFromStmt(pArrowStream, "An I/O error occurred while reading the result.");
+            return EIO;
+        }
+    }
+
+    iFirstRow = pResult->iCurRow + 1;
+    iRows = pResult->iNumberOfRowsInMem - iFirstRow;
+
+    if(iMaxRows > 0)
+        iRows = redshift_min(iRows, iMaxRows - (iFirstRow + pResult->iRowOffset));
+
+    if(iBatchRows > 0)
+        iRows = redshift_min(iRows, iBatchRows);
+
+    // End of stream
+    if(iRows <= 0)
+        return 0;
+
+    pData = initArrowArray(pOut, iRows, 1);
+    pData->children.reserve(pArrowStream->cols.size());
+
+    for(size_t iCol = 0; iCol < pArrowStream->cols.size(); iCol++)
+    {
+        struct ArrowArray *pChild = new struct ArrowArray();
+        int iError;
+
+        pData->children.push_back(pChild);
+        iError = buildArrowColumn(pArrowStream, pArrowStream->cols[iCol], (int)iCol, iFirstRow, iRows, pChild);
+        if(iError)
+        {
+            if(pArrowStream->szLastError.empty())
+                pArrowStream->szLastError = "Memory allocation error";
+            pOut->release(pOut);
+            return iError;
+        }
+    }
+
+    pOut->n_children = (int64_t)pData->children.size();
+    pOut->children = (pOut->n_children) ? pData->children.data() : NULL;
+
+    // Rows are consumed. SQLFetch continues after them.
+    pResult->iCurRow = iFirstRow + iRows - 1;
+    pResult->iPrevhCol = 0;
+
+    RS_LOG_TRACE("RSARROW", "Arrow batch rows=%d rowOffset=%lld", iRows, (long long)pResult->iRowOffset);
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// get_last_error callback of the stream.
+//
+static const char *getArrowStreamLastError(struct ArrowArrayStream *pStream)
+{
+    RS_ARROW_STREAM *pArrowStream = (RS_ARROW_STREAM *)pStream->private_data;
+
+    return (pArrowStream && !pArrowStream->szLastError.empty()) ? pArrowStream->szLastError.c_str() : NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// release callback of the stream.
+//
+static void releaseArrowStream(struct ArrowArrayStream *pStream)
+{
+    delete (RS_ARROW_STREAM *)pStream->private_data;
+
+    pStream->private_data = NULL;
+    pStream->release = NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// RsGetArrowArrayStream returns the current result of the statement as Arrow C stream.
+// Values are copied from PGresult straight into Arrow buffers, without binding and SQLFetch calls.
+//
+SQLRETURN SQL_API RsGetArrowArrayStream(SQLHSTMT phstmt, struct ArrowArrayStream *pStream)
+{
+    SQLRETURN rc = SQL_SUCCESS;
+    RS_STMT_INFO *pStmt = (RS_STMT_INFO *)phstmt;
+    RS_RESULT_INFO *pResult;
+    RS_ARROW_STREAM *pArrowStream;
+
+    if(!VALID_HSTMT(phstmt))
+    {
+        rc = SQL_INVALID_HANDLE;
+        goto error;
+    }
+
+    // Clear error list
+    pStmt->pErrorList = clearErrorList(pStmt->pErrorList);
+
+    if(pStream == NULL)
+    {
+        rc = SQL_ERROR;
+        addError(&pStmt->pErrorList,"HY009", "Invalid use of null pointer", 0, NULL);
+        goto error;
+    }
+
+    pResult = pStmt->pResultHead;
+
+    if(pResult == NULL || pResult->iNumberOfCols <= 0 || pStmt->pIRD->pDescRecHead == NULL)
+    {
+        rc = SQL_ERROR;
+        addError(&pStmt->pErrorList,"24000", "Invalid cursor state", 0, NULL);
+        goto error;
+    }
+
+    pArrowStream = new RS_ARROW_STREAM();
+    pArrowStream->pStmt = pStmt;
+    pArrowStream->pResult = pResult;
+    makeArrowColumns(pArrowStream);
+
+    pStream->get_schema = getArrowStreamSchema;
+    pStream->get_next = getArrowStreamNext;
+    pStream->get_last_error = getArrowStreamLastError;
+    pStream->release = releaseArrowStream;
+    pStream->private_data = pArrowStream;
+
+    RS_LOG_DEBUG("RSARROW", "Arrow stream created cols=%d batchRows=%d", pResult->iNumberOfCols, pStmt->pStmtAttr->iArrowBatchRows);
+
+error:
+
+    return rc;
+}
@@ -0,0 +1,115 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <stdint.h>
+#include <sql.h>
+
+// Driver specific extension to export a result set through the Arrow C stream interface.
+//
+// The application gets the driver statement handle using SQLGetInfo(SQL_DRIVER_HSTMT)
+// when a driver manager is in use, resolves RsGetArrowArrayStream from the driver library
+// and calls it after SQLExecute/SQLExecDirect. Each call to get_next() returns the next
+// batch of rows, starting from the current cursor position. Streaming and client side
+// cursor results are read batch by batch, so the whole result never needs to be in memory.
+//
+// Batches are independent of the statement and can outlive it. The stream itself must be
+// released before the cursor is closed or the statement is freed.
+//
+// Type mapping follows the SQL type of the column:
+//   SQL_BIT -> b, SQL_SMALLINT -> s, SQL_INTEGER -> i, SQL_BIGINT -> l, SQL_REAL -> f,
+//   SQL_FLOAT/SQL_DOUBLE -> g, SQL_NUMERIC -> d:p,s (precision <= 38), SQL_TYPE_DATE -> tdD,
+//   SQL_TYPE_TIMESTAMP -> tsu: (tsu:UTC for TIMESTAMPTZ in binary format),
+//   SQL_LONGVARBINARY -> z. Everything else is returned as utf8 text (u).
+
+#ifndef SQL_DRIVER_STMT_ATTR_BASE
+#define SQL_DRIVER_STMT_ATTR_BASE   0x00004000
+#endif
+
+#ifndef SQL_ATTR_RS_ARROW_BATCH_ROWS
+// Max rows per Arrow batch. 0 means one batch per rows in memory. Default is 65536.
+#define SQL_ATTR_RS_ARROW_BATCH_ROWS        (SQL_DRIVER_STMT_ATTR_BASE+1)
+#endif
+
+// Arrow C data interface. https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+// Arrow C stream interface. https://arrow.apache.org/docs/format/CStreamInterface.html
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+  // Callbacks providing stream functionality
+  int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+  int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+  const char* (*get_last_error)(struct ArrowArrayStream*);
+
+  // Release callback
+  void (*release)(struct ArrowArrayStream*);
+
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_STREAM_INTERFACE
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* C++ */
+
+// Export current result of the statement as Arrow stream.
+// Returns SQL_ERROR with diagnostics on the statement, if there is no result set.
+SQLRETURN SQL_API RsGetArrowArrayStream(SQLHSTMT phstmt, struct ArrowArrayStream *pStream);
+
+#ifdef __cplusplus
+}
+#endif /* C++ */
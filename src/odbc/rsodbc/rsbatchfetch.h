@@ -0,0 +1,48 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <sql.h>
+
+// Driver specific push style fetch.
+//
+// The application binds its rowset buffer as usual (SQLBindCol, SQL_ATTR_ROW_ARRAY_SIZE,
+// SQL_ATTR_ROW_BIND_TYPE, SQL_ATTR_ROW_STATUS_PTR) and calls RsFetchBatches once, with the
+// driver statement handle (SQLGetInfo(SQL_DRIVER_HSTMT) when a driver manager is in use).
+// The driver fills the bound buffers one rowset at a time and calls the callback after each
+// rowset, without going through the ODBC API per rowset. The same buffers are reused for the
+// next rowset, so the callback must consume or copy the rows before returning.
+
+// Return values of the callback
+#define RS_FETCH_BATCH_CONTINUE     0
+#define RS_FETCH_BATCH_STOP         1
+
+// Called after each rowset. lRowsFetched rows are valid in the bound buffers.
+typedef int (SQL_API *RS_FETCH_BATCH_CALLBACK)(SQLPOINTER pCallbackContext, SQLULEN lRowsFetched);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* C++ */
+
+// Fetch rowsets until the result is exhausted or the callback returns RS_FETCH_BATCH_STOP.
+// Returns SQL_SUCCESS (or SQL_SUCCESS_WITH_INFO) if at least one row was delivered, SQL_NO_DATA
+// if the result had no more rows, SQL_ERROR with diagnostics on the statement otherwise.
+// plTotalRows, if not NULL, gets the number of rows delivered to the callback.
+// After the callback stops, SQLFetch continues from the next rowset.
+SQLRETURN SQL_API RsFetchBatches(SQLHSTMT phstmt,
+                                 RS_FETCH_BATCH_CALLBACK pfnCallback,
+                                 SQLPOINTER pCallbackContext,
+                                 SQLULEN *plTotalRows);
+
+#ifdef __cplusplus
+}
+#endif /* C++ */
@@ -0,0 +1,124 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rscancel.h"
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Sender with at most the given workers, sending each cancel with the timeout.
+//
+RS_CANCEL_SENDER::RS_CANCEL_SENDER(int _iMaxThreads, int _iTimeoutSeconds)
+    : pool(_iMaxThreads, RS_WORKER_POOL_IDLE_SECONDS)
+{
+    iTimeoutSeconds = (_iTimeoutSeconds >= 0) ? _iTimeoutSeconds : RS_CANCEL_TIMEOUT_DEFAULT;
+    llSent = 0;
+    llCoalesced = 0;
+    llFailed = 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Queue the cancel unless one is pending for the backend.
+//
+int RS_CANCEL_SENDER::send(void *pConnKey, int iBackendPid, std::function<int(char *, int, int)> sendCancel)
+{
+    RS_CANCEL_KEY key(pConnKey, iBackendPid);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if(pending.count(key))
+        {
+            llCoalesced++;
+            return TRUE;
+        }
+
+        pending.insert(key);
+    }
+
+    if(!pool.submit([this, key, sendCancel]() mutable { run(key, sendCancel); }))
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        pending.erase(key);
+        done.notify_all();
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Wait while any cancel of the connection is pending.
+//
+void RS_CANCEL_SENDER::wait(void *pConnKey)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    for(;;)
+    {
+        std::set<RS_CANCEL_KEY>::iterator it = pending.lower_bound(RS_CANCEL_KEY(pConnKey, INT_MIN));
+
+        if(it == pending.end() || it->first != pConnKey)
+            break;
+
+        done.wait(guard);
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Cancels sent, coalesced and failed.
+//
+void RS_CANCEL_SENDER::getStats(long long *pllSent, long long *pllCoalesced, long long *pllFailed)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if(pllSent)
+        *pllSent = llSent;
+    if(pllCoalesced)
+        *pllCoalesced = llCoalesced;
+    if(pllFailed)
+        *pllFailed = llFailed;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Send the cancel on a worker. There is no statement to report a failure to, so it is logged.
+//
+void RS_CANCEL_SENDER::run(RS_CANCEL_KEY key, std::function<int(char *, int, int)> &sendCancel)
+{
+    char errBuf[MAX_ERR_MSG_LEN + 1];
+    int valid;
+
+    errBuf[0] = '\0';
+    errBuf[MAX_ERR_MSG_LEN] = '\0';
+    valid = sendCancel(errBuf, MAX_ERR_MSG_LEN, iTimeoutSeconds);
+
+    if(!valid)
+        RS_LOG_WARN("RSCANCEL", "Cancel of backend %d failed: %s", key.second, errBuf);
+
+    // Release the cancel object before the connection can go
+    sendCancel = nullptr;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    llSent++;
+    if(!valid)
+        llFailed++;
+    pending.erase(key);
+    done.notify_all();
+}
@@ -0,0 +1,69 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+// Driver specific sender of query cancels.
+//
+// A cancel opens a new connection to the server, so SQLCancel doesn't send it. It is queued
+// and sent by a worker of the sender, each bounded by the cancel timeout, and SQLCancel returns.
+// The workers are their own pool, so cancels don't wait behind the async executions they cancel.
+//
+// A cancel for the backend of a connection while one is pending for it is the same request,
+// so it isn't sent again. Before the next command on the connection, the driver waits for its
+// pending cancel, otherwise the cancel could reach the server after the next query started.
+
+#ifdef __cplusplus
+
+#include <functional>
+#include <set>
+#include <utility>
+#include "rsworkerpool.h"
+
+// Workers of the cancel sender
+#define RS_CANCEL_WORKER_THREADS            4
+
+// Seconds of each socket operation of a cancel, unless CancelTimeout is set in the driver options
+#define RS_CANCEL_TIMEOUT_DEFAULT           10
+
+class RS_CANCEL_SENDER
+{
+public:
+
+    RS_CANCEL_SENDER(int _iMaxThreads, int _iTimeoutSeconds);
+
+    // Queue the cancel of the backend of the connection. sendCancel sends it with the timeout and
+    // returns FALSE with the error in the buffer on failure. It isn't called when a cancel is pending
+    // for the backend. FALSE if it can't be queued, so the caller sends it.
+    int send(void *pConnKey, int iBackendPid, std::function<int(char *, int, int)> sendCancel);
+
+    // Wait for the pending cancels of the connection.
+    void wait(void *pConnKey);
+
+    // Cancels sent, coalesced with a pending one and failed. Any pointer can be NULL.
+    void getStats(long long *pllSent, long long *pllCoalesced, long long *pllFailed);
+
+private:
+
+    typedef std::pair<void *, int> RS_CANCEL_KEY;
+
+    void run(RS_CANCEL_KEY key, std::function<int(char *, int, int)> &sendCancel);
+
+    std::mutex lock;
+    std::condition_variable done;       // Pending cancel sent
+    std::set<RS_CANCEL_KEY> pending;
+
+    int iTimeoutSeconds;
+    long long llSent;
+    long long llCoalesced;
+    long long llFailed;
+
+    // Last, so the pending cancels are sent and the workers exit before the members they use go
+    RS_WORKER_POOL pool;
+};
+
+#endif /* C++ */
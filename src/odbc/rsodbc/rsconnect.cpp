@@ -12,6 +12,7 @@
 #include "rstrace.h"
 #include "rslock.h"
 #include "rsini.h"
+#include "rsparamarena.h"
 
 #include "RsIamEntry.h"
 #include "RsErrorException.h"
@@ -1982,6 +1983,9 @@ SQLRETURN  SQL_API RS_STMT_INFO::RS_SQLFreeStmt(SQLHSTMT phstmt,
             // Release prepared stmt in the server
             libpqExecuteDeallocateCommand(pStmt, TRUE, TRUE);
 
+            // Close prepared multi INSERT batches while the statement is on the connection
+            libpqReleaseMultiInsertBatches(pStmt);
+
             // Release prepare stmt related resources
             releasePrepares(pStmt);
 
@@ -2024,6 +2028,12 @@ SQLRETURN  SQL_API RS_STMT_INFO::RS_SQLFreeStmt(SQLHSTMT phstmt,
             // Release user insert command, if any.
             pStmt->resetMultiInsertInfo();
 
+            // Release parameter arena
+            if (pStmt->pParamArena != NULL) {
+              delete pStmt->pParamArena;
+              pStmt->pParamArena = NULL;
+            }
+
             // Free statement
             if (pStmt != NULL) {
               delete pStmt;
@@ -2382,6 +2392,28 @@ int RS_CONN_INFO::parseConnectString(char *szConnStrIn, size_t cbConnStrIn, int
                         }
         } else if (_stricmp(pname, RS_CSC_THRESHOLD) == 0) {
           sscanf(pval, "%lld", &pConnectProps->llCscThreshold);
+        } else if (_stricmp(pname, RS_CSC_SYNC_WRITES) == 0) {
+          sscanf(pval, "%d", &pConnectProps->iCscSyncWrites);
+          if ((pConnectProps->iCscSyncWrites) && (pConnectProps->iCscSyncWrites != 1))
+                            pConnectProps->iCscSyncWrites = 0;
+        } else if (_stricmp(pname, RS_CSC_FILE_FORMAT) == 0) {
+          sscanf(pval, "%d", &pConnectProps->iCscFileFormat);
+        } else if (_stricmp(pname, RS_CSC_CACHE_SIZE) == 0) {
+          sscanf(pval, "%lld", &pConnectProps->llCscCacheSize);
+        } else if (_stricmp(pname, RS_RESULT_MEMORY_LIMIT) == 0) {
+          sscanf(pval, "%lld", &pConnectProps->llResultMemoryLimit);
+        } else if (_stricmp(pname, RS_RESULT_CACHE_SIZE) == 0) {
+          sscanf(pval, "%lld", &pConnectProps->llResultCacheSize);
+        } else if (_stricmp(pname, RS_RESULT_CACHE_TTL) == 0) {
+          sscanf(pval, "%d", &pConnectProps->iResultCacheTtl);
+        } else if (_stricmp(pname, RS_LAZY_ROW_DECODE) == 0) {
+          sscanf(pval, "%d", &pConnectProps->iLazyRowDecode);
+        } else if (_stricmp(pname, RS_PREPARED_STATEMENT_CACHE_SIZE) == 0) {
+          sscanf(pval, "%d", &pConnectProps->iPreparedStatementCacheSize);
+        } else if (_stricmp(pname, RS_SQL_REWRITE_CACHE_SIZE) == 0) {
+          sscanf(pval, "%d", &pConnectProps->iSqlRewriteCacheSize);
+        } else if (_stricmp(pname, RS_MULTI_INSERT_BATCH_SIZE) == 0) {
+          sscanf(pval, "%lld", &pConnectProps->llMultiInsertBatchSize);
         } else if (_stricmp(pname, RS_ENCRYPTION_METHOD) == 0 ||
                    _stricmp(pname, "EM") == 0) {
           sscanf(pval, "%d", &pConnectProps->iEncryptionMethod);
@@ -2411,6 +2443,8 @@ int RS_CONN_INFO::parseConnectString(char *szConnStrIn, size_t cbConnStrIn, int
           sscanf(pval, "%d", &pConnectProps->iStreamingCursorRows);
           if (pConnectProps->iStreamingCursorRows < 0)
                           pConnectProps->iStreamingCursorRows = 0;
+        } else if (_stricmp(pname, RS_STREAMING_CURSOR_BATCH_SIZE) == 0) {
+          sscanf(pval, "%lld", &pConnectProps->llStreamingCursorBatchSize);
         } else if (_stricmp(pname, RS_DATABASE_METADATA_CURRENT_DB_ONLY) == 0) {
 						bool bVal = convertToBoolVal(pval);
 						pConnectProps->iDatabaseMetadataCurrentDbOnly = (bVal) ? 1 : 0;
@@ -2756,6 +2790,16 @@ void RS_CONN_INFO::resetConnectProps()
     pConnectProps->llCscMaxFileSize = (4 * 1024);
     pConnectProps->szCscPath[0] = '\0';
     pConnectProps->llCscThreshold = 1;
+    pConnectProps->iCscSyncWrites = FALSE;
+    pConnectProps->iCscFileFormat = 0;
+    pConnectProps->llCscCacheSize = 64;
+    pConnectProps->llResultMemoryLimit = 0;
+    pConnectProps->llResultCacheSize = 0;
+    pConnectProps->iResultCacheTtl = 60;
+    pConnectProps->iLazyRowDecode = 0;
+    pConnectProps->iPreparedStatementCacheSize = 0;
+    pConnectProps->iSqlRewriteCacheSize = 64;
+    pConnectProps->llStreamingCursorBatchSize = 0;
 
     // Default SSL options
     pConnectProps->iEncryptionMethod = 1; // verify-ca
@@ -2765,6 +2809,7 @@ void RS_CONN_INFO::resetConnectProps()
 
     // Multi-INSERT command conversion
     pConnectProps->iMultiInsertCmdConvertEnable = 1; // Default is ON
+    pConnectProps->llMultiInsertBatchSize = 8192;
 
     // Default KSN
 	pConnectProps->szKerberosServiceName[0] = '\0';
@@ -3253,6 +3298,11 @@ void RS_CONN_INFO::readMoreConnectPropsFromRegistry(int readUser)
         RS_CONN_INFO::readLongLongValFromDsn(pConnectProps->szDSN, RS_CSC_THRESHOLD, &(pConnectProps->llCscThreshold));
         RS_SQLGetPrivateProfileString(pConnectProps->szDSN, RS_CSC_PATH, "", pConnectProps->szCscPath, MAX_PATH, ODBC_INI);
         RS_CONN_INFO::readLongLongValFromDsn(pConnectProps->szDSN, RS_CSC_MAX_FILE_SIZE, &(pConnectProps->llCscMaxFileSize));
+        RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_CSC_SYNC_WRITES, &(pConnectProps->iCscSyncWrites));
+        if((pConnectProps->iCscSyncWrites) && (pConnectProps->iCscSyncWrites != 1))
+            pConnectProps->iCscSyncWrites = 0;
+        RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_CSC_FILE_FORMAT, &(pConnectProps->iCscFileFormat));
+        RS_CONN_INFO::readLongLongValFromDsn(pConnectProps->szDSN, RS_CSC_CACHE_SIZE, &(pConnectProps->llCscCacheSize));
 
         // Read SSL related parameters
         RS_SQLGetPrivateProfileString(pConnectProps->szDSN, RS_SSL_MODE, "", pConnectProps->szSslMode, MAX_IDEN_LEN, ODBC_INI);
@@ -3267,6 +3317,7 @@ void RS_CONN_INFO::readMoreConnectPropsFromRegistry(int readUser)
 
         // Read Multi-Insert command conversion
         RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_MULTI_INSERT_CMD_CONVERT_ENABLE, &(pConnectProps->iMultiInsertCmdConvertEnable));
+        RS_CONN_INFO::readLongLongValFromDsn(pConnectProps->szDSN, RS_MULTI_INSERT_BATCH_SIZE, &(pConnectProps->llMultiInsertBatchSize));
 
         // Read KSN
         RS_SQLGetPrivateProfileString(pConnectProps->szDSN, RS_KERBEROS_SERVICE_NAME, "", pConnectProps->szKerberosServiceName, MAX_IDEN_LEN, ODBC_INI);
@@ -3276,8 +3327,25 @@ void RS_CONN_INFO::readMoreConnectPropsFromRegistry(int readUser)
         RS_SQLGetPrivateProfileString(pConnectProps->szDSN, RS_KERBEROS_API, "", pConnectProps->szKerberosAPI, MAX_IDEN_LEN, ODBC_INI);
 #endif
 
+      // Read result memory limit
+      RS_CONN_INFO::readLongLongValFromDsn(pConnectProps->szDSN, RS_RESULT_MEMORY_LIMIT, &(pConnectProps->llResultMemoryLimit));
+
+      // Read result cache options
+      RS_CONN_INFO::readLongLongValFromDsn(pConnectProps->szDSN, RS_RESULT_CACHE_SIZE, &(pConnectProps->llResultCacheSize));
+      RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_RESULT_CACHE_TTL, &(pConnectProps->iResultCacheTtl));
+
+      // Read lazy row decode
+      RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_LAZY_ROW_DECODE, &(pConnectProps->iLazyRowDecode));
+
+      // Read prepared statement cache size
+      RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_PREPARED_STATEMENT_CACHE_SIZE, &(pConnectProps->iPreparedStatementCacheSize));
+
+      // Read SQL rewrite cache size
+      RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_SQL_REWRITE_CACHE_SIZE, &(pConnectProps->iSqlRewriteCacheSize));
+
       // Read Streaming Cursor Rows
       RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_STREAMING_CURSOR_ROWS, &(pConnectProps->iStreamingCursorRows));
+      RS_CONN_INFO::readLongLongValFromDsn(pConnectProps->szDSN, RS_STREAMING_CURSOR_BATCH_SIZE, &(pConnectProps->llStreamingCursorBatchSize));
 
       // Read MaxVarcharSize threshold
       RS_CONN_INFO::readIntValFromDsn(pConnectProps->szDSN, RS_MAX_VARCHAR_SIZE, &(pConnectProps->iMaxVarcharSize));
@@ -436,6 +436,20 @@ SQLRETURN  SQL_API RsDrvInfo::RS_SQLGetInfo(SQLHDBC phdbc,
             break;
         }
 
+        case SQL_ASYNC_NOTIFICATION:
+        {
+            iVal = SQL_ASYNC_NOTIFICATION_CAPABLE;
+            rc = integerInfoResponse(iVal, piVal, pcbLen, piRetType);
+            break;
+        }
+
+        case SQL_ASYNC_DBC_FUNCTIONS:
+        {
+            iVal = SQL_ASYNC_DBC_NOT_CAPABLE;
+            rc = integerInfoResponse(iVal, piVal, pcbLen, piRetType);
+            break;
+        }
+
         case SQL_BATCH_ROW_COUNT:
         {
             iVal = SQL_BRC_EXPLICIT;
@@ -1343,6 +1357,9 @@ static int doesFunctionSupport(UWORD iFunction)
         case    SQL_API_SQLCOLATTRIBUTE:
         case    SQL_API_SQLCOLUMNPRIVILEGES: 
         case    SQL_API_SQLCOLUMNS:   
+#ifdef SQL_API_SQLCOMPLETEASYNC
+        case    SQL_API_SQLCOMPLETEASYNC:
+#endif
         case    SQL_API_SQLCONNECT:  
         case    SQL_API_SQLCOPYDESC: 
         case    SQL_API_SQLDATASOURCES:      
@@ -1,6 +1,8 @@
 #include "rsescapeclause.h"
 #include "rsodbc.h"
 #include "rsutil.h"
+#include "rssqllexer.h"
+#include "rssqlrewritecache.h"
 
 // File-scope static mapping tables for ODBC escape clause processing
 static const RS_MAP_INTERVAL_NAME s_intervalMappings[] = {
@@ -151,6 +153,83 @@ int ODBCEscapeClauseProcessor::needToScanODBCEscapeClause(RS_STMT_INFO *pStmt) {
     return (pStmt == NULL || pStmt->pStmtAttr->iNoScan == SQL_NOSCAN_OFF);
 }
 
+// SQL rewrite cache of the connection of the statement, or NULL.
+static RS_SQL_REWRITE_CACHE *getSqlRewriteCache(RS_STMT_INFO *pStmt) {
+    return (pStmt && pStmt->phdbc) ? pStmt->phdbc->pSqlRewriteCache : NULL;
+}
+
+// Find the processing of the SQL text, making its key.
+static std::shared_ptr<const RS_SQL_REWRITE>
+findSqlRewrite(RS_SQL_REWRITE_CACHE *pCache, RS_STMT_INFO *pStmt,
+               const char *pData, size_t cbLen, int iReplaceParamMarker,
+               std::string &key) {
+    cbLen = (INT_LEN(cbLen) == SQL_NTS) ? strlen(pData) : cbLen;
+    key = makeSqlRewriteKey(
+        pData, cbLen, iReplaceParamMarker,
+        !ODBCEscapeClauseProcessor::needToScanODBCEscapeClause(pStmt));
+
+    return pCache->find(key);
+}
+
+// Keep the processing of the SQL text. pRewritten NULL means the SQL is
+// unchanged. Processing reporting an error, or done after a {call} of an
+// earlier SQL set iFunctionCall, isn't kept.
+static void addSqlRewrite(RS_SQL_REWRITE_CACHE *pCache, const std::string &key,
+                          RS_STMT_INFO *pStmt, const char *pRewritten,
+                          int numOfParamMarkers, int iFunctionCallBefore,
+                          RS_ERROR_INFO *pErrorsBefore) {
+    if (pStmt->pErrorList != pErrorsBefore || iFunctionCallBefore)
+        return;
+
+    std::shared_ptr<RS_SQL_REWRITE> rewrite = std::make_shared<RS_SQL_REWRITE>();
+
+    rewrite->iUnchanged = (pRewritten == NULL);
+    if (pRewritten)
+        rewrite->sql = pRewritten;
+    rewrite->iParamMarkers = numOfParamMarkers;
+    rewrite->iFunctionCall = pStmt->iFunctionCall;
+    rewrite->iMultiInsert = 0;
+
+    pCache->add(key, rewrite);
+}
+
+// Lex the SQL text once for the counts and the replacement. SQL without any '?'
+// or '{' isn't lexed.
+static void lexSqlRewrite(RS_STMT_INFO *pStmt, const char *pData, size_t cbLen,
+                          int iReplaceParamMarker, RS_SQL_LEX &lex,
+                          int &numOfParamMarkers,
+                          int &numOfODBCEscapeClauses) {
+    cbLen = (INT_LEN(cbLen) == SQL_NTS) ? strlen(pData) : cbLen;
+    numOfParamMarkers = 0;
+    numOfODBCEscapeClauses = 0;
+
+    if (!hasSqlMarkerOrEscape(pData, cbLen))
+        return;
+
+    lexSql(pData, cbLen, lex, RS_SQL_LEX_ALL_TOKENS);
+
+    if (iReplaceParamMarker)
+        numOfParamMarkers = lex.iParamMarkers;
+    if (ODBCEscapeClauseProcessor::needToScanODBCEscapeClause(pStmt))
+        numOfODBCEscapeClauses = lex.iEscapeClauses;
+}
+
+// Copy the rewritten SQL of the cache into the buffer.
+static unsigned char *copySqlRewrite(RS_STMT_INFO *pStmt,
+                                     const RS_SQL_REWRITE &rewrite,
+                                     RS_STR_BUF *pPaStrBuf) {
+    unsigned char *szData =
+        checkLenAndAllocatePaStrBuf(rewrite.sql.size(), pPaStrBuf);
+
+    if (szData)
+        memcpy(szData, rewrite.sql.c_str(), rewrite.sql.size() + 1);
+
+    if (rewrite.iFunctionCall)
+        pStmt->iFunctionCall = TRUE;
+
+    return szData;
+}
+
 unsigned char *
 ODBCEscapeClauseProcessor::checkReplaceParamMarkerAndODBCEscapeClause(
     RS_STMT_INFO *pStmt, char *pData, size_t cbLen, RS_STR_BUF *pPaStrBuf,
@@ -160,15 +239,37 @@ ODBCEscapeClauseProcessor::checkReplaceParamMarkerAndODBCEscapeClause(
     resetPaStrBuf(pPaStrBuf);
 
     if ((pData != NULL) && (INT_LEN(cbLen) != SQL_NULL_DATA)) {
-        int numOfParamMarkers =
-            (iReplaceParamMarker) ? countParamMarkers(pData, cbLen) : 0;
-        int numOfODBCEscapeClauses =
-            countODBCEscapeClauses(pStmt, pData, cbLen);
+        RS_SQL_REWRITE_CACHE *pCache = getSqlRewriteCache(pStmt);
+        std::shared_ptr<const RS_SQL_REWRITE> rewrite;
+        std::string key;
+        RS_SQL_LEX lex;
+        int numOfParamMarkers;
+        int numOfODBCEscapeClauses;
+
+        // Same SQL text processed before skips the scans
+        if (pCache)
+            rewrite = findSqlRewrite(pCache, pStmt, pData, cbLen,
+                                     iReplaceParamMarker, key);
+
+        if (rewrite) {
+            numOfParamMarkers = rewrite->iParamMarkers;
+            numOfODBCEscapeClauses = 0;
+        } else {
+            lexSqlRewrite(pStmt, pData, cbLen, iReplaceParamMarker, lex,
+                          numOfParamMarkers, numOfODBCEscapeClauses);
+        }
 
         if (pStmt)
             setParamMarkerCount(pStmt, numOfParamMarkers);
 
-        if (!numOfParamMarkers && !numOfODBCEscapeClauses) {
+        if (rewrite && !rewrite->iUnchanged) {
+            szData = copySqlRewrite(pStmt, *rewrite, pPaStrBuf);
+        } else if (rewrite ||
+                   (!numOfParamMarkers && !numOfODBCEscapeClauses)) {
+            if (pCache && !rewrite)
+                addSqlRewrite(pCache, key, pStmt, NULL, 0, FALSE,
+                              pStmt->pErrorList);
+
             if (INT_LEN(cbLen) == SQL_NTS) {
                 if (pPaStrBuf)
                     pPaStrBuf->pBuf = pData;
@@ -188,9 +289,18 @@ ODBCEscapeClauseProcessor::checkReplaceParamMarkerAndODBCEscapeClause(
             }
         } // No param marker
         else {
+            int iFunctionCallBefore = (pStmt) ? pStmt->iFunctionCall : FALSE;
+            RS_ERROR_INFO *pErrorsBefore = (pStmt) ? pStmt->pErrorList : NULL;
+
             szData = replaceParamMarkerAndODBCEscapeClause(
                 pStmt, pData, cbLen, pPaStrBuf, numOfParamMarkers,
-                numOfODBCEscapeClauses);
+                numOfODBCEscapeClauses, &lex);
+
+            // Original SQL back means a parse error
+            if (pCache && szData && szData != (unsigned char *)pData)
+                addSqlRewrite(pCache, key, pStmt, (char *)szData,
+                              numOfParamMarkers, iFunctionCallBefore,
+                              pErrorsBefore);
         } // Param marker found
     } else {
         szData = NULL;
@@ -199,9 +309,72 @@ ODBCEscapeClauseProcessor::checkReplaceParamMarkerAndODBCEscapeClause(
     return szData;
 }
 
+unsigned char *
+ODBCEscapeClauseProcessor::replaceParamMarkerAndODBCEscapeClauseInBuf(
+    RS_STMT_INFO *pStmt, RS_STR_BUF *pPaStrBuf) {
+    char *pData = pPaStrBuf->pBuf;
+    RS_SQL_REWRITE_CACHE *pCache = getSqlRewriteCache(pStmt);
+    std::shared_ptr<const RS_SQL_REWRITE> rewrite;
+    std::string key;
+
+    if (pData == NULL || *pData == '\0')
+        return (unsigned char *)pData;
+
+    // Same SQL text processed before skips the scans
+    if (pCache)
+        rewrite = findSqlRewrite(pCache, pStmt, pData, SQL_NTS, TRUE, key);
+
+    if (rewrite) {
+        setParamMarkerCount(pStmt, rewrite->iParamMarkers);
+
+        if (rewrite->iUnchanged)
+            return (unsigned char *)pData;
+
+        releasePaStrBuf(pPaStrBuf);
+        return copySqlRewrite(pStmt, *rewrite, pPaStrBuf);
+    }
+
+    RS_SQL_LEX lex;
+    int numOfParamMarkers;
+    int numOfODBCEscapeClauses;
+    unsigned char *szData = (unsigned char *)pData;
+
+    lexSqlRewrite(pStmt, pData, SQL_NTS, TRUE, lex, numOfParamMarkers,
+                  numOfODBCEscapeClauses);
+
+    setParamMarkerCount(pStmt, numOfParamMarkers);
+
+    if (numOfParamMarkers > 0 || numOfODBCEscapeClauses > 0) {
+        int iFunctionCallBefore = pStmt->iFunctionCall;
+        RS_ERROR_INFO *pErrorsBefore = pStmt->pErrorList;
+        char *pTempCmd = rs_strdup(pData, SQL_NTS);
+
+        releasePaStrBuf(pPaStrBuf);
+        szData = replaceParamMarkerAndODBCEscapeClause(
+            pStmt, pTempCmd, SQL_NTS, pPaStrBuf, numOfParamMarkers,
+            numOfODBCEscapeClauses, &lex);
+
+        // Original SQL back means a parse error. The buffer keeps it.
+        if (szData == (unsigned char *)pTempCmd) {
+            pPaStrBuf->iAllocDataLen = (int)strlen(pTempCmd);
+            pTempCmd = NULL;
+        } else if (pCache && szData) {
+            addSqlRewrite(pCache, key, pStmt, (char *)szData,
+                          numOfParamMarkers, iFunctionCallBefore,
+                          pErrorsBefore);
+        }
+
+        pTempCmd = (char *)rs_free(pTempCmd);
+    } else if (pCache) {
+        addSqlRewrite(pCache, key, pStmt, NULL, 0, FALSE, pStmt->pErrorList);
+    }
+
+    return szData;
+}
+
 unsigned char *ODBCEscapeClauseProcessor::replaceParamMarkerAndODBCEscapeClause(
     RS_STMT_INFO *pStmt, char *pData, size_t cbLen, RS_STR_BUF *pPaStrBuf,
-    int numOfParamMarkers, int numOfODBCEscapeClauses) {
+    int numOfParamMarkers, int numOfODBCEscapeClauses, const RS_SQL_LEX *pLex) {
     unsigned char *szData = (unsigned char *)pData;
 
     if (numOfParamMarkers > 0 || numOfODBCEscapeClauses > 0) {
@@ -210,22 +383,24 @@ unsigned char *ODBCEscapeClauseProcessor::replaceParamMarkerAndODBCEscapeClause(
         int iMaxParamMarkerLen;
         char szTemp[MAX_NUMBER_BUF_LEN];
         int i;
-        int iQuote = 0;
-        int iDoubleQuote = 0;
-        int iComment = 0;
-        int iSingleLineComment = 0;
         char *pSrc = pData;
         char *pDest, *pDestStart;
         int iParamNumber = 0;
         int iTemp;
         int buf_len;
         int parseError = FALSE; // Flag to track parsing errors
+        int scanForODBCEscapeClause = needToScanODBCEscapeClause(pStmt);
+        RS_SQL_LEX lex;
 
         resetPaStrBuf(pPaStrBuf);
         cbLen = (INT_LEN(cbLen) == SQL_NTS) ? strlen(pData) : cbLen;
 
-        iLen = (int)cbLen;
+        if (pLex == NULL) {
+            lexSql(pData, cbLen, lex, RS_SQL_LEX_ALL_TOKENS);
+            pLex = &lex;
+        }
 
+        iLen = (int)cbLen;
         if (numOfParamMarkers) {
             snprintf(szTemp, sizeof(szTemp), "%d", numOfParamMarkers);
             iMaxParamMarkerLen = (int)(strlen(szTemp) + 1);
@@ -251,117 +426,55 @@ unsigned char *ODBCEscapeClauseProcessor::replaceParamMarkerAndODBCEscapeClause(
         }
 
         pDestStart = pDest = (char *)szData;
-
-        for (i = 0; i < (int)cbLen && !parseError; i++, pSrc++, pDest++) {
-            switch (*pSrc) {
-            case PARAM_MARKER: {
-                if (!iQuote && !iDoubleQuote && !iComment &&
-                    !iSingleLineComment && numOfParamMarkers) {
-                    int occupied = (pDest - pDestStart);
-
-                    iTemp = snprintf(pDest, buf_len - occupied, "%c%d",
-                                     DOLLAR_SIGN, ++iParamNumber);
-                    pDest += (iTemp - 1); // -1 because we do ++ in the loop end
-                } else
-                    *pDest = *pSrc;
-
-                break;
-            }
-
-            case ODBC_ESCAPE_CLAUSE_START_MARKER: {
-                if (!iQuote && !iDoubleQuote && !iComment &&
-                    !iSingleLineComment) {
-                    int result = replaceODBCEscapeClause(
-                        pStmt, &pDest, pDestStart, buf_len, &pSrc, cbLen, i,
-                        numOfParamMarkers, iParamNumber, 0, parseError);
-                    if (result < 0 || parseError) {
-                        parseError = TRUE;
-                        break;
-                    }
-                    i = result;
-                } else
-                    *pDest = *pSrc;
-
-                break;
-            }
-
-            case SINGLE_QUOTE: {
-                if (!iComment && !iSingleLineComment) {
-                    int escapedQuote =
-                        ((pSrc != pData) && (*(pSrc - 1) == '\\'));
-
-                    if (!escapedQuote) {
-                        if (iQuote)
-                            iQuote--;
-                        else
-                            iQuote++;
-                    }
-                }
-
-                *pDest = *pSrc;
-                break;
-            }
-
-            case DOUBLE_QUOTE: {
-                if (!iComment && !iSingleLineComment) {
-                    if (iDoubleQuote)
-                        iDoubleQuote--;
-                    else
-                        iDoubleQuote++;
-                }
-
-                *pDest = *pSrc;
-                break;
-            }
-
-            case STAR: {
-                if (!iQuote && !iDoubleQuote) {
-                    if ((pSrc != pData) && (*(pSrc - 1) == SLASH))
-                        iComment++;
-                }
-
-                *pDest = *pSrc;
-                break;
-            }
-
-            case SLASH: {
-                if (!iQuote && !iDoubleQuote) {
-                    if ((pSrc != pData) && (*(pSrc - 1) == STAR) && iComment)
-                        iComment--;
-                }
-
-                *pDest = *pSrc;
-                break;
-            }
-
-            case DASH: // Single line comment
-            {
-                if (!iQuote && !iDoubleQuote) {
-                    if ((pSrc != pData) && (*(pSrc - 1) == DASH))
-                        iSingleLineComment++;
-                }
-
-                *pDest = *pSrc;
-                break;
-            }
-
-            case NEW_LINE: {
-                if (!iQuote && !iDoubleQuote) {
-                    if (iSingleLineComment)
-                        iSingleLineComment--;
+        i = 0;
+
+        // Only markers and escape clauses change, the text in between is
+        // copied as is.
+        for (const RS_SQL_TOKEN &token : pLex->tokens) {
+            int iMarker = (token.iType == RS_SQL_TOKEN_PARAM_MARKER &&
+                           numOfParamMarkers);
+            int iEscapeClause = (token.iType == RS_SQL_TOKEN_ESCAPE_START &&
+                                 scanForODBCEscapeClause);
+
+            // Token copied or in an escape clause replaced already
+            if ((!iMarker && !iEscapeClause) || token.iOffset < i)
+                continue;
+
+            memcpy(pDest, pSrc, token.iOffset - i);
+            pDest += (token.iOffset - i);
+            pSrc += (token.iOffset - i);
+            i = token.iOffset;
+
+            if (iMarker) {
+                int occupied = (pDest - pDestStart);
+
+                iTemp = snprintf(pDest, buf_len - occupied, "%c%d",
+                                 DOLLAR_SIGN, ++iParamNumber);
+                pDest += iTemp;
+                pSrc++;
+                i++;
+            } else {
+                int result = replaceODBCEscapeClause(
+                    pStmt, &pDest, pDestStart, buf_len, &pSrc, cbLen, i,
+                    numOfParamMarkers, iParamNumber, 0, parseError);
+                if (result < 0 || parseError) {
+                    parseError = TRUE;
+                    break;
                 }
 
-                *pDest = *pSrc;
-                break;
-            }
-
-            default: {
-                *pDest = *pSrc;
-                break;
+                // Clause ends at the result, pSrc and pDest are on its last
+                // character
+                i = result + 1;
+                pSrc++;
+                pDest++;
             }
-            } // Switch
         } // Loop
 
+        if (!parseError && i < (int)cbLen) {
+            memcpy(pDest, pSrc, cbLen - i);
+            pDest += (cbLen - i);
+        }
+
         // If parsing error occurred, return original data unchanged
         if (parseError) {
             RS_LOG_ERROR(
@@ -1349,92 +1462,16 @@ int ODBCEscapeClauseProcessor::countParamMarkers(char *pData, size_t cbLen) {
     int numOfParamMarkers = 0;
 
     if (pData) {
-        char *pTemp;
-
         if (INT_LEN(cbLen) == SQL_NTS)
             cbLen = strlen(pData);
 
         // Is any parameter marker?
-        pTemp = (char *)memchr(pData, PARAM_MARKER, cbLen);
-
-        if (pTemp != NULL) {
-            int iQuote = 0;
-            int iDoubleQuote = 0;
-            int iComment = 0;
-            int iSingleLineComment = 0;
-            int i;
-
-            pTemp = pData;
-
-            for (i = 0; i < (int)cbLen; i++, pTemp++) {
-                switch (*pTemp) {
-                case PARAM_MARKER: {
-                    if (!iQuote && !iDoubleQuote && !iComment &&
-                        !iSingleLineComment)
-                        numOfParamMarkers++;
-
-                    break;
-                }
-
-                case SINGLE_QUOTE: {
-                    int escapedQuote =
-                        ((pTemp != pData) && (*(pTemp - 1) == '\\'));
-
-                    if (!escapedQuote) {
-                        if (iQuote)
-                            iQuote--;
-                        else
-                            iQuote++;
-                    }
-
-                    break;
-                }
-
-                case DOUBLE_QUOTE: {
-                    if (iDoubleQuote)
-                        iDoubleQuote--;
-                    else
-                        iDoubleQuote++;
-
-                    break;
-                }
-
-                case STAR: {
-                    if ((pTemp != pData) && (*(pTemp - 1) == SLASH))
-                        iComment++;
-
-                    break;
-                }
-
-                case SLASH: {
-                    if ((pTemp != pData) && (*(pTemp - 1) == STAR) && iComment)
-                        iComment--;
-
-                    break;
-                }
-
-                case DASH: // Single line comment
-                {
-                    if ((pTemp != pData) && (*(pTemp - 1) == DASH))
-                        iSingleLineComment++;
-
-                    break;
-                }
-
-                case NEW_LINE: {
-                    if (iSingleLineComment)
-                        iSingleLineComment--;
-
-                    break;
-                }
+        if (memchr(pData, PARAM_MARKER, cbLen) != NULL) {
+            RS_SQL_LEX lex;
 
-                default: {
-                    // Do nothing
-                    break;
-                }
-                } // Switch
-            } // Loop
-        } // Any param marker?
+            lexSql(pData, cbLen, lex, 0);
+            numOfParamMarkers = lex.iParamMarkers;
+        }
     }
 
     return numOfParamMarkers;
@@ -1447,22 +1484,15 @@ int ODBCEscapeClauseProcessor::countODBCEscapeClauses(RS_STMT_INFO *pStmt,
     int scanForODBCEscapeClause = needToScanODBCEscapeClause(pStmt);
 
     if (pData && scanForODBCEscapeClause) {
-        char *pTemp = pData;
-        int iOffset = 0;
-
         if (INT_LEN(cbLen) == SQL_NTS)
             cbLen = strlen(pData);
 
-        while (pTemp != NULL) {
-            pTemp =
-                (char *)memchr(pData + iOffset, ODBC_ESCAPE_CLAUSE_START_MARKER,
-                               cbLen - iOffset);
-            if (pTemp) {
-                numOfEscapeClauses++;
-                iOffset = (int)((pTemp - pData) + 1);
-                if (iOffset >= (int)cbLen)
-                    break;
-            }
+        // Is any escape clause?
+        if (memchr(pData, ODBC_ESCAPE_CLAUSE_START_MARKER, cbLen) != NULL) {
+            RS_SQL_LEX lex;
+
+            lexSql(pData, cbLen, lex, 0);
+            numOfEscapeClauses = lex.iEscapeClauses;
         }
     }
 
@@ -8,6 +8,8 @@
 struct RS_STMT_INFO;
 struct _RS_STR_BUF;
 typedef struct _RS_STR_BUF RS_STR_BUF;
+struct _RS_SQL_LEX;
+typedef struct _RS_SQL_LEX RS_SQL_LEX;
 
 
 // Maximum replacement length for ODBC escape clause conversion
@@ -79,11 +81,26 @@ class ODBCEscapeClauseProcessor {
      * @param pPaStrBuf Buffer structure for result storage
      * @param numOfParamMarkers Number of parameter markers in the statement
      * @param numOfODBCEscapeClauses Number of escape clauses in the statement
+     * @param pLex Tokens of the SQL statement, or NULL to lex it
      * @return Pointer to processed SQL string
      */
     static unsigned char *replaceParamMarkerAndODBCEscapeClause(
         RS_STMT_INFO *pStmt, char *pData, size_t cbLen, RS_STR_BUF *pPaStrBuf,
-        int numOfParamMarkers, int numOfODBCEscapeClauses);
+        int numOfParamMarkers, int numOfODBCEscapeClauses,
+        const RS_SQL_LEX *pLex = NULL);
+    /**
+     * @brief Replace ODBC parameter markers and escape clauses of the SQL
+     * statement in the buffer.
+     *
+     * Like checkReplaceParamMarkerAndODBCEscapeClause, for SQL the driver
+     * already copied into the buffer. The processed SQL replaces it.
+     *
+     * @param pStmt Pointer to statement info structure
+     * @param pPaStrBuf Buffer holding the null-terminated SQL statement
+     * @return Pointer to processed SQL string
+     */
+    static unsigned char *replaceParamMarkerAndODBCEscapeClauseInBuf(
+        RS_STMT_INFO *pStmt, RS_STR_BUF *pPaStrBuf);
 
     /**
      * @brief Determine if ODBC escape clause scanning is needed.
@@ -95,8 +112,8 @@ class ODBCEscapeClauseProcessor {
     /**
      * @brief Count parameter markers in a SQL statement.
      *
-     * Counts '?' parameter markers while respecting quoted strings,
-     * double-quoted identifiers, and SQL comments.
+     * Counts '?' parameter markers outside quoted strings, double-quoted
+     * identifiers, and SQL comments, as lexed by lexSql.
      *
      * @param pData Pointer to SQL statement data
      * @param cbLen Length of SQL statement (or SQL_NTS for null-terminated)
@@ -106,8 +123,8 @@ class ODBCEscapeClauseProcessor {
     /**
      * @brief Count ODBC escape clauses in a SQL statement.
      *
-     * Counts '{' markers that indicate ODBC escape clauses, considering whether
-     * escape clause scanning is enabled.
+     * Counts '{' markers outside quotes and comments that indicate ODBC escape
+     * clauses, considering whether escape clause scanning is enabled.
      *
      * @param pStmt Pointer to statement info structure
      * @param pData Pointer to SQL statement data
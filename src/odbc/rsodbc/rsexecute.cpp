@@ -83,8 +83,7 @@ SQLRETURN SQL_API SQLExecDirectW(SQLHSTMT   phstmt,
     if(szCmd)
     {
         // Look for INSERT command with array binding, which can convert into Multi INSERT
-        char *pLastBatchMultiInsertCmd = NULL;
-        char *pszMultiInsertCmd = parseForMultiInsertCommand(pStmt, szCmd, SQL_NTS, &pLastBatchMultiInsertCmd);
+        char *pszMultiInsertCmd = parseForMultiInsertCommand(pStmt, szCmd, SQL_NTS);
 
         if(pszMultiInsertCmd)
         {
@@ -94,39 +93,13 @@ SQLRETURN SQL_API SQLExecDirectW(SQLHSTMT   phstmt,
                 rs_strncpy(szCmd, pszMultiInsertCmd,len+1);
 
             pszMultiInsertCmd = (char *)rs_free(pszMultiInsertCmd);
-
-            if(pLastBatchMultiInsertCmd)
-            {
-                rc = createLastBatchMultiInsertCmd(pStmt, pLastBatchMultiInsertCmd);
-                pLastBatchMultiInsertCmd = NULL;
-                if(rc == SQL_ERROR) {
-                    return rc;
-                }
-            }
         }
     }
 
     if(szCmd)
     {
-        int numOfParamMarkers = ODBCEscapeClauseProcessor::countParamMarkers(
-            pStmt->pCmdBuf->pBuf, SQL_NTS);
-        int numOfODBCEscapeClauses =
-            ODBCEscapeClauseProcessor::countODBCEscapeClauses(
-                pStmt, pStmt->pCmdBuf->pBuf, SQL_NTS);
-
-        setParamMarkerCount(pStmt,numOfParamMarkers);
-
-        if(numOfParamMarkers > 0 || numOfODBCEscapeClauses > 0)
-        {
-            char *pTempCmd = rs_strdup(pStmt->pCmdBuf->pBuf, SQL_NTS);
-
-            releasePaStrBuf(pStmt->pCmdBuf);
-            szCmd = (char *)ODBCEscapeClauseProcessor::
-                replaceParamMarkerAndODBCEscapeClause(
-                    pStmt, pTempCmd, SQL_NTS, pStmt->pCmdBuf, numOfParamMarkers,
-                    numOfODBCEscapeClauses);
-            pTempCmd = (char *)rs_free(pTempCmd);
-        }
+        szCmd = (char *)ODBCEscapeClauseProcessor::
+            replaceParamMarkerAndODBCEscapeClauseInBuf(pStmt, pStmt->pCmdBuf);
     }
 
     rc = RsExecute::RS_SQLExecDirect(phstmt, (SQLCHAR *)szCmd, SQL_NTS, TRUE, FALSE, TRUE, TRUE);
@@ -175,11 +148,8 @@ void RS_STMT_INFO::resetMultiInsertInfo() {
     pszUserInsertCmd = (char *)rs_free(pszUserInsertCmd);
     lArraySizeMultiInsert = 0;
     iMultiInsert = 0;
-    // Release last batch multi-insert command, if any.
-    releasePaStrBuf(pszLastBatchMultiInsertCmd);
-    pszLastBatchMultiInsertCmd =
-        (struct _RS_STR_BUF *)rs_free(pszLastBatchMultiInsertCmd);
-    iLastBatchMultiInsert = 0;
+    // Release smaller multi-insert batches, if any.
+    libpqReleaseMultiInsertBatches(this);
 }
 
 //---------------------------------------------------------------------------------------------------------igarish
@@ -198,7 +168,6 @@ SQLRETURN  SQL_API RsExecute::RS_SQLExecDirect(SQLHSTMT phstmt,
     RS_STMT_INFO *pStmt = (RS_STMT_INFO *)phstmt;
     char *pszCmd = NULL;
     char *pszMultiInsertCmd = NULL;
-    char *pLastBatchMultiInsertCmd = NULL;
 	RS_CONN_INFO *pConn = NULL;
 	int iApiLocked = FALSE;
 
@@ -211,12 +180,12 @@ SQLRETURN  SQL_API RsExecute::RS_SQLExecDirect(SQLHSTMT phstmt,
     // Is thread running?
     if(pStmt->pExecThread)
     {
-        int iPrepare = pStmt->pExecThread->iPrepare;
+        int iPrepare;
 
         rc = checkExecutingThread(pStmt);
         if(rc != SQL_STILL_EXECUTING)
         {
-            waitAndFreeExecThread(pStmt, FALSE);
+            rc = finishExecThread(pStmt, rc, &iPrepare);
             if(!iPrepare)
                 return rc;
             else
@@ -285,7 +254,7 @@ SQLRETURN  SQL_API RsExecute::RS_SQLExecDirect(SQLHSTMT phstmt,
 
             // Look for INSERT command with array binding, which can convert into Multi INSERT
             pszMultiInsertCmd = parseForMultiInsertCommand(
-                pStmt, (char *)pCmd, cbLen, &pLastBatchMultiInsertCmd);
+                pStmt, (char *)pCmd, cbLen);
 
             if(!pszMultiInsertCmd)
             {
@@ -301,14 +270,6 @@ SQLRETURN  SQL_API RsExecute::RS_SQLExecDirect(SQLHSTMT phstmt,
                         pStmt, pszMultiInsertCmd, SQL_NTS, pStmt->pCmdBuf,
                         TRUE);
                 pszMultiInsertCmd = (char *)rs_free(pszMultiInsertCmd);
-
-                if(pLastBatchMultiInsertCmd)
-                {
-                    rc = createLastBatchMultiInsertCmd(pStmt, pLastBatchMultiInsertCmd);
-                    pLastBatchMultiInsertCmd = NULL;
-                    if(rc == SQL_ERROR)
-                        goto error;
-                }
             }
         }
         else
@@ -420,12 +381,7 @@ SQLRETURN  SQL_API SQLParamData(SQLHSTMT phstmt, SQLPOINTER *ppValue)
         else
         {
             if(pStmt->pExecThread->iExecFromParamData)
-            {
-                pStmt->pExecThread->iExecFromParamData = 0;
-                resetAndReleaseDataAtExec(pStmt);
-                waitAndFreeExecThread(pStmt, FALSE);
-                return rc;
-            }
+                return finishExecThread(pStmt, rc, NULL);
             else
                 rc = SQL_SUCCESS;
         }
@@ -570,6 +526,7 @@ error:
 
 //---------------------------------------------------------------------------------------------------------igarish
 // SQLCancel cancels the processing on a statement.
+// The cancel request is sent in the background, so it returns without waiting for the server.
 //
 SQLRETURN  SQL_API SQLCancel(SQLHSTMT phstmt)
 {
@@ -603,6 +560,430 @@ error:
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// SQLCompleteAsync waits for the asynchronous function executing on the handle, e.g. after the notification of
+// its completion, and returns its return code in pAsyncRetCode. It finishes the function, as calling it again would.
+// Connection functions are never asynchronous, so a connection has nothing to complete.
+//
+SQLRETURN SQL_API SQLCompleteAsync(SQLSMALLINT hHandleType, SQLHANDLE pHandle, RETCODE *pAsyncRetCode)
+{
+    SQLRETURN rc = SQL_SUCCESS;
+
+    if(IS_TRACE_LEVEL_API_CALL())
+        TraceSQLCompleteAsync(FUNC_CALL, 0, hHandleType, pHandle, pAsyncRetCode);
+
+    switch(hHandleType)
+    {
+        case SQL_HANDLE_STMT:
+        {
+            RS_STMT_INFO *pStmt = (RS_STMT_INFO *)pHandle;
+
+            if(!VALID_HSTMT(pHandle))
+            {
+                rc = SQL_INVALID_HANDLE;
+                goto error;
+            }
+
+            // Clear error list
+            pStmt->pErrorList = clearErrorList(pStmt->pErrorList);
+
+            if(pAsyncRetCode == NULL)
+            {
+                rc = SQL_ERROR;
+                addError(&pStmt->pErrorList,"HY009", "Invalid use of null pointer", 0, NULL);
+                goto error;
+            }
+
+            if(pStmt->pExecThread == NULL)
+            {
+                rc = SQL_NO_DATA;
+                goto error;
+            }
+
+            // Same post-processing as when the operation is polled
+            *pAsyncRetCode = finishExecThread(pStmt, waitForExecThread(pStmt), NULL);
+
+            break;
+        }
+
+        case SQL_HANDLE_DBC:
+        {
+            if(!VALID_HDBC(pHandle))
+            {
+                rc = SQL_INVALID_HANDLE;
+                goto error;
+            }
+
+            rc = SQL_NO_DATA;
+            break;
+        }
+
+        default:
+        {
+            rc = SQL_INVALID_HANDLE;
+            break;
+        }
+    }
+
+error:
+
+    if(IS_TRACE_LEVEL_API_CALL())
+        TraceSQLCompleteAsync(FUNC_RETURN, rc, hHandleType, pHandle, pAsyncRetCode);
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Append the identifier in double quotes.
+//
+static void appendQuotedIdentifier(std::string &sql, const char *pszName)
+{
+    sql += '"';
+
+    for(const char *p = pszName; *p != '\0'; p++)
+    {
+        if(*p == '"')
+            sql += '"';
+        sql += *p;
+    }
+
+    sql += '"';
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Value and length/indicator of the bound column in the row of the rowset, where SQLFetch puts them.
+//
+static char *getBoundColumnData(RS_DESC_HEADER &pARDDescHeader, RS_DESC_REC *pDescRec, long lRow, SQLLEN **ppcbLenInd)
+{
+    SQLLEN iBindOffset = (pARDDescHeader.plBindOffsetPtr) ? *(pARDDescHeader.plBindOffsetPtr) : 0;
+    SQLLEN iValOffset;
+    SQLLEN *pcbLenInd;
+
+    if(pARDDescHeader.lBindType == SQL_BIND_BY_COLUMN)
+    {
+        // Column wise binding
+        iValOffset = pDescRec->iOctetLen;
+        pcbLenInd  = (pDescRec->pcbLenInd) ? pDescRec->pcbLenInd + lRow : NULL;
+    }
+    else
+    {
+        // Row wise binding
+        iValOffset = pARDDescHeader.lBindType;
+
+        if(pDescRec->plOctetLen == NULL)
+            pcbLenInd = (pDescRec->pcbLenInd) ? (SQLLEN *)(((char *)pDescRec->pcbLenInd) + (iValOffset * lRow)) : NULL;
+        else
+            pcbLenInd = (pDescRec->pcbLenInd) ? pDescRec->pcbLenInd + lRow : NULL;
+    }
+
+    *ppcbLenInd = (pcbLenInd) ? (SQLLEN *)((char *)pcbLenInd + iBindOffset) : NULL;
+
+    return (char *)pDescRec->pValue + (lRow * iValOffset) + iBindOffset;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release the converted values from the index.
+//
+static void releaseBulkValues(std::vector<RS_BIND_PARAM_STR_BUF> &strBufs, size_t iFrom, size_t iTo)
+{
+    for(size_t i = iFrom; i < iTo && i < strBufs.size(); i++)
+    {
+        if(strBufs[i].iAllocDataLen > 0)
+        {
+            strBufs[i].pBuf = (char *)rs_free(strBufs[i].pBuf);
+            strBufs[i].iAllocDataLen = 0;
+        }
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Execute the INSERT of the batch of rows, and put the status of its rows.
+//
+static SQLRETURN executeBulkBatch(RS_STMT_INFO *pStmt, std::string &sql, std::vector<const char *> &paramVals,
+                                  std::vector<RS_BIND_PARAM_STR_BUF> &strBufs, std::vector<long> &batchRows,
+                                  long *plRowsAdded, long *plRowsFailed)
+{
+    RS_DESC_HEADER &pIRDDescHeader = pStmt->pIRD->pDescHeader;
+    SQLRETURN rc = libpqExecuteBulkInsert(pStmt, (char *)sql.c_str(), (int)paramVals.size(), paramVals.data());
+
+    for(long lRow : batchRows)
+    {
+        if(pIRDDescHeader.phArrayStatusPtr)
+            pIRDDescHeader.phArrayStatusPtr[lRow] = (rc == SQL_ERROR) ? SQL_ROW_ERROR : SQL_ROW_ADDED;
+    }
+
+    if(rc == SQL_ERROR)
+        *plRowsFailed += (long)batchRows.size();
+    else
+        *plRowsAdded += (long)batchRows.size();
+
+    releaseBulkValues(strBufs, 0, paramVals.size());
+    paramVals.clear();
+    batchRows.clear();
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Failed batch aborted the transaction, so the rows of the earlier batches aren't added either.
+//
+static SQLRETURN failBulkAddTransaction(RS_STMT_INFO *pStmt, long lRows)
+{
+    RS_DESC_HEADER &pARDDescHeader = pStmt->pStmtAttr->pARD->pDescHeader;
+    RS_DESC_HEADER &pIRDDescHeader = pStmt->pIRD->pDescHeader;
+
+    if(pIRDDescHeader.phArrayStatusPtr)
+    {
+        for(long lRow = 0; lRow < lRows; lRow++)
+        {
+            if(pARDDescHeader.phArrayStatusPtr == NULL || pARDDescHeader.phArrayStatusPtr[lRow] != SQL_ROW_IGNORE)
+                pIRDDescHeader.phArrayStatusPtr[lRow] = SQL_ROW_ERROR;
+        }
+    }
+
+    return SQL_ERROR;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Add the rows of the rowset buffers to the table of the result set. Bound columns of a batch of rows go in one
+// multi-row INSERT, with the row and byte limits of the multi INSERT conversion. Columns not bound, and
+// SQL_COLUMN_IGNORE values, get the column default. Rows with SQL_ROW_IGNORE operation are skipped.
+// In a transaction, a failed batch fails all the rows, as the server aborts the transaction.
+// Data-at-execution values (SQL_DATA_AT_EXEC, SQL_LEN_DATA_AT_EXEC(n)) aren't supported, they fail the call before
+// any row is added.
+//
+static SQLRETURN bulkAddRows(RS_STMT_INFO *pStmt)
+{
+    RS_RESULT_INFO *pResult = pStmt->pResultHead;
+    RS_DESC_HEADER &pARDDescHeader = pStmt->pStmtAttr->pARD->pDescHeader;
+    RS_DESC_HEADER &pIRDDescHeader = pStmt->pIRD->pDescHeader;
+    long lRows = (pARDDescHeader.lArraySize <= 0) ? 1 : pARDDescHeader.lArraySize;
+    long long llMaxBytes = pStmt->phdbc->pConnectProps->llMultiInsertBatchSize * 1024;
+    RS_DESC_REC *pTableRec = NULL;
+    std::vector<RS_DESC_REC *> cols;
+    std::vector<RS_BIND_PARAM_STR_BUF> strBufs;
+    std::vector<const char *> paramVals;
+    std::vector<long> batchRows;
+    std::string insertCmd;
+    std::string sql;
+    long long llBatchBytes = 0;
+    long lRowsAdded = 0;
+    long lRowsFailed = 0;
+    int iMaxRows;
+    int iInTransaction = (pStmt->phdbc->pConnAttr->iAutoCommit == SQL_AUTOCOMMIT_OFF);
+
+    if(pResult == NULL || pResult->iNumberOfCols <= 0 || pStmt->pIRD->pDescRecHead == NULL)
+    {
+        addError(&pStmt->pErrorList,"HY010", "Function sequence error", 0, NULL);
+        return SQL_ERROR;
+    }
+
+    // Rows of the streaming cursor of the statement not read yet would be skipped by the INSERT
+    if(pStmt->pCscStatementContext
+        && isStreamingCursorMode(pStmt)
+        && pResult->pgResult
+        && !libpqIsEndOfStreamingCursorQuery(pStmt))
+    {
+        addError(&pStmt->pErrorList,"HY010", "Function sequence error-SQLBulkOperations:SQL_ADD while rows of the result set are pending", 0, NULL);
+        return SQL_ERROR;
+    }
+
+    // Bound columns, which must be of one table
+    for(RS_DESC_REC *pDescRec = pStmt->pStmtAttr->pARD->pDescRecHead; pDescRec != NULL; pDescRec = pDescRec->pNext)
+    {
+        RS_DESC_REC *pIRDRec;
+        const char *pszColName;
+
+        if(pDescRec->hRecNumber <= 0 || pDescRec->hRecNumber > pResult->iNumberOfCols || pDescRec->pValue == NULL)
+            continue;
+
+        pIRDRec = &pStmt->pIRD->pDescRecHead[pDescRec->hRecNumber - 1];
+
+        if(pIRDRec->szTableName[0] == '\0'
+            || (pTableRec && (strcmp(pTableRec->szTableName, pIRDRec->szTableName) != 0
+                                || strcmp(pTableRec->szSchemaName, pIRDRec->szSchemaName) != 0)))
+        {
+            addError(&pStmt->pErrorList,"HYC00", "Optional feature not implemented-SQLBulkOperations:SQL_ADD of columns of more than one table", 0, NULL);
+            return SQL_ERROR;
+        }
+
+        // Column of the table, not the label of it in the query. An expression has none.
+        pszColName = PQfcol_name(pResult->pgResult, pDescRec->hRecNumber - 1);
+        if(pszColName == NULL || *pszColName == '\0')
+        {
+            addError(&pStmt->pErrorList,"HY000", "SQLBulkOperations:SQL_ADD of a bound column that isn't a table column", 0, NULL);
+            return SQL_ERROR;
+        }
+
+        if(lRows > 1 && pARDDescHeader.lBindType == SQL_BIND_BY_COLUMN && pDescRec->iOctetLen <= 0)
+        {
+            addError(&pStmt->pErrorList,"HY000", "Array element length is zero.", 0, NULL);
+            return SQL_ERROR;
+        }
+
+        pTableRec = pIRDRec;
+        cols.push_back(pDescRec);
+    }
+
+    if(cols.empty())
+    {
+        addError(&pStmt->pErrorList,"HY000", "SQLBulkOperations:SQL_ADD needs bound columns", 0, NULL);
+        return SQL_ERROR;
+    }
+
+    std::sort(cols.begin(), cols.end(),
+                [](const RS_DESC_REC *pLeft, const RS_DESC_REC *pRight) { return pLeft->hRecNumber < pRight->hRecNumber; });
+
+    // Length/indicator of a data-at-execution value isn't the length of the data in the buffer
+    for(long lRow = 0; lRow < lRows; lRow++)
+    {
+        if(pARDDescHeader.phArrayStatusPtr && pARDDescHeader.phArrayStatusPtr[lRow] == SQL_ROW_IGNORE)
+            continue;
+
+        for(RS_DESC_REC *pDescRec : cols)
+        {
+            SQLLEN *pcbLenInd;
+
+            getBoundColumnData(pARDDescHeader, pDescRec, lRow, &pcbLenInd);
+
+            if(pcbLenInd && (*pcbLenInd == SQL_DATA_AT_EXEC || *pcbLenInd <= SQL_LEN_DATA_AT_EXEC_OFFSET))
+            {
+                addError(&pStmt->pErrorList,"HYC00", "Optional feature not implemented-SQLBulkOperations:SQL_ADD of data-at-execution columns", 0, NULL);
+                return SQL_ERROR;
+            }
+        }
+    }
+
+    // INSERT INTO "schema"."table" ("col", ...) VALUES
+    insertCmd = "INSERT INTO ";
+    if(pTableRec->szSchemaName[0] != '\0')
+    {
+        appendQuotedIdentifier(insertCmd, pTableRec->szSchemaName);
+        insertCmd += '.';
+    }
+    appendQuotedIdentifier(insertCmd, pTableRec->szTableName);
+    insertCmd += " (";
+    for(size_t iCol = 0; iCol < cols.size(); iCol++)
+    {
+        if(iCol != 0)
+            insertCmd += ", ";
+        appendQuotedIdentifier(insertCmd, PQfcol_name(pResult->pgResult, cols[iCol]->hRecNumber - 1));
+    }
+    insertCmd += ") VALUES ";
+
+    // Each value is "$n," in the text
+    iMaxRows = getTotalMultiTuples((int)cols.size(), (int)cols.size() * 8 + 2, lRows, llMaxBytes);
+    strBufs.resize(cols.size() * iMaxRows);
+    paramVals.reserve(cols.size() * iMaxRows);
+    sql = insertCmd;
+
+    for(long lRow = 0; lRow < lRows; lRow++)
+    {
+        size_t iFirstParam = paramVals.size();
+        std::string values = "(";
+        long long llRowBytes = 0;
+        int iRowError = FALSE;
+
+        if(pARDDescHeader.phArrayStatusPtr && pARDDescHeader.phArrayStatusPtr[lRow] == SQL_ROW_IGNORE)
+            continue;
+
+        for(size_t iCol = 0; iCol < cols.size() && !iRowError; iCol++)
+        {
+            RS_DESC_REC *pDescRec = cols[iCol];
+            RS_DESC_REC *pIRDRec = &pStmt->pIRD->pDescRecHead[pDescRec->hRecNumber - 1];
+            SQLLEN *pcbLenInd;
+            char *pData = getBoundColumnData(pARDDescHeader, pDescRec, lRow, &pcbLenInd);
+
+            if(iCol != 0)
+                values += ',';
+
+            if(pcbLenInd && *pcbLenInd == SQL_COLUMN_IGNORE)
+                values += "DEFAULT";
+            else
+            {
+                int iConversionError = FALSE;
+                char *pVal = convertCParamDataToSQLData(pStmt, pData, pDescRec->cbLen, pcbLenInd,
+                                                        pDescRec->hType, pIRDRec->hType, pIRDRec->hType,
+                                                        &strBufs[paramVals.size()], &iConversionError);
+
+                if(iConversionError)
+                {
+                    releaseBulkValues(strBufs, paramVals.size(), paramVals.size() + 1);
+                    iRowError = TRUE;
+                }
+                else
+                {
+                    paramVals.push_back(pVal);
+                    values += '$';
+                    values += std::to_string(paramVals.size());
+                    llRowBytes += (pVal) ? strlen(pVal) : 0;
+                }
+            }
+        } // Column loop
+
+        if(iRowError)
+        {
+            releaseBulkValues(strBufs, iFirstParam, paramVals.size());
+            paramVals.resize(iFirstParam);
+            lRowsFailed++;
+
+            if(pIRDDescHeader.phArrayStatusPtr)
+                pIRDDescHeader.phArrayStatusPtr[lRow] = SQL_ROW_ERROR;
+
+            continue;
+        }
+
+        values += ')';
+        if(!batchRows.empty())
+            sql += ',';
+        sql += values;
+        llBatchBytes += llRowBytes + values.size();
+        batchRows.push_back(lRow);
+
+        // Execute the batch when it's full
+        if((int)batchRows.size() == iMaxRows || (llMaxBytes > 0 && llBatchBytes >= llMaxBytes))
+        {
+            if(executeBulkBatch(pStmt, sql, paramVals, strBufs, batchRows, &lRowsAdded, &lRowsFailed) == SQL_ERROR
+                && iInTransaction)
+            {
+                return failBulkAddTransaction(pStmt, lRows);
+            }
+
+            llBatchBytes = 0;
+            sql = insertCmd;
+        }
+    } // Row loop
+
+    // Last batch
+    if(!batchRows.empty())
+    {
+        if(executeBulkBatch(pStmt, sql, paramVals, strBufs, batchRows, &lRowsAdded, &lRowsFailed) == SQL_ERROR
+            && iInTransaction)
+        {
+            return failBulkAddTransaction(pStmt, lRows);
+        }
+    }
+
+    if(lRowsFailed == 0)
+        return SQL_SUCCESS;
+
+    return (lRowsAdded > 0) ? SQL_SUCCESS_WITH_INFO : SQL_ERROR;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // SQLBulkOperations performs bulk insertions and bulk bookmark operations, including update, delete, 
 // and fetch by bookmark.
@@ -627,6 +1008,11 @@ SQLRETURN   SQL_API SQLBulkOperations(SQLHSTMT   phstmt, SQLSMALLINT hOperation)
     switch(hOperation)
     {
         case SQL_ADD:
+        {
+            rc = bulkAddRows(pStmt);
+            break;
+        }
+
         case SQL_UPDATE_BY_BOOKMARK:
         case SQL_DELETE_BY_BOOKMARK:
         case SQL_FETCH_BY_BOOKMARK:
@@ -0,0 +1,388 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rshex.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define RS_HEX_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define RS_HEX_TARGET_AVX2
+#else
+#define RS_HEX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+typedef struct _RS_HEX_TABLES
+{
+    char encode[256][2];        // Upper case hex pair for each byte value
+    unsigned char decode[256];  // Nibble value for each character, 0 if not a hex digit
+} RS_HEX_TABLES;
+
+typedef struct _RS_HEX_KERNELS
+{
+    const char *pszName;
+    void (*pfnEncode)(const unsigned char *pSrc, size_t iSrcLen, char *pDest);
+    void (*pfnEncodeW)(const unsigned char *pSrc, size_t iSrcLen, void *pDest, size_t iCharSize);
+    void (*pfnDecode)(const char *pSrc, size_t iDestLen, unsigned char *pDest);
+} RS_HEX_KERNELS;
+
+/*====================================================================================================================================================*/
+
+static RS_HEX_TABLES buildHexTables()
+{
+    static const char szHexDigits[] = "0123456789ABCDEF";
+    RS_HEX_TABLES tables;
+    int i;
+
+    memset(&tables, 0, sizeof(tables));
+
+    for (i = 0; i < 256; i++)
+    {
+        tables.encode[i][0] = szHexDigits[i >> 4];
+        tables.encode[i][1] = szHexDigits[i & 0xF];
+    }
+
+    for (i = 0; i < 10; i++)
+        tables.decode['0' + i] = (unsigned char)i;
+
+    for (i = 0; i < 6; i++)
+    {
+        tables.decode['A' + i] = (unsigned char)(10 + i);
+        tables.decode['a' + i] = (unsigned char)(10 + i);
+    }
+
+    return tables;
+}
+
+static const RS_HEX_TABLES *getHexTables()
+{
+    static const RS_HEX_TABLES tables = buildHexTables();
+
+    return &tables;
+}
+
+/*====================================================================================================================================================*/
+
+static void hexEncodeScalar(const unsigned char *pSrc, size_t iSrcLen, char *pDest)
+{
+    const RS_HEX_TABLES *pTables = getHexTables();
+    size_t i;
+
+    for (i = 0; i < iSrcLen; i++)
+        memcpy(pDest + 2 * i, pTables->encode[pSrc[i]], 2);
+}
+
+static void hexEncodeWScalar(const unsigned char *pSrc, size_t iSrcLen, void *pDest, size_t iCharSize)
+{
+    const RS_HEX_TABLES *pTables = getHexTables();
+    size_t i;
+
+    if (iCharSize == 2)
+    {
+        uint16_t *pOut = (uint16_t *)pDest;
+
+        for (i = 0; i < iSrcLen; i++)
+        {
+            *pOut++ = (uint16_t)pTables->encode[pSrc[i]][0];
+            *pOut++ = (uint16_t)pTables->encode[pSrc[i]][1];
+        }
+    }
+    else
+    {
+        uint32_t *pOut = (uint32_t *)pDest;
+
+        for (i = 0; i < iSrcLen; i++)
+        {
+            *pOut++ = (uint32_t)pTables->encode[pSrc[i]][0];
+            *pOut++ = (uint32_t)pTables->encode[pSrc[i]][1];
+        }
+    }
+}
+
+static void hexDecodeScalar(const char *pSrc, size_t iDestLen, unsigned char *pDest)
+{
+    const RS_HEX_TABLES *pTables = getHexTables();
+    const unsigned char *pIn = (const unsigned char *)pSrc;
+    size_t i;
+
+    for (i = 0; i < iDestLen; i++)
+        pDest[i] = (unsigned char)((pTables->decode[pIn[2 * i]] << 4) | pTables->decode[pIn[2 * i + 1]]);
+}
+
+/*====================================================================================================================================================*/
+
+#ifdef RS_HEX_X86
+
+// nibble + '0', plus 7 more for 10..15 to land on 'A'..'F'
+static inline __m128i hexDigitsSse2(__m128i nibbles)
+{
+    __m128i ascii = _mm_add_epi8(nibbles, _mm_set1_epi8('0'));
+    __m128i isLetter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+
+    return _mm_add_epi8(ascii, _mm_and_si128(isLetter, _mm_set1_epi8(7)));
+}
+
+// Character to nibble value, 0 for anything that isn't a hex digit.
+static inline __m128i hexNibblesSse2(__m128i chars)
+{
+    __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), chars));
+    __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                     _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+    __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10));
+
+    return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, letter));
+}
+
+// Pairs of nibbles in 16 bit lanes (high nibble first in memory) to bytes in 16 bit lanes
+static inline __m128i hexCombineSse2(__m128i nibbles)
+{
+    __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+
+    return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+}
+
+static void hexEncodeSse2(const unsigned char *pSrc, size_t iSrcLen, char *pDest)
+{
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; i + 16 <= iSrcLen; i += 16)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i *)(pSrc + i));
+        __m128i high = hexDigitsSse2(_mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        __m128i low = hexDigitsSse2(_mm_and_si128(in, mask));
+
+        _mm_storeu_si128((__m128i *)(pDest + 2 * i), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i *)(pDest + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+    }
+
+    hexEncodeScalar(pSrc + i, iSrcLen - i, pDest + 2 * i);
+}
+
+static void hexEncodeWSse2(const unsigned char *pSrc, size_t iSrcLen, void *pDest, size_t iCharSize)
+{
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    unsigned char *pOut = (unsigned char *)pDest;
+    size_t i = 0;
+
+    for (; i + 16 <= iSrcLen; i += 16)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i *)(pSrc + i));
+        __m128i high = hexDigitsSse2(_mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        __m128i low = hexDigitsSse2(_mm_and_si128(in, mask));
+        __m128i ascii[2];
+        int j;
+
+        ascii[0] = _mm_unpacklo_epi8(high, low);
+        ascii[1] = _mm_unpackhi_epi8(high, low);
+
+        for (j = 0; j < 2; j++)
+        {
+            __m128i wide[2];
+            int k;
+
+            wide[0] = _mm_unpacklo_epi8(ascii[j], zero);
+            wide[1] = _mm_unpackhi_epi8(ascii[j], zero);
+
+            for (k = 0; k < 2; k++)
+            {
+                if (iCharSize == 2)
+                {
+                    _mm_storeu_si128((__m128i *)pOut, wide[k]);
+                    pOut += 16;
+                }
+                else
+                {
+                    _mm_storeu_si128((__m128i *)pOut, _mm_unpacklo_epi16(wide[k], zero));
+                    _mm_storeu_si128((__m128i *)(pOut + 16), _mm_unpackhi_epi16(wide[k], zero));
+                    pOut += 32;
+                }
+            }
+        }
+    }
+
+    hexEncodeWScalar(pSrc + i, iSrcLen - i, pOut, iCharSize);
+}
+
+static void hexDecodeSse2(const char *pSrc, size_t iDestLen, unsigned char *pDest)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= iDestLen; i += 16)
+    {
+        __m128i first = hexNibblesSse2(_mm_loadu_si128((const __m128i *)(pSrc + 2 * i)));
+        __m128i second = hexNibblesSse2(_mm_loadu_si128((const __m128i *)(pSrc + 2 * i + 16)));
+
+        _mm_storeu_si128((__m128i *)(pDest + i), _mm_packus_epi16(hexCombineSse2(first), hexCombineSse2(second)));
+    }
+
+    hexDecodeScalar(pSrc + 2 * i, iDestLen - i, pDest + i);
+}
+
+/*====================================================================================================================================================*/
+
+RS_HEX_TARGET_AVX2 static inline __m256i hexDigitsAvx2(__m256i nibbles)
+{
+    __m256i ascii = _mm256_add_epi8(nibbles, _mm256_set1_epi8('0'));
+    __m256i isLetter = _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9));
+
+    return _mm256_add_epi8(ascii, _mm256_and_si256(isLetter, _mm256_set1_epi8(7)));
+}
+
+RS_HEX_TARGET_AVX2 static inline __m256i hexNibblesAvx2(__m256i chars)
+{
+    __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+    __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+    __m256i isLetter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10));
+
+    return _mm256_or_si256(_mm256_and_si256(isDigit, digit), _mm256_and_si256(isLetter, letter));
+}
+
+RS_HEX_TARGET_AVX2 static inline __m256i hexCombineAvx2(__m256i nibbles)
+{
+    __m256i high = _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)), 4);
+
+    return _mm256_or_si256(high, _mm256_srli_epi16(nibbles, 8));
+}
+
+RS_HEX_TARGET_AVX2 static void hexEncodeAvx2(const unsigned char *pSrc, size_t iSrcLen, char *pDest)
+{
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; i + 32 <= iSrcLen; i += 32)
+    {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(pSrc + i));
+        __m256i high = hexDigitsAvx2(_mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+        __m256i low = hexDigitsAvx2(_mm256_and_si256(in, mask));
+        // Unpack works per 128 bit lane: lo = bytes 0-7 | 16-23, hi = bytes 8-15 | 24-31
+        __m256i lo = _mm256_unpacklo_epi8(high, low);
+        __m256i hi = _mm256_unpackhi_epi8(high, low);
+
+        _mm256_storeu_si256((__m256i *)(pDest + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(pDest + 2 * i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    hexEncodeSse2(pSrc + i, iSrcLen - i, pDest + 2 * i);
+}
+
+RS_HEX_TARGET_AVX2 static void hexDecodeAvx2(const char *pSrc, size_t iDestLen, unsigned char *pDest)
+{
+    size_t i = 0;
+
+    for (; i + 32 <= iDestLen; i += 32)
+    {
+        __m256i first = hexNibblesAvx2(_mm256_loadu_si256((const __m256i *)(pSrc + 2 * i)));
+        __m256i second = hexNibblesAvx2(_mm256_loadu_si256((const __m256i *)(pSrc + 2 * i + 32)));
+        // Pack works per 128 bit lane, so restore quadword order afterwards
+        __m256i packed = _mm256_packus_epi16(hexCombineAvx2(first), hexCombineAvx2(second));
+
+        _mm256_storeu_si256((__m256i *)(pDest + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    hexDecodeSse2(pSrc + 2 * i, iDestLen - i, pDest + i);
+}
+
+/*====================================================================================================================================================*/
+
+static int cpuSupportsAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return 0;
+
+    // AVX and OSXSAVE, and the OS saves YMM state
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+        return 0;
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return 0;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // RS_HEX_X86
+
+/*====================================================================================================================================================*/
+
+static RS_HEX_KERNELS selectHexKernels()
+{
+    RS_HEX_KERNELS kernels = { "scalar", hexEncodeScalar, hexEncodeWScalar, hexDecodeScalar };
+
+#ifdef RS_HEX_X86
+    // SSE2 is part of x86-64
+    kernels.pszName = "sse2";
+    kernels.pfnEncode = hexEncodeSse2;
+    kernels.pfnEncodeW = hexEncodeWSse2;
+    kernels.pfnDecode = hexDecodeSse2;
+
+    if (cpuSupportsAvx2())
+    {
+        kernels.pszName = "avx2";
+        kernels.pfnEncode = hexEncodeAvx2;
+        kernels.pfnDecode = hexDecodeAvx2;
+    }
+#endif
+
+    return kernels;
+}
+
+static const RS_HEX_KERNELS *getHexKernels()
+{
+    static const RS_HEX_KERNELS kernels = selectHexKernels();
+
+    return &kernels;
+}
+
+/*====================================================================================================================================================*/
+
+void rsHexEncode(const unsigned char *pSrc, size_t iSrcLen, char *pDest)
+{
+    getHexKernels()->pfnEncode(pSrc, iSrcLen, pDest);
+}
+
+/*====================================================================================================================================================*/
+
+void rsHexEncodeW(const unsigned char *pSrc, size_t iSrcLen, void *pDest, size_t iCharSize)
+{
+    getHexKernels()->pfnEncodeW(pSrc, iSrcLen, pDest, iCharSize);
+}
+
+/*====================================================================================================================================================*/
+
+void rsHexDecode(const char *pSrc, size_t iDestLen, unsigned char *pDest)
+{
+    getHexKernels()->pfnDecode(pSrc, iDestLen, pDest);
+}
+
+/*====================================================================================================================================================*/
+
+const char *rsHexKernelName()
+{
+    return getHexKernels()->pszName;
+}
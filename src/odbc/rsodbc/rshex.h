@@ -0,0 +1,27 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <stddef.h>
+
+// Hex encode/decode kernels used for VARBYTE, GEOMETRY and GEOGRAPHY data.
+// Scalar code is table driven. On x86-64 SSE2 and AVX2 variants are selected
+// once at runtime based on CPU support.
+
+// Encode iSrcLen bytes to 2 * iSrcLen upper case hex characters. No NUL is written.
+void rsHexEncode(const unsigned char *pSrc, size_t iSrcLen, char *pDest);
+
+// Same as rsHexEncode, but each output character is iCharSize (2 or 4) bytes wide.
+void rsHexEncodeW(const unsigned char *pSrc, size_t iSrcLen, void *pDest, size_t iCharSize);
+
+// Decode 2 * iDestLen hex characters into iDestLen bytes.
+// Invalid hex characters decode as 0.
+void rsHexDecode(const char *pSrc, size_t iDestLen, unsigned char *pDest);
+
+// Name of the selected kernel ("avx2", "sse2" or "scalar"). Used for tracing and tests.
+const char *rsHexKernelName();
@@ -14,6 +14,13 @@
 #include "rslock.h"
 #include "rsdrvinfo.h"
 #include "rsMetadataAPIPostProcessor.h"
+#include "rsresultcache.h"
+#include "rspreparecache.h"
+#include "rssqlrewritecache.h"
+#include "rsparamarena.h"
+#include "rscancel.h"
+#include <atomic>
+#include <memory>
 #include <regex>
 
 #ifdef LINUX
@@ -29,10 +36,16 @@ extern "C" {
 
 static void getResultDescription(PGresult *pgResult, RS_RESULT_INFO *pResult, int iFetchRefCursor);
 static RS_RESULT_INFO *createResultObject(RS_STMT_INFO *pStmt, PGresult *pgResult);
+static const char *getPreparedName(RS_STMT_INFO *pStmt);
+static const char *prepareMultiInsertBatch(RS_STMT_INFO *pStmt, RS_MULTI_INSERT_BATCH *pBatch);
+static int prepareFromCache(RS_STMT_INFO *pStmt, const std::string &key, SQLRETURN *pRc);
+static void addPrepareToCache(RS_STMT_INFO *pStmt, const std::string &key, const std::string &name, SQLRETURN rc);
+static void waitForPendingCancel(RS_CONN_INFO *pConn);
 
 int getCscThreadCreatedFlag(void *_pCscStatementContext);
 void setCscThreadCreatedFlag(void *_pCscStatementContext, int flag);
 int pgCloseCsc(PGresult * pgResult);
+int pgHasCsc(PGresult * pgResult);
 
 SQLRETURN setResultInStmt(SQLRETURN rc, RS_STMT_INFO *pStmt, PGresult *pgResult, int readStatusFlag, ExecStatusType pqRc, 
                           int *piStop,int iArrayBinding);
@@ -42,6 +55,7 @@ void initCscLib(FILE    *fpTrace);
 void uninitCscLib();
 int getUnknownTypeSize(Oid pgType);
 void setStreamingCursorRows(void *_pCscStatementContext, int iStreamingCursorRows);
+void setStreamingCursorBatchSize(void *_pCscStatementContext, long long llBatchBytes, int iRowsetSize);
 
 void setEndOfStreamingCursorQuery(void *_pCscStatementContext, int flag);
 int isEndOfStreamingCursor(void *_pCscStatementContext);
@@ -79,10 +93,15 @@ SQLRETURN libpqConnect(RS_CONN_INFO *pConn)
     char szCscEnable[MAX_NUMBER_BUF_LEN];
     char szCscMaxFileSize[MAX_NUMBER_BUF_LEN];
     char szCscThreshold[MAX_NUMBER_BUF_LEN];
+    char szCscSyncWrites[MAX_NUMBER_BUF_LEN];
+    char szCscFileFormat[MAX_NUMBER_BUF_LEN];
+    char szCscCacheSize[MAX_NUMBER_BUF_LEN];
     char szSslMode[MAX_IDEN_LEN];
     char szSslRootCert[MAX_PATH + 1];
     char szlibpqConnectionTraceFile[MAX_PATH + 1];
     char szStreamingCursorRows[MAX_NUMBER_BUF_LEN];
+    char szResultMemoryLimit[MAX_NUMBER_BUF_LEN];
+    char szLazyRowDecode[MAX_NUMBER_BUF_LEN];
     char szSslDefaultCertPath [MAX_PATH + 1];
 	char szClientProtocolVersion[MAX_NUMBER_BUF_LEN];
 	char szOsVersion[MAX_TEMP_BUF_LEN];
@@ -125,6 +144,21 @@ SQLRETURN libpqConnect(RS_CONN_INFO *pConn)
             snprintf(szCscThreshold,sizeof(szCscThreshold),"%lld",pConnectProps->llCscThreshold);
             ppKeywords[iCount] = "CscThreshold";
             ppValues[iCount++] = szCscThreshold;
+
+            // CscSyncWrites
+            snprintf(szCscSyncWrites,sizeof(szCscSyncWrites),"%d",pConnectProps->iCscSyncWrites);
+            ppKeywords[iCount] = "CscSyncWrites";
+            ppValues[iCount++] = szCscSyncWrites;
+
+            // CscFileFormat
+            snprintf(szCscFileFormat,sizeof(szCscFileFormat),"%d",pConnectProps->iCscFileFormat);
+            ppKeywords[iCount] = "CscFileFormat";
+            ppValues[iCount++] = szCscFileFormat;
+
+            // CscCacheSize
+            snprintf(szCscCacheSize,sizeof(szCscCacheSize),"%lld",pConnectProps->llCscCacheSize);
+            ppKeywords[iCount] = "CscCacheSize";
+            ppValues[iCount++] = szCscCacheSize;
         }
 
         if(pConnAttr)
@@ -230,6 +264,22 @@ SQLRETURN libpqConnect(RS_CONN_INFO *pConn)
             ppValues[iCount++] = szStreamingCursorRows;
 		}
 
+        if(pConnectProps->llResultMemoryLimit != 0)
+        {
+            // ResultMemoryLimit
+            snprintf(szResultMemoryLimit,sizeof(szResultMemoryLimit), "%lld",pConnectProps->llResultMemoryLimit);
+            ppKeywords[iCount] = "ResultMemoryLimit";
+            ppValues[iCount++] = szResultMemoryLimit;
+        }
+
+        if(pConnectProps->iLazyRowDecode)
+        {
+            // LazyRowDecode
+            snprintf(szLazyRowDecode,sizeof(szLazyRowDecode), "%d",pConnectProps->iLazyRowDecode);
+            ppKeywords[iCount] = "LazyRowDecode";
+            ppValues[iCount++] = szLazyRowDecode;
+        }
+
 		// client_protocol_version
 		if(pConnectProps->iClientProtocolVersion != -1)
 			snprintf(szClientProtocolVersion, sizeof(szClientProtocolVersion), "%d", pConnectProps->iClientProtocolVersion);
@@ -521,6 +571,13 @@ SQLRETURN libpqConnect(RS_CONN_INFO *pConn)
 
             if(!fail)
                 pConn->iStatus = RS_OPEN_CONNECTION;
+
+            // Statements prepared on the new connection
+            if(!fail && pConnectProps->iPreparedStatementCacheSize > 0 && pConn->pPrepareCache == NULL)
+                pConn->pPrepareCache = new RS_PREPARE_CACHE(pConnectProps->iPreparedStatementCacheSize);
+
+            if(!fail && pConnectProps->iSqlRewriteCacheSize > 0 && pConn->pSqlRewriteCache == NULL)
+                pConn->pSqlRewriteCache = new RS_SQL_REWRITE_CACHE(pConnectProps->iSqlRewriteCacheSize, RS_SQL_REWRITE_CACHE_MAX_BYTES);
         }
     }
     else
@@ -541,11 +598,48 @@ void libpqDisconnect(RS_CONN_INFO *pConn)
 {
     if(pConn->pgConn != NULL)
     {
+        // Cancel being sent uses the connection
+        waitForPendingCancel(pConn);
+
         // Wait for any csc thread executing, otherwise it may leads to IOException and some log on server side.
         pgWaitForCscThreadToFinish(pConn->pgConn, TRUE);
 
         pqCloseConnection(pConn->pgConn);
     }
+
+    pConn->resultCacheSession.clear();
+    pConn->iResultCacheSessionObjects = FALSE;
+
+    // Prepared statements are gone with the connection
+    for(RS_STMT_INFO *pStmt = pConn->phstmtHead; pStmt != NULL; pStmt = pStmt->pNext)
+    {
+        pStmt->szPreparedName[0] = '\0';
+        pStmt->iPreparedFromCache = FALSE;
+    }
+
+    if(pConn->pPrepareCache)
+    {
+        long long llHits, llMisses, llEvictions, llEntries;
+
+        pConn->pPrepareCache->getStats(&llHits, &llMisses, &llEvictions, &llEntries);
+        RS_LOG_DEBUG("RSLIBPQ", "Prepared statement cache hits=%lld misses=%lld evictions=%lld entries=%lld",
+                     llHits, llMisses, llEvictions, llEntries);
+
+        delete pConn->pPrepareCache;
+        pConn->pPrepareCache = NULL;
+    }
+
+    if(pConn->pSqlRewriteCache)
+    {
+        long long llHits, llMisses, llEvictions, llBytes;
+
+        pConn->pSqlRewriteCache->getStats(&llHits, &llMisses, &llEvictions, &llBytes);
+        RS_LOG_DEBUG("RSLIBPQ", "SQL rewrite cache hits=%lld misses=%lld evictions=%lld bytes=%lld",
+                     llHits, llMisses, llEvictions, llBytes);
+
+        delete pConn->pSqlRewriteCache;
+        pConn->pSqlRewriteCache = NULL;
+    }
 }
 
 /*====================================================================================================================================================*/
@@ -574,6 +668,16 @@ char *libpqParameterStatus(RS_CONN_INFO *pConn, const char *paramName)
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Get session TimeZone from the connection snapshot. Cheap enough for per-row use.
+//
+char *libpqSessionTimeZone(RS_CONN_INFO *pConn)
+{
+    return (pConn) ? (char *) PQsessionTimeZone(pConn->pgConn) : NULL;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Get SQLState using libpq.
 //
@@ -623,6 +727,9 @@ SQLRETURN libpqExecuteTransactionCommand(RS_CONN_INFO *pConn, char *cmd, int iLo
 
         // Wait for current csc thread to finish, if any.
         pgWaitForCscThreadToFinish(pConn->pgConn, FALSE);
+
+        // Wait for the pending cancel of the connection, if any.
+        waitForPendingCancel(pConn);
     }
 
 	// We have to release any result of streaming cursor before executing internal command
@@ -643,6 +750,10 @@ SQLRETURN libpqExecuteTransactionCommand(RS_CONN_INFO *pConn, char *cmd, int iLo
     PQclear(pgResult);
     pgResult = NULL;
 
+    // Other connections may have cached results read before the changes of the transaction.
+    if(!fail && pConn->pConnectProps->llResultCacheSize > 0 && _stricmp(cmd, COMMIT_CMD) == 0)
+        invalidateResultCache(getServerForResultCache(pConn), "");
+
     if(iLockRequired)
     {
         // Unlock connection sem
@@ -654,10 +765,109 @@ SQLRETURN libpqExecuteTransactionCommand(RS_CONN_INFO *pConn, char *cmd, int iLo
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Execute the INSERT of SQLBulkOperations(SQL_ADD) on the connection. The result set of the statement stays as it is.
+//
+SQLRETURN libpqExecuteBulkInsert(RS_STMT_INFO *pStmt, char *pszCmd, int nParams, const char *const *ppParamVals)
+{
+    RS_CONN_INFO *pConn = pStmt->phdbc;
+    int fail = FALSE;
+    PGresult *pgResult;
+
+    // Lock connection sem to protect multiple stmt execution at same time.
+    rsLockSem(pConn->hSemMultiStmt);
+
+    // Wait for current csc thread to finish, if any.
+    pgWaitForCscThreadToFinish(pConn->pgConn, FALSE);
+
+    // Wait for the pending cancel of the connection, if any.
+    waitForPendingCancel(pConn);
+
+	// We have to release any result of streaming cursor of other statements before executing the command.
+	// The caller doesn't come with rows of its own streaming cursor pending, so its result set stays.
+	skipAllResultsOfStreamingRowsUsingConnection(pConn);
+
+    // Look for whether to execute BEGIN or not
+    if(pConn->pConnAttr->iAutoCommit == SQL_AUTOCOMMIT_OFF && libpqIsTransactionIdle(pConn))
+    {
+        if(libpqExecuteTransactionCommand(pConn, BEGIN_CMD, FALSE) == SQL_ERROR)
+        {
+            rsUnlockSem(pConn->hSemMultiStmt);
+            return SQL_ERROR;
+        }
+    }
+
+    pgResult = PQexecParams(pConn->pgConn, pszCmd, nParams, NULL, ppParamVals, NULL, NULL, RS_TEXT_FORMAT);
+
+    if(PQresultStatus(pgResult) != PGRES_COMMAND_OK)
+    {
+        char *pError = libpqErrorMsg(pConn);
+
+        fail = TRUE;
+
+        if(pError && *pError != '\0')
+            addError(&pStmt->pErrorList,"HY000", pError, 0, pConn);
+    }
+
+    PQclear(pgResult);
+    pgResult = NULL;
+
+    // Cached results may be of the table
+    if(!fail && pConn->pConnectProps->llResultCacheSize > 0)
+        invalidateResultCache(getServerForResultCache(pConn), "");
+
+    // Unlock connection sem
+    rsUnlockSem(pConn->hSemMultiStmt);
+
+    return (fail) ? SQL_ERROR : SQL_SUCCESS;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Sender of the cancels of the driver, made on first cancel. It isn't released, like the async worker pool.
+//
+static std::once_flag cancelSenderCreated;
+static std::atomic<RS_CANCEL_SENDER *> pCancelSender(NULL);
+
+static RS_CANCEL_SENDER *getCancelSender()
+{
+    std::call_once(cancelSenderCreated, []() {
+        char optionVal[MAX_OPTION_VAL_LEN];
+        int iTimeoutSeconds = RS_CANCEL_TIMEOUT_DEFAULT;
+
+        optionVal[0] = '\0';
+        if(readDriverOptionFromIniFile("CancelTimeout", optionVal, sizeof(optionVal)) && optionVal[0] != '\0')
+            sscanf(optionVal, "%d", &iTimeoutSeconds);
+
+        pCancelSender = new RS_CANCEL_SENDER(RS_CANCEL_WORKER_THREADS, iTimeoutSeconds);
+    });
+
+    return pCancelSender;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Wait for the cancel of the connection sent by a worker, so it doesn't cancel the next command.
+// Nothing is pending before the first cancel.
+//
+static void waitForPendingCancel(RS_CONN_INFO *pConn)
+{
+    RS_CANCEL_SENDER *pSender = pCancelSender;
+
+    if(pSender && pConn->pgConn)
+        pSender->wait(pConn->pgConn);
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Cancel the query.
 //
 // You don't have to lock on cancel request, but need to drain the pending result after sending cancel.
+// The cancel is sent by a worker of the cancel sender, so it doesn't wait for the new connection to the
+// server. A failure of it is logged. If it can't be queued, it is sent here.
 SQLRETURN libpqCancelQuery(RS_STMT_INFO *pStmt)
 {
     SQLRETURN rc = SQL_SUCCESS;
@@ -666,21 +876,29 @@ SQLRETURN libpqCancelQuery(RS_STMT_INFO *pStmt)
 
     if(pgCancelObj)
     {
-        char errBuf[MAX_ERR_MSG_LEN + 1];
-        int valid; 
-            
-        errBuf[0] = '\0';
-        errBuf[MAX_ERR_MSG_LEN] = '\0';
-        valid = PQcancel(pgCancelObj, errBuf, MAX_ERR_MSG_LEN);
-        if(!valid && errBuf[0] != '\0')
-        {
-            rc = SQL_ERROR;
-            addError(&pStmt->pErrorList,"HY000", errBuf, 0, NULL);
-        }
+        RS_CANCEL_SENDER *pSender = getCancelSender();
+        std::shared_ptr<PGcancel> pgCancel(pgCancelObj, PQfreeCancel);
+        std::function<int(char *, int, int)> sendCancel = [pgCancel](char *errBuf, int errBufLen, int iTimeoutSeconds) {
+            return PQcancelTimeout(pgCancel.get(), errBuf, errBufLen, iTimeoutSeconds);
+        };
 
-        PQfreeCancel(pgCancelObj);
         pgCancelObj = NULL;
 
+        if(pSender == NULL || !pSender->send(pConn->pgConn, PQbackendPID(pConn->pgConn), sendCancel))
+        {
+            char errBuf[MAX_ERR_MSG_LEN + 1];
+            int valid; 
+
+            errBuf[0] = '\0';
+            errBuf[MAX_ERR_MSG_LEN] = '\0';
+            valid = sendCancel(errBuf, MAX_ERR_MSG_LEN, RS_CANCEL_TIMEOUT_DEFAULT);
+            if(!valid && errBuf[0] != '\0')
+            {
+                rc = SQL_ERROR;
+                addError(&pStmt->pErrorList,"HY000", errBuf, 0, NULL);
+            }
+        }
+
         if(rc == SQL_SUCCESS)
         {
             // Skip all results
@@ -739,9 +957,8 @@ SQLRETURN libpqExecuteDirectOrPrepared(RS_STMT_INFO *pStmt, char *pszCmd, int ex
             pExecThread->rc = SQL_STILL_EXECUTING;
             pExecThread->iPrepare = 0;
 
-            // create thread
-            pExecThread->hThread = rsCreateThread((void *)libpqExecuteDirectOrPreparedThreadProc, pStmt);
-            if(pExecThread->hThread == (THREAD_HANDLE)(long) NULL)
+            // Queue on the async worker pool
+            if(!queueExecThread(pStmt, [pStmt]() { libpqExecuteDirectOrPreparedThreadProc(pStmt); }))
             {
                 // Release thread info
                 waitAndFreeExecThread(pStmt, FALSE);
@@ -768,7 +985,7 @@ error:
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Execute direct or prepare on a separate thread using this thread procedure.
+// Execute direct or prepare on a worker of the async pool using this procedure.
 //
 #ifdef WIN32
 void
@@ -784,7 +1001,7 @@ libpqExecuteDirectOrPreparedThreadProc(void *pArg)
 
     rc = libpqExecuteDirectOrPreparedOnThread(pStmt, pExecThread->pszCmd, pExecThread->executePrepared, TRUE, TRUE);
 
-    setThreadExecutionStatus(pExecThread, rc);
+    setThreadExecutionStatus(pStmt, rc);
 
 #ifdef WIN32
     return;
@@ -796,6 +1013,55 @@ libpqExecuteDirectOrPreparedThreadProc(void *pArg)
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Allocate the bind parameter arrays from the parameter arena of the statement. Converted values of the
+// parameters go in the arena too.
+//
+static int allocBindParamArrays(RS_STMT_INFO *pStmt, int iCount, char ***pppBindParamVals, int **ppiParamFormats,
+                                RS_BIND_PARAM_STR_BUF **ppBindParamStrBuf)
+{
+    if(pStmt->pParamArena == NULL)
+    {
+        pStmt->pParamArena = new RS_PARAM_ARENA();
+        if(pStmt->pParamArena == NULL)
+            return FALSE;
+    }
+
+    *pppBindParamVals = (char **)pStmt->pParamArena->calloc(iCount, sizeof(char *));
+    *ppiParamFormats  = (int *)pStmt->pParamArena->calloc(iCount, sizeof(int));
+    *ppBindParamStrBuf = (RS_BIND_PARAM_STR_BUF *)pStmt->pParamArena->calloc(iCount, sizeof(RS_BIND_PARAM_STR_BUF));
+
+    if(*pppBindParamVals == NULL
+        || *ppiParamFormats == NULL
+        || *ppBindParamStrBuf == NULL)
+    {
+        return FALSE;
+    }
+
+    for(int i = 0; i < iCount; i++)
+        (*ppBindParamStrBuf)[i].pArena = pStmt->pParamArena;
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release the bind parameter arrays and the converted values, by resetting the parameter arena.
+//
+static void releaseBindParamArrays(RS_STMT_INFO *pStmt, char ***pppBindParamVals, int **ppiParamFormats,
+                                   RS_BIND_PARAM_STR_BUF **ppBindParamStrBuf)
+{
+    *pppBindParamVals = NULL;
+    *ppiParamFormats = NULL;
+    *ppBindParamStrBuf = NULL;
+
+    if(pStmt->pParamArena)
+        pStmt->pParamArena->reset();
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Execute direct or prepare on a separate thread.
 //
@@ -811,8 +1077,11 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
     int iBindParam;
     int iBeginCommand = FALSE;
     int iCscThreadCreated = FALSE;
-    int iLastBatchMultiInsertPrepare = FALSE;
     std::vector<Oid> paramTypes;
+    std::string resultCacheSql;
+    std::string resultCacheKey;
+    int iResultCacheable = FALSE;
+    int iResultCacheHit = FALSE;
     // Use for legacy functions that need pointer and need to indicate null as
     // empty
     auto getParamTypesPtr = [&]() -> const Oid * {
@@ -826,6 +1095,19 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
 
         // Wait for current csc thread to finish, if any.
         pgWaitForCscThreadToFinish(pConn->pgConn, FALSE);
+
+        // Wait for the pending cancel of the connection, if any.
+        waitForPendingCancel(pConn);
+    }
+
+    if(pConn->pConnectProps->llResultCacheSize > 0)
+    {
+        char *pszResultCacheCmd = (executePrepared) ? ((pStmt->pCmdBuf) ? pStmt->pCmdBuf->pBuf : NULL) : pszCmd;
+
+        resultCacheSql = normalizeSqlForResultCache(pszResultCacheCmd);
+        iResultCacheable = isReadOnlyForResultCache(resultCacheSql)
+                            && isDeterministicForResultCache(resultCacheSql)
+                            && isStatementEligibleForResultCache(pStmt);
     }
 
     if((pszCmd && !executePrepared) || executePrepared)
@@ -849,9 +1131,23 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
             int  iArrayBinding = (lParamsToBind > 1);
             int  iBindOffset = (pAPDDescHeader.plBindOffsetPtr) ?  *((int*)pAPDDescHeader.plBindOffsetPtr) : 0;
             int  iMultiInsert = pStmt->iMultiInsert;
-            int  iLastBatchMultiInsert = pStmt->iLastBatchMultiInsert;
             int  iOffset = 0;
 
+            // Multi insert batch being bound. Its rows are picked at its first row, from the bytes of the rows so far.
+            int  iBatchRows = 0;
+            int  iBatchTarget = iMultiInsert;
+            int  iFlushBatch;
+            long long llParamBytes = 0;
+            long long llRowTextBytes = 0;
+            long long llMaxBatchBytes = pConn->pConnectProps->llMultiInsertBatchSize * 1024;
+
+            if(iMultiInsert)
+            {
+                char *pszMultiInsertCmd = (executePrepared) ? ((pStmt->pCmdBuf) ? pStmt->pCmdBuf->pBuf : NULL) : pszCmd;
+
+                llRowTextBytes = (pszMultiInsertCmd) ? (long long)strlen(pszMultiInsertCmd) / iMultiInsert : 0;
+            }
+
             for(lParamProcessed = 0; lParamProcessed < lParamsToBind; lParamProcessed++)
             {
                 if(pStmt->pStmtAttr->pAPD->pDescRecHead)
@@ -886,13 +1182,7 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
                         {
                             if(iNumBindParams > 0)
                             {
-                                ppBindParamVals = (char **)rs_calloc(iNumBindParams, sizeof(char *));
-                                piParamFormats  = (int *)rs_calloc(iNumBindParams, sizeof(int));
-                                pBindParamStrBuf = (RS_BIND_PARAM_STR_BUF *)rs_calloc(iNumBindParams, sizeof(RS_BIND_PARAM_STR_BUF));
-
-                                if(ppBindParamVals == NULL 
-                                    || piParamFormats == NULL
-                                    || pBindParamStrBuf == NULL)
+                                if(!allocBindParamArrays(pStmt, iNumBindParams, &ppBindParamVals, &piParamFormats, &pBindParamStrBuf))
                                 {
                                     rc = SQL_ERROR;
                                     goto error;
@@ -903,13 +1193,7 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
                         {
                             if((iNumBindParams > 0) && (ppBindParamVals == NULL))
                             {
-                                ppBindParamVals = (char **)rs_calloc(iNumBindParams * iMultiInsert, sizeof(char *));
-                                piParamFormats  = (int *)rs_calloc(iNumBindParams * iMultiInsert, sizeof(int));
-                                pBindParamStrBuf = (RS_BIND_PARAM_STR_BUF *)rs_calloc(iNumBindParams * iMultiInsert, sizeof(RS_BIND_PARAM_STR_BUF));
-
-                                if(ppBindParamVals == NULL 
-                                    || piParamFormats == NULL
-                                    || pBindParamStrBuf == NULL)
+                                if(!allocBindParamArrays(pStmt, iNumBindParams * iMultiInsert, &ppBindParamVals, &piParamFormats, &pBindParamStrBuf))
                                 {
                                     rc = SQL_ERROR;
                                     goto error;
@@ -1055,38 +1339,80 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
                     } /* !Data_At_Exec */
                 }
 
-                if(!iMultiInsert || (iMultiInsert && ((((lParamProcessed + 1) % iMultiInsert) == 0) 
-                                                            || (iLastBatchMultiInsert && (lParamProcessed + 1 == lParamsToBind))
-                                                      )
-                                    )
-                  )
+                if(iMultiInsert)
                 {
+                    for(iBindParam = (iOffset > iNumBindParams) ? iOffset - iNumBindParams : 0; iBindParam < iOffset; iBindParam++)
+                    {
+                        if(ppBindParamVals[iBindParam])
+                            llParamBytes += strlen(ppBindParamVals[iBindParam]);
+                    }
+
+                    if(iBatchRows++ == 0)
+                    {
+                        iBatchTarget = getMultiInsertBatchRows(iMultiInsert, lParamsToBind - lParamProcessed,
+                                                               llRowTextBytes + llParamBytes / (lParamProcessed + 1),
+                                                               llMaxBatchBytes);
+                    }
+                }
+
+                iFlushBatch = (!iMultiInsert || iBatchRows == iBatchTarget);
+
+                if(iFlushBatch)
+                {
+                    // Look for the result of the same query in the result cache
+                    if(rc != SQL_NEED_DATA && iResultCacheable)
+                    {
+                        PGresult *pCachedResult;
+
+                        resultCacheKey = makeResultCacheKeyForConnection(pConn, resultCacheSql, iNumBindParams, (const char *const *)ppBindParamVals);
+                        pCachedResult = findResultCache(resultCacheKey, pConn->pConnectProps->iResultCacheTtl);
+
+                        if(pCachedResult)
+                        {
+                            int iStopFlag = FALSE;
+
+                            iResultCacheHit = TRUE;
+                            rc = setResultInStmt(rc, pStmt, pCachedResult, FALSE, PGRES_TUPLES_OK, &iStopFlag, FALSE);
+                        }
+                    }
+
                     // Execute it using libpq
-                    if(rc != SQL_NEED_DATA)
+                    if(rc != SQL_NEED_DATA && !iResultCacheHit)
                     {
                         int iStopFlag = FALSE;
                         int nParams = 0;
+                        int iResultCount = 0;
 						int iReadOutParamVals = pStmt->iFunctionCall;
+                        char *pszExecCmd = pszCmd;
+                        const char *pszExecName = (executePrepared) ? getPreparedName(pStmt) : NULL;
                        
                         if(iMultiInsert)
                         {
-                            if(iLastBatchMultiInsert && (lParamProcessed + 1 == lParamsToBind))
+                            nParams = (iNumBindParams * iBatchTarget);
+
+                            // Smaller batch uses its own command
+                            if(iBatchTarget != iMultiInsert)
                             {
-                                nParams = (iNumBindParams * iLastBatchMultiInsert);
+                                RS_MULTI_INSERT_BATCH *pBatch = getMultiInsertBatch(pStmt, iBatchTarget);
+
+                                if(pBatch == NULL)
+                                {
+                                    rc = SQL_ERROR;
+                                    goto error;
+                                }
 
                                 if(!executePrepared)
-                                    pszCmd = pStmt->pszLastBatchMultiInsertCmd->pBuf;
+                                    pszExecCmd = pBatch->pszCmd;
                                 else
                                 {
-                                    iLastBatchMultiInsertPrepare = TRUE;
-                                    // De-allocate previous multi-insert command and prepare last batch multi-insret command
-                                    rc = rePrepareMultiInsertCommand(pStmt, pStmt->pszLastBatchMultiInsertCmd->pBuf);
-                                    if(rc == SQL_ERROR)
-                                         goto error;
+                                    pszExecName = prepareMultiInsertBatch(pStmt, pBatch);
+                                    if(pszExecName == NULL)
+                                    {
+                                        rc = SQL_ERROR;
+                                        goto error;
+                                    }
                                 }
                             }
-                            else
-                                nParams = (iNumBindParams * iMultiInsert);
                         }
                         else
                             nParams = iNumBindParams;
@@ -1103,9 +1429,9 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
 
                         if(asyncEnable)
                         {
-                            sendStatus = (!executePrepared) ? ( (iNumBindParams) ? PQsendQueryParams( pConn->pgConn, pszCmd, nParams, getParamTypesPtr(),(const char *const * )ppBindParamVals,NULL, piParamFormats, RS_TEXT_FORMAT)
-                                                                                  : PQsendQuery(pConn->pgConn, pszCmd) )
-                                                            : PQsendQueryPrepared(pConn->pgConn, pStmt->szCursorName, nParams, (const char *const * )ppBindParamVals, NULL, piParamFormats, RS_TEXT_FORMAT);
+                            sendStatus = (!executePrepared) ? ( (iNumBindParams) ? PQsendQueryParams( pConn->pgConn, pszExecCmd, nParams, getParamTypesPtr(),(const char *const * )ppBindParamVals,NULL, piParamFormats, RS_TEXT_FORMAT)
+                                                                                  : PQsendQuery(pConn->pgConn, pszExecCmd) )
+                                                            : PQsendQueryPrepared(pConn->pgConn, pszExecName, nParams, (const char *const * )ppBindParamVals, NULL, piParamFormats, RS_TEXT_FORMAT);
 
                             if(sendStatus)
                             {
@@ -1118,17 +1444,17 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
                           if (!executePrepared) {
                             if (iNumBindParams) {
                               pgResult = pqexecParams(
-                                  pConn->pgConn, pszCmd, nParams, getParamTypesPtr(),
+                                  pConn->pgConn, pszExecCmd, nParams, getParamTypesPtr(),
                                   (const char *const *)ppBindParamVals, NULL,
                                   piParamFormats, RS_TEXT_FORMAT,
                                   pStmt->pCscStatementContext);
                             } else {
-                              pgResult = pqExec(pConn->pgConn, pszCmd,
+                              pgResult = pqExec(pConn->pgConn, pszExecCmd,
                                                 pStmt->pCscStatementContext);
                             }
                           } else {
                             pgResult = pqExecPrepared(
-                                pConn->pgConn, pStmt->szCursorName, nParams,
+                                pConn->pgConn, pszExecName, nParams,
                                 (const char *const *)ppBindParamVals, NULL,
                                 piParamFormats, RS_TEXT_FORMAT,
                                 pStmt->pCscStatementContext);
@@ -1141,6 +1467,7 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
                         {
                             // Even one result in error, we are retuning error.
                             rc = setResultInStmt(rc, pStmt, pgResult, FALSE, pqRc,&iStopFlag, iArrayBinding);
+                            iResultCount++;
                             if(iStopFlag)
                                 break;
 
@@ -1194,6 +1521,21 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
                             }
                         }while(TRUE); // Results  loop
 
+                        // Keep a single, fully in memory result for the next execution of the same query
+                        if(iResultCacheable
+                            && rc == SQL_SUCCESS
+                            && iResultCount == 1
+                            && !iCscThreadCreated
+                            && pStmt->pResultHead
+                            && pStmt->pResultHead->pNext == NULL
+                            && pStmt->pResultHead->pgResult
+                            && PQresultStatus(pStmt->pResultHead->pgResult) == PGRES_TUPLES_OK
+                            && !pgHasCsc(pStmt->pResultHead->pgResult))
+                        {
+                            addResultCache(resultCacheKey, getServerForResultCache(pConn), resultCacheSql,
+                                            pStmt->pResultHead->pgResult, pConn->pConnectProps->llResultCacheSize * 1024 * 1024);
+                        }
+
 						if (rc == SQL_SUCCESS)
 						{
 							// Put the OUT parameter values, if any
@@ -1214,44 +1556,18 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
                 } 
 
                 // Clean param buffers
-                if((iNumBindParams > 0) && (!iMultiInsert || ( iMultiInsert && ((((lParamProcessed + 1) % iMultiInsert) == 0)
-                                                                                    || (iLastBatchMultiInsert && (lParamProcessed + 1 == lParamsToBind))
-                                                                               )
-                                                             )
-                                           )
-                  )
+                if((iNumBindParams > 0) && iFlushBatch)
                 {
-                    ppBindParamVals = (char **)rs_free(ppBindParamVals);
-                    piParamFormats  = (int *)rs_free(piParamFormats);
-
-                    if(pBindParamStrBuf)
-                    {
-                        for(iBindParam = 0; iBindParam < iNumBindParams; iBindParam++)
-                        {
-                            if(pBindParamStrBuf[iBindParam].iAllocDataLen > 0)
-                            {
-                                pBindParamStrBuf[iBindParam].pBuf = (char *)rs_free(pBindParamStrBuf[iBindParam].pBuf);
-                                pBindParamStrBuf[iBindParam].iAllocDataLen = 0;
-                            }
-                        }
-
-                        pBindParamStrBuf = (RS_BIND_PARAM_STR_BUF *)rs_free(pBindParamStrBuf);
-                    }
+                    releaseBindParamArrays(pStmt, &ppBindParamVals, &piParamFormats, &pBindParamStrBuf);
 
 					paramTypes.clear();
 
                     iOffset = 0;
                 }
-            } // Array binding loop
 
-            if(iLastBatchMultiInsertPrepare)
-            {
-                iLastBatchMultiInsertPrepare = FALSE;
-                // De-allocate previous multi-insert command and prepare regular multi-insret command
-                rc = rePrepareMultiInsertCommand(pStmt, pStmt->pCmdBuf->pBuf);
-                if(rc == SQL_ERROR)
-                     goto error;
-            }
+                if(iFlushBatch)
+                    iBatchRows = 0;
+            } // Array binding loop
         } // SQL_SUCCESS
     }
     else
@@ -1275,6 +1591,20 @@ SQLRETURN libpqExecuteDirectOrPreparedOnThread(RS_STMT_INFO *pStmt, char *pszCmd
         }
     }
 
+    // Session settings become part of the result cache key and other commands may change cached results.
+    // Objects of the session stop the connection using the cache, even if the command failed after making them.
+    if(!resultCacheSql.empty() && rc != SQL_NEED_DATA && isSessionObjectCommandForResultCache(resultCacheSql))
+        pConn->iResultCacheSessionObjects = TRUE;
+
+    if(!resultCacheSql.empty() && rc != SQL_ERROR && rc != SQL_NEED_DATA)
+    {
+        if(isSessionCommandForResultCache(resultCacheSql))
+            updateSessionForResultCache(pConn->resultCacheSession, resultCacheSql);
+        else
+        if(!isReadOnlyForResultCache(resultCacheSql))
+            invalidateResultCache(getServerForResultCache(pConn), "");
+    }
+
     if(iBeginCommand)
     {
         if(pConn->pConnAttr->iAutoCommit != SQL_AUTOCOMMIT_OFF 
@@ -1298,24 +1628,7 @@ error:
 
     // Clean param buffers
     if(iNumBindParams > 0)
-    {
-        ppBindParamVals = (char **)rs_free(ppBindParamVals);
-        piParamFormats  = (int *)rs_free(piParamFormats);
-
-        if(pBindParamStrBuf)
-        {
-            for(iBindParam = 0; iBindParam < iNumBindParams; iBindParam++)
-            {
-                if(pBindParamStrBuf[iBindParam].iAllocDataLen > 0)
-                {
-                    pBindParamStrBuf[iBindParam].pBuf = (char *)rs_free(pBindParamStrBuf[iBindParam].pBuf);
-                    pBindParamStrBuf[iBindParam].iAllocDataLen = 0;
-                }
-            }
-
-            pBindParamStrBuf = (RS_BIND_PARAM_STR_BUF *)rs_free(pBindParamStrBuf);
-        }
-    }
+        releaseBindParamArrays(pStmt, &ppBindParamVals, &piParamFormats, &pBindParamStrBuf);
 
 
     if(iLockRequired)
@@ -1621,9 +1934,8 @@ SQLRETURN libpqPrepare(RS_STMT_INFO *pStmt, char *pszCmd)
             pExecThread->rc = SQL_STILL_EXECUTING;
             pExecThread->iPrepare = 1;
 
-            // create thread
-            pExecThread->hThread =  rsCreateThread((void *)libpqPrepareThreadProc, pStmt);
-            if(pExecThread->hThread == (THREAD_HANDLE)(long) NULL)
+            // Queue on the async worker pool
+            if(!queueExecThread(pStmt, [pStmt]() { libpqPrepareThreadProc(pStmt); }))
             {
                 // Release thread info
                 waitAndFreeExecThread(pStmt, FALSE);
@@ -1650,7 +1962,7 @@ error:
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Prepare SQL statement using thread procedure.
+// Prepare SQL statement on a worker of the async pool using this procedure.
 //
 #ifdef WIN32
 void
@@ -1666,7 +1978,7 @@ libpqPrepareThreadProc(void *pArg)
 
     rc = libpqPrepareOnThread(pStmt, pExecThread->pszCmd);
 
-    setThreadExecutionStatus(pExecThread, rc);
+    setThreadExecutionStatus(pStmt, rc);
 
 #ifdef WIN32
     return;
@@ -1692,32 +2004,53 @@ SQLRETURN libpqPrepareOnThread(RS_STMT_INFO *pStmt, char *pszCmd)
     // Wait for current csc thread to finish, if any.
     pgWaitForCscThreadToFinish(pConn->pgConn, FALSE);
 
+    // Wait for the pending cancel of the connection, if any.
+    waitForPendingCancel(pConn);
+
     if(pszCmd)
     {
         PGresult *pgResult = NULL;
         ExecStatusType pqRc = PGRES_COMMAND_OK;
         int asyncEnable = isAsyncEnable(pStmt);
         int sendStatus = 1;
-        RS_PREPARE_INFO *pPrepare;
-        // TODO: improve the code repetition in if and else
-        if(asyncEnable)
+        RS_PREPARE_INFO *pPrepare = NULL;
+        int iNoOfBindParams = countBindParams(pStmt->pStmtAttr->pAPD->pDescRecHead);
+        int nPrepareParams = 0;
+        std::vector<Oid> paramTypes;
+        const char *pszName = pStmt->szCursorName;
+        std::string cacheKey;
+        std::string cacheName;
+
+        // OUT parameters in the stmt
+        if(pStmt->iNumOfOutOnlyParams != 0 || iNoOfBindParams != 0)
         {
-			int iNoOfBindParams = countBindParams(pStmt->pStmtAttr->pAPD->pDescRecHead);
+            paramTypes = getParamTypes(
+                iNoOfBindParams,
+                pStmt->pStmtAttr->pAPD->pDescRecHead,
+                pConn->pConnectProps);
+            nPrepareParams = iNoOfBindParams;
+        }
 
-			if (pStmt->iNumOfOutOnlyParams == 0 && iNoOfBindParams == 0)
-				sendStatus = pqSendPrepareAndDescribe(pConn->pgConn, pStmt->szCursorName, pszCmd, 0, NULL);
-            else {
-                std::vector<Oid> paramTypes = getParamTypes(
-                    iNoOfBindParams,
-                    pStmt->pStmtAttr->pAPD->pDescRecHead,
-                    pConn->pConnectProps);
-
-                sendStatus = pqSendPrepareAndDescribe(
-                    pConn->pgConn, pStmt->szCursorName, pszCmd,
-                    iNoOfBindParams,
-                    paramTypes.empty() ? nullptr
-                                       : paramTypes.data());
-            }
+        // Use the statement an earlier SQLPrepare of the query left on the server, otherwise prepare it under
+        // a name of the cache.
+        if(pConn->pPrepareCache)
+        {
+            cacheKey = makePrepareCacheKey(pszCmd, nPrepareParams, paramTypes.empty() ? nullptr : paramTypes.data());
+
+            if(prepareFromCache(pStmt, cacheKey, &rc))
+                goto error;
+
+            cacheName = pConn->pPrepareCache->newName();
+            pszName = cacheName.c_str();
+        }
+
+        if(asyncEnable)
+        {
+            sendStatus = pqSendPrepareAndDescribe(
+                pConn->pgConn, pszName, pszCmd,
+                nPrepareParams,
+                paramTypes.empty() ? nullptr
+                                   : paramTypes.data());
 
             if(sendStatus)
             {
@@ -1729,22 +2062,11 @@ SQLRETURN libpqPrepareOnThread(RS_STMT_INFO *pStmt, char *pszCmd)
         }
         else
         {
-			int iNoOfBindParams = countBindParams(pStmt->pStmtAttr->pAPD->pDescRecHead);
-			if(pStmt->iNumOfOutOnlyParams == 0 && iNoOfBindParams == 0)
-				pgResult = pqPrepare(pConn->pgConn, pStmt->szCursorName, pszCmd, 0, NULL);
-            else {
-                std::vector<Oid> paramTypes = getParamTypes(
-                    iNoOfBindParams,
-                    pStmt->pStmtAttr->pAPD->pDescRecHead,
-                    pConn->pConnectProps);
-
-                // OUT parameters in the stmt
-                pgResult = pqPrepare(
-                    pConn->pgConn, pStmt->szCursorName, pszCmd,
-                    iNoOfBindParams,
-                    paramTypes.empty() ? nullptr
-                                       : paramTypes.data());
-            }
+            pgResult = pqPrepare(
+                pConn->pgConn, pszName, pszCmd,
+                nPrepareParams,
+                paramTypes.empty() ? nullptr
+                                   : paramTypes.data());
             pqRc = PQresultStatus(pgResult);
         }
 
@@ -1847,6 +2169,10 @@ SQLRETURN libpqPrepareOnThread(RS_STMT_INFO *pStmt, char *pszCmd)
             pqRc = PQresultStatus(pgResult);
 
         }while(TRUE); // Results  loop
+
+        // Keep the statement prepared for the next SQLPrepare of the query
+        if(pConn->pPrepareCache)
+            addPrepareToCache(pStmt, cacheKey, cacheName, rc);
     }
     else
     {
@@ -1865,6 +2191,167 @@ error:
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Name of the statement prepared on the server.
+//
+static const char *getPreparedName(RS_STMT_INFO *pStmt)
+{
+    return (pStmt->szPreparedName[0] != '\0') ? pStmt->szPreparedName : pStmt->szCursorName;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Name of the multi INSERT batch prepared on the server. It's prepared on first use, and kept for the next executions.
+// NULL means error.
+//
+static const char *prepareMultiInsertBatch(RS_STMT_INFO *pStmt, RS_MULTI_INSERT_BATCH *pBatch)
+{
+    if(pBatch->szPreparedName[0] == '\0')
+    {
+        char szName[MAX_IDEN_LEN];
+
+        snprintf(szName, sizeof(szName), "rs_mi_%p_%d", (void *)pStmt, pBatch->iRows);
+
+        if(libpqPrepareOnThreadWithoutStoringResults(pStmt, szName, pBatch->pszCmd) != SQL_SUCCESS)
+            return NULL;
+
+        rs_strncpy(pBatch->szPreparedName, szName, sizeof(pBatch->szPreparedName));
+    }
+
+    return pBatch->szPreparedName;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release the multi INSERT batches of the statement. Prepared ones are closed with the next request to the server.
+//
+void libpqReleaseMultiInsertBatches(RS_STMT_INFO *pStmt)
+{
+    RS_CONN_INFO *pConn = pStmt->phdbc;
+    RS_MULTI_INSERT_BATCH *pBatch;
+    int iPrepared = FALSE;
+
+    for(pBatch = pStmt->pMultiInsertBatchHead; pBatch != NULL; pBatch = pBatch->pNext)
+    {
+        if(pBatch->szPreparedName[0] != '\0')
+            iPrepared = TRUE;
+    }
+
+    if(iPrepared && pConn && pConn->pgConn)
+    {
+        // Lock connection sem, the queue is sent with the next request of any statement of the connection.
+        rsLockSem(pConn->hSemMultiStmt);
+
+        // Wait for current csc thread to finish, if any.
+        pgWaitForCscThreadToFinish(pConn->pgConn, FALSE);
+
+        // Wait for the pending cancel of the connection, if any.
+        waitForPendingCancel(pConn);
+
+        for(pBatch = pStmt->pMultiInsertBatchHead; pBatch != NULL; pBatch = pBatch->pNext)
+        {
+            if(pBatch->szPreparedName[0] != '\0'
+                && !pqQueueClosePrepared(pConn->pgConn, pBatch->szPreparedName))
+            {
+                RS_LOG_WARN("RSLIBPQ", "Close of %s failed: %s", pBatch->szPreparedName, PQerrorMessage(pConn->pgConn));
+            }
+        }
+
+        // Unlock connection sem
+        rsUnlockSem(pConn->hSemMultiStmt);
+    }
+
+    pBatch = pStmt->pMultiInsertBatchHead;
+
+    while(pBatch != NULL)
+    {
+        RS_MULTI_INSERT_BATCH *pNext = pBatch->pNext;
+
+        pBatch->pszCmd = (char *)rs_free(pBatch->pszCmd);
+        rs_free(pBatch);
+        pBatch = pNext;
+    }
+
+    pStmt->pMultiInsertBatchHead = NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Prepare the statement using the prepared statement cache of the connection. FALSE means the query isn't in it.
+//
+static int prepareFromCache(RS_STMT_INFO *pStmt, const std::string &key, SQLRETURN *pRc)
+{
+    RS_CONN_INFO *pConn = pStmt->phdbc;
+    std::string name;
+    PGresult *pgResult = NULL;
+    PGresult *pgResultDescParam = NULL;
+    PGresult *pgResultDescCol = NULL;
+    RS_PREPARE_INFO *pPrepare;
+
+    if(!pConn->pPrepareCache->find(key, name, &pgResult, &pgResultDescParam, &pgResultDescCol))
+        return FALSE;
+
+    rs_strncpy(pStmt->szPreparedName, name.c_str(), sizeof(pStmt->szPreparedName));
+    pStmt->iPreparedFromCache = TRUE;
+
+    // Same objects as a prepare on the server gives
+    pPrepare = (RS_PREPARE_INFO *)new RS_PREPARE_INFO(pStmt, pgResult);
+
+    *pRc = libpqDescribeParams(pStmt, pPrepare, pgResultDescParam);
+
+    addPrepare(pStmt, pPrepare);
+
+    if(pgResultDescCol)
+    {
+        RS_RESULT_INFO *pResult = createResultObject(pStmt, pgResultDescCol);
+
+        getResultDescription(pgResultDescCol, pResult, FALSE);
+
+        pPrepare->pResultForDescribeCol = pResult;
+    }
+
+    RS_LOG_DEBUG("RSLIBPQ", "Prepared statement %s from cache", pStmt->szPreparedName);
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Add the statement prepared under the name to the prepared statement cache of the connection. Statement preparing
+// more than one query isn't cached, but keeps the name. Evicted statements are deallocated on the server.
+//
+static void addPrepareToCache(RS_STMT_INFO *pStmt, const std::string &key, const std::string &name, SQLRETURN rc)
+{
+    RS_CONN_INFO *pConn = pStmt->phdbc;
+    RS_PREPARE_INFO *pPrepare = pStmt->pPrepareHead;
+    std::vector<std::string> deallocateNames;
+
+    rs_strncpy(pStmt->szPreparedName, name.c_str(), sizeof(pStmt->szPreparedName));
+
+    if(rc != SQL_SUCCESS || pPrepare == NULL || pPrepare->pNext != NULL
+        || PQstatus(pConn->pgConn) != CONNECTION_OK)
+    {
+        return;
+    }
+
+    pConn->pPrepareCache->add(key, name, pPrepare->pgResult, pPrepare->pgResultDescribeParam,
+                              (pPrepare->pResultForDescribeCol) ? pPrepare->pResultForDescribeCol->pgResult : NULL,
+                              deallocateNames);
+    pStmt->iPreparedFromCache = TRUE;
+
+    for(const std::string &evictedName : deallocateNames)
+    {
+        if(!pqQueueClosePrepared(pConn->pgConn, evictedName.c_str()))
+            RS_LOG_WARN("RSLIBPQ", "Close of %s failed: %s", evictedName.c_str(), PQerrorMessage(pConn->pgConn));
+    }
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Release prepared statement related resource.
 //
@@ -2260,17 +2747,24 @@ static void getResultDescription(PGresult *pgResult, RS_RESULT_INFO *pResult, in
 //---------------------------------------------------------------------------------------------------------igarish
 // Release prepared statement on server.
 //
-// DEALLOCATE stmt_name
+// Close of the statement goes with the next request on the connection, instead of a DEALLOCATE stmt_name
+// round trip.
 SQLRETURN libpqExecuteDeallocateCommand(RS_STMT_INFO *pStmt, int iLockRequired, int calledFromDrop)
 {
     int fail = FALSE;
     RS_CONN_INFO *pConn = pStmt->phdbc;
+    int iDeallocate = TRUE;
 
-    if(pStmt->pPrepareHead && (calledFromDrop || pStmt->iStatus != RS_CANCEL_STMT))
+    // Statement of the prepared statement cache stays on the server for the next SQLPrepare of the query,
+    // unless it was evicted while this statement used it.
+    if(pStmt->iPreparedFromCache)
     {
-        char szCmd[SHORT_CMD_LEN + 1];
-        PGresult *pgResult;
+        iDeallocate = (pConn->pPrepareCache != NULL && pConn->pPrepareCache->release(pStmt->szPreparedName));
+        pStmt->iPreparedFromCache = FALSE;
+    }
 
+    if(pStmt->pPrepareHead && iDeallocate && (calledFromDrop || pStmt->iStatus != RS_CANCEL_STMT))
+    {
         if(iLockRequired)
         {
             // Lock connection sem to protect multiple stmt execution at same time.
@@ -2278,16 +2772,15 @@ SQLRETURN libpqExecuteDeallocateCommand(RS_STMT_INFO *pStmt, int iLockRequired,
 
             // Wait for current csc thread to finish, if any.
             pgWaitForCscThreadToFinish(pConn->pgConn, FALSE);
+
+            // Wait for the pending cancel of the connection, if any.
+            waitForPendingCancel(pConn);
         }
 
 		// We have to release any result of streaming cursor before executing internal command
 		checkAndSkipAllResultsOfStreamingCursor(pStmt);
 
-        snprintf(szCmd,sizeof(szCmd),"%s %s", DEALLOCATE_CMD, pStmt->szCursorName);
-        
-        pgResult = PQexec(pConn->pgConn, szCmd);
-
-        if(PQresultStatus(pgResult) != PGRES_COMMAND_OK)
+        if(!pqQueueClosePrepared(pConn->pgConn, getPreparedName(pStmt)))
         {
             char *pError = libpqErrorMsg(pConn);
 
@@ -2297,9 +2790,6 @@ SQLRETURN libpqExecuteDeallocateCommand(RS_STMT_INFO *pStmt, int iLockRequired,
                 addError(&pStmt->pErrorList,"HY000", pError, 0, pConn);
         }
 
-        PQclear(pgResult);
-        pgResult = NULL;
-
         if(iLockRequired)
         {
             // Unlock connection sem
@@ -2307,6 +2797,8 @@ SQLRETURN libpqExecuteDeallocateCommand(RS_STMT_INFO *pStmt, int iLockRequired,
         }
     }
 
+    pStmt->szPreparedName[0] = '\0';
+
     return (fail) ? SQL_ERROR : SQL_SUCCESS;
 }
 
@@ -2637,9 +3129,9 @@ ConnStatusType libpqConnectionStatus(RS_CONN_INFO *pConn)
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Prepare SQL statement using thread.
+// Prepare SQL statement under the name, without storing the results.
 //
-SQLRETURN libpqPrepareOnThreadWithoutStoringResults(RS_STMT_INFO *pStmt, char *pszCmd)
+SQLRETURN libpqPrepareOnThreadWithoutStoringResults(RS_STMT_INFO *pStmt, const char *pszName, char *pszCmd)
 {
     SQLRETURN rc = SQL_SUCCESS;
     RS_CONN_INFO *pConn = pStmt->phdbc;
@@ -2653,7 +3145,7 @@ SQLRETURN libpqPrepareOnThreadWithoutStoringResults(RS_STMT_INFO *pStmt, char *p
 
         if(asyncEnable)
         {
-            sendStatus = pqSendPrepareAndDescribe(pConn->pgConn, pStmt->szCursorName, pszCmd, 0, NULL);
+            sendStatus = pqSendPrepareAndDescribe(pConn->pgConn, pszName, pszCmd, 0, NULL);
 
             if(sendStatus)
             {
@@ -2665,7 +3157,7 @@ SQLRETURN libpqPrepareOnThreadWithoutStoringResults(RS_STMT_INFO *pStmt, char *p
         }
         else
         {
-            pgResult = pqPrepare(pConn->pgConn, pStmt->szCursorName, pszCmd, 0, NULL);
+            pgResult = pqPrepare(pConn->pgConn, pszName, pszCmd, 0, NULL);
             pqRc = PQresultStatus(pgResult);
         }
 
@@ -2775,11 +3267,16 @@ void *libpqFreemem(void *ptr)
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Set streaming cursor rows
+// Set streaming cursor rows, batch size and rowset size of the application
 //
 void libpqSetStreamingCursorRows(RS_STMT_INFO *pStmt)
 {
-	setStreamingCursorRows(pStmt->pCscStatementContext, pStmt->phdbc->pConnectProps->iStreamingCursorRows);
+	RS_CONNECT_PROPS_INFO *pConnectProps = pStmt->phdbc->pConnectProps;
+	long lRowsetSize = (pStmt->pStmtAttr && pStmt->pStmtAttr->pARD) ? pStmt->pStmtAttr->pARD->pDescHeader.lArraySize : 1;
+
+	setStreamingCursorRows(pStmt->pCscStatementContext, pConnectProps->iStreamingCursorRows);
+	setStreamingCursorBatchSize(pStmt->pCscStatementContext, pConnectProps->llStreamingCursorBatchSize * 1024,
+								(lRowsetSize > 1) ? (int)lRowsetSize : 1);
 }
 
 /*====================================================================================================================================================*/
@@ -32,6 +32,8 @@
 #include <string_view>
 #include <optional>
 #include <vector>
+#include <mutex>
+#include <condition_variable>
 
 #include "libpq-fe.h"
 
@@ -70,6 +72,8 @@
 #define MAX_NAMEOID_SIZE NAMEDATALEN
 #define PADB_MAX_NUM_BUF_LEN 40 // 38 + '.' + '\0'
 #define PADB_MAX_PARAMETERS 32767
+#define RS_MULTI_INSERT_BATCH_ROWS_FACTOR 4 // Rows of smaller multi insert batches are powers of it
+#define RS_DATA_AT_EXEC_MIN_ALLOC 1024 // Bytes of the first buffer of a data-at-exec value
 #define MAX_LARGE_TEMP_BUF_LEN        1024
 #define MAX_SMALL_TEMP_BUF_LEN        32
 #define DEFAULT_MAX_REMARK_LEN     1024 // Default Max length of comment defined in padb
@@ -149,6 +153,56 @@
 
 /* Proprietary Connection/Env Attributes. END */
 
+/* Proprietary Statement Attributes. START */
+
+#ifndef SQL_DRIVER_STMT_ATTR_BASE
+#define SQL_DRIVER_STMT_ATTR_BASE   0x00004000
+#endif
+
+// Max rows per batch returned by RsGetArrowArrayStream. 0 means one batch per rows in memory.
+#define SQL_ATTR_RS_ARROW_BATCH_ROWS        (SQL_DRIVER_STMT_ATTR_BASE+1)
+
+#define RS_DEFAULT_ARROW_BATCH_ROWS         65536
+
+/* Proprietary Statement Attributes. END */
+
+/* ODBC 3.8 asynchronous notification, for headers without it. START */
+
+#ifndef SQL_ATTR_ASYNC_STMT_EVENT
+#define SQL_ATTR_ASYNC_STMT_EVENT           29
+#define SQL_ATTR_ASYNC_STMT_PCALLBACK       10012
+#define SQL_ATTR_ASYNC_STMT_PCONTEXT        10013
+#endif
+
+#ifndef SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE
+#define SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE 117
+#define SQL_ASYNC_DBC_ENABLE_ON             1UL
+#define SQL_ASYNC_DBC_ENABLE_OFF            0UL
+#define SQL_ASYNC_DBC_ENABLE_DEFAULT        SQL_ASYNC_DBC_ENABLE_OFF
+#endif
+
+#ifndef SQL_ASYNC_DBC_FUNCTIONS
+#define SQL_ASYNC_DBC_FUNCTIONS             10023
+#define SQL_ASYNC_DBC_NOT_CAPABLE           0x00000000L
+#define SQL_ASYNC_DBC_CAPABLE               0x00000001L
+#endif
+
+#ifndef SQL_ASYNC_NOTIFICATION
+#define SQL_ASYNC_NOTIFICATION              10025
+#define SQL_ASYNC_NOTIFICATION_NOT_CAPABLE  0x00000000L
+#define SQL_ASYNC_NOTIFICATION_CAPABLE      0x00000001L
+#endif
+
+// Callback of the Driver Manager for the completion of an asynchronous function, SQL_ASYNC_NOTIFICATION_CALLBACK of sqlspi.h.
+typedef SQLRETURN (SQL_API *RS_ASYNC_NOTIFICATION_CALLBACK)(SQLPOINTER pContext, int fLast);
+
+#ifdef __cplusplus
+extern "C"
+#endif
+SQLRETURN SQL_API SQLCompleteAsync(SQLSMALLINT hHandleType, SQLHANDLE pHandle, RETCODE *pAsyncRetCode);
+
+/* ODBC 3.8 asynchronous notification. END */
+
 // OID values from catalog/pg_type.h
 #define BOOLOID            16
 #define BYTEAOID           17
@@ -234,10 +288,14 @@ class RS_STMT_ATTR_INFO;
 
 class RS_DATA_AT_EXEC;
 class RS_EXEC_THREAD_INFO;
+class RS_PREPARE_CACHE;
+class RS_SQL_REWRITE_CACHE;
+class RS_PARAM_ARENA;
 // Data structures
 struct _RS_DESC_REC; // Array of it
 struct _RS_STR_BUF;
 struct _CscStatementContext;
+struct _RS_MULTI_INSERT_BATCH;
 
 
 /*
@@ -319,6 +377,9 @@ public:
       hSemMultiStmt = NULL;
       hApiMutex = NULL;
       iLastQueryTimeoutSetInServer = 0;
+      iResultCacheSessionObjects = FALSE;
+      pPrepareCache = NULL;
+      pSqlRewriteCache = NULL;
       pNext = NULL;
 
 //      memset(&iamSettings, '\0', sizeof(iamSettings));
@@ -361,6 +422,18 @@ public:
     // IAM stuff
     RsSettings iamSettings;
 
+    // Last SET command of each setting executed on the connection, part of the result cache key
+    std::map<std::string, std::string> resultCacheSession;
+
+    // Connection may have temporary objects of its session, so it doesn't use the result cache
+    int iResultCacheSessionObjects;
+
+    // Statements prepared on the server, reused by SQLPrepare of the same query
+    RS_PREPARE_CACHE *pPrepareCache;
+
+    // Parameter marker, ODBC escape clause and multi INSERT processing of recent SQL
+    RS_SQL_REWRITE_CACHE *pSqlRewriteCache;
+
 
     // Next element
     RS_CONN_INFO *pNext;
@@ -460,6 +533,8 @@ class RS_STMT_INFO
 	  iNumOfInOutOnlyParams = 0;
 
       szCursorName[0] = '\0';
+      szPreparedName[0] = '\0';
+      iPreparedFromCache = 0;
       pPrepareHead = NULL;
 
       pAPDRecDataAtExec = NULL;
@@ -473,8 +548,8 @@ class RS_STMT_INFO
       pExecThread = NULL;
       pCscStatementContext = NULL;
       iMultiInsert = 0;
-      iLastBatchMultiInsert = 0;
-      pszLastBatchMultiInsertCmd = NULL;
+      pMultiInsertBatchHead = NULL;
+      pParamArena = NULL;
 
       pszUserInsertCmd = NULL;
       pNext = NULL;
@@ -515,6 +590,12 @@ class RS_STMT_INFO
     // Implicit or explicit cursor name.
     char    szCursorName[MAX_IDEN_LEN];
 
+    // Name of the statement prepared on the server, when it isn't the cursor name.
+    char    szPreparedName[MAX_IDEN_LEN];
+
+    // Is the prepared statement an entry of the prepared statement cache of the connection?
+    int iPreparedFromCache;
+
     // Prepare statement info from libpq
     RS_PREPARE_INFO *pPrepareHead;
 
@@ -541,11 +622,11 @@ class RS_STMT_INFO
     // Records the lArraySize when iMultiInsert was updated
     int lArraySizeMultiInsert;
 
-    // > 0 means Multi-Insert has remainder which is less than iMultiInsert.
-    int iLastBatchMultiInsert;
+    // Multi-INSERT commands of the batches with fewer rows than iMultiInsert, made on first use.
+    struct _RS_MULTI_INSERT_BATCH *pMultiInsertBatchHead;
 
-    // If iLastBatchMultiInsert > 0 then this will contain last batch multi-insert command.
-    struct _RS_STR_BUF *pszLastBatchMultiInsertCmd;
+    // Bind parameter arrays and converted values of the execute, reset after each send. Made on first execute with parameters.
+    RS_PARAM_ARENA *pParamArena;
 
     // Contains user INSERT command pass to SQLPrepare, which we can convert into multi-insert if API sequence calls not in order.
     char *pszUserInsertCmd;
@@ -605,6 +686,11 @@ class RS_STMT_INFO
                                           SQLSMALLINT hFetchOrientation,
                                           SQLLEN iFetchOffset);
 
+    static SQLRETURN fetchRowset(RS_STMT_INFO *pStmt,
+                                 SQLSMALLINT hFetchOrientation,
+                                 SQLLEN iFetchOffset,
+                                 SQLULEN *plRowsFetched);
+
     SQLRETURN  SQL_API InternalSQLCloseCursor();
     SQLRETURN  SQL_API InternalSQLPrepare(
                                         SQLCHAR* pCmd,
@@ -659,10 +745,12 @@ public:
     RS_DATA_AT_EXEC() {
       pValue = NULL;
       cbLen = 0;
+      cbAlloc = 0;
     }
 
     char *pValue; 
     SQLLEN cbLen;      
+    SQLLEN cbAlloc;    // Bytes allocated for pValue, more than cbLen for the NUL and the next pieces
 };
 
 /*
@@ -1119,15 +1207,26 @@ struct SHOWPROCEDURESFUNCTIONSResult {
 #define RS_CSC_THRESHOLD              "CscThreshold"
 #define RS_CSC_PATH                   "CscPath"
 #define RS_CSC_MAX_FILE_SIZE          "CscMaxFileSize"
+#define RS_CSC_SYNC_WRITES            "CscSyncWrites"
+#define RS_CSC_FILE_FORMAT            "CscFileFormat"
+#define RS_CSC_CACHE_SIZE             "CscCacheSize"
+#define RS_RESULT_MEMORY_LIMIT        "ResultMemoryLimit"
+#define RS_RESULT_CACHE_SIZE          "ResultCacheSize"
+#define RS_RESULT_CACHE_TTL           "ResultCacheTTL"
+#define RS_LAZY_ROW_DECODE            "LazyRowDecode"
+#define RS_PREPARED_STATEMENT_CACHE_SIZE  "PreparedStatementCacheSize"
+#define RS_SQL_REWRITE_CACHE_SIZE     "SqlRewriteCacheSize"
 #define RS_SSL_MODE                   "SSLMode"
 #define RS_ENCRYPTION_METHOD          "EncryptionMethod"
 #define RS_VALIDATE_SERVER_CERTIFICATE  "ValidateServerCertificate"
 //#define RS_HOST_NAME_IN_CERTIFICATE     "HostNameInCertificate"
 #define RS_TRUST_STORE                  "TrustStore"
 #define RS_MULTI_INSERT_CMD_CONVERT_ENABLE  "MultiInsertCmdConvertEnable"
+#define RS_MULTI_INSERT_BATCH_SIZE          "MultiInsertBatchSize"
 #define RS_KERBEROS_SERVICE_NAME            "KerberosServiceName"
 #define RS_KERBEROS_API                     "KerberosAPI"
 #define RS_STREAMING_CURSOR_ROWS            "StreamingCursorRows"
+#define RS_STREAMING_CURSOR_BATCH_SIZE      "StreamingCursorBatchSize"
 #define RS_DATABASE_METADATA_CURRENT_DB_ONLY     "DatabaseMetadataCurrentDbOnly"
 #define RS_READ_ONLY							"ReadOnly"
 #define RS_USE_UNICODE                          "UseUnicode"
@@ -1319,6 +1418,16 @@ public:
 
       llCscThreshold = 0LL;
 
+      iCscSyncWrites = 0;
+      iCscFileFormat = 0;
+      llCscCacheSize = 0LL;
+      llResultMemoryLimit = 0LL;
+      llResultCacheSize = 0LL;
+      iResultCacheTtl = 60;
+      iLazyRowDecode = 0;
+      iPreparedStatementCacheSize = 0;
+      iSqlRewriteCacheSize = 64;
+
 	  strncpy(szSslMode,"verify-ca",sizeof(szSslMode));
       iEncryptionMethod = 1;
       iValidateServerCertificate = 1;
@@ -1327,11 +1436,13 @@ public:
       szTrustStore[0] = '\0';
 
       iMultiInsertCmdConvertEnable = 0;
+      llMultiInsertBatchSize = 8192LL;
 
       szKerberosServiceName[0] = '\0';
       szKerberosAPI[0] = '\0';
 
       iStreamingCursorRows = 0;
+      llStreamingCursorBatchSize = 0LL;
 	  iDatabaseMetadataCurrentDbOnly = 1;
 	  iReadOnly = 0;
 	  iUseUnicode = 0;
@@ -1450,6 +1561,61 @@ public:
 */
     long long llCscThreshold;
 
+/*  Flush and fsync the client side cursor file on every batch of 1000 rows written. The file
+    is deleted when the cursor is closed, so by default the driver buffers writes in memory
+    and never syncs them to disk. Default is false.
+*/
+    int iCscSyncWrites;
+
+/*  Format of the client side cursor file. 1 is the row format with an offset file for
+    scrollable cursors, 2 is compressed column-wise blocks. 0 means the default, 2.
+*/
+    int iCscFileFormat;
+
+/*  Memory (in MB) for decoded client side cursor blocks, shared by all statements on the
+    connection. Recently read blocks are kept, so scrolling back to them doesn't read the
+    file again. A value of 0 means no cache. Negative values are treated as 0. Default is 64.
+*/
+    long long llCscCacheSize;
+
+/*  Memory (in MB) for result sets of all connections in the process. When results use more,
+    the result being read is spilled to the client side cursor file, if CSC is enabled on its
+    connection. The lowest value asked by any connection is used. A value of 0 means no limit.
+    -1 means half of the cgroup memory limit of the process. Default is 0.
+*/
+    long long llResultMemoryLimit;
+
+/*  Memory (in MB) for results of read only queries, kept to answer the same query again
+    without going to the server. The cache is shared by the connections of the process and the
+    largest value asked by any connection is used. A value of 0 disables the cache for the
+    connection. Default is 0.
+*/
+    long long llResultCacheSize;
+
+/*  Time (in seconds) a cached result can be used by the connection. Default is 60.
+*/
+    int iResultCacheTtl;
+
+/*  Keep the rows of in memory results as received and decode the columns of a row when it's
+    first read. Saves copies and memory when few columns of wide rows are read. Rows going to
+    the client side cursor file or a streaming cursor batch are decoded as received. Default is 0.
+*/
+    int iLazyRowDecode;
+
+/*  Number of statements the connection keeps prepared on the server, after the statement handle
+    preparing them moves on to another query or is freed. SQLPrepare of the same query with the
+    same parameter types then needs no round trip to the server. Statements keep the column
+    description of the first prepare, so a cached statement of a table changed later by DDL can
+    fail with an error. A value of 0 disables the cache. Default is 0.
+*/
+    int iPreparedStatementCacheSize;
+
+/*  Number of SQL texts the connection keeps the parameter marker, ODBC escape clause and multi
+    INSERT processing of, so executing the same SQL text again skips scanning it. The cache of a
+    connection holds at most 4 MB of SQL. A value of 0 disables the cache. Default is 64.
+*/
+    int iSqlRewriteCacheSize;
+
 /*
  * SSLMode set by user. If it's not set then derived from other parameters such as EncryptionMethod,
  * ValidateServerCertificate, szHostNameInCertificate.
@@ -1490,6 +1656,12 @@ public:
     // Multi-Insert conversion enable
     int iMultiInsertCmdConvertEnable;
 
+/*  Size (in KB) a multi-INSERT batch aims at, counting its SQL text and its parameter values. Batches of
+    wide rows get fewer rows than PADB_MAX_PARAMETERS allows. 0 means only the parameter count limits
+    a batch. Default is 8192.
+*/
+    long long llMultiInsertBatchSize;
+
 /* Kerberos authentication support specifying the service name 
 */
     char szKerberosServiceName[MAX_IDEN_LEN] = {0};
@@ -1501,6 +1673,12 @@ public:
 /* Streaming Cursor size
 */
     int iStreamingCursorRows; // Default is 0
+
+/*  Memory (in KB) for the rows of a streaming cursor batch. When it's > 0, batches end once their rows
+    use this much memory instead of at StreamingCursorRows rows, so narrow rows get bigger batches than
+    wide ones. Batches always end at a multiple of the rowset size (SQL_ATTR_ROW_ARRAY_SIZE). Default is 0.
+*/
+    long long llStreamingCursorBatchSize;
 	int iDatabaseMetadataCurrentDbOnly; // Default is 1. 0 means datashare i.e. across multiple databases.
 	int iReadOnly; // Default is 0. 1 means READ ONLY session.
 	int iUseUnicode; // Default is 0. 1 means report wide SQL types for character columns.
@@ -1582,6 +1760,7 @@ public:
       pTranslateLib = NULL;
       iTranslateOption = 0;
       iTxnIsolation = SQL_TXN_SERIALIZABLE;
+      iAsyncDbcFunctionsEnable = SQL_ASYNC_DBC_ENABLE_OFF;
 
       szApplicationName[0] = '\0';
       szOsUserName[0] = '\0';
@@ -1606,6 +1785,7 @@ public:
     char *pTranslateLib;
     int  iTranslateOption;
     int  iTxnIsolation;
+    int  iAsyncDbcFunctionsEnable; // Only SQL_ASYNC_DBC_ENABLE_OFF
 
     // Audit trail information
     char szApplicationName[MAX_TEMP_BUF_LEN];
@@ -1642,6 +1822,10 @@ public:
       iRowNumber = 0;
       iSimulateCursor = SQL_SC_NON_UNIQUE;
       iUseBookmark = SQL_UB_DEFAULT;
+      iArrowBatchRows = RS_DEFAULT_ARROW_BATCH_ROWS;
+      hAsyncEvent = NULL;
+      pAsyncCallback = NULL;
+      pAsyncContext = NULL;
     }
 
     RS_DESC_INFO *pAPD; /* APD */
@@ -1663,6 +1847,10 @@ public:
     int iRowNumber;                      /* Read Only */
     int iSimulateCursor;
     int iUseBookmark;
+    int iArrowBatchRows;                 /* SQL_ATTR_RS_ARROW_BATCH_ROWS */
+    HANDLE hAsyncEvent;                  /* SQL_ATTR_ASYNC_STMT_EVENT, signaled when no callback is set */
+    RS_ASYNC_NOTIFICATION_CALLBACK pAsyncCallback; /* SQL_ATTR_ASYNC_STMT_PCALLBACK, set by the Driver Manager */
+    SQLPOINTER pAsyncContext;            /* SQL_ATTR_ASYNC_STMT_PCONTEXT */
 };
 
 /*
@@ -1708,6 +1896,7 @@ public:
     RS_RESULT_INFO *pNext;
 
     // Methods
+    static SQLRETURN readNextBatchOfRows(RS_STMT_INFO *pStmt, RS_RESULT_INFO *pResult);
     static SQLRETURN setFetchAtFirstRow(RS_STMT_INFO *pStmt, RS_RESULT_INFO *pResult);
     static SQLRETURN setFetchAtLastRow(RS_STMT_INFO *pStmt, RS_RESULT_INFO *pResult);
     static SQLRETURN setAbsolute(RS_STMT_INFO *pStmt, RS_RESULT_INFO *pResult, SQLLEN iFetchOffset);
@@ -1751,6 +1940,18 @@ public:
 
 SQLRETURN setQueryTimeoutInServer(RS_STMT_INFO *pStmt);
 
+/*
+ * Multi-INSERT batch info. A batch has one of a few row counts, so the rows at the end of an
+ * array, or of wide rows, don't need a command of their own.
+ */
+typedef struct _RS_MULTI_INSERT_BATCH
+{
+    int iRows;
+    char *pszCmd;                           // Command with $n param markers
+    char szPreparedName[MAX_IDEN_LEN];      // Name on the server, when prepared
+    struct _RS_MULTI_INSERT_BATCH *pNext;
+} RS_MULTI_INSERT_BATCH;
+
 /* Type information
 */
 typedef struct _RS_TYPE_INFO
@@ -1786,7 +1987,7 @@ public:
     RS_EXEC_THREAD_INFO() {
       pszCmd = NULL;
       executePrepared = 0;
-      hThread = NULL;
+      iQueued = 0;
       rc = 0;
       iPrepare = 0;
       iExecFromParamData = 0;
@@ -1794,10 +1995,13 @@ public:
 
     char *pszCmd; // Command. This is allocated buffer using rs_strdup because of async operation.
     int executePrepared; // Execute prepared one or execute direct.
-    THREAD_HANDLE hThread; // Thread handle
+    int iQueued; // 1 means queued on the async worker pool and not finished
     SQLRETURN rc;   // Return code
     int iPrepare; // 1 means SQLPrepare
     int iExecFromParamData;
+
+    std::mutex lock; // Guards rc and iQueued between the worker and the application
+    std::condition_variable done; // Signaled when the worker sets rc
 };
 
 // Golbal var
@@ -1812,10 +2016,12 @@ SQLRETURN libpqConnect(RS_CONN_INFO *pConn);
 void libpqDisconnect(RS_CONN_INFO *pConn);
 void libpqFreeConnect(RS_CONN_INFO *pConn);
 char *libpqParameterStatus(RS_CONN_INFO *pConn, const char *paramName);
+char *libpqSessionTimeZone(RS_CONN_INFO *pConn);
 char *libpqGetNativeSqlState(RS_CONN_INFO *pConn);
 char *libpqErrorMsg(RS_CONN_INFO *pConn);
 int libpqIsTransactionIdle(RS_CONN_INFO *pConn);
 SQLRETURN libpqExecuteTransactionCommand(RS_CONN_INFO *pConn, char *cmd, int iLockRequired);
+SQLRETURN libpqExecuteBulkInsert(RS_STMT_INFO *pStmt, char *pszCmd, int nParams, const char *const *ppParamVals);
 SQLRETURN libpqCancelQuery(RS_STMT_INFO *pStmt);
 
 SQLRETURN libpqExecuteDirectOrPrepared(RS_STMT_INFO *pStmt, char *pszCmd, int executePrepared);
@@ -1857,7 +2063,7 @@ SQLRETURN libpqCreateSQLProcedureColumnsCustomizedResultSet(RS_STMT_INFO *pStmt,
 
 SQLRETURN libpqPrepare(RS_STMT_INFO *pStmt, char *pszCmd);
 SQLRETURN libpqPrepareOnThread(RS_STMT_INFO *pStmt, char *pszCmd);
-SQLRETURN libpqPrepareOnThreadWithoutStoringResults(RS_STMT_INFO *pStmt, char *pszCmd);
+SQLRETURN libpqPrepareOnThreadWithoutStoringResults(RS_STMT_INFO *pStmt, const char *pszName, char *pszCmd);
 
 #ifdef WIN32
 void
@@ -1871,6 +2077,7 @@ void libpqReleasePrepare(RS_PREPARE_INFO *pPrepare);
 void libpqTrace(RS_CONN_INFO *pConn); // Deprecated
 SQLRETURN libpqDescribeParams(RS_STMT_INFO *pStmt, RS_PREPARE_INFO *pPrepare, PGresult *pgResult);
 SQLRETURN libpqExecuteDeallocateCommand(RS_STMT_INFO *pStmt, int iLockRequired, int calledFromDrop);
+void libpqReleaseMultiInsertBatches(RS_STMT_INFO *pStmt);
 void initLibpq(FILE    *fpTrace);
 void uninitLibpq();
 
@@ -661,6 +661,12 @@ SQLRETURN  SQL_API RsOptions::RS_SQLGetConnectAttr(SQLHDBC phdbc,
             break;
         }
 
+        case SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE:
+        {
+            *piVal = pConnAttr->iAsyncDbcFunctionsEnable;
+            break;
+        }
+
         default:
         {
             rc = SQL_ERROR;
@@ -938,6 +944,36 @@ SQLRETURN  SQL_API RsOptions::RS_SQLGetStmtAttr(SQLHSTMT        phstmt,
             break;
         }
 
+        case SQL_ATTR_RS_ARROW_BATCH_ROWS:
+        {
+            *piVal = pStmtAttr->iArrowBatchRows;
+            break;
+        }
+
+        case SQL_ATTR_ASYNC_STMT_EVENT:
+        {
+            *(void **)pValue = pStmtAttr->hAsyncEvent;
+            if(pcbLen)
+                *pcbLen = sizeof(void *);
+            break;
+        }
+
+        case SQL_ATTR_ASYNC_STMT_PCALLBACK:
+        {
+            *(void **)pValue = (void *)pStmtAttr->pAsyncCallback;
+            if(pcbLen)
+                *pcbLen = sizeof(void *);
+            break;
+        }
+
+        case SQL_ATTR_ASYNC_STMT_PCONTEXT:
+        {
+            *(void **)pValue = pStmtAttr->pAsyncContext;
+            if(pcbLen)
+                *pcbLen = sizeof(void *);
+            break;
+        }
+
         case SQL_ATTR_ENABLE_AUTO_IPD:
         default:
         {
@@ -1293,6 +1329,20 @@ SQLRETURN  SQL_API RsOptions::RS_SQLSetConnectAttr(SQLHDBC phdbc,
             break;
         }
 
+        case SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE:
+        {
+            // Connection functions aren't asynchronous. SQLGetInfo(SQL_ASYNC_DBC_FUNCTIONS) says so.
+            if(iVal != SQL_ASYNC_DBC_ENABLE_OFF)
+            {
+                rc = SQL_ERROR;
+                addError(&pConn->pErrorList,"HYC00", "Optional feature not implemented::SQL_ATTR_ASYNC_DBC_FUNCTIONS_ENABLE", 0, NULL);
+                goto error;
+            }
+
+            pConnAttr->iAsyncDbcFunctionsEnable = iVal;
+            break;
+        }
+
         case SQL_ATTR_ANSI_APP:
         /*
         Since we can handle both unicode as well as ANSI, we'll return SQL_ERROR as per
@@ -1685,6 +1735,45 @@ SQLRETURN  SQL_API RsOptions::RS_SQLSetStmtAttr(SQLHSTMT    phstmt,
             break;
         }
 
+        case SQL_ATTR_RS_ARROW_BATCH_ROWS:
+        {
+            if(iVal < 0)
+            {
+                rc = SQL_ERROR;
+                addError(&pStmt->pErrorList,"HY024", "Invalid attribute value", 0, NULL);
+                goto error;
+            }
+
+            pStmtAttr->iArrowBatchRows = iVal;
+            break;
+        }
+
+        case SQL_ATTR_ASYNC_STMT_EVENT:
+        {
+            // Can't change while a function is executing asynchronously
+            if(checkExecutingThread(pStmt) == SQL_STILL_EXECUTING)
+            {
+                rc = SQL_ERROR;
+                addError(&pStmt->pErrorList,"HY010", "Function sequence error", 0, NULL);
+                goto error;
+            }
+
+            pStmtAttr->hAsyncEvent = (HANDLE)pValue;
+            break;
+        }
+
+        case SQL_ATTR_ASYNC_STMT_PCALLBACK:
+        {
+            pStmtAttr->pAsyncCallback = (RS_ASYNC_NOTIFICATION_CALLBACK)pValue;
+            break;
+        }
+
+        case SQL_ATTR_ASYNC_STMT_PCONTEXT:
+        {
+            pStmtAttr->pAsyncContext = pValue;
+            break;
+        }
+
         case SQL_ATTR_ENABLE_AUTO_IPD:
         default:
         {
@@ -0,0 +1,172 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rsparamarena.h"
+
+// Alignment of the allocations
+#define RS_PARAM_ARENA_ALIGN(cbLen)  (((cbLen) + 15) & ~((size_t)15))
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Arena without blocks. First allocation adds one.
+//
+RS_PARAM_ARENA::RS_PARAM_ARENA()
+{
+    pHead = NULL;
+    cbUsed = 0;
+    cbHighWater = 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release the blocks.
+//
+RS_PARAM_ARENA::~RS_PARAM_ARENA()
+{
+    releaseBlocks();
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Allocate from the block being used, or from a new block at least double of it.
+//
+void *RS_PARAM_ARENA::alloc(size_t cbLen)
+{
+    RS_PARAM_ARENA_BLOCK *pBlock = pHead;
+    char *pData;
+
+    cbLen = RS_PARAM_ARENA_ALIGN((cbLen > 0) ? cbLen : 1);
+
+    if(pBlock == NULL || pBlock->cbSize - pBlock->cbUsed < cbLen)
+    {
+        size_t cbSize = (pBlock) ? pBlock->cbSize * 2 : RS_PARAM_ARENA_MIN_BLOCK;
+
+        pBlock = addBlock((cbSize > cbLen) ? cbSize : cbLen);
+        if(pBlock == NULL)
+            return NULL;
+    }
+
+    pData = (char *)pBlock + RS_PARAM_ARENA_ALIGN(sizeof(RS_PARAM_ARENA_BLOCK)) + pBlock->cbUsed;
+    pBlock->cbUsed += cbLen;
+    cbUsed += cbLen;
+
+    return pData;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Allocate zeroed array.
+//
+void *RS_PARAM_ARENA::calloc(size_t iCount, size_t cbLen)
+{
+    void *pData;
+
+    if(cbLen > 0 && iCount > ((size_t)-1) / cbLen)
+        return NULL;
+
+    pData = alloc(iCount * cbLen);
+    if(pData)
+        memset(pData, '\0', iCount * cbLen);
+
+    return pData;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Reset the arena. More than one block is replaced by one block of the bytes used, and a block much
+// larger than the bytes used is released.
+//
+void RS_PARAM_ARENA::reset()
+{
+    if(pHead)
+    {
+        if(pHead->pNext != NULL
+            || (pHead->cbSize > RS_PARAM_ARENA_MAX_IDLE_BLOCK && cbUsed < pHead->cbSize / 4))
+        {
+            releaseBlocks();
+
+            if(cbUsed > 0)
+                addBlock((cbUsed > RS_PARAM_ARENA_MIN_BLOCK) ? cbUsed : RS_PARAM_ARENA_MIN_BLOCK);
+        }
+        else
+            pHead->cbUsed = 0;
+    }
+
+    cbHighWater = cbUsed;
+    cbUsed = 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Bytes of the blocks.
+//
+size_t RS_PARAM_ARENA::getBlockBytes()
+{
+    size_t cbBytes = 0;
+
+    for(RS_PARAM_ARENA_BLOCK *pBlock = pHead; pBlock != NULL; pBlock = pBlock->pNext)
+        cbBytes += pBlock->cbSize;
+
+    return cbBytes;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Bytes used at the last reset.
+//
+size_t RS_PARAM_ARENA::getHighWaterMark()
+{
+    return cbHighWater;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Add block of the size in front of the blocks.
+//
+RS_PARAM_ARENA::RS_PARAM_ARENA_BLOCK *RS_PARAM_ARENA::addBlock(size_t cbSize)
+{
+    RS_PARAM_ARENA_BLOCK *pBlock;
+
+    cbSize = RS_PARAM_ARENA_ALIGN(cbSize);
+
+    pBlock = (RS_PARAM_ARENA_BLOCK *)rs_malloc(RS_PARAM_ARENA_ALIGN(sizeof(RS_PARAM_ARENA_BLOCK)) + cbSize);
+    if(pBlock)
+    {
+        pBlock->pNext = pHead;
+        pBlock->cbSize = cbSize;
+        pBlock->cbUsed = 0;
+        pHead = pBlock;
+    }
+
+    return pBlock;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release all the blocks.
+//
+void RS_PARAM_ARENA::releaseBlocks()
+{
+    while(pHead)
+    {
+        RS_PARAM_ARENA_BLOCK *pNext = pHead->pNext;
+
+        rs_free(pHead);
+        pHead = pNext;
+    }
+}
@@ -0,0 +1,69 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+// Driver specific arena of the parameter buffers of a statement.
+//
+// Bind parameter arrays and the strings of the converted parameter values live only until
+// the values are sent. They are allocated from the arena of the statement, which is reset
+// instead of freed after each send. Blocks of the arena are kept, and a reset after more
+// than one block was used replaces them with one block of the bytes used, so the next
+// execute of the same size doesn't allocate.
+//
+// A block much larger than the bytes used, e.g. after a large data-at-exec value, is
+// released on reset, so a statement doesn't keep it.
+
+#ifdef __cplusplus
+
+#include <stddef.h>
+
+// Bytes of the smallest block
+#define RS_PARAM_ARENA_MIN_BLOCK        4096
+
+// Block larger than it and four times the bytes used is released on reset
+#define RS_PARAM_ARENA_MAX_IDLE_BLOCK   (1024 * 1024)
+
+class RS_PARAM_ARENA
+{
+public:
+
+    RS_PARAM_ARENA();
+    ~RS_PARAM_ARENA();
+
+    // Bytes aligned for any parameter array, or NULL.
+    void *alloc(size_t cbLen);
+
+    // Zeroed array, or NULL.
+    void *calloc(size_t iCount, size_t cbLen);
+
+    // Release all the allocations, keeping the blocks for the next ones.
+    void reset();
+
+    // Bytes of the blocks and bytes used at the last reset.
+    size_t getBlockBytes();
+    size_t getHighWaterMark();
+
+private:
+
+    typedef struct _RS_PARAM_ARENA_BLOCK
+    {
+        struct _RS_PARAM_ARENA_BLOCK *pNext;
+        size_t cbSize;      // Bytes of data after the header
+        size_t cbUsed;
+    } RS_PARAM_ARENA_BLOCK;
+
+    RS_PARAM_ARENA_BLOCK *addBlock(size_t cbSize);
+    void releaseBlocks();
+
+    // Front is the block being used
+    RS_PARAM_ARENA_BLOCK *pHead;
+    size_t cbUsed;          // Bytes allocated since the reset
+    size_t cbHighWater;     // Bytes allocated before the last reset
+};
+
+#endif /* C++ */
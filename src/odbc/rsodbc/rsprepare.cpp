@@ -46,7 +46,6 @@ SQLRETURN SQL_API SQLPrepareW(SQLHSTMT  phstmt,
     char *szCmd = NULL;
     size_t copiedChars = 0, len = 0;
     std::string u8Str;
-    char *pLastBatchMultiInsertCmd = NULL;
 
     if (IS_TRACE_LEVEL_API_CALL())
         TraceSQLPrepareW(FUNC_CALL, 0, phstmt, pwCmd, cchLen);
@@ -117,7 +116,7 @@ SQLRETURN SQL_API SQLPrepareW(SQLHSTMT  phstmt,
     {
         // Look for INSERT command with array binding, which can convert into Multi INSERT
         char *pszMultiInsertCmd = parseForMultiInsertCommand(
-            pStmt, szCmd, SQL_NTS, &pLastBatchMultiInsertCmd);
+            pStmt, szCmd, SQL_NTS);
 
         if(pszMultiInsertCmd)
         {
@@ -127,34 +126,13 @@ SQLRETURN SQL_API SQLPrepareW(SQLHSTMT  phstmt,
                 rs_strncpy(szCmd, pszMultiInsertCmd,len+1);
 
             pszMultiInsertCmd = (char *)rs_free(pszMultiInsertCmd);
-
-            if(pLastBatchMultiInsertCmd)
-            {
-                rc = createLastBatchMultiInsertCmd(pStmt, pLastBatchMultiInsertCmd);
-                pLastBatchMultiInsertCmd = NULL;
-                if (rc == SQL_ERROR) {
-                    return rc;
-                }
-            }
         }
     }
 
     // Replace param markers / ODBC escapes if present
     if (szCmd && *szCmd) {
-        int numPM = ODBCEscapeClauseProcessor::countParamMarkers(
-            pStmt->pCmdBuf->pBuf, SQL_NTS);
-        int numEsc = ODBCEscapeClauseProcessor::countODBCEscapeClauses(
-            pStmt, pStmt->pCmdBuf->pBuf, SQL_NTS);
-        setParamMarkerCount(pStmt, numPM);
-
-        if (numPM > 0 || numEsc > 0) {
-            char *tmp = rs_strdup(pStmt->pCmdBuf->pBuf, SQL_NTS);
-            releasePaStrBuf(pStmt->pCmdBuf);
-            szCmd = (char *)ODBCEscapeClauseProcessor::
-                replaceParamMarkerAndODBCEscapeClause(
-                    pStmt, tmp, SQL_NTS, pStmt->pCmdBuf, numPM, numEsc);
-            tmp = (char *)rs_free(tmp);
-        }
+        szCmd = (char *)ODBCEscapeClauseProcessor::
+            replaceParamMarkerAndODBCEscapeClauseInBuf(pStmt, pStmt->pCmdBuf);
     }
 
     // Final prepare (guard against accidental empties)
@@ -621,7 +599,6 @@ SQLRETURN  SQL_API RsPrepare::RS_SQLPrepare(SQLHSTMT phstmt,
     char *pszCmd;
     char *pszMultiInsertCmd = NULL;
     char *pszUserInsertCmd = NULL;
-    char *pLastBatchMultiInsertCmd = NULL;
 	RS_CONN_INFO *pConn = NULL;
 	int iApiLocked = FALSE;
 
@@ -634,12 +611,12 @@ SQLRETURN  SQL_API RsPrepare::RS_SQLPrepare(SQLHSTMT phstmt,
     // Is thread running?
     if(pStmt->pExecThread)
     {
-        int iPrepare = pStmt->pExecThread->iPrepare;
+        int iPrepare;
 
         rc = checkExecutingThread(pStmt);
         if(rc != SQL_STILL_EXECUTING)
         {
-            waitAndFreeExecThread(pStmt, FALSE);
+            rc = finishExecThread(pStmt, rc, &iPrepare);
             if(iPrepare)
                 return rc;
             else
@@ -706,7 +683,7 @@ SQLRETURN  SQL_API RsPrepare::RS_SQLPrepare(SQLHSTMT phstmt,
 
         // Look for INSERT command with array binding, which can convert into Multi INSERT
         pszMultiInsertCmd = parseForMultiInsertCommand(
-            pStmt, (char *)pCmd, cbLen, &pLastBatchMultiInsertCmd);
+            pStmt, (char *)pCmd, cbLen);
 
         if(!pszMultiInsertCmd)
         {
@@ -721,15 +698,6 @@ SQLRETURN  SQL_API RsPrepare::RS_SQLPrepare(SQLHSTMT phstmt,
                     pStmt, (char *)pszMultiInsertCmd, SQL_NTS, pStmt->pCmdBuf,
                     TRUE);
             pszMultiInsertCmd = (char *)rs_free(pszMultiInsertCmd);
-
-            if(pLastBatchMultiInsertCmd)
-            {
-                rc = createLastBatchMultiInsertCmd(pStmt, pLastBatchMultiInsertCmd);
-                pLastBatchMultiInsertCmd = NULL;
-                if(rc == SQL_ERROR)
-                    goto error;
-
-            }
         }
     }
     else
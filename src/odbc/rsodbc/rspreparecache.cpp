@@ -0,0 +1,245 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rspreparecache.h"
+
+// Prefix of the statement names of the cache. Lower case, because DEALLOCATE folds the name.
+#define RS_PREPARE_CACHE_NAME_PREFIX    "rs_ps_"
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Make the key of a query and its parameter types.
+//
+std::string makePrepareCacheKey(const char *pszCmd, int nParams, const Oid *paramTypes)
+{
+    std::string key = (pszCmd) ? pszCmd : "";
+
+    // Query can't have a NUL, so types can't run into it.
+    key += '\0';
+    key += std::to_string(nParams);
+
+    for(int i = 0; i < nParams; i++)
+    {
+        key += ',';
+        key += std::to_string((paramTypes) ? paramTypes[i] : 0);
+    }
+
+    return key;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Cache of at most the given entries.
+//
+RS_PREPARE_CACHE::RS_PREPARE_CACHE(int _iMaxEntries)
+{
+    iMaxEntries = (_iMaxEntries > 0) ? _iMaxEntries : 1;
+    llLastName = 0;
+    llHits = 0;
+    llMisses = 0;
+    llEvictions = 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Free the entries. Statements on the server are gone with the connection.
+//
+RS_PREPARE_CACHE::~RS_PREPARE_CACHE()
+{
+    for(auto &it : names)
+        freeEntry(it.second);
+
+    names.clear();
+    index.clear();
+    lru.clear();
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Find the statement of the key and copy its descriptions. FALSE means not found.
+//
+int RS_PREPARE_CACHE::find(const std::string &key, std::string &name, PGresult **ppPrepare,
+                           PGresult **ppDescribeParam, PGresult **ppDescribeCol)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = index.find(key);
+    RS_PREPARE_CACHE_ENTRY *pEntry;
+
+    if(found == index.end())
+    {
+        llMisses++;
+        return FALSE;
+    }
+
+    pEntry = *(found->second);
+
+    *ppPrepare = pqCopyDescribeResult(pEntry->pgPrepare);
+    *ppDescribeParam = pqCopyDescribeResult(pEntry->pgDescribeParam);
+    *ppDescribeCol = (pEntry->pgDescribeCol) ? pqCopyDescribeResult(pEntry->pgDescribeCol) : NULL;
+
+    if(*ppPrepare == NULL || *ppDescribeParam == NULL || (pEntry->pgDescribeCol && *ppDescribeCol == NULL))
+    {
+        PQclear(*ppPrepare);
+        PQclear(*ppDescribeParam);
+        PQclear(*ppDescribeCol);
+        *ppPrepare = *ppDescribeParam = *ppDescribeCol = NULL;
+        llMisses++;
+        return FALSE;
+    }
+
+    lru.splice(lru.begin(), lru, found->second);
+    pEntry->iRefs++;
+    name = pEntry->name;
+    llHits++;
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Name for a new statement.
+//
+std::string RS_PREPARE_CACHE::newName()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return RS_PREPARE_CACHE_NAME_PREFIX + std::to_string(++llLastName);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Add a statement prepared under the name, used by the caller. Copies of the descriptions are kept.
+//
+void RS_PREPARE_CACHE::add(const std::string &key, const std::string &name, const PGresult *pPrepare,
+                           const PGresult *pDescribeParam, const PGresult *pDescribeCol,
+                           std::vector<std::string> &deallocateNames)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    RS_PREPARE_CACHE_ENTRY *pEntry = new RS_PREPARE_CACHE_ENTRY();
+
+    pEntry->key = key;
+    pEntry->name = name;
+    pEntry->pgPrepare = pqCopyDescribeResult(pPrepare);
+    pEntry->pgDescribeParam = pqCopyDescribeResult(pDescribeParam);
+    pEntry->pgDescribeCol = (pDescribeCol) ? pqCopyDescribeResult(pDescribeCol) : NULL;
+    pEntry->iRefs = 1;
+    pEntry->iEvicted = FALSE;
+
+    // Entry, which isn't complete or is a second prepare of a key, is only known by its name.
+    if(pEntry->pgPrepare == NULL || pEntry->pgDescribeParam == NULL || (pDescribeCol && pEntry->pgDescribeCol == NULL)
+        || index.find(key) != index.end())
+    {
+        pEntry->iEvicted = TRUE;
+    }
+    else
+    {
+        lru.push_front(pEntry);
+        index[key] = lru.begin();
+    }
+
+    names[name] = pEntry;
+
+    evict(deallocateNames);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release the statement used by the caller.
+//
+int RS_PREPARE_CACHE::release(const std::string &name)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = names.find(name);
+    RS_PREPARE_CACHE_ENTRY *pEntry;
+
+    if(found == names.end())
+        return FALSE;
+
+    pEntry = found->second;
+
+    if(pEntry->iRefs > 0)
+        pEntry->iRefs--;
+
+    if(pEntry->iEvicted && pEntry->iRefs == 0)
+    {
+        names.erase(found);
+        freeEntry(pEntry);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Hits, misses, evictions and entries of the cache. Any pointer can be NULL.
+//
+void RS_PREPARE_CACHE::getStats(long long *pllHits, long long *pllMisses, long long *pllEvictions, long long *pllEntries)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if(pllHits)
+        *pllHits = llHits;
+    if(pllMisses)
+        *pllMisses = llMisses;
+    if(pllEvictions)
+        *pllEvictions = llEvictions;
+    if(pllEntries)
+        *pllEntries = (long long)lru.size();
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Evict least recently used entries over the size. Entries in use are deallocated on last release.
+// Lock must be held.
+//
+void RS_PREPARE_CACHE::evict(std::vector<std::string> &deallocateNames)
+{
+    while((int)lru.size() > iMaxEntries)
+    {
+        RS_PREPARE_CACHE_ENTRY *pEntry = lru.back();
+
+        lru.pop_back();
+        index.erase(pEntry->key);
+        llEvictions++;
+
+        RS_LOG_DEBUG("RSPREPCACHE", "Evict prepared statement %s", pEntry->name.c_str());
+
+        if(pEntry->iRefs > 0)
+            pEntry->iEvicted = TRUE;
+        else
+        {
+            deallocateNames.push_back(pEntry->name);
+            names.erase(pEntry->name);
+            freeEntry(pEntry);
+        }
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Free the entry and its descriptions.
+//
+void RS_PREPARE_CACHE::freeEntry(RS_PREPARE_CACHE_ENTRY *pEntry)
+{
+    PQclear(pEntry->pgPrepare);
+    PQclear(pEntry->pgDescribeParam);
+    PQclear(pEntry->pgDescribeCol);
+    delete pEntry;
+}
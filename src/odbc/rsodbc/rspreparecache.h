@@ -0,0 +1,89 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+// Driver specific server side prepared statement cache.
+//
+// With PreparedStatementCacheSize > 0, statements prepared on a connection stay prepared on
+// the server after SQLPrepare of another query or SQLFreeStmt, under a name of the cache, and
+// SQLPrepare of the same query, with the same parameter types, on any statement of the
+// connection uses them without going to the server. The parameter and column descriptions of
+// the first prepare are kept with the entry.
+//
+// Least recently used entries over the size are deallocated on the server, once no statement
+// uses them. Only a query preparing to a single statement is cached.
+
+#ifdef __cplusplus
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "libpq-fe.h"
+
+std::string makePrepareCacheKey(const char *pszCmd, int nParams, const Oid *paramTypes);
+
+class RS_PREPARE_CACHE
+{
+public:
+
+    RS_PREPARE_CACHE(int _iMaxEntries);
+    ~RS_PREPARE_CACHE();
+
+    // Find the statement of the key. On hit, the entry is used by the caller until release()
+    // and the pp* results are copies of the descriptions, owned by the caller.
+    int find(const std::string &key, std::string &name, PGresult **ppPrepare,
+             PGresult **ppDescribeParam, PGresult **ppDescribeCol);
+
+    // Name for a new statement, unique on the connection.
+    std::string newName();
+
+    // Add a statement prepared under the name. The entry is used by the caller until release().
+    // Names of evicted statements to deallocate on the server are added to deallocateNames.
+    void add(const std::string &key, const std::string &name, const PGresult *pPrepare,
+             const PGresult *pDescribeParam, const PGresult *pDescribeCol,
+             std::vector<std::string> &deallocateNames);
+
+    // Caller no longer uses the statement. Returns TRUE if it has to be deallocated on the
+    // server, because it was evicted while in use.
+    int release(const std::string &name);
+
+    void getStats(long long *pllHits, long long *pllMisses, long long *pllEvictions, long long *pllEntries);
+
+private:
+
+    typedef struct _RS_PREPARE_CACHE_ENTRY
+    {
+        std::string key;
+        std::string name;           // Statement name on the server
+        PGresult *pgPrepare;
+        PGresult *pgDescribeParam;
+        PGresult *pgDescribeCol;    // NULL when the statement returns no rows
+        int iRefs;                  // Statements using it
+        int iEvicted;               // Deallocate on last release
+    } RS_PREPARE_CACHE_ENTRY;
+
+    void evict(std::vector<std::string> &deallocateNames);
+    static void freeEntry(RS_PREPARE_CACHE_ENTRY *pEntry);
+
+    std::mutex lock;
+    int iMaxEntries;
+    long long llLastName;
+
+    // Front is the most recently used. Evicted entries in use are only in the names index.
+    std::list<RS_PREPARE_CACHE_ENTRY *> lru;
+    std::unordered_map<std::string, std::list<RS_PREPARE_CACHE_ENTRY *>::iterator> index;
+    std::unordered_map<std::string, RS_PREPARE_CACHE_ENTRY *> names;
+
+    long long llHits;
+    long long llMisses;
+    long long llEvictions;
+};
+
+#endif /* C++ */
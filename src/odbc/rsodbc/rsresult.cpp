@@ -12,6 +12,7 @@
 #include "rstrace.h"
 #include "rsoptions.h"
 #include "rsmin.h"
+#include "rsbatchfetch.h"
 #include <string>
 
 #ifdef __cplusplus
@@ -491,6 +492,87 @@ SQLRETURN  SQL_API SQLFetch(SQLHSTMT phstmt)
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// RsFetchBatches fetches rowsets into the bound columns and hands each one to the application callback.
+// Handle validation and error list cleanup happen once per call, not once per rowset.
+//
+SQLRETURN SQL_API RsFetchBatches(SQLHSTMT phstmt,
+                                 RS_FETCH_BATCH_CALLBACK pfnCallback,
+                                 SQLPOINTER pCallbackContext,
+                                 SQLULEN *plTotalRows)
+{
+    SQLRETURN rc = SQL_SUCCESS;
+    RS_STMT_INFO *pStmt = (RS_STMT_INFO *)phstmt;
+    SQLULEN lTotalRows = 0;
+    long lBatches = 0;
+    int iWithInfo = FALSE;
+
+    if(plTotalRows)
+        *plTotalRows = 0;
+
+    if(!VALID_HSTMT(phstmt))
+    {
+        rc = SQL_INVALID_HANDLE;
+        goto error;
+    }
+
+    // Clear error list
+    pStmt->pErrorList = clearErrorList(pStmt->pErrorList);
+
+    if(pfnCallback == NULL)
+    {
+        rc = SQL_ERROR;
+        addError(&pStmt->pErrorList,"HY009", "Invalid use of null pointer", 0, NULL);
+        goto error;
+    }
+
+    for(;;)
+    {
+        SQLULEN lRowsFetched = 0;
+
+        rc = RS_STMT_INFO::fetchRowset(pStmt, SQL_FETCH_NEXT, 0, &lRowsFetched);
+
+        if(rc == SQL_SUCCESS_WITH_INFO)
+            iWithInfo = TRUE;
+        else
+        if(rc != SQL_SUCCESS)
+            break;
+
+        if(lRowsFetched == 0)
+        {
+            rc = SQL_NO_DATA;
+            break;
+        }
+
+        lTotalRows += lRowsFetched;
+        lBatches++;
+
+        if(pfnCallback(pCallbackContext, lRowsFetched) != RS_FETCH_BATCH_CONTINUE)
+        {
+            rc = SQL_SUCCESS;
+            break;
+        }
+    }
+
+    // End of result after some rows is not an error for the caller
+    if(rc == SQL_NO_DATA && lTotalRows > 0)
+        rc = SQL_SUCCESS;
+
+    if(rc == SQL_SUCCESS && iWithInfo)
+        rc = SQL_SUCCESS_WITH_INFO;
+
+    if(plTotalRows)
+        *plTotalRows = lTotalRows;
+
+    RS_LOG_DEBUG("RSRES", "RsFetchBatches: batches=%ld rows=%llu rc=%d", lBatches, (unsigned long long)lTotalRows, rc);
+
+error:
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // SQLMoreResults determines whether more results are available on a statement containing SELECT, UPDATE, INSERT, 
 // or DELETE statements and, if so, initializes processing for those results.
@@ -1515,7 +1597,6 @@ SQLRETURN  SQL_API RS_STMT_INFO::RS_SQLFetchScroll(SQLHSTMT phstmt,
 {
     SQLRETURN rc = SQL_SUCCESS;
     RS_STMT_INFO *pStmt = (RS_STMT_INFO *)phstmt;
-    RS_RESULT_INFO *pResult;
 
     if(!VALID_HSTMT(phstmt))
     {
@@ -1534,6 +1615,30 @@ SQLRETURN  SQL_API RS_STMT_INFO::RS_SQLFetchScroll(SQLHSTMT phstmt,
         goto error; 
     }
 
+    rc = RS_STMT_INFO::fetchRowset(pStmt, hFetchOrientation, iFetchOffset, NULL);
+
+error:
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Fetch one rowset into the bound columns. Caller validates the handle and clears the error list.
+// plRowsFetched gets the number of rows put in the rowset.
+//
+SQLRETURN RS_STMT_INFO::fetchRowset(RS_STMT_INFO *pStmt,
+                                    SQLSMALLINT hFetchOrientation,
+                                    SQLLEN iFetchOffset,
+                                    SQLULEN *plRowsFetched)
+{
+    SQLRETURN rc = SQL_SUCCESS;
+    RS_RESULT_INFO *pResult;
+
+    if(plRowsFetched)
+        *plRowsFetched = 0;
+
     pResult = pStmt->pResultHead;
 
     if(pResult)
@@ -1568,61 +1673,9 @@ SQLRETURN  SQL_API RS_STMT_INFO::RS_SQLFetchScroll(SQLHSTMT phstmt,
 
                         if(!iMaxRowsReached)
                         {
-                            // Check for client side cursor
-                            if(pgIsFileCreatedCsc(pResult->pgResult))
-                            {
-                                int iCscError = 0;
-                                int gotRowsFromCsc = pgReadNextBatchOfRowsCsc(pResult->pgResult,&iCscError);
-
-                                if(gotRowsFromCsc)
-                                {
-                                    pResult->iRowOffset += pResult->iNumberOfRowsInMem; // We are discarding some data.
-                                    pResult->iCurRow = -1; // We increment below
-                                    // New #of rows in memory
-                                    pResult->iNumberOfRowsInMem = PQntuples(pResult->pgResult);
-                                }
-
-                                if(iCscError)
-                                {
-                                    rc = SQL_ERROR;
-                                    addCursorIOError(pStmt, pResult, "client side cursor", "CSC read error");
-                                    goto error; 
-                                }
-                            }
-							else
-							if(pStmt->pCscStatementContext 
-								&& isStreamingCursorMode(pStmt)
-								&& !(libpqIsEndOfStreamingCursor(pStmt))
-							)
-							{
-								int iNumberOfRowsInMem = pResult->iNumberOfRowsInMem;
-                                int iError = 0;
-
-								// Read more rows from socket
-								libpqReadNextBatchOfStreamingRows(pStmt, pStmt->pCscStatementContext, pResult->pgResult, pStmt->phdbc->pgConn,&iError, FALSE);
-
-								// Set pResult parameters
-                                // New #of rows in memory
-                                pResult->iNumberOfRowsInMem = PQntuples(pResult->pgResult);
-
-                                if(pResult->iNumberOfRowsInMem == 0 && !iError) {
-                                    RS_LOG_WARN("STRIO", "Streaming cursor: batch read returned 0 rows, rowOffset=%lld",
-                                        (long long)pResult->iRowOffset);
-                                }
-
-								if(pResult->iNumberOfRowsInMem > 0)
-								{
-                                    pResult->iRowOffset += iNumberOfRowsInMem; // We are discarding some data.
-                                    pResult->iCurRow = -1; // We increment below
-								}
-
-                                if(iError)
-                                {
-                                    rc = SQL_ERROR;
-                                    addCursorIOError(pStmt, pResult, "streaming cursor", "Streaming cursor read error");
-                                    goto error; 
-                                }
-							}
+                            rc = RS_RESULT_INFO::readNextBatchOfRows(pStmt, pResult);
+                            if(rc == SQL_ERROR)
+                                goto error; 
                         } // !Max limit
                     } // !Last row in memory
 
@@ -1945,6 +1998,9 @@ SQLRETURN  SQL_API RS_STMT_INFO::RS_SQLFetchScroll(SQLHSTMT phstmt,
             if(lRowFetched > 0)
                 rc = SQL_SUCCESS;
         } 
+
+        if(plRowsFetched && rc != SQL_ERROR)
+            *plRowsFetched = lRowFetched;
     }
     else
     {
@@ -1959,6 +2015,73 @@ error:
 }
 
 
+/*=====================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Replace the rows in memory with the next batch from client side cursor file or streaming cursor socket.
+// Caller must have consumed the current batch. Leaves the result untouched when no more rows available.
+//
+SQLRETURN RS_RESULT_INFO::readNextBatchOfRows(RS_STMT_INFO *pStmt, RS_RESULT_INFO *pResult)
+{
+    SQLRETURN rc = SQL_SUCCESS;
+
+    // Check for client side cursor
+    if(pgIsFileCreatedCsc(pResult->pgResult))
+    {
+        int iCscError = 0;
+        int gotRowsFromCsc = pgReadNextBatchOfRowsCsc(pResult->pgResult,&iCscError);
+
+        if(gotRowsFromCsc)
+        {
+            pResult->iRowOffset += pResult->iNumberOfRowsInMem; // We are discarding some data.
+            pResult->iCurRow = -1; // Caller increments
+            // New #of rows in memory
+            pResult->iNumberOfRowsInMem = PQntuples(pResult->pgResult);
+        }
+
+        if(iCscError)
+        {
+            rc = SQL_ERROR;
+            addCursorIOError(pStmt, pResult, "client side cursor", "CSC read error");
+        }
+    }
+    else
+    if(pStmt->pCscStatementContext
+        && isStreamingCursorMode(pStmt)
+        && !(libpqIsEndOfStreamingCursor(pStmt))
+    )
+    {
+        int iNumberOfRowsInMem = pResult->iNumberOfRowsInMem;
+        int iError = 0;
+
+        // Read more rows from socket
+        libpqReadNextBatchOfStreamingRows(pStmt, pStmt->pCscStatementContext, pResult->pgResult, pStmt->phdbc->pgConn,&iError, FALSE);
+
+        // Set pResult parameters
+        // New #of rows in memory
+        pResult->iNumberOfRowsInMem = PQntuples(pResult->pgResult);
+
+        if(pResult->iNumberOfRowsInMem == 0 && !iError) {
+            RS_LOG_WARN("STRIO", "Streaming cursor: batch read returned 0 rows, rowOffset=%lld",
+                (long long)pResult->iRowOffset);
+        }
+
+        if(pResult->iNumberOfRowsInMem > 0)
+        {
+            pResult->iRowOffset += iNumberOfRowsInMem; // We are discarding some data.
+            pResult->iCurRow = -1; // Caller increments
+        }
+
+        if(iError)
+        {
+            rc = SQL_ERROR;
+            addCursorIOError(pStmt, pResult, "streaming cursor", "Streaming cursor read error");
+        }
+    }
+
+    return rc;
+}
+
 /*=====================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
@@ -0,0 +1,702 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rsresultcache.h"
+
+#include <ctype.h>
+#include <chrono>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Separator of the parts of a key
+#define RS_RESULT_CACHE_KEY_SEP     '\x1f'
+
+// Cached result
+typedef struct _RS_RESULT_CACHE_ENTRY
+{
+    std::string key;
+    std::string server;         // Server and database, for invalidation
+    std::string sql;            // Normalized query, for invalidation
+    PGresult *pgResult;
+    long long llSize;           // Bytes of the result and the key
+    std::chrono::steady_clock::time_point added;
+} RS_RESULT_CACHE_ENTRY;
+
+// LRU cache of the process. Front is the most recently used.
+typedef struct _RS_RESULT_CACHE
+{
+    std::mutex lock;
+    std::list<RS_RESULT_CACHE_ENTRY> lru;
+    std::unordered_map<std::string, std::list<RS_RESULT_CACHE_ENTRY>::iterator> index;
+    long long llBudget;         // Lowest budget asked by a connection
+    long long llUsed;
+    long long llHits;
+    long long llMisses;
+} RS_RESULT_CACHE;
+
+static RS_RESULT_CACHE gResultCache;
+
+// Words, which make a query write.
+static const char *gNotReadOnlyWords[] = {
+    "into", "insert", "update", "delete", "merge", "create", "drop", "alter", "truncate",
+    "grant", "revoke", "copy", "unload", "call", "lock",
+    NULL
+};
+
+// Words without parentheses, which make a query depend on the time it runs.
+static const char *gVolatileWords[] = {
+    "current_date", "current_time", "current_timestamp", "localtime", "localtimestamp", "sysdate",
+    NULL
+};
+
+// Words before '(', which aren't function calls: keywords and types with modifiers.
+static const char *gNotFunctionWords[] = {
+    "select", "from", "where", "and", "or", "not", "in", "exists", "any", "all", "some", "values", "over",
+    "as", "join", "on", "using", "when", "then", "else", "case", "by", "filter", "within", "group", "having",
+    "union", "intersect", "except", "minus", "lateral", "between", "is", "like", "ilike", "similar", "escape",
+    "distinct", "top", "limit", "offset", "with", "array", "row",
+    "numeric", "decimal", "varchar", "char", "character", "varying", "nvarchar", "nchar", "bpchar",
+    "float", "time", "timestamp", "timestamptz", "timetz", "varbyte", "binary",
+    NULL
+};
+
+// Built in functions, which return the same result for the same arguments.
+static const char *gDeterministicFunctions[] = {
+    "count", "sum", "avg", "min", "max", "stddev", "stddev_samp", "stddev_pop", "variance", "var_samp", "var_pop",
+    "median", "listagg", "bool_and", "bool_or", "bit_and", "bit_or", "percentile_cont", "percentile_disc",
+    "row_number", "rank", "dense_rank", "percent_rank", "cume_dist", "ntile", "lag", "lead",
+    "first_value", "last_value", "nth_value", "ratio_to_report",
+    "abs", "ceil", "ceiling", "floor", "round", "trunc", "mod", "power", "pow", "sqrt", "cbrt", "exp", "ln", "log",
+    "sign", "pi", "degrees", "radians", "sin", "cos", "tan", "asin", "acos", "atan", "atan2", "cot",
+    "length", "len", "char_length", "character_length", "octet_length", "lower", "upper", "initcap",
+    "trim", "btrim", "ltrim", "rtrim", "substring", "substr", "left", "right", "replace", "translate", "concat",
+    "repeat", "replicate", "reverse", "lpad", "rpad", "position", "strpos", "charindex", "split_part", "chr", "ascii",
+    "md5", "sha1", "sha2", "func_sha1", "fnv_hash", "checksum", "crc32",
+    "regexp_replace", "regexp_substr", "regexp_count", "regexp_instr", "quote_ident", "quote_literal",
+    "coalesce", "nullif", "nvl", "nvl2", "decode", "greatest", "least", "cast", "convert",
+    "to_char", "to_number", "to_date", "to_timestamp", "date", "date_trunc", "date_part", "datepart", "extract",
+    "dateadd", "datediff", "add_months", "months_between", "last_day",
+    "json_extract_path_text", "json_extract_array_element_text", "json_array_length", "is_valid_json",
+    "is_valid_json_array", "json_parse", "json_serialize",
+    NULL
+};
+
+static void removeEntryResultCache(std::list<RS_RESULT_CACHE_ENTRY>::iterator it);
+static size_t skipQuotedForResultCache(const std::string &sql, size_t i);
+static int isWordInListForResultCache(const std::string &word, const char **ppList);
+static void getWordsForResultCache(const std::string &normalizedSql, std::vector<std::string> &words, int *piMultiStatement,
+                                   std::vector<std::string> *pCalls = NULL);
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// RsInvalidateResultCache removes entries from the result cache of the process.
+//
+SQLRETURN SQL_API RsInvalidateResultCache(SQLHDBC phdbc, SQLCHAR *szSql)
+{
+    RS_CONN_INFO *pConn = (RS_CONN_INFO *)phdbc;
+    std::string sql = (szSql) ? normalizeSqlForResultCache((const char *)szSql) : "";
+
+    if(!VALID_HDBC(phdbc))
+    {
+        invalidateResultCache("", sql);
+        return SQL_SUCCESS;
+    }
+
+    if(pConn->pgConn == NULL)
+        return SQL_INVALID_HANDLE;
+
+    invalidateResultCache(getServerForResultCache(pConn), sql);
+
+    return SQL_SUCCESS;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Normalize the query for the result cache. Comments are removed, white space outside of quotes becomes one space,
+// words outside of quotes become lower case and trailing ';' is removed.
+//
+std::string normalizeSqlForResultCache(const char *pszCmd)
+{
+    std::string sql = (pszCmd) ? pszCmd : "";
+    std::string out;
+    int iSpace = FALSE;
+    size_t i = 0;
+
+    out.reserve(sql.size());
+
+    while(i < sql.size())
+    {
+        char c = sql[i];
+
+        if(c == '-' && i + 1 < sql.size() && sql[i + 1] == '-')
+        {
+            while(i < sql.size() && sql[i] != '\n')
+                i++;
+            iSpace = TRUE;
+        }
+        else
+        if(c == '/' && i + 1 < sql.size() && sql[i + 1] == '*')
+        {
+            size_t end = sql.find("*/", i + 2);
+
+            i = (end == std::string::npos) ? sql.size() : end + 2;
+            iSpace = TRUE;
+        }
+        else
+        if(isspace((unsigned char)c))
+        {
+            iSpace = TRUE;
+            i++;
+        }
+        else
+        {
+            size_t end = skipQuotedForResultCache(sql, i);
+
+            if(iSpace && !out.empty())
+                out += ' ';
+            iSpace = FALSE;
+
+            if(end > i)
+            {
+                // Quoted text stays as it is.
+                out.append(sql, i, end - i);
+                i = end;
+            }
+            else
+            {
+                out += (char)tolower((unsigned char)c);
+                i++;
+            }
+        }
+    }
+
+    while(!out.empty() && (out.back() == ';' || out.back() == ' '))
+        out.pop_back();
+
+    return out;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether the normalized query only reads. It's one SELECT, WITH or VALUES statement without INTO
+// or data changing commands.
+//
+int isReadOnlyForResultCache(const std::string &normalizedSql)
+{
+    std::vector<std::string> words;
+    int iMultiStatement = FALSE;
+
+    getWordsForResultCache(normalizedSql, words, &iMultiStatement);
+
+    if(iMultiStatement || words.empty())
+        return FALSE;
+
+    if(words[0] != "select" && words[0] != "with" && words[0] != "values")
+        return FALSE;
+
+    for(const std::string &word : words)
+    {
+        if(isWordInListForResultCache(word, gNotReadOnlyWords))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether the result of the normalized query depends only on the data and the session settings. Every
+// function it calls must be a known deterministic built in function, so unknown and user defined functions
+// aren't, and it can't use the time of the query or a temporary table (#name) of the session.
+//
+int isDeterministicForResultCache(const std::string &normalizedSql)
+{
+    std::vector<std::string> words;
+    std::vector<std::string> calls;
+    int iMultiStatement = FALSE;
+
+    getWordsForResultCache(normalizedSql, words, &iMultiStatement, &calls);
+
+    for(const std::string &word : words)
+    {
+        if(word[0] == '#' || isWordInListForResultCache(word, gVolatileWords))
+            return FALSE;
+    }
+
+    for(const std::string &call : calls)
+    {
+        if(!isWordInListForResultCache(call, gNotFunctionWords)
+            && !isWordInListForResultCache(call, gDeterministicFunctions))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether the normalized query changes a session setting, like SET search_path.
+//
+int isSessionCommandForResultCache(const std::string &normalizedSql)
+{
+    std::vector<std::string> words;
+    int iMultiStatement = FALSE;
+
+    getWordsForResultCache(normalizedSql, words, &iMultiStatement);
+
+    return (!iMultiStatement && !words.empty() && (words[0] == "set" || words[0] == "reset"));
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Apply the normalized session command to the settings of the connection. A SET replaces the previous SET of the
+// setting, RESET removes it and RESET ALL removes all. SET LOCAL doesn't outlive the transaction, so it's ignored.
+//
+void updateSessionForResultCache(std::map<std::string, std::string> &session, const std::string &normalizedSql)
+{
+    std::vector<std::string> words;
+    int iMultiStatement = FALSE;
+    size_t iName = 1;
+
+    getWordsForResultCache(normalizedSql, words, &iMultiStatement);
+
+    if(iMultiStatement || words.empty() || (words[0] != "set" && words[0] != "reset"))
+        return;
+
+    if(words.size() > iName && words[iName] == "local")
+        return;
+
+    if(words.size() > iName + 1 && words[iName] == "session")
+        iName++;
+
+    if(words[0] == "reset")
+    {
+        if(words.size() <= iName || words[iName] == "all")
+            session.clear();
+        else
+            session.erase(words[iName]);
+    }
+    else
+        session[(words.size() > iName) ? words[iName] : normalizedSql] = normalizedSql;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Make the session settings part of the result cache key.
+//
+std::string getSessionForResultCache(const std::map<std::string, std::string> &session)
+{
+    std::string settings;
+
+    for(const auto &setting : session)
+        settings += setting.second + ";";
+
+    return settings;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether the normalized query may create objects of the session, like a temporary table, which other
+// connections of the user don't see. CREATE of a TEMP or #name object, SELECT INTO and CALL may.
+//
+int isSessionObjectCommandForResultCache(const std::string &normalizedSql)
+{
+    std::vector<std::string> words;
+    int iMultiStatement = FALSE;
+    int iCreate = FALSE;
+    int iInto = FALSE;
+    int iTemp = FALSE;
+
+    getWordsForResultCache(normalizedSql, words, &iMultiStatement);
+
+    if(words.empty())
+        return FALSE;
+
+    for(const std::string &word : words)
+    {
+        if(word == "create")
+            iCreate = TRUE;
+        else
+        if(word == "into")
+            iInto = TRUE;
+        else
+        if(word == "temp" || word == "temporary" || word[0] == '#')
+            iTemp = TRUE;
+    }
+
+    return ((iCreate && iTemp)
+            || (iInto && (words[0] == "select" || words[0] == "with"))
+            || words[0] == "call");
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether the result of the statement can come from or go in the result cache. The query itself is checked
+// by isReadOnlyForResultCache and isDeterministicForResultCache. A connection, which may have created objects of
+// its session, isn't, as the key doesn't tell sessions of the user apart.
+//
+int isStatementEligibleForResultCache(RS_STMT_INFO *pStmt)
+{
+    RS_CONN_INFO *pConn = pStmt->phdbc;
+    RS_DESC_HEADER &pAPDDescHeader = pStmt->pStmtAttr->pAPD->pDescHeader;
+
+    return (pConn->pConnectProps->llResultCacheSize > 0
+            && !pConn->iResultCacheSessionObjects
+            && pConn->pConnAttr->iAutoCommit != SQL_AUTOCOMMIT_OFF
+            && libpqIsTransactionIdle(pConn)
+            && !pStmt->iFunctionCall
+            && pStmt->iNumOfOutOnlyParams == 0
+            && pStmt->iNumOfInOutOnlyParams == 0
+            && !pStmt->iMultiInsert
+            && pAPDDescHeader.lArraySize <= 1
+            && !isStreamingCursorMode(pStmt));
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get server and database of the connection.
+//
+std::string getServerForResultCache(RS_CONN_INFO *pConn)
+{
+    const char *pHost = PQhost(pConn->pgConn);
+    const char *pPort = PQport(pConn->pgConn);
+    const char *pDb = PQdb(pConn->pgConn);
+
+    return std::string((pHost) ? pHost : "") + ":" + ((pPort) ? pPort : "") + "/" + ((pDb) ? pDb : "");
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Make the key of a query. NULL parameter values are different from any string.
+//
+std::string makeResultCacheKey(const std::string &server, const std::string &user, const std::string &session,
+                               const std::string &normalizedSql, int nParams, const char *const *ppParamVals)
+{
+    std::string key;
+
+    key.reserve(server.size() + user.size() + session.size() + normalizedSql.size() + 16);
+    key += server;
+    key += RS_RESULT_CACHE_KEY_SEP;
+    key += user;
+    key += RS_RESULT_CACHE_KEY_SEP;
+    key += session;
+    key += RS_RESULT_CACHE_KEY_SEP;
+    key += normalizedSql;
+
+    for(int i = 0; i < nParams; i++)
+    {
+        key += RS_RESULT_CACHE_KEY_SEP;
+
+        if(ppParamVals == NULL || ppParamVals[i] == NULL)
+            key += 'N';
+        else
+        {
+            key += 'V';
+            key += std::to_string(strlen(ppParamVals[i]));
+            key += ':';
+            key += ppParamVals[i];
+        }
+    }
+
+    return key;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Make the key of a query executing on the connection. Session part has the search_path reported by the server and
+// the last SET of each setting executed on the connection.
+//
+std::string makeResultCacheKeyForConnection(RS_CONN_INFO *pConn, const std::string &normalizedSql,
+                                            int nParams, const char *const *ppParamVals)
+{
+    const char *pUser = PQuser(pConn->pgConn);
+    const char *pSearchPath = libpqParameterStatus(pConn, "search_path");
+    std::string session = std::string((pSearchPath) ? pSearchPath : "") + RS_RESULT_CACHE_KEY_SEP + getSessionForResultCache(pConn->resultCacheSession);
+
+    return makeResultCacheKey(getServerForResultCache(pConn), (pUser) ? pUser : "", session,
+                              normalizedSql, nParams, ppParamVals);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Find the result of the key. Returns a copy of the result, which caller owns, or NULL if it isn't there or it's older
+// than the TTL.
+//
+PGresult *findResultCache(const std::string &key, int iTtlSeconds)
+{
+    std::lock_guard<std::mutex> guard(gResultCache.lock);
+    auto found = gResultCache.index.find(key);
+
+    if(found == gResultCache.index.end())
+    {
+        gResultCache.llMisses++;
+        return NULL;
+    }
+
+    auto it = found->second;
+
+    if(std::chrono::steady_clock::now() - it->added >= std::chrono::seconds(iTtlSeconds))
+    {
+        removeEntryResultCache(it);
+        gResultCache.llMisses++;
+        return NULL;
+    }
+
+    // Most recently used
+    gResultCache.lru.splice(gResultCache.lru.begin(), gResultCache.lru, it);
+    gResultCache.llHits++;
+
+    return PQcopyResult(it->pgResult, PG_COPYRES_ATTRS | PG_COPYRES_TUPLES);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Add a copy of the result for the key. Least recently used results are removed to stay in the budget.
+//
+void addResultCache(const std::string &key, const std::string &server, const std::string &normalizedSql,
+                    PGresult *pgResult, long long llBudget)
+{
+    PGresult *pCopy;
+    long long llSize;
+
+    if(llBudget <= 0 || pgResult == NULL)
+        return;
+
+    pCopy = PQcopyResult(pgResult, PG_COPYRES_ATTRS | PG_COPYRES_TUPLES);
+    if(pCopy == NULL)
+        return;
+
+    llSize = (long long)PQresultMemorySize(pCopy) + (long long)key.size();
+
+    std::lock_guard<std::mutex> guard(gResultCache.lock);
+
+    // Connections can ask for different budgets, so the lowest one stays, like the result memory limit.
+    if(gResultCache.llBudget == 0 || llBudget < gResultCache.llBudget)
+    {
+        gResultCache.llBudget = llBudget;
+
+        while(gResultCache.llUsed > gResultCache.llBudget && !gResultCache.lru.empty())
+            removeEntryResultCache(std::prev(gResultCache.lru.end()));
+    }
+
+    if(llSize > gResultCache.llBudget)
+    {
+        PQclear(pCopy);
+        return;
+    }
+
+    auto found = gResultCache.index.find(key);
+    if(found != gResultCache.index.end())
+        removeEntryResultCache(found->second);
+
+    RS_RESULT_CACHE_ENTRY entry;
+
+    entry.key = key;
+    entry.server = server;
+    entry.sql = normalizedSql;
+    entry.pgResult = pCopy;
+    entry.llSize = llSize;
+    entry.added = std::chrono::steady_clock::now();
+
+    gResultCache.lru.push_front(entry);
+    gResultCache.index[key] = gResultCache.lru.begin();
+    gResultCache.llUsed += llSize;
+
+    while(gResultCache.llUsed > gResultCache.llBudget && !gResultCache.lru.empty())
+        removeEntryResultCache(std::prev(gResultCache.lru.end()));
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Remove results of the server and the query. Empty server means all servers and empty query means all queries.
+//
+void invalidateResultCache(const std::string &server, const std::string &normalizedSql)
+{
+    std::lock_guard<std::mutex> guard(gResultCache.lock);
+    auto it = gResultCache.lru.begin();
+
+    while(it != gResultCache.lru.end())
+    {
+        auto next = std::next(it);
+
+        if((server.empty() || it->server == server)
+            && (normalizedSql.empty() || it->sql == normalizedSql))
+        {
+            removeEntryResultCache(it);
+        }
+
+        it = next;
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get statistics of the result cache.
+//
+void getResultCacheStats(long long *pllHits, long long *pllMisses, long long *pllUsed, long long *pllEntries)
+{
+    std::lock_guard<std::mutex> guard(gResultCache.lock);
+
+    if(pllHits)
+        *pllHits = gResultCache.llHits;
+    if(pllMisses)
+        *pllMisses = gResultCache.llMisses;
+    if(pllUsed)
+        *pllUsed = gResultCache.llUsed;
+    if(pllEntries)
+        *pllEntries = (long long)gResultCache.lru.size();
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Remove an entry. Caller holds the lock.
+//
+static void removeEntryResultCache(std::list<RS_RESULT_CACHE_ENTRY>::iterator it)
+{
+    gResultCache.llUsed -= it->llSize;
+    PQclear(it->pgResult);
+    gResultCache.index.erase(it->key);
+    gResultCache.lru.erase(it);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// If a quoted string, identifier or dollar quoted string starts at i, return the position after it.
+// Otherwise return i.
+//
+static size_t skipQuotedForResultCache(const std::string &sql, size_t i)
+{
+    char c = sql[i];
+
+    if(c == '\'' || c == '"')
+    {
+        size_t j = i + 1;
+
+        while(j < sql.size())
+        {
+            if(c == '\'' && sql[j] == '\\' && j + 1 < sql.size())
+                j += 2;
+            else
+            if(sql[j] == c)
+                return j + 1;
+            else
+                j++;
+        }
+
+        return sql.size();
+    }
+
+    // $tag$...$tag$, but not a parameter marker like $1.
+    if(c == '$' && (i == 0 || !(isalnum((unsigned char)sql[i - 1]) || sql[i - 1] == '_')))
+    {
+        size_t j = i + 1;
+
+        while(j < sql.size() && (isalpha((unsigned char)sql[j]) || sql[j] == '_'))
+            j++;
+
+        if(j < sql.size() && sql[j] == '$')
+        {
+            std::string tag = sql.substr(i, j - i + 1);
+            size_t end = sql.find(tag, j + 1);
+
+            return (end == std::string::npos) ? sql.size() : end + tag.size();
+        }
+    }
+
+    return i;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether the word is in the NULL terminated list.
+//
+static int isWordInListForResultCache(const std::string &word, const char **ppList)
+{
+    for(int i = 0; ppList[i] != NULL; i++)
+    {
+        if(word == ppList[i])
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get words outside of quotes of the normalized query. Sets *piMultiStatement, if there is a ';' outside of quotes.
+// A #name word keeps its '#'. Words followed by '(' also go in *pCalls, if it isn't NULL. A qualified name, like
+// schema.name, goes in as ".name", which no list has.
+//
+static void getWordsForResultCache(const std::string &normalizedSql, std::vector<std::string> &words, int *piMultiStatement,
+                                   std::vector<std::string> *pCalls)
+{
+    size_t i = 0;
+
+    *piMultiStatement = FALSE;
+
+    while(i < normalizedSql.size())
+    {
+        char c = normalizedSql[i];
+        size_t end = skipQuotedForResultCache(normalizedSql, i);
+
+        if(end > i)
+            i = end;
+        else
+        if(isalpha((unsigned char)c) || c == '_'
+            || (c == '#' && i + 1 < normalizedSql.size()
+                && (isalpha((unsigned char)normalizedSql[i + 1]) || normalizedSql[i + 1] == '_')))
+        {
+            size_t start = i;
+            size_t next;
+
+            i++;
+            while(i < normalizedSql.size()
+                    && (isalnum((unsigned char)normalizedSql[i]) || normalizedSql[i] == '_' || normalizedSql[i] == '$'))
+                i++;
+
+            words.push_back(normalizedSql.substr(start, i - start));
+
+            next = (i < normalizedSql.size() && normalizedSql[i] == ' ') ? i + 1 : i;
+            if(pCalls && next < normalizedSql.size() && normalizedSql[next] == '(')
+                pCalls->push_back(((start > 0 && normalizedSql[start - 1] == '.') ? "." : "") + words.back());
+        }
+        else
+        {
+            if(c == ';')
+                *piMultiStatement = TRUE;
+            i++;
+        }
+    }
+}
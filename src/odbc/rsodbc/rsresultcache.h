@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <sql.h>
+
+// Driver specific client side result cache.
+//
+// With ResultCacheSize > 0, results of read only queries are kept in memory and the next
+// execution of the same query, with the same parameter values, on a connection to the same
+// server, database and user, with the same session settings, gets a copy of the result without
+// going to the server. Entries live for ResultCacheTTL seconds of the connection looking them up.
+//
+// Only queries the driver can classify as read only (one SELECT, WITH or VALUES statement,
+// without INTO or data changing commands) and deterministic (calling only known deterministic
+// built in functions, without the time of the query or #name temporary tables) are cached, and
+// only in auto commit mode, outside of a transaction. Results spilled to a client side cursor
+// file and streaming cursor results aren't cached.
+//
+// The key doesn't tell sessions of a user apart, so a connection, which may have created
+// objects of its session (CREATE TEMP, #name, SELECT INTO, CALL), doesn't use the cache until
+// it reconnects.
+//
+// Any other statement executed through the driver invalidates the entries of the database, and
+// the last SET of each setting becomes part of the session settings of the connection, until RESET. Changes made by other
+// clients are seen after the TTL, or after RsInvalidateResultCache.
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* C++ */
+
+// Remove entries from the result cache of the process.
+// phdbc NULL removes all entries. Otherwise entries of the database of the connection are
+// removed, only the ones of the query szSql, if it's not NULL.
+// The connection handle is the driver connection handle (SQLGetInfo(SQL_DRIVER_HDBC) when a
+// driver manager is in use). Returns SQL_SUCCESS or SQL_INVALID_HANDLE.
+SQLRETURN SQL_API RsInvalidateResultCache(SQLHDBC phdbc, SQLCHAR *szSql);
+
+#ifdef __cplusplus
+}
+#endif /* C++ */
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include "libpq-fe.h"
+
+class RS_CONN_INFO;
+class RS_STMT_INFO;
+
+std::string normalizeSqlForResultCache(const char *pszCmd);
+int isReadOnlyForResultCache(const std::string &normalizedSql);
+int isDeterministicForResultCache(const std::string &normalizedSql);
+int isSessionCommandForResultCache(const std::string &normalizedSql);
+void updateSessionForResultCache(std::map<std::string, std::string> &session, const std::string &normalizedSql);
+std::string getSessionForResultCache(const std::map<std::string, std::string> &session);
+int isSessionObjectCommandForResultCache(const std::string &normalizedSql);
+int isStatementEligibleForResultCache(RS_STMT_INFO *pStmt);
+std::string getServerForResultCache(RS_CONN_INFO *pConn);
+std::string makeResultCacheKey(const std::string &server, const std::string &user, const std::string &session,
+                               const std::string &normalizedSql, int nParams, const char *const *ppParamVals);
+std::string makeResultCacheKeyForConnection(RS_CONN_INFO *pConn, const std::string &normalizedSql,
+                                            int nParams, const char *const *ppParamVals);
+
+PGresult *findResultCache(const std::string &key, int iTtlSeconds);
+void addResultCache(const std::string &key, const std::string &server, const std::string &normalizedSql,
+                    PGresult *pgResult, long long llBudget);
+void invalidateResultCache(const std::string &server, const std::string &normalizedSql);
+void getResultCacheStats(long long *pllHits, long long *pllMisses, long long *pllUsed, long long *pllEntries);
+
+#endif /* C++ */
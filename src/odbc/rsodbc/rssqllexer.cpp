@@ -0,0 +1,337 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rssqllexer.h"
+
+// Character classes of the lexer
+#define RS_SQL_CLASS_OTHER      0   // Token of its own, of the type of the character
+#define RS_SQL_CLASS_SPACE      1
+#define RS_SQL_CLASS_WORD       2
+#define RS_SQL_CLASS_QUOTE      3
+#define RS_SQL_CLASS_DASH       4
+#define RS_SQL_CLASS_SLASH      5
+
+typedef struct _RS_SQL_CLASSES
+{
+    unsigned char cls[256];
+    unsigned char type[256];
+
+    _RS_SQL_CLASSES();
+} RS_SQL_CLASSES;
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Class and token type of each character. Bytes of multi byte characters are word characters.
+//
+_RS_SQL_CLASSES::_RS_SQL_CLASSES()
+{
+    for(int c = 0; c < 256; c++)
+    {
+        cls[c] = RS_SQL_CLASS_OTHER;
+        type[c] = RS_SQL_TOKEN_OTHER;
+
+        if(c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f')
+            cls[c] = RS_SQL_CLASS_SPACE;
+        else
+        if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+            || c == '_' || c == '$' || c >= 0x80)
+        {
+            cls[c] = RS_SQL_CLASS_WORD;
+        }
+    }
+
+    cls['\''] = RS_SQL_CLASS_QUOTE;
+    cls['"'] = RS_SQL_CLASS_QUOTE;
+    cls['-'] = RS_SQL_CLASS_DASH;
+    cls['/'] = RS_SQL_CLASS_SLASH;
+
+    type['?'] = RS_SQL_TOKEN_PARAM_MARKER;
+    type['{'] = RS_SQL_TOKEN_ESCAPE_START;
+    type['}'] = RS_SQL_TOKEN_ESCAPE_END;
+    type['('] = RS_SQL_TOKEN_LEFT_PAREN;
+    type[')'] = RS_SQL_TOKEN_RIGHT_PAREN;
+    type[','] = RS_SQL_TOKEN_COMMA;
+    type[';'] = RS_SQL_TOKEN_SEMI_COLON;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Offset after the string or quoted identifier starting at the offset. memchr does the scan,
+// so long literals go at its speed.
+//
+static size_t skipSqlQuote(const char *pData, size_t cbLen, size_t i)
+{
+    char quote = pData[i++];
+
+    while(i < cbLen)
+    {
+        const char *pEnd = (const char *)memchr(pData + i, quote, cbLen - i);
+
+        if(pEnd == NULL)
+            return cbLen;
+
+        // Backslash escapes the next character of a string
+        if(quote == '\'')
+        {
+            const char *pBackslash = (const char *)memchr(pData + i, '\\', pEnd - (pData + i));
+
+            if(pBackslash)
+            {
+                i = (size_t)(pBackslash - pData) + 2;
+                continue;
+            }
+        }
+
+        i = (size_t)(pEnd - pData) + 1;
+
+        // Doubled quote is in the string
+        if(i < cbLen && pData[i] == quote)
+        {
+            i++;
+            continue;
+        }
+
+        return i;
+    }
+
+    return cbLen;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Offset after the comment starting with the / * at the offset, with the comments nested in it.
+//
+static size_t skipSqlBlockComment(const char *pData, size_t cbLen, size_t i)
+{
+    int iDepth = 1;
+
+    i += 2;
+
+    while(i < cbLen)
+    {
+        const char *pStar = (const char *)memchr(pData + i, '*', cbLen - i);
+        size_t j;
+
+        if(pStar == NULL)
+            return cbLen;
+
+        j = (size_t)(pStar - pData);
+
+        if(j > i && pData[j - 1] == '/')
+        {
+            iDepth++;
+            i = j + 1;
+        }
+        else
+        if(j + 1 < cbLen && pData[j + 1] == '/')
+        {
+            i = j + 2;
+
+            if(--iDepth == 0)
+                return i;
+        }
+        else
+            i = j + 1;
+    }
+
+    return cbLen;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Lex the SQL text.
+//
+void lexSql(const char *pData, size_t cbLen, RS_SQL_LEX &lex, int iMaxTokens)
+{
+    static const RS_SQL_CLASSES classes;
+    const unsigned char *pText = (const unsigned char *)pData;
+    size_t i = 0;
+
+    lex.tokens.clear();
+    lex.iParamMarkers = 0;
+    lex.iEscapeClauses = 0;
+
+    if(pData == NULL)
+        return;
+
+    while(i < cbLen)
+    {
+        unsigned char c = pText[i];
+        size_t iStart = i;
+        int iType;
+
+        switch(classes.cls[c])
+        {
+            case RS_SQL_CLASS_SPACE:
+            {
+                for(i++; i < cbLen && classes.cls[pText[i]] == RS_SQL_CLASS_SPACE; i++)
+                    ;
+                continue;
+            }
+
+            case RS_SQL_CLASS_WORD:
+            {
+                for(i++; i < cbLen && classes.cls[pText[i]] == RS_SQL_CLASS_WORD; i++)
+                    ;
+                iType = RS_SQL_TOKEN_WORD;
+                break;
+            }
+
+            case RS_SQL_CLASS_QUOTE:
+            {
+                i = skipSqlQuote(pData, cbLen, i);
+                iType = (c == '\'') ? RS_SQL_TOKEN_STRING : RS_SQL_TOKEN_QUOTED_IDENT;
+                break;
+            }
+
+            case RS_SQL_CLASS_DASH:
+            {
+                if(i + 1 < cbLen && pText[i + 1] == '-')
+                {
+                    const char *pEnd = (const char *)memchr(pData + i + 2, '\n', cbLen - i - 2);
+
+                    i = (pEnd) ? (size_t)(pEnd - pData) + 1 : cbLen;
+                    continue;
+                }
+
+                i++;
+                iType = RS_SQL_TOKEN_OTHER;
+                break;
+            }
+
+            case RS_SQL_CLASS_SLASH:
+            {
+                if(i + 1 < cbLen && pText[i + 1] == '*')
+                {
+                    i = skipSqlBlockComment(pData, cbLen, i);
+                    continue;
+                }
+
+                i++;
+                iType = RS_SQL_TOKEN_OTHER;
+                break;
+            }
+
+            default:
+            {
+                i++;
+                iType = classes.type[c];
+
+                if(iType == RS_SQL_TOKEN_PARAM_MARKER)
+                    lex.iParamMarkers++;
+                else
+                if(iType == RS_SQL_TOKEN_ESCAPE_START)
+                    lex.iEscapeClauses++;
+
+                break;
+            }
+        } // Switch
+
+        if(iMaxTokens != 0)
+        {
+            lex.tokens.push_back({iType, (int)iStart, (int)(i - iStart)});
+
+            if(iMaxTokens > 0 && (int)lex.tokens.size() >= iMaxTokens)
+                break;
+        }
+    } // Loop
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check for any '?' or '{', which SQL without any doesn't need lexing for.
+//
+int hasSqlMarkerOrEscape(const char *pData, size_t cbLen)
+{
+    return (pData
+            && (memchr(pData, '?', cbLen) != NULL
+                || memchr(pData, '{', cbLen) != NULL));
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check the token is the word.
+//
+int isSqlWord(const RS_SQL_LEX &lex, int iToken, const char *pData, const char *pszWord)
+{
+    const RS_SQL_TOKEN *pToken;
+
+    if(iToken < 0 || iToken >= (int)lex.tokens.size())
+        return FALSE;
+
+    pToken = &lex.tokens[iToken];
+
+    return (pToken->iType == RS_SQL_TOKEN_WORD
+            && pToken->iLen == (int)strlen(pszWord)
+            && _strnicmp(pData + pToken->iOffset, pszWord, pToken->iLen) == 0);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Find the word outside parentheses.
+//
+int findSqlWord(const RS_SQL_LEX &lex, const char *pData, const char *pszWord)
+{
+    int iDepth = 0;
+
+    for(int i = 0; i < (int)lex.tokens.size(); i++)
+    {
+        int iType = lex.tokens[i].iType;
+
+        if(iType == RS_SQL_TOKEN_LEFT_PAREN)
+            iDepth++;
+        else
+        if(iType == RS_SQL_TOKEN_RIGHT_PAREN)
+        {
+            if(iDepth > 0)
+                iDepth--;
+        }
+        else
+        if(iDepth == 0 && isSqlWord(lex, i, pData, pszWord))
+            return i;
+    }
+
+    return -1;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Find the ')' of the '('.
+//
+int findSqlMatchingParen(const RS_SQL_LEX &lex, int iLeftParen)
+{
+    int iDepth = 0;
+
+    if(iLeftParen < 0 || iLeftParen >= (int)lex.tokens.size()
+        || lex.tokens[iLeftParen].iType != RS_SQL_TOKEN_LEFT_PAREN)
+    {
+        return -1;
+    }
+
+    for(int i = iLeftParen; i < (int)lex.tokens.size(); i++)
+    {
+        int iType = lex.tokens[i].iType;
+
+        if(iType == RS_SQL_TOKEN_LEFT_PAREN)
+            iDepth++;
+        else
+        if(iType == RS_SQL_TOKEN_RIGHT_PAREN && --iDepth == 0)
+            return i;
+    }
+
+    return -1;
+}
@@ -0,0 +1,70 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+// Driver specific lexer of SQL text.
+//
+// One pass splits the SQL text into tokens, which are offsets into the text, so the
+// parameter marker and ODBC escape clause processing and the multi INSERT conversion agree
+// on what is inside a quote or a comment, and none of them copies or scans the text again.
+//
+// Whitespace and comments aren't tokens. A string, quoted identifier or comment without its
+// end runs to the end of the text. Comments nest, as on the server.
+
+#ifdef __cplusplus
+
+#include <stddef.h>
+#include <vector>
+
+// Token types
+#define RS_SQL_TOKEN_WORD           1   // Keyword, identifier or number
+#define RS_SQL_TOKEN_STRING         2   // '...', with '' and \' in it
+#define RS_SQL_TOKEN_QUOTED_IDENT   3   // "...", with "" in it
+#define RS_SQL_TOKEN_PARAM_MARKER   4   // ?
+#define RS_SQL_TOKEN_ESCAPE_START   5   // {
+#define RS_SQL_TOKEN_ESCAPE_END     6   // }
+#define RS_SQL_TOKEN_LEFT_PAREN     7
+#define RS_SQL_TOKEN_RIGHT_PAREN    8
+#define RS_SQL_TOKEN_COMMA          9
+#define RS_SQL_TOKEN_SEMI_COLON     10
+#define RS_SQL_TOKEN_OTHER          11  // Any other character
+
+// Most tokens to keep, for all of them
+#define RS_SQL_LEX_ALL_TOKENS       -1
+
+typedef struct _RS_SQL_TOKEN
+{
+    int iType;
+    int iOffset;
+    int iLen;
+} RS_SQL_TOKEN;
+
+typedef struct _RS_SQL_LEX
+{
+    std::vector<RS_SQL_TOKEN> tokens;   // Empty when only counted
+    int iParamMarkers;
+    int iEscapeClauses;                 // '{' outside quotes and comments
+} RS_SQL_LEX;
+
+// Lex the SQL text, keeping at most iMaxTokens tokens. With 0 only the counts are set. Lexing
+// stops after the most tokens, and the counts are of the text up to there.
+void lexSql(const char *pData, size_t cbLen, RS_SQL_LEX &lex, int iMaxTokens);
+
+// TRUE if the SQL text has a '?' or '{' anywhere, so it may need the processing.
+int hasSqlMarkerOrEscape(const char *pData, size_t cbLen);
+
+// TRUE if the token is the word, in any case.
+int isSqlWord(const RS_SQL_LEX &lex, int iToken, const char *pData, const char *pszWord);
+
+// Index of the first token of the word outside parentheses, or -1.
+int findSqlWord(const RS_SQL_LEX &lex, const char *pData, const char *pszWord);
+
+// Index of the ')' of the '(' token, or -1.
+int findSqlMatchingParen(const RS_SQL_LEX &lex, int iLeftParen);
+
+#endif /* C++ */
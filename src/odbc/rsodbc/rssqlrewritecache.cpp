@@ -0,0 +1,148 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rssqlrewritecache.h"
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Make the key of the parameter marker and ODBC escape clause processing of the SQL.
+//
+std::string makeSqlRewriteKey(const char *pData, size_t cbLen, int iReplaceParamMarker, int iNoScan)
+{
+    std::string key = "R";
+
+    key += (iReplaceParamMarker) ? '1' : '0';
+    key += (iNoScan) ? '1' : '0';
+    key += '\0';
+    key.append(pData, cbLen);
+
+    return key;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Make the key of the multi INSERT conversion of the INSERT for the array size.
+//
+std::string makeMultiInsertKey(const char *pCmd, size_t cbLen, long lArraySize)
+{
+    std::string key = "M";
+
+    key += std::to_string(lArraySize);
+    key += '\0';
+    key.append(pCmd, cbLen);
+
+    return key;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Cache of at most the given entries and bytes.
+//
+RS_SQL_REWRITE_CACHE::RS_SQL_REWRITE_CACHE(int _iMaxEntries, long long _llMaxBytes)
+{
+    iMaxEntries = (_iMaxEntries > 0) ? _iMaxEntries : 1;
+    llMaxBytes = (_llMaxBytes > 0) ? _llMaxBytes : RS_SQL_REWRITE_CACHE_MAX_BYTES;
+    llBytes = 0;
+    llHits = 0;
+    llMisses = 0;
+    llEvictions = 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Entries still used by a statement are freed by it.
+//
+RS_SQL_REWRITE_CACHE::~RS_SQL_REWRITE_CACHE()
+{
+    index.clear();
+    lru.clear();
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Find the rewrite of the key. NULL means not found.
+//
+std::shared_ptr<const RS_SQL_REWRITE> RS_SQL_REWRITE_CACHE::find(const std::string &key)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = index.find(key);
+
+    if(found == index.end())
+    {
+        llMisses++;
+        return NULL;
+    }
+
+    lru.splice(lru.begin(), lru, found->second);
+    llHits++;
+
+    return found->second->rewrite;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Add the rewrite of the key. Rewrite of more than a quarter of the bytes isn't kept.
+//
+void RS_SQL_REWRITE_CACHE::add(const std::string &key, std::shared_ptr<const RS_SQL_REWRITE> rewrite)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    long long llEntryBytes = (long long)(key.size() + rewrite->sql.size());
+
+    if(llEntryBytes > llMaxBytes / 4 || index.find(key) != index.end())
+        return;
+
+    lru.push_front({key, rewrite, llEntryBytes});
+    index[key] = lru.begin();
+    llBytes += llEntryBytes;
+
+    evict();
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Hits, misses, evictions and bytes of the cache. Any pointer can be NULL.
+//
+void RS_SQL_REWRITE_CACHE::getStats(long long *pllHits, long long *pllMisses, long long *pllEvictions, long long *pllBytes)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if(pllHits)
+        *pllHits = llHits;
+    if(pllMisses)
+        *pllMisses = llMisses;
+    if(pllEvictions)
+        *pllEvictions = llEvictions;
+    if(pllBytes)
+        *pllBytes = llBytes;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Evict least recently used entries over the size. Lock must be held.
+//
+void RS_SQL_REWRITE_CACHE::evict()
+{
+    while((int)lru.size() > iMaxEntries || llBytes > llMaxBytes)
+    {
+        RS_SQL_REWRITE_CACHE_ENTRY &entry = lru.back();
+
+        llBytes -= entry.llBytes;
+        index.erase(entry.key);
+        lru.pop_back();
+        llEvictions++;
+    }
+}
@@ -0,0 +1,83 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+// Driver specific cache of rewritten SQL.
+//
+// Parameter marker and ODBC escape clause processing, and the multi INSERT conversion of an
+// INSERT with array binding, scan and copy the SQL text again on each execute. With
+// SqlRewriteCacheSize > 0, a connection keeps the outcome for the SQL text and the options
+// it depends on, and the same SQL text skips the scans.
+//
+// Least recently used entries over the size, or over RS_SQL_REWRITE_CACHE_MAX_BYTES of the
+// connection, are evicted. Entries are immutable, so a statement can keep using one evicted
+// by another statement.
+
+#ifdef __cplusplus
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Most bytes of SQL text kept by the cache of a connection
+#define RS_SQL_REWRITE_CACHE_MAX_BYTES  (4 * 1024 * 1024)
+
+typedef struct _RS_SQL_REWRITE
+{
+    std::string sql;            // Rewritten SQL or the multi INSERT
+    int iUnchanged;             // Rewritten SQL is the original SQL, sql isn't set
+    int iParamMarkers;
+    int iFunctionCall;          // Has {call} escape clause
+    int iMultiInsert;
+} RS_SQL_REWRITE;
+
+std::string makeSqlRewriteKey(const char *pData, size_t cbLen, int iReplaceParamMarker, int iNoScan);
+std::string makeMultiInsertKey(const char *pCmd, size_t cbLen, long lArraySize);
+
+class RS_SQL_REWRITE_CACHE
+{
+public:
+
+    RS_SQL_REWRITE_CACHE(int _iMaxEntries, long long _llMaxBytes);
+    ~RS_SQL_REWRITE_CACHE();
+
+    // Rewrite of the key, or NULL.
+    std::shared_ptr<const RS_SQL_REWRITE> find(const std::string &key);
+
+    void add(const std::string &key, std::shared_ptr<const RS_SQL_REWRITE> rewrite);
+
+    void getStats(long long *pllHits, long long *pllMisses, long long *pllEvictions, long long *pllBytes);
+
+private:
+
+    typedef struct _RS_SQL_REWRITE_CACHE_ENTRY
+    {
+        std::string key;
+        std::shared_ptr<const RS_SQL_REWRITE> rewrite;
+        long long llBytes;
+    } RS_SQL_REWRITE_CACHE_ENTRY;
+
+    void evict();
+
+    std::mutex lock;
+    int iMaxEntries;
+    long long llMaxBytes;
+    long long llBytes;
+
+    // Front is the most recently used
+    std::list<RS_SQL_REWRITE_CACHE_ENTRY> lru;
+    std::unordered_map<std::string, std::list<RS_SQL_REWRITE_CACHE_ENTRY>::iterator> index;
+
+    long long llHits;
+    long long llMisses;
+    long long llEvictions;
+};
+
+#endif /* C++ */
@@ -3494,6 +3494,41 @@ void RsTrace::TraceSQLCancel(int iCallOrRet,
 
 /*====================================================================================================================================================*/
 
+void RsTrace::TraceSQLCompleteAsync(int iCallOrRet,
+                           SQLRETURN  iRc,
+                           SQLSMALLINT hHandleType,
+                           SQLHANDLE pHandle,
+                           RETCODE *pAsyncRetCode)
+{
+    switch (logWhat(iCallOrRet)) 
+    {
+        case FUNC_CALL:
+        {
+            traceAPICall("SQLCompleteAsync(");
+            traceHandleType(hHandleType);
+            traceHandle("pHandle",pHandle);
+            tracePointer("pAsyncRetCode",pAsyncRetCode);
+            traceClosingBracket();
+
+            break;
+        }
+
+        case FUNC_RETURN:
+        {
+            traceAPICall("SQLCompleteAsync() return %s",getRcString(iRc));
+            if(iRc == SQL_SUCCESS && pAsyncRetCode)
+                traceArg("\t*pAsyncRetCode=%s",getRcString(*pAsyncRetCode));
+            if(!SQL_SUCCEEDED(iRc))
+                traceErrorList(NULL,(hHandleType == SQL_HANDLE_DBC) ? pHandle : NULL,
+                                (hHandleType == SQL_HANDLE_STMT) ? pHandle : NULL,NULL);
+
+            break;
+        }
+    }
+}
+
+/*====================================================================================================================================================*/
+
 void RsTrace::TraceSQLParamData(int iCallOrRet,
                        SQLRETURN  iRc,
                        SQLHSTMT   phstmt,
@@ -7395,6 +7430,15 @@ void TraceSQLCancel(int iCallOrRet, SQLRETURN iRc, SQLHSTMT phstmt) {
     }
 }
 
+void TraceSQLCompleteAsync(int iCallOrRet, SQLRETURN iRc, SQLSMALLINT hHandleType,
+                           SQLHANDLE pHandle, RETCODE *pAsyncRetCode) {
+    if (getRsLoglevel() >= LOG_LEVEL_DEBUG) {
+        RsTrace logger;
+        logger.TraceSQLCompleteAsync(iCallOrRet, iRc, hHandleType, pHandle, pAsyncRetCode);
+        logger.process();
+    }
+}
+
 void TraceSQLParamData(int iCallOrRet, SQLRETURN iRc, SQLHSTMT phstmt,
                        SQLPOINTER *ppValue) {
     if (getRsLoglevel() >= LOG_LEVEL_DEBUG) {
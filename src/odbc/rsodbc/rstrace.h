@@ -332,6 +332,12 @@ public:
                         SQLRETURN  iRc,
                         SQLHSTMT   phstmt);
 
+    void TraceSQLCompleteAsync(int iCallOrRet,
+                               SQLRETURN  iRc,
+                               SQLSMALLINT hHandleType,
+                               SQLHANDLE pHandle,
+                               RETCODE *pAsyncRetCode);
+
     void TraceSQLParamData(int iCallOrRet,
                         SQLRETURN  iRc,
                         SQLHSTMT   phstmt,
@@ -1267,6 +1273,12 @@ void TraceSQLCancel(int iCallOrRet,
                     SQLRETURN  iRc,
                     SQLHSTMT   phstmt);
 
+void TraceSQLCompleteAsync(int iCallOrRet,
+                           SQLRETURN  iRc,
+                           SQLSMALLINT hHandleType,
+                           SQLHANDLE pHandle,
+                           RETCODE *pAsyncRetCode);
+
 void TraceSQLParamData(int iCallOrRet,
                     SQLRETURN  iRc,
                     SQLHSTMT   phstmt,
@@ -15,6 +15,11 @@
 #include "rsexecute.h"
 #include "rsmin.h"
 #include "rsescapeclause.h"
+#include "rshex.h"
+#include "rssqllexer.h"
+#include "rssqlrewritecache.h"
+#include "rsparamarena.h"
+#include "rsworkerpool.h"
 #include <rsversion.h>
 #include <algorithm>
 #include <vector>
@@ -179,7 +184,6 @@ int isEndOfStreamingCursor(void *_pCscStatementContext);
 int isEndOfStreamingCursorQuery(void *_pCscStatementContext);
 int getStreamingCursorBatchNumber(void *_pCscStatementContext);
 void resetStreamingCursorBatchNumber(void *_pCscStatementContext);
-unsigned char hex_to_binary(char in_hex);
 #ifdef __cplusplus
 }
 #endif
@@ -1023,27 +1027,6 @@ SQLRETURN copyBinaryDataBigLen(const char *pSrc, SQLINTEGER iSrcLen, char *pDest
 
 /*====================================================================================================================================================*/
 
-unsigned char hex_to_binary(char in_hex)
-{
-	int temp = toupper(in_hex);
-
-	if ((65 <= temp) && (70 >= temp))
-	{
-		// Convert hex characters "A" to "F".
-		return (unsigned char)(temp - 55);
-	}
-	else if ((48 <= temp) && (57 >= temp))
-	{
-		// Convert hex characters "0" to "9".
-		return (unsigned char)(temp - 48);
-	}
-
-	// Error
-	return 0;
-}
-
-/*====================================================================================================================================================*/
-
 SQLRETURN copyHexToBinaryDataBigLen(const char *pSrc, SQLINTEGER iSrcLen, char *pDest, SQLLEN cbLen, SQLLEN *pcbLen, SQLLEN *cbLenOffset)
 {
 	SQLRETURN rc = SQL_SUCCESS;
@@ -1081,16 +1064,7 @@ SQLRETURN copyHexToBinaryDataBigLen(const char *pSrc, SQLINTEGER iSrcLen, char *
 					rc = SQL_SUCCESS_WITH_INFO;
 				}
 
-				for (int outputIndex = 0; outputIndex < output_len; ++outputIndex)
-				{
-					// 4 higher-order bits
-					unsigned char higherOrder = hex_to_binary(*pSrc++);
-
-					// 4 lower-order bits
-					unsigned char lowerOrder = hex_to_binary(*pSrc++);
-
-					pDest[outputIndex] = ((higherOrder << 4) | lowerOrder);
-				}
+				rsHexDecode(pSrc, output_len, (unsigned char *)pDest);
 			}
 			else
 			{
@@ -1124,7 +1098,6 @@ SQLRETURN copyBinaryToHexDataBigLen(const char *pSrc, SQLINTEGER iSrcLen, char *
 	int len = (pSrc && (iSrcLen != SQL_NULL_DATA))
 		? iSrcLen
 		: 0;
-	const char * hex = "0123456789ABCDEF";
 
 	if (cbLen & 1)
 	{
@@ -1148,12 +1121,7 @@ SQLRETURN copyBinaryToHexDataBigLen(const char *pSrc, SQLINTEGER iSrcLen, char *
 				rc = SQL_SUCCESS_WITH_INFO;
 			}
 
-			for (int outputIndex = 0; outputIndex < output_len; )
-			{
-				pDest[outputIndex++] = hex[(*pSrc >> 4) & 0xF];
-				pDest[outputIndex++] = hex[*pSrc & 0xF];
-				pSrc++;
-			}
+			rsHexEncode((const unsigned char *)pSrc, output_len / 2, pDest);
 
 			pDest[output_len] = '\0'; // Null terminate the data
 		}
@@ -1545,8 +1513,6 @@ SQLRETURN SQL_API copyWBinaryToHexDataBigLen(const char *psrc,
                                              SQLLEN cbLen,
                                              SQLLEN *pcbLen)
 {
-    static const char HEX[] = "0123456789ABCDEF";
-
     const unsigned char* pSrc = (const unsigned char*)psrc;
     const bool hasData = (pSrc && iSrcLen != SQL_NULL_DATA && iSrcLen > 0);
     const size_t inBytes = hasData ? (size_t)iSrcLen : 0u;
@@ -1579,26 +1545,10 @@ SQLRETURN SQL_API copyWBinaryToHexDataBigLen(const char *psrc,
     if (usable & 1u) usable -= 1u;
 
     unsigned char* wp = (unsigned char*)pDest;     // byte writer
-    size_t produced = 0;                            // chars (not bytes)
-
-    auto put_wchar = [&](uint32_t ascii) {
-        if (w == 2) {
-            uint16_t v = (uint16_t)ascii;
-            std::memcpy(wp, &v, 2);
-            wp += 2;
-        } else { // w == 4
-            uint32_t v = ascii;
-            std::memcpy(wp, &v, 4);
-            wp += 4;
-        }
-        ++produced;
-    };
 
-    for (size_t i = 0; i < inBytes && produced + 2u <= usable; ++i) {
-        unsigned v = pSrc[i];
-        put_wchar((uint32_t)HEX[(v >> 4) & 0xF]);
-        put_wchar((uint32_t)HEX[v & 0xF]);
-    }
+    // Two hex chars per input byte
+    rsHexEncodeW(pSrc, usable / 2u, wp, w);
+    wp += usable * w;
 
     // NUL terminator (one wchar)
     if (w == 2) {
@@ -2161,7 +2111,7 @@ SQLRETURN convertSQLDataToCData(RS_STMT_INFO *pStmt, char *pColData,
 							else
 							if (hRsSpecialType == TIMESTAMPTZOID)
 							{
-								char *pTimeZone = libpqParameterStatus(pStmt->phdbc, "TimeZone");
+								char *pTimeZone = libpqSessionTimeZone(pStmt->phdbc);
 								len = timestamp_out(rsVal.llVal, (char *)pBuf, cbLen, pTimeZone);
 							}
 						}
@@ -2476,7 +2426,7 @@ SQLRETURN convertSQLDataToCData(RS_STMT_INFO *pStmt, char *pColData,
 							else
 							if (hRsSpecialType == TIMESTAMPTZOID)
 							{
-								char *pTimeZone = libpqParameterStatus(pStmt->phdbc, "TimeZone");
+								char *pTimeZone = libpqSessionTimeZone(pStmt->phdbc);
 
 								len = timestamp_out_wchar(rsVal.llVal, (SQLWCHAR *)pBuf, cbLen, pTimeZone);
 							}
@@ -2496,7 +2446,7 @@ SQLRETURN convertSQLDataToCData(RS_STMT_INFO *pStmt, char *pColData,
 							else
 							if (hRsSpecialType == TIMESTAMPTZOID)
 							{
-								char *pTimeZone = libpqParameterStatus(pStmt->phdbc, "TimeZone");
+								char *pTimeZone = libpqSessionTimeZone(pStmt->phdbc);
 
 								len = timestamp_out(rsVal.llVal, (char *)tempBuf, sizeof(tempBuf), pTimeZone);
 							}
@@ -3486,14 +3436,7 @@ SQLRETURN convertSQLDataToCData(RS_STMT_INFO *pStmt, char *pColData,
 					}
 					else
 					{
-						SQL_NUMERIC_STRUCT *pnVal = (SQL_NUMERIC_STRUCT *)&(rsVal.nVal);
-						char tempBuf[MAX_TEMP_BUF_LEN];
-						char *pNumData = tempBuf;
-						int num_data_len = sizeof(tempBuf);
-
-						convertScaledIntegerToNumericString(pnVal, pNumData, num_data_len);
-
-						rsVal.dVal = (float)atof(pNumData);
+						rsVal.dVal = convertScaledIntegerToDouble(&(rsVal.nVal));
 					}
 
                     // Now put double into app buf
@@ -3798,7 +3741,7 @@ SQLRETURN convertSQLDataToCData(RS_STMT_INFO *pStmt, char *pColData,
 						}
 						else
 						{
-							char *pTimeZone = libpqParameterStatus(pStmt->phdbc, "TimeZone");
+							char *pTimeZone = libpqSessionTimeZone(pStmt->phdbc);
 							len = timestamp_out(rsVal.llVal, (char *)tempBuf, MAX_TEMP_BUF_LEN, pTimeZone);
 
 							pTemp = tempBuf;
@@ -4935,45 +4878,8 @@ int getRsVal(char *pColData, int iColDataLen, short hSQLType, RS_VALUE  *pRsVal,
 					}
 					else
 					{
-						long long llMsbVal = getInt64FromBinary(pColData, 0);
-						long long llLsbVal;
-						bool is128 = (iColDataLen > 8);
-						SQL_NUMERIC_STRUCT *pnVal = &(pRsVal->nVal);
-						char *pTemp;
-						int len;
-						int i;
-
-						if (is128)
-						{
-							llLsbVal = getInt64FromBinary(pColData, 8);
-
-							pnVal->sign = (llMsbVal > 0) ? 1 : 0;
-						}
-						else
-						{
-							llLsbVal = llMsbVal;
-							llMsbVal = 0L;
-
-							pnVal->sign = (llLsbVal > 0) ? 1 : 0;
-						}
-
-						pnVal->precision = pDescRec->iSize;
-						pnVal->scale = (int)pDescRec->hScale;
-
-						pTemp = (char *)&llLsbVal;
-						len = sizeof(llLsbVal);
-
-						for (i = 0; i < len; i++)
-							pnVal->val[i] = *pTemp++;
-
-						if (is128)
-						{
-							pTemp = (char *)&llMsbVal;
-							len = sizeof(llMsbVal);
-
-							for (i = 0; i < len; i++)
-								pnVal->val[i + 8] = *pTemp++;
-						}
+						// Binary numeric is a 64 or 128 bit scaled integer in network byte order
+						convertBinaryNumericToScaledInteger(pColData, iColDataLen, pDescRec->iSize, (int)pDescRec->hScale, &(pRsVal->nVal));
 					}
                 }
                 else
@@ -8003,6 +7909,24 @@ void printHexSQLWCHR(SQLWCHAR *sqlwchr,
     }
 }
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Allocate buffer of the parameter value, from the arena if any.
+//
+static char *allocBindParamBuf(RS_BIND_PARAM_STR_BUF *pBindParamStrBuf, size_t cbLen)
+{
+    char *pBuf;
+
+    if(pBindParamStrBuf->pArena)
+        return (char *)pBindParamStrBuf->pArena->alloc(cbLen);
+
+    pBuf = (char *)rs_malloc(cbLen);
+    pBindParamStrBuf->iAllocDataLen = (pBuf) ? (int)cbLen : 0;
+
+    return pBuf;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Get parameter value as string from C buffer using given C data type.
 //
@@ -8047,8 +7971,12 @@ char *getParamVal(char *pParamData, SQLLEN iParamDataLen, SQLLEN *plParamDataStr
                     else
                     if(iParamDataLen > 0)
                     {
-                        pBindParamStrBuf->pBuf = rs_strdup(pParamData, iParamDataLen);
-                        pBindParamStrBuf->iAllocDataLen = iParamDataLen;
+                        pBindParamStrBuf->pBuf = allocBindParamBuf(pBindParamStrBuf, iParamDataLen + 1);
+                        if(pBindParamStrBuf->pBuf)
+                        {
+                            memcpy(pBindParamStrBuf->pBuf, pParamData, iParamDataLen);
+                            pBindParamStrBuf->pBuf[iParamDataLen] = '\0';
+                        }
                     }
                     else
                         pBindParamStrBuf->pBuf = NULL;
@@ -8069,7 +7997,7 @@ char *getParamVal(char *pParamData, SQLLEN iParamDataLen, SQLLEN *plParamDataStr
 
                     size_t bufSize = len;
                     pBindParamStrBuf->pBuf =
-                        (char *)rs_malloc(bufSize + charsize);
+                        allocBindParamBuf(pBindParamStrBuf, bufSize + charsize);
                     if (!pBindParamStrBuf->pBuf) {
                         RS_LOG_ERROR("RSUTIL",
                                      "Memory allocation for %zu bytes failed "
@@ -8077,7 +8005,6 @@ char *getParamVal(char *pParamData, SQLLEN iParamDataLen, SQLLEN *plParamDataStr
                                      (bufSize + charsize));
                         return false;
                     }
-                    pBindParamStrBuf->iAllocDataLen = (int)(bufSize + charsize);
                     memcpy(pBindParamStrBuf->pBuf, (char *)utf8Str.c_str(),
                            bufSize);
                     memset((char *)pBindParamStrBuf->pBuf + bufSize, '\0',
@@ -9169,20 +9096,15 @@ RS_DATA_AT_EXEC *allocateAndSetDataAtExec(char *pDataPtr, long lStrLenOrInd)
 {
     RS_DATA_AT_EXEC *pDataAtExec = (RS_DATA_AT_EXEC *) new RS_DATA_AT_EXEC();
 
-    if(pDataAtExec)
+    if(pDataAtExec && lStrLenOrInd != SQL_NULL_DATA)
     {
-        if(lStrLenOrInd == SQL_NULL_DATA)
-        {
-            pDataAtExec->pValue = NULL;
-            pDataAtExec->cbLen  = 0;
-        }
-        else
+        // Empty value, not NULL, even without any data
+        pDataAtExec->pValue = (char *)rs_malloc(RS_DATA_AT_EXEC_MIN_ALLOC);
+        if(pDataAtExec->pValue)
         {
-            pDataAtExec->pValue = rs_strdup(pDataPtr, lStrLenOrInd);
-            if(pDataAtExec->pValue)
-                pDataAtExec->cbLen = strlen(pDataAtExec->pValue);
-            else
-                pDataAtExec->cbLen  = 0;
+            pDataAtExec->pValue[0] = '\0';
+            pDataAtExec->cbAlloc = RS_DATA_AT_EXEC_MIN_ALLOC;
+            pDataAtExec = appendDataAtExec(pDataAtExec, pDataPtr, lStrLenOrInd);
         }
     }
 
@@ -9192,30 +9114,46 @@ RS_DATA_AT_EXEC *allocateAndSetDataAtExec(char *pDataPtr, long lStrLenOrInd)
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Append data-at-exec value.
+// Append data-at-exec value. The buffer at least doubles when it grows, so a value sent in many pieces
+// is copied a few times in all, not once per piece. Length of the piece is used as is, so binary data
+// with NULs in it isn't cut.
 //
 RS_DATA_AT_EXEC *appendDataAtExec(RS_DATA_AT_EXEC *pDataAtExec, char *pDataPtr, long lStrLenOrInd)
 {
-    if(pDataAtExec && pDataPtr)
+    if(pDataAtExec && pDataPtr && lStrLenOrInd != SQL_NULL_DATA)
     {
-        char *pVal = pDataAtExec->pValue;
         SQLLEN cbLen = pDataAtExec->cbLen;
 
         if(lStrLenOrInd == SQL_NTS)
             lStrLenOrInd = (long)strlen(pDataPtr);
 
-        pDataAtExec->pValue = (char *)rs_malloc(cbLen + lStrLenOrInd + 1);
-        if(pDataAtExec->pValue)
+        if(lStrLenOrInd <= 0)
+            return pDataAtExec;
+
+        // Room for the piece and the NUL
+        if(cbLen + lStrLenOrInd + 1 > pDataAtExec->cbAlloc)
         {
-            strncpy(pDataAtExec->pValue, pVal, cbLen);
-            strncpy(pDataAtExec->pValue + cbLen, pDataPtr, lStrLenOrInd);
-            pDataAtExec->cbLen = cbLen + lStrLenOrInd;
-            pDataAtExec->pValue[pDataAtExec->cbLen] = '\0';
+            SQLLEN cbAlloc = (pDataAtExec->cbAlloc > 0) ? pDataAtExec->cbAlloc * 2 : RS_DATA_AT_EXEC_MIN_ALLOC;
+            char *pVal;
+
+            if(cbAlloc < cbLen + lStrLenOrInd + 1)
+                cbAlloc = cbLen + lStrLenOrInd + 1;
+
+            pVal = (char *)rs_malloc(cbAlloc);
+            if(pVal == NULL)
+                return freeDataAtExec(pDataAtExec);
+
+            if(pDataAtExec->pValue)
+                memcpy(pVal, pDataAtExec->pValue, cbLen);
+
+            rs_free(pDataAtExec->pValue);
+            pDataAtExec->pValue = pVal;
+            pDataAtExec->cbAlloc = cbAlloc;
         }
-        else
-            pDataAtExec = NULL;
 
-        pVal = (char *)rs_free(pVal);
+        memcpy(pDataAtExec->pValue + cbLen, pDataPtr, lStrLenOrInd);
+        pDataAtExec->cbLen = cbLen + lStrLenOrInd;
+        pDataAtExec->pValue[pDataAtExec->cbLen] = '\0';
     }
 
     return pDataAtExec;
@@ -9232,6 +9170,7 @@ RS_DATA_AT_EXEC *freeDataAtExec(RS_DATA_AT_EXEC *pDataAtExec)
     {
         pDataAtExec->pValue = (char *)rs_free(pDataAtExec->pValue);
         pDataAtExec->cbLen = 0;
+        pDataAtExec->cbAlloc = 0;
         delete pDataAtExec;
         pDataAtExec = NULL;
     }
@@ -9334,9 +9273,7 @@ void makeItReadyForNewQueryExecution(RS_STMT_INFO *pStmt, int executePrepared, i
         if(iResetMultiInsert)
         {
             pStmt->iMultiInsert = 0;
-            pStmt->iLastBatchMultiInsert = 0;
-            releasePaStrBuf(pStmt->pszLastBatchMultiInsertCmd);
-            pStmt->pszLastBatchMultiInsertCmd = (RS_STR_BUF *)rs_free(pStmt->pszLastBatchMultiInsertCmd);
+            libpqReleaseMultiInsertBatches(pStmt);
         }
     }
 }
@@ -9412,15 +9349,86 @@ void resetCatalogQueryFlag(RS_STMT_INFO *pStmt)
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Set the thread execution status.
+// Worker pool of async execution of the driver, made on first use. It isn't released, so the driver
+// unload doesn't wait for the workers, which exit when idle.
+//
+static RS_WORKER_POOL *getAsyncWorkerPool()
+{
+    static std::once_flag created;
+    static RS_WORKER_POOL *pPool = NULL;
+
+    std::call_once(created, []() {
+        char optionVal[MAX_OPTION_VAL_LEN];
+        int iMaxThreads = RS_ASYNC_WORKER_THREADS_DEFAULT;
+
+        optionVal[0] = '\0';
+        if(readDriverOptionFromIniFile("AsyncWorkerThreads", optionVal, sizeof(optionVal)) && optionVal[0] != '\0')
+            sscanf(optionVal, "%d", &iMaxThreads);
+
+        pPool = new RS_WORKER_POOL(iMaxThreads, RS_WORKER_POOL_IDLE_SECONDS);
+    });
+
+    return pPool;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Queue the async execution of the statement on the worker pool. FALSE means the caller executes it.
 //
-void setThreadExecutionStatus(RS_EXEC_THREAD_INFO *pExecThread, SQLRETURN rc)
+int queueExecThread(RS_STMT_INFO *pStmt, std::function<void()> task)
 {
-    if(pExecThread && pExecThread->hThread)
+    RS_EXEC_THREAD_INFO *pExecThread = pStmt->pExecThread;
+    RS_WORKER_POOL *pPool = getAsyncWorkerPool();
+
+    pExecThread->iQueued = 1;
+
+    if(pPool == NULL || !pPool->submit(std::move(task)))
     {
-        pExecThread->pszCmd = (char *)rs_free(pExecThread->pszCmd);
-        pExecThread->executePrepared = 0;
-        pExecThread->rc = rc;
+        pExecThread->iQueued = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Set the thread execution status and notify the application. The worker doesn't use the statement
+// after the status is set, as the application may free it then.
+//
+void setThreadExecutionStatus(RS_STMT_INFO *pStmt, SQLRETURN rc)
+{
+    RS_EXEC_THREAD_INFO *pExecThread = pStmt->pExecThread;
+
+    if(pExecThread && pExecThread->iQueued)
+    {
+        RS_ASYNC_NOTIFICATION_CALLBACK pAsyncCallback = pStmt->pStmtAttr->pAsyncCallback;
+        SQLPOINTER pAsyncContext = pStmt->pStmtAttr->pAsyncContext;
+#ifdef WIN32
+        HANDLE hAsyncEvent = pStmt->pStmtAttr->hAsyncEvent;
+#endif
+
+        {
+            std::lock_guard<std::mutex> guard(pExecThread->lock);
+
+            pExecThread->pszCmd = (char *)rs_free(pExecThread->pszCmd);
+            pExecThread->executePrepared = 0;
+            pExecThread->rc = rc;
+            pExecThread->iQueued = 0;
+            pExecThread->done.notify_all();
+        }
+
+        // Driver Manager calls the function again on the callback. Without it, the application
+        // waits on the event.
+        if(pAsyncCallback)
+            pAsyncCallback(pAsyncContext, TRUE);
+#ifdef WIN32
+        else
+        if(hAsyncEvent)
+            SetEvent(hAsyncEvent);
+#endif
     }
 }
 
@@ -9435,7 +9443,11 @@ SQLRETURN checkExecutingThread(RS_STMT_INFO *pStmt)
     RS_EXEC_THREAD_INFO *pExecThread = pStmt->pExecThread;
 
     if(pExecThread)
+    {
+        std::lock_guard<std::mutex> guard(pExecThread->lock);
+
         rc = pExecThread->rc;
+    }
     else
         rc = SQL_SUCCESS;
 
@@ -9444,6 +9456,62 @@ SQLRETURN checkExecutingThread(RS_STMT_INFO *pStmt)
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Wait for the executing thread to finish and return its status.
+//
+SQLRETURN waitForExecThread(RS_STMT_INFO *pStmt)
+{
+    RS_EXEC_THREAD_INFO *pExecThread = pStmt->pExecThread;
+
+    if(pExecThread)
+    {
+        std::unique_lock<std::mutex> guard(pExecThread->lock);
+
+        while(pExecThread->iQueued)
+            pExecThread->done.wait(guard);
+
+        return pExecThread->rc;
+    }
+
+    return SQL_SUCCESS;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Finish the completed async operation with its status, whether it is polled or waited for by SQLCompleteAsync.
+// A failed prepare leaves the statement unprepared. An execute from SQLParamData releases the data-at-exec state.
+// Returns the status and sets *piPrepare when the operation was a prepare.
+//
+SQLRETURN finishExecThread(RS_STMT_INFO *pStmt, SQLRETURN rc, int *piPrepare)
+{
+    RS_EXEC_THREAD_INFO *pExecThread = pStmt->pExecThread;
+    int iPrepare = FALSE;
+
+    if(pExecThread)
+    {
+        iPrepare = pExecThread->iPrepare;
+
+        if(pExecThread->iExecFromParamData)
+        {
+            pExecThread->iExecFromParamData = 0;
+            resetAndReleaseDataAtExec(pStmt);
+        }
+
+        waitAndFreeExecThread(pStmt, FALSE);
+
+        if(iPrepare && rc == SQL_ERROR && pStmt->iStatus == RS_PREPARE_STMT)
+            pStmt->iStatus = RS_ALLOCATE_STMT;
+    }
+
+    if(piPrepare)
+        *piPrepare = iPrepare;
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Wait for executing thread to finish and then release resources of it.
 //
@@ -9455,11 +9523,15 @@ void waitAndFreeExecThread(RS_STMT_INFO *pStmt, int iWaitFlag)
     {
         if(iWaitFlag)
         {
-            rsJoinThread(pExecThread->hThread);
+            waitForExecThread(pStmt);
+        }
+        else
+        {
+            // Worker is done with it once the status is set
+            std::lock_guard<std::mutex> guard(pExecThread->lock);
         }
 
         // Free the exec-thread info
-        pExecThread->hThread = (THREAD_HANDLE)(long)NULL;
         pExecThread->pszCmd = (char *)rs_free(pExecThread->pszCmd);
         if (pStmt->pExecThread != NULL) {
           delete pStmt->pExecThread;
@@ -10197,6 +10269,269 @@ void getAuditTrailInfo(SQLHDBC phdbc)
 
 /*=====================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Decode binary NUMERIC (8 or 16 byte big endian two's complement) into scaled integer in little endian mode.
+//
+void convertBinaryNumericToScaledInteger(char *pColData, int iColDataLen, int iPrecision, int iScale, SQL_NUMERIC_STRUCT *pnVal)
+{
+    unsigned long long ullMsbVal;
+    unsigned long long ullLsbVal;
+    int i;
+
+    if (iColDataLen > 8)
+    {
+        ullMsbVal = (unsigned long long)getInt64FromBinary(pColData, 0);
+        ullLsbVal = (unsigned long long)getInt64FromBinary(pColData, 8);
+    }
+    else
+    {
+        ullLsbVal = (unsigned long long)getInt64FromBinary(pColData, 0);
+        ullMsbVal = ((long long)ullLsbVal < 0) ? ~0ULL : 0ULL; // Sign extend
+    }
+
+    pnVal->precision = (SQLCHAR)iPrecision;
+    pnVal->scale = (SQLSCHAR)iScale;
+    pnVal->sign = ((long long)ullMsbVal < 0) ? 0 : 1;
+
+    if (!pnVal->sign)
+    {
+        // SQL_NUMERIC_STRUCT holds magnitude, so negate the two's complement value
+        ullLsbVal = ~ullLsbVal + 1;
+        ullMsbVal = ~ullMsbVal + ((ullLsbVal == 0) ? 1 : 0);
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        pnVal->val[i] = (SQLCHAR)(ullLsbVal >> (8 * i));
+        pnVal->val[i + 8] = (SQLCHAR)(ullMsbVal >> (8 * i));
+    }
+}
+
+/*=====================================================================================*/
+
+#ifdef RS_HAVE_INT128
+
+typedef unsigned __int128 rs_uint128;
+
+#define RS_INT128_MAX_NUMERIC_DIGITS 38
+#define RS_POW10_19 10000000000000000000ULL
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Parse numeric string directly into 128 bit scaled integer.
+// Fraction digits beyond 38 significant digits are rounded half up and the scale is reduced.
+// Returns FALSE when the value needs the arbitrary precision path.
+//
+static int parseNumericStringToInt128(const char *pNumData, SQL_NUMERIC_STRUCT *pnVal)
+{
+    const char *pTemp = pNumData;
+    rs_uint128 mag = 0;
+    int iDigits = 0;
+    int iScale = 0;
+    int iFraction = FALSE;
+    int iDropped = 0;
+    int iRoundUp = FALSE;
+    int sign = 1;
+    int i;
+
+    if(*pTemp == '+')
+        pTemp++;
+    else
+    if(*pTemp == '-')
+    {
+        pTemp++;
+        sign = 0;
+    }
+
+    for(; *pTemp; pTemp++)
+    {
+        if(*pTemp == '.')
+        {
+            if(iFraction)
+                return FALSE;
+            iFraction = TRUE;
+            continue;
+        }
+
+        if(*pTemp < '0' || *pTemp > '9')
+            return FALSE;
+
+        if(iDigits >= RS_INT128_MAX_NUMERIC_DIGITS)
+        {
+            // Integer part doesn't fit in 38 digits
+            if(!iFraction)
+                return FALSE;
+
+            if(iDropped++ == 0)
+                iRoundUp = (*pTemp >= '5');
+            continue;
+        }
+
+        mag = mag * 10 + (*pTemp - '0');
+        iDigits++;
+        if(iFraction)
+            iScale++;
+    }
+
+    if(iDigits == 0)
+        return FALSE;
+
+    if(iRoundUp)
+    {
+        rs_uint128 limit = (rs_uint128)RS_POW10_19 * RS_POW10_19;
+
+        mag++;
+
+        // 99..9 rounded up to 10^38, carry into one more digit
+        if(mag == limit)
+        {
+            if(iScale > 0)
+            {
+                mag /= 10;
+                iScale--;
+            }
+            else
+                iDigits++;
+        }
+    }
+
+    memset(pnVal,0,sizeof(SQL_NUMERIC_STRUCT));
+    pnVal->sign = sign;
+    pnVal->precision = (SQLCHAR)iDigits;
+    pnVal->scale = (SQLSCHAR)iScale;
+
+    for(i = 0; i < SQL_MAX_NUMERIC_LEN; i++)
+        pnVal->val[i] = (SQLCHAR)(mag >> (8 * i));
+
+    return TRUE;
+}
+
+/*=====================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get 128 bit magnitude of scaled integer.
+//
+static rs_uint128 getInt128FromScaledInteger(SQL_NUMERIC_STRUCT *pnVal)
+{
+    rs_uint128 mag = 0;
+    int i;
+
+    for(i = SQL_MAX_NUMERIC_LEN - 1; i >= 0; i--)
+        mag = (mag << 8) | pnVal->val[i];
+
+    return mag;
+}
+
+/*=====================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Format 128 bit scaled integer as numeric string. Output is truncated like snprintf.
+// Returns FALSE when the scale needs the arbitrary precision path.
+//
+static int formatInt128NumericString(SQL_NUMERIC_STRUCT *pnVal, char *pNumData, int num_data_len)
+{
+    rs_uint128 mag = getInt128FromScaledInteger(pnVal);
+    char szDigits[48]; // Reversed digits, at most 39
+    char szBuf[MAX_NUMBER_BUF_LEN + RS_INT128_MAX_NUMERIC_DIGITS];
+    unsigned long long ullChunk[3];
+    int iScale = pnVal->scale;
+    int iDigits = 0;
+    int outputLen = 0;
+    int i;
+
+    if(iScale < 0 || iScale > RS_INT128_MAX_NUMERIC_DIGITS || num_data_len <= 0)
+        return FALSE;
+
+    // Split into 64 bit chunks of 19 digits, so only two 128 bit divisions are needed.
+    ullChunk[0] = (unsigned long long)(mag % RS_POW10_19);
+    mag /= RS_POW10_19;
+    ullChunk[1] = (unsigned long long)(mag % RS_POW10_19);
+    ullChunk[2] = (unsigned long long)(mag / RS_POW10_19);
+
+    for(i = 0; i < 3; i++)
+    {
+        unsigned long long ullVal = ullChunk[i];
+        int iMore = (i == 0) ? (ullChunk[1] || ullChunk[2]) : (i == 1) ? (ullChunk[2] != 0) : FALSE;
+        int iCount = 0;
+
+        while(ullVal || (iMore && iCount < 19))
+        {
+            szDigits[iDigits++] = (char)('0' + ullVal % 10);
+            ullVal /= 10;
+            iCount++;
+        }
+    }
+
+    if(pnVal->sign == 0 && iDigits > 0)
+        szBuf[outputLen++] = '-';
+
+    // Output data before decimal digit
+    if(iDigits <= iScale)
+        szBuf[outputLen++] = '0';
+    else
+    {
+        for(i = iDigits - 1; i >= iScale; i--)
+            szBuf[outputLen++] = szDigits[i];
+    }
+
+    // Output data after decimal digit
+    if(iScale > 0)
+    {
+        szBuf[outputLen++] = '.';
+
+        for(i = iScale - 1; i >= 0; i--)
+            szBuf[outputLen++] = (i < iDigits) ? szDigits[i] : '0';
+    }
+
+    if(outputLen >= num_data_len)
+        outputLen = num_data_len - 1;
+
+    memcpy(pNumData, szBuf, outputLen);
+    pNumData[outputLen] = '\0';
+
+    return TRUE;
+}
+
+#endif // RS_HAVE_INT128
+
+/*=====================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Convert scaled integer in little endian mode to double.
+//
+double convertScaledIntegerToDouble(SQL_NUMERIC_STRUCT *pnVal)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    char szNumData[MAX_TEMP_BUF_LEN];
+    unsigned long long ullVal = 0;
+    int iFitsInMantissa = TRUE;
+    int i;
+
+    for(i = SQL_MAX_NUMERIC_LEN - 1; i >= 0; i--)
+    {
+        if(i >= 7 && pnVal->val[i] != 0)
+        {
+            iFitsInMantissa = FALSE;
+            break;
+        }
+        ullVal = (ullVal << 8) | pnVal->val[i];
+    }
+
+    // Both operands are exact doubles, so a single division is correctly rounded.
+    if(iFitsInMantissa && ullVal < (1ULL << 53) && pnVal->scale >= 0 && pnVal->scale <= 22)
+    {
+        double dVal = (double)ullVal / pow10[pnVal->scale];
+
+        return (pnVal->sign == 0) ? -dVal : dVal;
+    }
+
+    convertScaledIntegerToNumericString(pnVal, szNumData, sizeof(szNumData));
+
+    return atof(szNumData);
+}
+
+/*=====================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Convert character string buffer of numeric to scaled integer in little endian mode.
 //
@@ -10210,6 +10545,11 @@ void convertNumericStringToScaledInteger(char *pNumData, SQL_NUMERIC_STRUCT *pnV
     int i; 
     char *pTemp;
 
+#ifdef RS_HAVE_INT128
+    if(parseNumericStringToInt128(pNumData, pnVal))
+        return;
+#endif
+
     memset(pnVal,0,sizeof(SQL_NUMERIC_STRUCT));
 
     pnVal->sign = 1;
@@ -10333,6 +10673,11 @@ void convertScaledIntegerToNumericString(SQL_NUMERIC_STRUCT *pnVal,char *pNumDat
     long long divisor;
     double final_val;
 
+#ifdef RS_HAVE_INT128
+    if(formatInt128NumericString(pnVal, pNumData, num_data_len))
+        return;
+#endif
+
     if(pnVal->precision < 19)
     {
         for(i=0; i < SQL_MAX_NUMERIC_LEN;i++)
@@ -10723,12 +11068,91 @@ void readCscOptionsForDsnlessConnection(RS_CONNECT_PROPS_INFO *pConnectProps)
         sscanf(optionVal,"%lld",&pConnectProps->llCscThreshold);
     }
 
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("CscSyncWrites", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%d",&pConnectProps->iCscSyncWrites);
+        if((pConnectProps->iCscSyncWrites) && (pConnectProps->iCscSyncWrites != 1))
+            pConnectProps->iCscSyncWrites = 0;
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("CscFileFormat", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%d",&pConnectProps->iCscFileFormat);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("CscCacheSize", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%lld",&pConnectProps->llCscCacheSize);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("ResultMemoryLimit", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%lld",&pConnectProps->llResultMemoryLimit);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("ResultCacheSize", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%lld",&pConnectProps->llResultCacheSize);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("ResultCacheTTL", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%d",&pConnectProps->iResultCacheTtl);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("LazyRowDecode", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%d",&pConnectProps->iLazyRowDecode);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("PreparedStatementCacheSize", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%d",&pConnectProps->iPreparedStatementCacheSize);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("SqlRewriteCacheSize", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%d",&pConnectProps->iSqlRewriteCacheSize);
+    }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("MultiInsertBatchSize", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%lld",&pConnectProps->llMultiInsertBatchSize);
+    }
+
 	optionVal[0] = '\0';
 	readOptions = readDriverOptionFromIniFile("StreamingCursorRows", optionVal, sizeof(optionVal));
     if(readOptions && optionVal[0] != '\0')
     {
         sscanf(optionVal,"%d",&pConnectProps->iStreamingCursorRows);
     }
+
+	optionVal[0] = '\0';
+	readOptions = readDriverOptionFromIniFile("StreamingCursorBatchSize", optionVal, sizeof(optionVal));
+    if(readOptions && optionVal[0] != '\0')
+    {
+        sscanf(optionVal,"%lld",&pConnectProps->llStreamingCursorBatchSize);
+    }
 	if(pConnectProps->iCscEnable)
 		pConnectProps->iStreamingCursorRows = 0;
 	else
@@ -10739,304 +11163,257 @@ void readCscOptionsForDsnlessConnection(RS_CONNECT_PROPS_INFO *pConnectProps)
 
 
 /*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
-// Parse for INSERT command for multi insert conversion. Looking for INSERT...VALUES. If it found INSERT command and successfully convert 
-// INSERT into multi INSERT, it will return new command, otherwise returns NULL.
+// Find the value of INSERT...VALUES(...) for multi insert conversion. Returns parameter markers in the command and offsets of
+// '(' and ')' of the value, or 0 if the command can't be converted.
 //
-char *parseForMultiInsertCommand(RS_STMT_INFO *pStmt, char *pCmd, SQLINTEGER cbLen, char **ppLastBatchMultiInsertCmd)
+static int findMultiInsertValues(char *pCmd, SQLINTEGER cbLen, int *piLeftBracket, int *piRightBracket)
 {
-    char *pMultiInsertCmd = NULL;
-    char *pLastBatchMultiInsertCmd = NULL;
-    RS_CONN_INFO *pConn = pStmt->phdbc;
-    RS_CONNECT_PROPS_INFO *pConnectProps = pConn->pConnectProps;
+    RS_SQL_LEX lex;
+    int iValues;
+    int iLeftBracket;
+    int iRightBracket;
 
-    // Reset the flag for the new command
-    pStmt->iMultiInsert = 0;
-    pStmt->iLastBatchMultiInsert = 0;
+    // INSERT command. Tokens are offsets into it, so it isn't copied.
+    lexSql(pCmd, cbLen, lex, RS_SQL_LEX_ALL_TOKENS);
 
-    if(pConnectProps->iMultiInsertCmdConvertEnable && pCmd)
+    if(!isSqlWord(lex, 0, pCmd, "INSERT")
+        || lex.iParamMarkers <= 0 || lex.iParamMarkers > PADB_MAX_PARAMETERS)
     {
-        int i;
-        char *pToken;
-        int iTokenLen;
-        char *pSrc = pCmd;
+        return 0;
+    }
 
-        cbLen = (INT_LEN(cbLen) == SQL_NTS) ? strlen(pCmd) : cbLen;
-        i = 0;
+    // Look for VALUES outside the brackets, and the bracket of the value after it.
+    iValues = findSqlWord(lex, pCmd, "VALUES");
+    if(iValues < 0 || iValues + 1 >= (int)lex.tokens.size()
+        || lex.tokens[iValues + 1].iType != RS_SQL_TOKEN_LEFT_PAREN)
+    {
+        return 0;
+    }
 
-        // Get first token
-        pToken = getNextTokenForInsertCommand(&pSrc,cbLen,&i,0);
-        if(pToken && (pToken != pSrc))
-        {
-           iTokenLen = (int)(pSrc - pToken);
-
-           if(iTokenLen == strlen("INSERT")
-               && _strnicmp(pToken, "INSERT", iTokenLen) == 0)
-           {
-                // Is it array binding?
-                RS_DESC_HEADER &pAPDDescHeader = pStmt->pStmtAttr->pAPD->pDescHeader;
-
-                // Bind array/single value
-                long lArraySize = (pAPDDescHeader.valid == false || pAPDDescHeader.lArraySize <= 0) ? 1 : pAPDDescHeader.lArraySize;
-
-                // Store insert command the and the respective state
-                if (pCmd != pStmt->pszUserInsertCmd) { // we are re-prepareing
-                    pStmt->resetMultiInsertInfo();
-                    pStmt->pszUserInsertCmd = rs_strdup(pCmd, cbLen);
-                }
-                pStmt->lArraySizeMultiInsert = lArraySize;
-
-                int  iArrayBinding = (lArraySize > 1);
-
-                if(iArrayBinding)
-                {
-                   // INSERT command.
-                   char *pTempCmd = rs_strdup(pCmd, cbLen);
-
-                   if(pTempCmd)
-                   {
-                       int numOfParamMarkers =
-                           ODBCEscapeClauseProcessor::countParamMarkers(
-                               pTempCmd, SQL_NTS);
-
-                       if(numOfParamMarkers > 0 && numOfParamMarkers <= PADB_MAX_PARAMETERS)
-                       {
-                           // Look for VALUES. We may reach to VALUES with more parsing in between tokens.
-                           char *pTemp = findSQLClause(pTempCmd,"VALUES");
-                           char *pLeftBracket = NULL;
-                           char *pRightBracket = NULL;
-
-                           if(pTemp)
-                           {
-                               pSrc = pTemp + strlen("VALUES");
-                               i = (int)(pSrc - pTempCmd);
-
-                               // Get next token to VALUES
-                               pToken = getNextTokenForInsertCommand(&pSrc,cbLen,&i,'(');
-
-                               if(pToken && (*pToken == '('))
-                               {
-                                  pLeftBracket = pToken;
-
-                                  // This should not be multi-value command
-                                  pToken = getNextTokenForInsertCommand(&pSrc,cbLen,&i,')');
-
-                                  if(pToken && (*pToken == ')'))
-                                  {
-                                    pRightBracket = pToken;
-
-                                    // User specified command in MULTI INSERT?
-                                    pToken = getNextTokenForInsertCommand(&pSrc,cbLen,&i,0);
-                                    if(pToken && (*pToken != ',') && (*pToken == '\0' || *pToken == ';'))
-                                    {
-                                        int iLastBatchTotalMultiTuples = 0;
-                                        int iTotalMultiTuples = getTotalMultiTuples(numOfParamMarkers, lArraySize, &iLastBatchTotalMultiTuples);
-
-                                        if(iTotalMultiTuples >= 1)
-                                        {
-                                            int iValueClauseLen = (int)(pRightBracket - pLeftBracket) + 1 + 1; // +1 for ','. '(' and ')' already included.
-                                            int iMultiInsertCmdLen = (int)(cbLen + (int)(iValueClauseLen * iTotalMultiTuples) + 1); 
-                                            int iLastPartLen;
-                                            int iLastBatchMultiInsertCmdLen = (iLastBatchTotalMultiTuples > 0) ? (int)(cbLen + (int)(iValueClauseLen * iLastBatchTotalMultiTuples) + 1) : 0; 
-
-                                            pMultiInsertCmd = (char *)rs_calloc(sizeof(char), iMultiInsertCmdLen);
-                                            if(iLastBatchMultiInsertCmdLen > 0)
-                                            {
-                                                pLastBatchMultiInsertCmd = (char *)rs_calloc(sizeof(char), iLastBatchMultiInsertCmdLen);
-                                            }
-
-                                            if(pMultiInsertCmd)
-                                            {
-                                                int iCount;
-
-                                                // Copy upto first '('
-                                                i =  (int)(pLeftBracket - pTempCmd);
-                                                memcpy(pMultiInsertCmd, pTempCmd,i);
-                                                if(pLastBatchMultiInsertCmd)
-                                                    memcpy(pLastBatchMultiInsertCmd, pTempCmd,i);
-
-                                                // Copy values in the loop for array
-                                                for(iCount = 0;iCount < iTotalMultiTuples; iCount++)
-                                                {
-                                                    if(iCount != 0)
-                                                    {
-                                                        memcpy(pMultiInsertCmd + i,",",1);
-
-                                                        if(pLastBatchMultiInsertCmd  && (iCount < iLastBatchTotalMultiTuples))
-                                                            memcpy(pLastBatchMultiInsertCmd + i,",",1);
-
-                                                        i += 1;
-                                                    }
-
-                                                    memcpy(pMultiInsertCmd + i, pLeftBracket, pRightBracket - pLeftBracket + 1);
-                                                    if(pLastBatchMultiInsertCmd  && (iCount < iLastBatchTotalMultiTuples))
-                                                        memcpy(pLastBatchMultiInsertCmd + i, pLeftBracket, pRightBracket - pLeftBracket + 1);
-                                                    i += ((int)(pRightBracket - pLeftBracket) + 1);
-
-                                                } // Loop
-
-                                                // Copy after ')'. Mostly this should be blanks with or without ';'. 
-                                                iLastPartLen =  (int)(cbLen - ((int)(pRightBracket - pTempCmd) + 1));
-                                                if(iLastPartLen > 0)
-                                                {
-                                                    memcpy(pMultiInsertCmd + i, pRightBracket + 1, iLastPartLen);
-                                                    if(pLastBatchMultiInsertCmd)
-                                                        memcpy(pLastBatchMultiInsertCmd + i, pRightBracket + 1, iLastPartLen);
-                                                }
-
-                                                // Convert INSERT into MULTI INSERT
-                                                pStmt->iMultiInsert = iTotalMultiTuples;
-                                                pStmt->iLastBatchMultiInsert = iLastBatchTotalMultiTuples;
-                                            } // Allocated?
-                                        } // multi-tuple>1
-
-                                    } // User specified command in MULTI INSERT
-                                  } // Right bracket
-                               } // Left bracket
-                           } // VALUES
-                       } // #Params
-
-                       pTempCmd = (char *)rs_free(pTempCmd);
-
-                   } // Temp CMD
-                } // ARRAY binding
-           } // INSERT
-           else {
-                // Remove previous traces, if any.
-                pStmt->resetMultiInsertInfo();
-           }
-        }
+    iLeftBracket = iValues + 1;
+    iRightBracket = findSqlMatchingParen(lex, iLeftBracket);
+
+    // This should not be multi-value command. User specified command in MULTI INSERT?
+    if(iRightBracket < 0
+        || (iRightBracket + 1 < (int)lex.tokens.size()
+            && lex.tokens[iRightBracket + 1].iType != RS_SQL_TOKEN_SEMI_COLON))
+    {
+        return 0;
     }
 
-    if(ppLastBatchMultiInsertCmd)
-        *ppLastBatchMultiInsertCmd = pLastBatchMultiInsertCmd;
+    *piLeftBracket = lex.tokens[iLeftBracket].iOffset;
+    *piRightBracket = lex.tokens[iRightBracket].iOffset;
 
-    return pMultiInsertCmd;
+    return lex.iParamMarkers;
 }
 
-/*=====================================================================================*/
+/*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Get next token for INSERT command
+// Build the multi INSERT of the given rows from the INSERT and offsets of '(' and ')' of its value.
 //
-char *getNextTokenForInsertCommand(char **ppSrc, size_t cbLen, int *pi, char token)
+static char *buildMultiInsertCmd(char *pCmd, SQLINTEGER cbLen, int iLeftBracket, int iRightBracket, int iRows)
 {
-    char *pToken = NULL;
-    char *pSrc = *ppSrc;
-    int i = *pi;
-    int iQuote = 0;
-    int iBracket = 0; // Increment on '(' and decrement on ')'.
-    char cPrevChar = 0;
+    int iValueLen = iRightBracket - iLeftBracket + 1;
+    size_t i;
+    int iCount;
+    char *pMultiInsertCmd = (char *)rs_calloc(sizeof(char), cbLen + (size_t)(iValueLen + 1) * iRows + 1);
+
+    if(pMultiInsertCmd == NULL)
+        return NULL;
 
+    // Copy upto first '('
+    i = iLeftBracket;
+    memcpy(pMultiInsertCmd, pCmd, i);
 
-    // Trim leading space 
-    while(isspace(*pSrc) && *pSrc && (i < (int)cbLen))
+    // Copy values in the loop for array
+    for(iCount = 0;iCount < iRows; iCount++)
     {
-         pSrc++; 
-         i++;
-    }
+        if(iCount != 0)
+            pMultiInsertCmd[i++] = ',';
+
+        memcpy(pMultiInsertCmd + i, pCmd + iLeftBracket, iValueLen);
+        i += iValueLen;
+    } // Loop
+
+    // Copy after ')'. Mostly this should be blanks with or without ';'.
+    memcpy(pMultiInsertCmd + i, pCmd + iRightBracket + 1, cbLen - (iRightBracket + 1));
+
+    return pMultiInsertCmd;
+}
 
-    // Get the second token
-    if(!token)
-        pToken = pSrc;
+/*====================================================================================================================================================*/
 
-    while(*pSrc && (i < (int)cbLen))
+//---------------------------------------------------------------------------------------------------------igarish
+// Parse for INSERT command for multi insert conversion. Looking for INSERT...VALUES. If it found INSERT command and successfully convert 
+// INSERT into multi INSERT, it will return new command, otherwise returns NULL.
+//
+char *parseForMultiInsertCommand(RS_STMT_INFO *pStmt, char *pCmd, SQLINTEGER cbLen)
+{
+    char *pMultiInsertCmd = NULL;
+    RS_CONN_INFO *pConn = pStmt->phdbc;
+    RS_CONNECT_PROPS_INFO *pConnectProps = pConn->pConnectProps;
+
+    // Reset the flag for the new command
+    pStmt->iMultiInsert = 0;
+
+    if(pConnectProps->iMultiInsertCmdConvertEnable && pCmd)
     {
-        // Looking for a specific token?
-        if(token) 
+        RS_SQL_LEX lex;
+
+        cbLen = (INT_LEN(cbLen) == SQL_NTS) ? strlen(pCmd) : cbLen;
+
+        // Get first token
+        lexSql(pCmd, cbLen, lex, 1);
+
+        if(isSqlWord(lex, 0, pCmd, "INSERT"))
         {
-            if(*pSrc == SINGLE_QUOTE && (cPrevChar == 0 || cPrevChar != '\\'))
+            // Is it array binding?
+            RS_DESC_HEADER &pAPDDescHeader = pStmt->pStmtAttr->pAPD->pDescHeader;
+
+            // Bind array/single value
+            long lArraySize = (pAPDDescHeader.valid == false || pAPDDescHeader.lArraySize <= 0) ? 1 : pAPDDescHeader.lArraySize;
+
+            // Store insert command the and the respective state
+            if (pCmd != pStmt->pszUserInsertCmd) { // we are re-prepareing
+                pStmt->resetMultiInsertInfo();
+                pStmt->pszUserInsertCmd = rs_strdup(pCmd, cbLen);
+            }
+            pStmt->lArraySizeMultiInsert = lArraySize;
+
+            int  iArrayBinding = (lArraySize > 1);
+            RS_SQL_REWRITE_CACHE *pCache = (iArrayBinding) ? pConn->pSqlRewriteCache : NULL;
+            std::shared_ptr<const RS_SQL_REWRITE> rewrite;
+            std::string key;
+
+            // Same INSERT converted for the array size before
+            if(pCache)
             {
-                if(iQuote)
-                    iQuote--;
-                else
-                    iQuote++;
+                key = makeMultiInsertKey(pCmd, cbLen, lArraySize);
+                rewrite = pCache->find(key);
             }
-            else
-            if(*pSrc == '(' && token == ')' && !iQuote)
+
+            if(rewrite)
             {
-                iBracket++;
+                pMultiInsertCmd = rs_strdup(rewrite->sql.c_str(), SQL_NTS);
+
+                if(pMultiInsertCmd)
+                    pStmt->iMultiInsert = rewrite->iMultiInsert;
             }
             else
-            if(*pSrc == ')' && token == ')' && !iQuote)
+            if(iArrayBinding)
             {
-                if(iBracket)
+                int iLeftBracket;
+                int iRightBracket;
+                int numOfParamMarkers = findMultiInsertValues(pCmd, cbLen, &iLeftBracket, &iRightBracket);
+
+                if(numOfParamMarkers > 0)
                 {
-                    iBracket--;
+                    int iValueClauseLen = (iRightBracket - iLeftBracket) + 1 + 1; // +1 for ','. '(' and ')' already included.
+                    int iTotalMultiTuples = getTotalMultiTuples(numOfParamMarkers, iValueClauseLen, lArraySize,
+                                                                pConnectProps->llMultiInsertBatchSize * 1024);
 
-                    if(token)
-                        cPrevChar = *pSrc;
+                    pMultiInsertCmd = buildMultiInsertCmd(pCmd, cbLen, iLeftBracket, iRightBracket, iTotalMultiTuples);
 
-                     pSrc++; 
-                     i++;
+                    // Convert INSERT into MULTI INSERT
+                    if(pMultiInsertCmd)
+                        pStmt->iMultiInsert = iTotalMultiTuples;
+                } // User specified command in MULTI INSERT
+
+                if(pCache && pMultiInsertCmd && pStmt->iMultiInsert)
+                {
+                    std::shared_ptr<RS_SQL_REWRITE> multiInsert = std::make_shared<RS_SQL_REWRITE>();
 
-                    continue;
+                    multiInsert->sql = pMultiInsertCmd;
+                    multiInsert->iUnchanged = FALSE;
+                    multiInsert->iParamMarkers = 0;
+                    multiInsert->iFunctionCall = FALSE;
+                    multiInsert->iMultiInsert = pStmt->iMultiInsert;
+
+                    pCache->add(key, multiInsert);
                 }
-            }
+            } // ARRAY binding
+        } // INSERT
+        else {
+            // Remove previous traces, if any.
+            pStmt->resetMultiInsertInfo();
+        }
+    }
 
-            if(*pSrc == token && !iQuote && !iBracket)
-            {
-                pToken = pSrc;
-                pSrc++; 
-                i++;
+    return pMultiInsertCmd;
+}
 
-                break;
-            }
-            else
-            if(*pSrc == SEMI_COLON && !iQuote)
-                break;
+/*====================================================================================================================================================*/
 
-        }
-        else
-        if(isspace(*pSrc) || (*pSrc == SEMI_COLON))
-            break;
+//---------------------------------------------------------------------------------------------------------igarish
+// Make the multi INSERT of the given rows from the INSERT. Returns NULL if the INSERT can't be converted.
+//
+char *makeMultiInsertCmd(char *pCmd, SQLINTEGER cbLen, int iRows)
+{
+    int iLeftBracket;
+    int iRightBracket;
 
-        if(token)
-            cPrevChar = *pSrc;
+    if(pCmd == NULL || iRows < 1)
+        return NULL;
 
-         pSrc++; 
-         i++;
-    } // Loop
+    cbLen = (INT_LEN(cbLen) == SQL_NTS) ? strlen(pCmd) : cbLen;
 
-    // Update the output var
-    *ppSrc = pSrc;
-    *pi = i;
+    if(findMultiInsertValues(pCmd, cbLen, &iLeftBracket, &iRightBracket) == 0)
+        return NULL;
 
-    return pToken;
+    return buildMultiInsertCmd(pCmd, cbLen, iLeftBracket, iRightBracket, iRows);
 }
 
 /*=====================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Calculate total multi tuples because limitations of MAX params.
+// Calculate total multi tuples because limitations of MAX params and of the statement size.
 //
-int getTotalMultiTuples(int numOfParamMarkers, long lArraySize, int *piLastBatchTotalMultiTuples)
+int getTotalMultiTuples(int numOfParamMarkers, int iValueClauseLen, long lArraySize, long long llMaxBytes)
 {
-    int iTotalMultiTuples = (int)lArraySize;
-    long lTotalParams = numOfParamMarkers * lArraySize;
-    int iLastBatchTotalMultiTuples = 0;
+    long lTotalMultiTuples = lArraySize;
 
-    if(lTotalParams > PADB_MAX_PARAMETERS)
-    {
-        int iLoopCount;
-        int iMaxParamsPerBatch;
+    if(numOfParamMarkers > 0 && (long long)numOfParamMarkers * lArraySize > PADB_MAX_PARAMETERS)
+        lTotalMultiTuples = PADB_MAX_PARAMETERS/numOfParamMarkers;
 
-        iTotalMultiTuples = PADB_MAX_PARAMETERS/numOfParamMarkers;
-        iMaxParamsPerBatch = (numOfParamMarkers * iTotalMultiTuples);
-        iLoopCount = lTotalParams/iMaxParamsPerBatch;
-        iLastBatchTotalMultiTuples = lArraySize - (iTotalMultiTuples * iLoopCount);
-    }
+    if(iValueClauseLen > 0 && llMaxBytes > 0 && (long long)iValueClauseLen * lTotalMultiTuples > llMaxBytes)
+        lTotalMultiTuples = (long)(llMaxBytes / iValueClauseLen);
 
-    if(piLastBatchTotalMultiTuples)
-        *piLastBatchTotalMultiTuples = iLastBatchTotalMultiTuples;
+    if(lTotalMultiTuples < 1)
+        lTotalMultiTuples = 1;
 
     if(IS_TRACE_ON())
     {
-        RS_LOG_INFO("RSUTIL", "iTotalMultiTuples=%d, numOfParamMarkers=%d, lArraySize=%ld, iLastBatchTotalMultiTuples=%d", 
-                        iTotalMultiTuples, numOfParamMarkers,lArraySize, iLastBatchTotalMultiTuples);
+        RS_LOG_INFO("RSUTIL", "iTotalMultiTuples=%ld, numOfParamMarkers=%d, lArraySize=%ld, iValueClauseLen=%d, llMaxBytes=%lld", 
+                        lTotalMultiTuples, numOfParamMarkers, lArraySize, iValueClauseLen, llMaxBytes);
     }
 
-    return iTotalMultiTuples;
+    return (int)lTotalMultiTuples;
+}
+
+/*=====================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Rows of the next batch of the multi INSERT. Full batch if the rows left and their bytes allow it, otherwise
+// the largest canonical batch that fits, so the tail of an array and wide rows reuse a few prepared statements.
+//
+int getMultiInsertBatchRows(int iMultiInsert, long lRowsLeft, long long llRowBytes, long long llMaxBytes)
+{
+    long lRows = (lRowsLeft < iMultiInsert) ? lRowsLeft : iMultiInsert;
+    int iRows = 1;
+
+    if(llRowBytes > 0 && llMaxBytes > 0 && llRowBytes * lRows > llMaxBytes)
+        lRows = (long)(llMaxBytes / llRowBytes);
+
+    if(lRows >= iMultiInsert)
+        return iMultiInsert;
+
+    while((long)iRows * RS_MULTI_INSERT_BATCH_ROWS_FACTOR <= lRows)
+        iRows *= RS_MULTI_INSERT_BATCH_ROWS_FACTOR;
+
+    return iRows;
 }
 
 /*=====================================================================================*/
@@ -11115,57 +11492,59 @@ int DoesEmbedInDoubleQuotes(char *pStart, char *pEnd)
 /*=====================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Create last batch insert command and store in Stmt
+// Get the multi INSERT batch of the given rows of the statement. It's made from the user INSERT on first use, and kept
+// until the INSERT changes.
 //
-SQLRETURN createLastBatchMultiInsertCmd(RS_STMT_INFO *pStmt, char *pszLastBatchMultiInsertCmd)
+RS_MULTI_INSERT_BATCH *getMultiInsertBatch(RS_STMT_INFO *pStmt, int iRows)
 {
-    SQLRETURN rc = SQL_SUCCESS;
+    RS_MULTI_INSERT_BATCH *pBatch;
+    RS_STR_BUF cmdBuf;
+    char *pszMultiInsertCmd;
     char *pszCmd = NULL;
 
-    if(pStmt && pszLastBatchMultiInsertCmd)
+    for(pBatch = pStmt->pMultiInsertBatchHead; pBatch != NULL; pBatch = pBatch->pNext)
     {
-        if(pStmt->pszLastBatchMultiInsertCmd == NULL)
-            pStmt->pszLastBatchMultiInsertCmd = (RS_STR_BUF *)rs_calloc(1,sizeof(struct _RS_STR_BUF));
+        if(pBatch->iRows == iRows)
+            return pBatch;
+    }
 
-        if(pStmt->pszLastBatchMultiInsertCmd)
-        {
-            pszCmd = (char *)ODBCEscapeClauseProcessor::
-                checkReplaceParamMarkerAndODBCEscapeClause(
-                    NULL, (char *)pszLastBatchMultiInsertCmd, SQL_NTS,
-                    pStmt->pszLastBatchMultiInsertCmd, TRUE);
+    memset(&cmdBuf, 0, sizeof(cmdBuf));
+    pszMultiInsertCmd = makeMultiInsertCmd(pStmt->pszUserInsertCmd, SQL_NTS, iRows);
 
-            if(pszCmd == NULL || pszCmd != pszLastBatchMultiInsertCmd)
-            {
-                pszLastBatchMultiInsertCmd = (char *)rs_free(pszLastBatchMultiInsertCmd);
-            }
-        }
-        else
-        {
-            rc = SQL_ERROR;
-            addError(&pStmt->pErrorList,"HY009", "Couldn't create last batch multi-insert command", 0, NULL);
-        }
+    if(pszMultiInsertCmd)
+    {
+        // Statement options like SQL_ATTR_NOSCAN apply, but its param markers stay those of the full multi INSERT
+        int iParamMarkers = getParamMarkerCount(pStmt);
+
+        pszCmd = (char *)ODBCEscapeClauseProcessor::
+            checkReplaceParamMarkerAndODBCEscapeClause(
+                pStmt, pszMultiInsertCmd, SQL_NTS, &cmdBuf, TRUE);
+
+        setParamMarkerCount(pStmt, iParamMarkers);
     }
 
-    return rc;
-}
+    pBatch = (pszCmd) ? (RS_MULTI_INSERT_BATCH *)rs_calloc(1, sizeof(RS_MULTI_INSERT_BATCH)) : NULL;
 
-/*=====================================================================================*/
+    if(pBatch)
+    {
+        pBatch->pszCmd = rs_strdup(pszCmd, SQL_NTS);
+        if(pBatch->pszCmd == NULL)
+            pBatch = (RS_MULTI_INSERT_BATCH *)rs_free(pBatch);
+    }
 
-//---------------------------------------------------------------------------------------------------------igarish
-// Re-prepare comamnd without storing any info. This is used by last batch multi-insert command.
-//
-SQLRETURN rePrepareMultiInsertCommand(RS_STMT_INFO *pStmt, char *pszCmd)
-{
-    SQLRETURN rc;
+    releasePaStrBuf(&cmdBuf);
+    pszMultiInsertCmd = (char *)rs_free(pszMultiInsertCmd);
 
-    // Release prepared stmt in the server
-    rc = libpqExecuteDeallocateCommand(pStmt, FALSE, FALSE);
-    if(rc == SQL_SUCCESS)
+    if(pBatch)
     {
-        rc = libpqPrepareOnThreadWithoutStoringResults(pStmt, pszCmd);
+        pBatch->iRows = iRows;
+        pBatch->pNext = pStmt->pMultiInsertBatchHead;
+        pStmt->pMultiInsertBatchHead = pBatch;
     }
+    else
+        addError(&pStmt->pErrorList,"HY001", "Couldn't create multi-insert batch command", 0, NULL);
 
-    return rc;
+    return pBatch;
 }
 
 /*=====================================================================================*/
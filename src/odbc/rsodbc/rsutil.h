@@ -60,6 +60,11 @@
 #define TEXT_FORMAT		0
 #define BINARY_FORMAT	1
 
+// 128 bit integer fast path for NUMERIC/DECIMAL conversions. MSVC uses the byte-wise path.
+#if defined(__SIZEOF_INT128__)
+#define RS_HAVE_INT128 1
+#endif
+
 #define ENABLE_SANITIZER 0
 
 #define INT_LEN(cbStrLen) ((int)cbStrLen)
@@ -145,9 +150,10 @@ typedef union _RS_VALUE
 // Convert C type to char * when pass it to libpq
 typedef struct _RS_BIND_PARAM_STR_BUF
 {
-    int iAllocDataLen; // Allocated data len. 0 means not allocated and data is in array. > 0 mean allocated. < 0 means data buffer point to application buffer.
+    int iAllocDataLen; // Allocated data len. 0 means not allocated and data is in array or in pArena. > 0 mean allocated. < 0 means data buffer point to application buffer.
     char buf[MAX_NUMBER_BUF_LEN + 1]; // Short numeric, boolean, date, datetime data store in array without allocation.
     char *pBuf;           // User bind buf, buf[] or allocated buffer of iAllocDataLen + 1 data.
+    RS_PARAM_ARENA *pArena; // Arena of longer data, if not NULL. Data in it isn't freed by the caller.
 }RS_BIND_PARAM_STR_BUF;
 
 // ODBC2 behavior
@@ -395,9 +401,11 @@ int isUpdatableCursor(RS_STMT_INFO *pStmt);
 
 void setCatalogQueryBuf(RS_STMT_INFO *pStmt, char *szCatlogQuery);
 
-void setThreadExecutionStatus(RS_EXEC_THREAD_INFO *pExecThread, SQLRETURN rc);
+void setThreadExecutionStatus(RS_STMT_INFO *pStmt, SQLRETURN rc);
 SQLRETURN checkExecutingThread(RS_STMT_INFO *pStmt);
+SQLRETURN waitForExecThread(RS_STMT_INFO *pStmt);
 void waitAndFreeExecThread(RS_STMT_INFO *pStmt, int iWaitFlag);
+SQLRETURN finishExecThread(RS_STMT_INFO *pStmt, SQLRETURN rc, int *piPrepare);
 
 void setParamMarkerCount(RS_STMT_INFO *pStmt, int iNumOfParamMarkers);
 int getParamMarkerCount(RS_STMT_INFO *pStmt);
@@ -443,6 +451,8 @@ char *getDriverPath();
 SQLRETURN getGucVariableVal(RS_CONN_INFO *pConn, char *pVarName, char *pVarVal, int iBufLen);
 void convertNumericStringToScaledInteger(char *pNumData, SQL_NUMERIC_STRUCT *pnVal);
 void convertScaledIntegerToNumericString(SQL_NUMERIC_STRUCT *pnVal,char *pNumData, int num_data_len);
+void convertBinaryNumericToScaledInteger(char *pColData, int iColDataLen, int iPrecision, int iScale, SQL_NUMERIC_STRUCT *pnVal);
+double convertScaledIntegerToDouble(SQL_NUMERIC_STRUCT *pnVal);
 
 int fileExists(const char * pFileName);
 int readTraceOptionsFromIniFile(char  *pszTraceLevel,int iTraceLevelBufLen, char *pszTraceFile, int iTraceFileBufLen);
@@ -458,15 +468,15 @@ void sharedObjectDetach();
 
 #endif
 
-char *parseForMultiInsertCommand(RS_STMT_INFO *pStmt, char *pCmd, SQLINTEGER cbLen, char **ppLastBatchMultiInsertCmd);
-char *getNextTokenForInsertCommand(char **ppSrc, size_t cbLen, int *pi, char delimiter);
+char *parseForMultiInsertCommand(RS_STMT_INFO *pStmt, char *pCmd, SQLINTEGER cbLen);
+char *makeMultiInsertCmd(char *pCmd, SQLINTEGER cbLen, int iRows);
 int getNumberOfParams(RS_STMT_INFO *pStmt);
-int getTotalMultiTuples(int numOfParamMarkers, long lArraySize, int *piLastBatchTotalMultiTuples);
+int getTotalMultiTuples(int numOfParamMarkers, int iValueClauseLen, long lArraySize, long long llMaxBytes);
+int getMultiInsertBatchRows(int iMultiInsert, long lRowsLeft, long long llRowBytes, long long llMaxBytes);
+RS_MULTI_INSERT_BATCH *getMultiInsertBatch(RS_STMT_INFO *pStmt, int iRows);
 
 char *findSQLClause(char *pTempCmd, char *pClause);
 int DoesEmbedInDoubleQuotes(char *pStart,char *pEnd);
-SQLRETURN createLastBatchMultiInsertCmd(RS_STMT_INFO *pStmt, char *pszLastBatchMultiInsertCmd);
-SQLRETURN rePrepareMultiInsertCommand(RS_STMT_INFO *pStmt, char *pszCmd);
 
 
 
@@ -536,6 +546,8 @@ int intervaly2m_out_wchar(INTERVALD2S_STRUCT* d2s, SQLWCHAR *buf, int buf_len);
 
 std::vector<Oid> getParamTypes(int iNoOfBindParams, RS_DESC_REC *pDescRecHead, RS_CONNECT_PROPS_INFO *pConnectProps);
 
+int queueExecThread(RS_STMT_INFO *pStmt, std::function<void()> task);
+
 typedef std::map<std::string, std::string,
                  std::function<bool(const std::string &, const std::string &)>>
     StringMap;
@@ -0,0 +1,138 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rsworkerpool.h"
+#include <chrono>
+#include <thread>
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Pool of at most the given workers. Workers start with the tasks.
+//
+RS_WORKER_POOL::RS_WORKER_POOL(int _iMaxThreads, int _iIdleSeconds)
+{
+    iMaxThreads = (_iMaxThreads > 0) ? _iMaxThreads : 1;
+    iIdleSeconds = (_iIdleSeconds > 0) ? _iIdleSeconds : RS_WORKER_POOL_IDLE_SECONDS;
+    iThreads = 0;
+    iIdle = 0;
+    iStop = FALSE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Stop the workers after the queued tasks and wait for them to exit.
+//
+RS_WORKER_POOL::~RS_WORKER_POOL()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    iStop = TRUE;
+    wakeup.notify_all();
+
+    while(iThreads > 0)
+        exited.wait(guard);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Queue the task, starting a worker when none is idle for it.
+//
+int RS_WORKER_POOL::submit(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if(iStop)
+        return FALSE;
+
+    tasks.push_back(std::move(task));
+
+    if((int)tasks.size() > iIdle && iThreads < iMaxThreads)
+    {
+        try
+        {
+            std::thread(&RS_WORKER_POOL::run, this).detach();
+            iThreads++;
+        }
+        catch(const std::exception &e)
+        {
+            RS_LOG_WARN("RSWORKERPOOL", "Worker thread not started: %s", e.what());
+
+            // Existing workers run it later
+            if(iThreads == 0)
+            {
+                tasks.pop_back();
+                return FALSE;
+            }
+        }
+    }
+
+    wakeup.notify_one();
+
+    return TRUE;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Workers, idle workers and queued tasks of the pool.
+//
+void RS_WORKER_POOL::getStats(int *piThreads, int *piIdle, int *piQueued)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if(piThreads)
+        *piThreads = iThreads;
+    if(piIdle)
+        *piIdle = iIdle;
+    if(piQueued)
+        *piQueued = (int)tasks.size();
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Run tasks until the pool stops with no task queued, or no task comes for the idle time.
+//
+void RS_WORKER_POOL::run()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    for(;;)
+    {
+        std::function<void()> task;
+
+        while(tasks.empty() && !iStop)
+        {
+            std::cv_status status;
+
+            iIdle++;
+            status = wakeup.wait_for(guard, std::chrono::seconds(iIdleSeconds));
+            iIdle--;
+
+            if(status == std::cv_status::timeout && tasks.empty())
+                break;
+        }
+
+        if(tasks.empty())
+            break;
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+
+        guard.unlock();
+        task();
+        guard.lock();
+    } // Loop
+
+    iThreads--;
+    exited.notify_all();
+}
@@ -0,0 +1,61 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+// Driver specific pool of worker threads.
+//
+// Asynchronous execute and prepare (SQL_ATTR_ASYNC_ENABLE) run as tasks of one pool of the
+// driver, instead of on a new thread each. The pool starts a worker when a task is queued and
+// no worker is idle, up to the most workers. Tasks over it wait in the queue in order. A
+// worker idle for the idle time exits, so an idle pool holds no threads.
+
+#ifdef __cplusplus
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// Most workers of the async pool, unless AsyncWorkerThreads is set in the driver options
+#define RS_ASYNC_WORKER_THREADS_DEFAULT     64
+
+// Seconds an idle worker waits for a task before it exits
+#define RS_WORKER_POOL_IDLE_SECONDS         60
+
+class RS_WORKER_POOL
+{
+public:
+
+    RS_WORKER_POOL(int _iMaxThreads, int _iIdleSeconds);
+
+    // Queued tasks run before the workers exit.
+    ~RS_WORKER_POOL();
+
+    // Queue the task. FALSE if the pool has no worker and can't start one.
+    int submit(std::function<void()> task);
+
+    // Workers, idle workers and queued tasks. Any pointer can be NULL.
+    void getStats(int *piThreads, int *piIdle, int *piQueued);
+
+private:
+
+    void run();
+
+    std::mutex lock;
+    std::condition_variable wakeup;     // Task queued or pool stopping
+    std::condition_variable exited;     // Worker exited
+    std::deque<std::function<void()>> tasks;
+
+    int iMaxThreads;
+    int iIdleSeconds;
+    int iThreads;
+    int iIdle;
+    int iStop;
+};
+
+#endif /* C++ */
@@ -0,0 +1,1069 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#include "ClientSideCursorBlock.h"
+#include "ClientSideCursorTrace.h"
+
+static int ensureBufferCscBlock(char **ppBuf, long long *pSize, long long needed);
+static int compressPayloadCscBlockWriter(ClientSideCursorBlockWriter *pWriter, int rawSize);
+static int decompressPayloadCscBlockReader(ClientSideCursorBlockReader *pReader, const char *pStored, int storedSize, int rawSize);
+static void seekRowCscBlockReader(ClientSideCursorBlockReader *pReader, int rowIndex);
+static int getLenCscBlockReader(ClientSideCursorBlockReader *pReader, int col, int rowIndex);
+static int setColsCscBlockReader(ClientSideCursorBlockReader *pReader, int cols);
+static void linkEntryCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry);
+static void unlinkEntryCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry);
+static void freeEntryCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry);
+static void evictCscBlockCache(ClientSideCursorBlockCache *pCache);
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Grow the buffer to hold needed bytes. 0 means successful.
+//
+static int ensureBufferCscBlock(char **ppBuf, long long *pSize, long long needed)
+{
+    if(needed > *pSize)
+    {
+        long long newSize = (*pSize > 0) ? *pSize : 4096;
+        char *pTemp;
+
+        while(newSize < needed)
+            newSize *= 2;
+
+        pTemp = rs_realloc(*ppBuf, (size_t)newSize);
+        if(pTemp == NULL)
+            return TRUE;
+
+        *ppBuf = pTemp;
+        *pSize = newSize;
+    }
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Initialize the block writer.
+//
+ClientSideCursorBlockWriter *createCscBlockWriter(int compress)
+{
+    ClientSideCursorBlockWriter *pWriter = rs_calloc(1, sizeof(ClientSideCursorBlockWriter));
+
+    if(pWriter && compress)
+    {
+        // If compressor is not available, blocks are stored uncompressed.
+        pWriter->m_compressor = zs_create_compressor(CSC_BLOCK_ZSTD_IMPL, CSC_BLOCK_ZSTD_LEVEL);
+    }
+
+    return pWriter;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Release the block writer.
+//
+ClientSideCursorBlockWriter *releaseCscBlockWriter(ClientSideCursorBlockWriter *pWriter)
+{
+    if(pWriter)
+    {
+        int col;
+
+        for(col = 0; col < pWriter->m_cols && pWriter->m_columns != NULL; col++)
+        {
+            pWriter->m_columns[col].m_lens = rs_free(pWriter->m_columns[col].m_lens);
+            pWriter->m_columns[col].m_vals = rs_free(pWriter->m_columns[col].m_vals);
+        }
+
+        pWriter->m_columns = rs_free(pWriter->m_columns);
+        pWriter->m_payload = rs_free(pWriter->m_payload);
+        pWriter->m_compressed = rs_free(pWriter->m_compressed);
+        zs_compressor_free(pWriter->m_compressor);
+        pWriter->m_compressor = NULL;
+
+        pWriter = rs_free(pWriter);
+    }
+
+    return NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Add a row in the block. 0 means successful.
+//
+int addRowCscBlockWriter(ClientSideCursorBlockWriter *pWriter, PGresAttValue *tuple, int noOfCols)
+{
+    int col;
+
+    if(pWriter->m_columns == NULL)
+    {
+        pWriter->m_columns = rs_calloc(noOfCols, sizeof(ClientSideCursorBlockColumn));
+        if(pWriter->m_columns == NULL)
+            return TRUE;
+
+        pWriter->m_cols = noOfCols;
+    }
+    else
+    if(noOfCols != pWriter->m_cols)
+        return TRUE;
+
+    // Grow length arrays
+    if(pWriter->m_rows == pWriter->m_rowsSize)
+    {
+        int newRowsSize = (pWriter->m_rowsSize > 0) ? pWriter->m_rowsSize * 2 : 1024;
+
+        if(newRowsSize > CSC_BLOCK_MAX_ROWS)
+            newRowsSize = CSC_BLOCK_MAX_ROWS;
+
+        for(col = 0; col < noOfCols; col++)
+        {
+            int *pLens = rs_realloc(pWriter->m_columns[col].m_lens, newRowsSize * sizeof(int));
+
+            if(pLens == NULL)
+                return TRUE;
+
+            pWriter->m_columns[col].m_lens = pLens;
+        }
+
+        pWriter->m_rowsSize = newRowsSize;
+    }
+
+    for(col = 0; col < noOfCols; col++)
+    {
+        ClientSideCursorBlockColumn *pColumn = &(pWriter->m_columns[col]);
+        int colValLen = (tuple[col].value != NULL) ? tuple[col].len : -1;
+
+        pColumn->m_lens[pWriter->m_rows] = colValLen;
+
+        if(colValLen > 0)
+        {
+            if(ensureBufferCscBlock(&(pColumn->m_vals), &(pColumn->m_valsSize), pColumn->m_valsLen + colValLen))
+                return TRUE;
+
+            memcpy(pColumn->m_vals + pColumn->m_valsLen, tuple[col].value, colValLen);
+            pColumn->m_valsLen += colValLen;
+            pWriter->m_rawSize += colValLen;
+        }
+
+        pWriter->m_rawSize += sizeof(int);
+    }
+
+    (pWriter->m_rows)++;
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Check whether block should be written.
+//
+int isFullCscBlockWriter(ClientSideCursorBlockWriter *pWriter)
+{
+    return (pWriter->m_rows >= CSC_BLOCK_MAX_ROWS) || (pWriter->m_rawSize >= CSC_BLOCK_MAX_BYTES);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Compress the raw payload as one zstd frame. Returns compressed size, or 0 if it doesn't fit in raw size.
+//
+static int compressPayloadCscBlockWriter(ClientSideCursorBlockWriter *pWriter, int rawSize)
+{
+    size_t srcPos = 0;
+    size_t dstPos = 0;
+    size_t processed;
+    size_t dstProcessed;
+    int rc = ZS_OK;
+
+    if(pWriter->m_compressor == NULL
+        || ensureBufferCscBlock(&(pWriter->m_compressed), &(pWriter->m_compressedSize), rawSize))
+    {
+        return 0;
+    }
+
+    // Compress
+    while(rc == ZS_OK && dstPos < (size_t)rawSize && (srcPos < (size_t)rawSize || zs_buffered(pWriter->m_compressor)))
+    {
+        rc = (int)zs_write(pWriter->m_compressor, pWriter->m_payload + srcPos, rawSize - srcPos, &processed,
+                            pWriter->m_compressed + dstPos, rawSize - dstPos, &dstProcessed);
+        srcPos += processed;
+        dstPos += dstProcessed;
+    }
+
+    // End the frame
+    if(rc == ZS_OK && srcPos == (size_t)rawSize)
+    {
+        do
+        {
+            rc = (int)zs_end_compression(pWriter->m_compressor, pWriter->m_compressed + dstPos, rawSize - dstPos, &dstProcessed);
+            dstPos += dstProcessed;
+        }while(rc == ZS_OK && zs_buffered(pWriter->m_compressor) && dstPos < (size_t)rawSize);
+    }
+
+    if(rc != ZS_OK || srcPos < (size_t)rawSize || zs_buffered(pWriter->m_compressor) || dstPos >= (size_t)rawSize)
+    {
+        // Compressor is in the middle of a frame, so start with a new one for next block.
+        zs_compressor_free(pWriter->m_compressor);
+        pWriter->m_compressor = zs_create_compressor(CSC_BLOCK_ZSTD_IMPL, CSC_BLOCK_ZSTD_LEVEL);
+
+        return 0;
+    }
+
+    return (int)dstPos;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Write the block and reset the writer for next block. pEntry gets the directory entry of the block. 0 means successful.
+//
+int writeBlockCscBlockWriter(ClientSideCursorBlockWriter *pWriter, ClientSideCursorOutputStream *pCscOutputStream,
+                             int firstRowNumber, ClientSideCursorBlockDirEntry *pEntry)
+{
+    int rawSize = (int)pWriter->m_rawSize;
+    int storedSize;
+    short codec;
+    char *pStored;
+    long long pos;
+    int col;
+    int rc;
+
+    if(pWriter->m_rows == 0)
+        return 0;
+
+    if(ensureBufferCscBlock(&(pWriter->m_payload), &(pWriter->m_payloadSize), rawSize))
+        return TRUE;
+
+    // Lengths of all columns, then values of all columns
+    pos = 0;
+    for(col = 0; col < pWriter->m_cols; col++)
+    {
+        memcpy(pWriter->m_payload + pos, pWriter->m_columns[col].m_lens, pWriter->m_rows * sizeof(int));
+        pos += pWriter->m_rows * sizeof(int);
+    }
+
+    for(col = 0; col < pWriter->m_cols; col++)
+    {
+        if(pWriter->m_columns[col].m_valsLen > 0)
+        {
+            memcpy(pWriter->m_payload + pos, pWriter->m_columns[col].m_vals, (size_t)pWriter->m_columns[col].m_valsLen);
+            pos += pWriter->m_columns[col].m_valsLen;
+        }
+    }
+
+    storedSize = compressPayloadCscBlockWriter(pWriter, rawSize);
+    if(storedSize > 0)
+    {
+        codec = CSC_BLOCK_CODEC_ZSTD;
+        pStored = pWriter->m_compressed;
+    }
+    else
+    {
+        codec = CSC_BLOCK_CODEC_NONE;
+        storedSize = rawSize;
+        pStored = pWriter->m_payload;
+    }
+
+    pEntry->m_offset = sizeCscOutputStream(pCscOutputStream);
+    pEntry->m_firstRowNumber = firstRowNumber;
+    pEntry->m_rows = pWriter->m_rows;
+    pEntry->m_size = CSC_BLOCK_HEADER_SIZE + storedSize;
+
+    // Block header
+    rc = writeIntCscOutputStream(pCscOutputStream, pWriter->m_rows);
+    if(!rc)
+        rc = writeShortCscOutputStream(pCscOutputStream, (short)pWriter->m_cols);
+    if(!rc)
+        rc = writeShortCscOutputStream(pCscOutputStream, codec);
+    if(!rc)
+        rc = writeIntCscOutputStream(pCscOutputStream, rawSize);
+    if(!rc)
+        rc = writeIntCscOutputStream(pCscOutputStream, storedSize);
+
+    // Payload
+    if(!rc)
+        rc = writeCscOutputStream(pCscOutputStream, pStored, 0, storedSize);
+
+    if(IS_TRACE_ON_CSC())
+    {
+        traceInfoCsc("writeBlock: rows=%d raw=%d stored=%d codec=%d", pWriter->m_rows, rawSize, storedSize, codec);
+    }
+
+    // Reset for next block
+    for(col = 0; col < pWriter->m_cols; col++)
+        pWriter->m_columns[col].m_valsLen = 0;
+
+    pWriter->m_rows = 0;
+    pWriter->m_rawSize = 0;
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Initialize the block directory.
+//
+ClientSideCursorBlockDir *createCscBlockDir(void)
+{
+    ClientSideCursorBlockDir *pDir = rs_calloc(1, sizeof(ClientSideCursorBlockDir));
+
+    if(pDir)
+        pDir->m_lock = rsCreateMutex();
+
+    return pDir;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Release the block directory.
+//
+ClientSideCursorBlockDir *releaseCscBlockDir(ClientSideCursorBlockDir *pDir)
+{
+    if(pDir)
+    {
+        rsDestroyMutex(pDir->m_lock);
+        pDir->m_lock = NULL;
+        pDir->m_entries = rs_free(pDir->m_entries);
+        pDir = rs_free(pDir);
+    }
+
+    return NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Add an entry for a written block. 0 means successful.
+//
+int addEntryCscBlockDir(ClientSideCursorBlockDir *pDir, ClientSideCursorBlockDirEntry *pEntry)
+{
+    int rc = 0;
+
+    rsLockMutex(pDir->m_lock);
+
+    if(pDir->m_count == pDir->m_size)
+    {
+        int newSize = (pDir->m_size > 0) ? pDir->m_size * 2 : 64;
+        ClientSideCursorBlockDirEntry *pEntries = rs_realloc(pDir->m_entries, newSize * sizeof(ClientSideCursorBlockDirEntry));
+
+        if(pEntries)
+        {
+            pDir->m_entries = pEntries;
+            pDir->m_size = newSize;
+        }
+        else
+            rc = TRUE;
+    }
+
+    if(!rc)
+        pDir->m_entries[(pDir->m_count)++] = *pEntry;
+
+    rsUnlockMutex(pDir->m_lock);
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Find the block of the given row number. Row number start from 1. TRUE means found.
+//
+int findEntryCscBlockDir(ClientSideCursorBlockDir *pDir, int rowNumber, ClientSideCursorBlockDirEntry *pEntry)
+{
+    int found = FALSE;
+    int low = 0;
+    int high;
+
+    rsLockMutex(pDir->m_lock);
+
+    high = pDir->m_count - 1;
+
+    while(low <= high)
+    {
+        int mid = low + (high - low) / 2;
+        ClientSideCursorBlockDirEntry *pMid = &(pDir->m_entries[mid]);
+
+        if(rowNumber < pMid->m_firstRowNumber)
+            high = mid - 1;
+        else
+        if(rowNumber >= pMid->m_firstRowNumber + pMid->m_rows)
+            low = mid + 1;
+        else
+        {
+            *pEntry = *pMid;
+            found = TRUE;
+            break;
+        }
+    }
+
+    rsUnlockMutex(pDir->m_lock);
+
+    return found;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Initialize the block reader.
+//
+ClientSideCursorBlockReader *createCscBlockReader(void)
+{
+    return rs_calloc(1, sizeof(ClientSideCursorBlockReader));
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Release the block reader.
+//
+ClientSideCursorBlockReader *releaseCscBlockReader(ClientSideCursorBlockReader *pReader)
+{
+    if(pReader)
+    {
+        if(pReader->m_cacheEntry != NULL)
+            unpinCscBlockCache(pReader->m_cache, pReader->m_cacheEntry);
+
+        pReader->m_cacheEntry = NULL;
+        pReader->m_payload = rs_free(pReader->m_payload);
+        pReader->m_compressed = rs_free(pReader->m_compressed);
+        pReader->m_colStart = rs_free(pReader->m_colStart);
+        pReader->m_colPos = rs_free(pReader->m_colPos);
+        zs_decompressor_free(pReader->m_decompressor);
+        pReader->m_decompressor = NULL;
+
+        pReader = rs_free(pReader);
+    }
+
+    return NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Decompress one zstd frame in the raw payload. 0 means successful.
+//
+static int decompressPayloadCscBlockReader(ClientSideCursorBlockReader *pReader, const char *pStored, int storedSize, int rawSize)
+{
+    size_t srcPos = 0;
+    size_t dstPos = 0;
+    size_t processed;
+    size_t dstProcessed;
+    int rc;
+
+    if(pReader->m_decompressor == NULL)
+    {
+        pReader->m_decompressor = zs_create_decompressor(CSC_BLOCK_ZSTD_IMPL);
+        if(pReader->m_decompressor == NULL)
+            return TRUE;
+    }
+
+    do
+    {
+        rc = (int)zs_read(pReader->m_decompressor, pStored + srcPos, storedSize - srcPos, &processed,
+                            pReader->m_payload + dstPos, rawSize - dstPos, &dstProcessed);
+        srcPos += processed;
+        dstPos += dstProcessed;
+
+        if(rc == ZS_OK && processed == 0 && dstProcessed == 0)
+            rc = ZS_DECOMPRESS_ERROR; // No progress
+    }while(rc == ZS_OK);
+
+    if(rc != ZS_STREAM_END || dstPos != (size_t)rawSize)
+    {
+        // Start with a new decompressor for next block.
+        zs_decompressor_free(pReader->m_decompressor);
+        pReader->m_decompressor = NULL;
+
+        return TRUE;
+    }
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Read and decode the block of the directory entry. 0 means successful.
+// Stored payload is used from the mapped view of the file, when the input stream has one.
+// With a block cache, a block decoded before is used from the cache and a newly decoded one is added to it.
+//
+int loadCscBlockReader(ClientSideCursorBlockReader *pReader, ClientSideCursorInputStream *pCscInputStream,
+                       ClientSideCursorBlockDirEntry *pEntry)
+{
+    int rows;
+    int cols;
+    int codec;
+    int rawSize;
+    int storedSize;
+    const char *pStored;
+    long long pos;
+    int col;
+    int row;
+
+    pReader->m_block.m_rows = 0;
+    pReader->m_data = NULL;
+
+    // Done with the cached block loaded before.
+    if(pReader->m_cacheEntry != NULL)
+    {
+        unpinCscBlockCache(pReader->m_cache, pReader->m_cacheEntry);
+        pReader->m_cacheEntry = NULL;
+    }
+
+    if(pReader->m_cache != NULL)
+    {
+        ClientSideCursorBlockCacheEntry *pCached = findCscBlockCache(pReader->m_cache, pReader->m_cacheOwnerId, pEntry->m_offset);
+
+        if(pCached != NULL)
+        {
+            pReader->m_cacheEntry = pCached;
+
+            if(pCached->m_rows != pEntry->m_rows || setColsCscBlockReader(pReader, pCached->m_cols))
+                return TRUE;
+
+            memcpy(pReader->m_colStart, pCached->m_colStart, pCached->m_cols * sizeof(long long));
+            pReader->m_data = pCached->m_payload;
+            pReader->m_block = *pEntry;
+            seekRowCscBlockReader(pReader, 0);
+
+            return 0;
+        }
+    }
+
+    // Blocks are read by offset for all cursor types.
+    if(setPositionCscInputStream(pCscInputStream, pEntry->m_offset) != 0)
+        return TRUE;
+
+    pCscInputStream->m_eof = FALSE;
+
+    rows = readIntCscInputStream(pCscInputStream);
+    cols = readShortCscInputStream(pCscInputStream);
+    codec = readShortCscInputStream(pCscInputStream);
+    rawSize = readIntCscInputStream(pCscInputStream);
+    storedSize = readIntCscInputStream(pCscInputStream);
+
+    if(getIOErrorCsc(&(pCscInputStream->m_error)) || feofCscInputStream(pCscInputStream)
+        || rows != pEntry->m_rows || cols <= 0 || rawSize < rows * cols * (int)sizeof(int) || storedSize < 0)
+    {
+        return TRUE;
+    }
+
+    if((codec != CSC_BLOCK_CODEC_ZSTD) && (codec != CSC_BLOCK_CODEC_NONE || storedSize != rawSize))
+        return TRUE;
+
+    pStored = readMappedCscInputStream(pCscInputStream, storedSize);
+
+    if(pStored == NULL)
+    {
+        // Not mapped, read it.
+        char **ppBuf = (codec == CSC_BLOCK_CODEC_ZSTD) ? &(pReader->m_compressed) : &(pReader->m_payload);
+        long long *pBufSize = (codec == CSC_BLOCK_CODEC_ZSTD) ? &(pReader->m_compressedSize) : &(pReader->m_payloadSize);
+
+        if(ensureBufferCscBlock(ppBuf, pBufSize, storedSize)
+            || readCscInputStream(pCscInputStream, *ppBuf, 0, storedSize) != storedSize)
+        {
+            return TRUE;
+        }
+
+        pStored = *ppBuf;
+    }
+
+    if(codec == CSC_BLOCK_CODEC_ZSTD)
+    {
+        if(ensureBufferCscBlock(&(pReader->m_payload), &(pReader->m_payloadSize), rawSize)
+            || decompressPayloadCscBlockReader(pReader, pStored, storedSize, rawSize))
+        {
+            return TRUE;
+        }
+
+        pReader->m_data = pReader->m_payload;
+    }
+    else
+        pReader->m_data = pStored;
+
+    if(setColsCscBlockReader(pReader, cols))
+        return TRUE;
+
+    // Values of each column start after lengths of all columns
+    pos = (long long)rows * cols * sizeof(int);
+    pReader->m_block = *pEntry;
+    for(col = 0; col < cols; col++)
+    {
+        pReader->m_colStart[col] = pos;
+        for(row = 0; row < rows; row++)
+        {
+            int colValLen = getLenCscBlockReader(pReader, col, row);
+
+            if(colValLen > 0)
+                pos += colValLen;
+        }
+    }
+
+    if(pos != rawSize)
+    {
+        pReader->m_block.m_rows = 0;
+        return TRUE;
+    }
+
+    // Keep the decoded block for scrolling back to it. Uncompressed block in the mapped view is in memory already.
+    if(pReader->m_cache != NULL && pReader->m_data == pReader->m_payload)
+    {
+        ClientSideCursorBlockCacheEntry *pCached = addCscBlockCache(pReader->m_cache, pReader->m_cacheOwnerId, pEntry->m_offset,
+                                                                    rows, cols, pReader->m_payload, pReader->m_payloadSize,
+                                                                    pReader->m_colStart);
+
+        if(pCached != NULL)
+        {
+            // Cache owns the payload now.
+            pReader->m_payload = NULL;
+            pReader->m_payloadSize = 0;
+            pReader->m_cacheEntry = pCached;
+        }
+    }
+
+    seekRowCscBlockReader(pReader, 0);
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Allocate column cursors for the number of cols. 0 means successful.
+//
+static int setColsCscBlockReader(ClientSideCursorBlockReader *pReader, int cols)
+{
+    if(cols != pReader->m_cols)
+    {
+        pReader->m_colStart = rs_free(pReader->m_colStart);
+        pReader->m_colPos = rs_free(pReader->m_colPos);
+        pReader->m_colStart = rs_calloc(cols, sizeof(long long));
+        pReader->m_colPos = rs_calloc(cols, sizeof(long long));
+        pReader->m_cols = (pReader->m_colStart && pReader->m_colPos) ? cols : 0;
+        if(pReader->m_cols == 0)
+            return TRUE;
+    }
+
+    return 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Use the block cache for the result of the owner id.
+//
+void setCacheCscBlockReader(ClientSideCursorBlockReader *pReader, ClientSideCursorBlockCache *pCache, long long ownerId)
+{
+    pReader->m_cache = pCache;
+    pReader->m_cacheOwnerId = ownerId;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Position the column cursors on the row index in the loaded block.
+//
+static void seekRowCscBlockReader(ClientSideCursorBlockReader *pReader, int rowIndex)
+{
+    int col;
+
+    for(col = 0; col < pReader->m_cols; col++)
+    {
+        long long pos = pReader->m_colStart[col];
+        int row;
+
+        for(row = 0; row < rowIndex; row++)
+        {
+            int colValLen = getLenCscBlockReader(pReader, col, row);
+
+            if(colValLen > 0)
+                pos += colValLen;
+        }
+
+        pReader->m_colPos[col] = pos;
+    }
+
+    pReader->m_curRow = rowIndex;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Is the row number in the loaded block?
+//
+int containsRowCscBlockReader(ClientSideCursorBlockReader *pReader, int rowNumber)
+{
+    return (pReader->m_block.m_rows > 0)
+            && (rowNumber >= pReader->m_block.m_firstRowNumber)
+            && (rowNumber < pReader->m_block.m_firstRowNumber + pReader->m_block.m_rows);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Read a row from the loaded block. Row must be in the block. Caller owns the row, same as a row read from the row format.
+//
+PGresAttValue *readRowCscBlockReader(ClientSideCursorBlockReader *pReader, int rowNumber, long long *pRawRowLength)
+{
+    int rowIndex = rowNumber - pReader->m_block.m_firstRowNumber;
+    PGresAttValue *tuple;
+    int col;
+
+    *pRawRowLength = 0;
+
+    if(rowIndex != pReader->m_curRow)
+        seekRowCscBlockReader(pReader, rowIndex);
+
+    tuple = (PGresAttValue *)rs_calloc(sizeof(PGresAttValue), pReader->m_cols);
+    if(tuple == NULL)
+        return NULL;
+
+    for(col = 0; col < pReader->m_cols; col++)
+    {
+        int colValLen = getLenCscBlockReader(pReader, col, rowIndex);
+
+        tuple[col].len = colValLen;
+
+        if(colValLen != -1)
+        {
+            tuple[col].value = rs_calloc(sizeof(char), colValLen + 1);
+
+            if(colValLen > 0)
+            {
+                memcpy(tuple[col].value, pReader->m_data + pReader->m_colPos[col], colValLen);
+                pReader->m_colPos[col] += colValLen;
+                *pRawRowLength += colValLen;
+            }
+        }
+    }
+
+    pReader->m_curRow = rowIndex + 1;
+
+    return tuple;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Get raw length of a row in the loaded block. Row must be in the block.
+//
+long long getRowLengthCscBlockReader(ClientSideCursorBlockReader *pReader, int rowNumber)
+{
+    int rowIndex = rowNumber - pReader->m_block.m_firstRowNumber;
+    long long rawRowLength = 0;
+    int col;
+
+    for(col = 0; col < pReader->m_cols; col++)
+    {
+        int colValLen = getLenCscBlockReader(pReader, col, rowIndex);
+
+        if(colValLen > 0)
+            rawRowLength += colValLen;
+    }
+
+    return rawRowLength;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Get value length of a column for the row index in the loaded block. Data in the mapped view may not be aligned.
+//
+static int getLenCscBlockReader(ClientSideCursorBlockReader *pReader, int col, int rowIndex)
+{
+    int colValLen;
+
+    memcpy(&colValLen, pReader->m_data + ((((long long)col * pReader->m_block.m_rows) + rowIndex) * sizeof(int)), sizeof(int));
+
+    return colValLen;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Initialize the block cache with the memory budget in bytes. Caller has the first reference.
+//
+ClientSideCursorBlockCache *createCscBlockCache(long long budget)
+{
+    ClientSideCursorBlockCache *pCache = rs_calloc(1, sizeof(ClientSideCursorBlockCache));
+
+    if(pCache)
+    {
+        pCache->m_budget = budget;
+        pCache->m_refs = 1;
+        pCache->m_lock = rsCreateMutex();
+
+        if(pCache->m_lock == NULL)
+            pCache = rs_free(pCache);
+    }
+
+    return pCache;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Add a reference to the block cache.
+//
+ClientSideCursorBlockCache *addRefCscBlockCache(ClientSideCursorBlockCache *pCache)
+{
+    if(pCache)
+    {
+        rsLockMutex(pCache->m_lock);
+        (pCache->m_refs)++;
+        rsUnlockMutex(pCache->m_lock);
+    }
+
+    return pCache;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Release a reference to the block cache. Last one frees it.
+//
+ClientSideCursorBlockCache *releaseCscBlockCache(ClientSideCursorBlockCache *pCache)
+{
+    if(pCache)
+    {
+        int refs;
+
+        rsLockMutex(pCache->m_lock);
+        refs = --(pCache->m_refs);
+        rsUnlockMutex(pCache->m_lock);
+
+        if(refs == 0)
+        {
+            while(pCache->m_head != NULL)
+                freeEntryCscBlockCache(pCache, pCache->m_head);
+
+            rsDestroyMutex(pCache->m_lock);
+            pCache->m_lock = NULL;
+            pCache = rs_free(pCache);
+        }
+    }
+
+    return NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Get a new owner id for a result. Blocks of different results never match.
+//
+long long newOwnerCscBlockCache(ClientSideCursorBlockCache *pCache)
+{
+    long long ownerId;
+
+    rsLockMutex(pCache->m_lock);
+    ownerId = ++(pCache->m_lastOwnerId);
+    rsUnlockMutex(pCache->m_lock);
+
+    return ownerId;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Find the block of the owner at the file offset. Found entry is pinned and becomes the most recently used.
+// NULL means not found.
+//
+ClientSideCursorBlockCacheEntry *findCscBlockCache(ClientSideCursorBlockCache *pCache, long long ownerId, long long offset)
+{
+    ClientSideCursorBlockCacheEntry *pEntry;
+
+    rsLockMutex(pCache->m_lock);
+
+    for(pEntry = pCache->m_head; pEntry != NULL; pEntry = pEntry->m_next)
+    {
+        if(pEntry->m_ownerId == ownerId && pEntry->m_offset == offset)
+            break;
+    }
+
+    if(pEntry != NULL)
+    {
+        unlinkEntryCscBlockCache(pCache, pEntry);
+        linkEntryCscBlockCache(pCache, pEntry);
+        (pEntry->m_pins)++;
+        (pCache->m_hits)++;
+    }
+    else
+        (pCache->m_misses)++;
+
+    rsUnlockMutex(pCache->m_lock);
+
+    return pEntry;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Add a decoded block. Cache owns the payload, if it's added. Added entry is pinned.
+// Least recently used unpinned entries are evicted to stay in the budget. NULL means not added.
+//
+ClientSideCursorBlockCacheEntry *addCscBlockCache(ClientSideCursorBlockCache *pCache, long long ownerId, long long offset,
+                                                  int rows, int cols, char *pPayload, long long payloadSize, long long *pColStart)
+{
+    ClientSideCursorBlockCacheEntry *pEntry = rs_calloc(1, sizeof(ClientSideCursorBlockCacheEntry));
+
+    if(pEntry == NULL)
+        return NULL;
+
+    pEntry->m_colStart = rs_malloc(cols * sizeof(long long));
+    if(pEntry->m_colStart == NULL)
+    {
+        pEntry = rs_free(pEntry);
+        return NULL;
+    }
+
+    memcpy(pEntry->m_colStart, pColStart, cols * sizeof(long long));
+    pEntry->m_ownerId = ownerId;
+    pEntry->m_offset = offset;
+    pEntry->m_rows = rows;
+    pEntry->m_cols = cols;
+    pEntry->m_payload = pPayload;
+    pEntry->m_payloadSize = payloadSize;
+    pEntry->m_pins = 1;
+
+    rsLockMutex(pCache->m_lock);
+
+    linkEntryCscBlockCache(pCache, pEntry);
+    pCache->m_used += payloadSize;
+    evictCscBlockCache(pCache);
+
+    rsUnlockMutex(pCache->m_lock);
+
+    return pEntry;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Reader is done with the entry.
+//
+void unpinCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry)
+{
+    rsLockMutex(pCache->m_lock);
+
+    (pEntry->m_pins)--;
+
+    if(pEntry->m_pins == 0 && pEntry->m_ownerId == 0)
+        freeEntryCscBlockCache(pCache, pEntry);
+    else
+        evictCscBlockCache(pCache);
+
+    rsUnlockMutex(pCache->m_lock);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Remove all blocks of the owner, when its file goes away. Pinned ones are freed on unpin.
+//
+void removeOwnerCscBlockCache(ClientSideCursorBlockCache *pCache, long long ownerId)
+{
+    ClientSideCursorBlockCacheEntry *pEntry;
+
+    rsLockMutex(pCache->m_lock);
+
+    pEntry = pCache->m_head;
+    while(pEntry != NULL)
+    {
+        ClientSideCursorBlockCacheEntry *pNext = pEntry->m_next;
+
+        if(pEntry->m_ownerId == ownerId)
+        {
+            if(pEntry->m_pins == 0)
+                freeEntryCscBlockCache(pCache, pEntry);
+            else
+                pEntry->m_ownerId = 0;
+        }
+
+        pEntry = pNext;
+    }
+
+    rsUnlockMutex(pCache->m_lock);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Link the entry at the head of the LRU list. Caller holds the lock.
+//
+static void linkEntryCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry)
+{
+    pEntry->m_prev = NULL;
+    pEntry->m_next = pCache->m_head;
+
+    if(pCache->m_head != NULL)
+        pCache->m_head->m_prev = pEntry;
+    else
+        pCache->m_tail = pEntry;
+
+    pCache->m_head = pEntry;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Unlink the entry from the LRU list. Caller holds the lock.
+//
+static void unlinkEntryCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry)
+{
+    if(pEntry->m_prev != NULL)
+        pEntry->m_prev->m_next = pEntry->m_next;
+    else
+        pCache->m_head = pEntry->m_next;
+
+    if(pEntry->m_next != NULL)
+        pEntry->m_next->m_prev = pEntry->m_prev;
+    else
+        pCache->m_tail = pEntry->m_prev;
+
+    pEntry->m_prev = NULL;
+    pEntry->m_next = NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Unlink and free the entry. Caller holds the lock.
+//
+static void freeEntryCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry)
+{
+    unlinkEntryCscBlockCache(pCache, pEntry);
+    pCache->m_used -= pEntry->m_payloadSize;
+
+    pEntry->m_payload = rs_free(pEntry->m_payload);
+    pEntry->m_colStart = rs_free(pEntry->m_colStart);
+    pEntry = rs_free(pEntry);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------
+// Evict least recently used unpinned entries, until the cache is in the budget. Caller holds the lock.
+//
+static void evictCscBlockCache(ClientSideCursorBlockCache *pCache)
+{
+    ClientSideCursorBlockCacheEntry *pEntry = pCache->m_tail;
+
+    while(pEntry != NULL && pCache->m_used > pCache->m_budget)
+    {
+        ClientSideCursorBlockCacheEntry *pPrev = pEntry->m_prev;
+
+        if(pEntry->m_pins == 0)
+            freeEntryCscBlockCache(pCache, pEntry);
+
+        pEntry = pPrev;
+    }
+}
@@ -0,0 +1,289 @@
+/*-------------------------------------------------------------------------
+*
+* Copyright(c) 2026, Amazon.com, Inc. or Its Affiliates. All rights reserved.
+*
+*-------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+// Windows Header Files:
+#include <windows.h>
+#endif // WIN32
+
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+#ifdef WIN32
+#include "csc_win_port.h"
+#endif // WIN32
+
+#ifdef LINUX
+#include "csc_linux_port.h"
+#endif
+
+#include "rsfile.h"
+#include "rslock.h"
+#include "rsmem.h"
+
+#include "ClientSideCursorOutputStream.h"
+#include "ClientSideCursorInputStream.h"
+
+#include "libpq-fe.h"
+#include "libpq-int.h"
+#include "libpq/z_stream.h"
+
+// Constants
+
+// Max rows in a block
+#define CSC_BLOCK_MAX_ROWS      65536
+
+// Max raw (uncompressed) bytes in a block. Last row can go over it.
+#define CSC_BLOCK_MAX_BYTES     (4 * 1024 * 1024)
+
+// Block payload codec
+#define CSC_BLOCK_CODEC_NONE    0
+#define CSC_BLOCK_CODEC_ZSTD    1
+
+// Index of zstd in z_stream algorithms and level we use.
+// LZ4 in z_stream is a ring buffer stream, so a block couldn't be decoded without the blocks before it.
+#define CSC_BLOCK_ZSTD_IMPL     0
+#define CSC_BLOCK_ZSTD_LEVEL    1
+
+// Size of block header on disk
+#define CSC_BLOCK_HEADER_SIZE   16
+
+/**
+ * Block file format.
+ *
+ * Rows are grouped into blocks. Each block is:
+ *    4 bytes: row count
+ *    2 bytes: column count
+ *    2 bytes: codec
+ *    4 bytes: raw payload size
+ *    4 bytes: stored payload size
+ *    N bytes: payload, compressed with the codec.
+ *
+ * Raw payload stores the block column-wise:
+ *    for each column: 4 bytes column value length for each row. -1 means NULL.
+ *    for each column: values of all rows.
+ *
+ * The block directory in memory gives row-to-block lookup, so scrollable cursor doesn't need an offset file.
+ */
+
+// Column of the block being built.
+typedef struct _ClientSideCursorBlockColumn
+{
+    // Value lengths, one per row
+    int *m_lens;
+
+    // Values
+    char *m_vals;
+
+    // Used bytes in m_vals
+    long long m_valsLen;
+
+    // Allocated bytes in m_vals
+    long long m_valsSize;
+}ClientSideCursorBlockColumn;
+
+// Builds a block from rows and writes it.
+typedef struct _ClientSideCursorBlockWriter
+{
+    // Number of cols
+    int m_cols;
+
+    // Rows in the block
+    int m_rows;
+
+    // Allocated rows in m_lens of each column
+    int m_rowsSize;
+
+    // Raw payload size
+    long long m_rawSize;
+
+    // Columns
+    ClientSideCursorBlockColumn *m_columns;
+
+    // Raw payload buffer
+    char *m_payload;
+    long long m_payloadSize;
+
+    // Compressed payload buffer
+    char *m_compressed;
+    long long m_compressedSize;
+
+    // Compressor. NULL means blocks are stored uncompressed.
+    ZStream *m_compressor;
+}ClientSideCursorBlockWriter;
+
+// Block directory entry
+typedef struct _ClientSideCursorBlockDirEntry
+{
+    // Offset of the block header in the file
+    long long m_offset;
+
+    // 1 based row number of the first row in the block
+    int m_firstRowNumber;
+
+    // Rows in the block
+    int m_rows;
+
+    // Bytes of the block in the file, header included
+    int m_size;
+}ClientSideCursorBlockDirEntry;
+
+// Block directory. Writer adds entries, while reader looks them up.
+typedef struct _ClientSideCursorBlockDir
+{
+    ClientSideCursorBlockDirEntry *m_entries;
+
+    // Number of entries
+    int m_count;
+
+    // Allocated entries
+    int m_size;
+
+    // Lock for parallel read/write
+    MUTEX_HANDLE m_lock;
+}ClientSideCursorBlockDir;
+
+// Decoded block in the block cache.
+typedef struct _ClientSideCursorBlockCacheEntry
+{
+    // Result the block belongs to. 0 means the result is gone.
+    long long m_ownerId;
+
+    // Offset of the block header in the file
+    long long m_offset;
+
+    // Rows and cols in the block
+    int m_rows;
+    int m_cols;
+
+    // Raw payload
+    char *m_payload;
+    long long m_payloadSize;
+
+    // Offset of the values of each column in the payload
+    long long *m_colStart;
+
+    // Readers using the entry. Pinned entry isn't evicted.
+    int m_pins;
+
+    // LRU list. Head is the most recently used.
+    struct _ClientSideCursorBlockCacheEntry *m_prev;
+    struct _ClientSideCursorBlockCacheEntry *m_next;
+}ClientSideCursorBlockCacheEntry;
+
+// LRU cache of decoded blocks. One per connection, shared by all its results.
+typedef struct _ClientSideCursorBlockCache
+{
+    // Memory budget in bytes. Pinned entries can go over it.
+    long long m_budget;
+
+    // Bytes used by entries
+    long long m_used;
+
+    ClientSideCursorBlockCacheEntry *m_head;
+    ClientSideCursorBlockCacheEntry *m_tail;
+
+    // Last owner id given to a result
+    long long m_lastOwnerId;
+
+    // References from the executor and results. Result can outlive the connection.
+    int m_refs;
+
+    // Statistics
+    long long m_hits;
+    long long m_misses;
+
+    // Lock, because results of a connection can be read from different threads.
+    MUTEX_HANDLE m_lock;
+}ClientSideCursorBlockCache;
+
+// Decoded block for reading.
+typedef struct _ClientSideCursorBlockReader
+{
+    // Loaded block. m_rows is 0, if no block is loaded.
+    ClientSideCursorBlockDirEntry m_block;
+
+    // Number of cols
+    int m_cols;
+
+    // Raw payload of the loaded block. It points to m_payload or into the mapped view of the file.
+    const char *m_data;
+
+    // Decompressed payload
+    char *m_payload;
+    long long m_payloadSize;
+
+    // Compressed payload, when file isn't mapped
+    char *m_compressed;
+    long long m_compressedSize;
+
+    // Offset of the values of each column in the payload
+    long long *m_colStart;
+
+    // Offset of the value of each column for the row m_curRow
+    long long *m_colPos;
+
+    // Row index in the block for m_colPos
+    int m_curRow;
+
+    // Decompressor
+    ZStream *m_decompressor;
+
+    // Block cache and owner id of the result in it. NULL means no cache.
+    ClientSideCursorBlockCache *m_cache;
+    long long m_cacheOwnerId;
+
+    // Cache entry of the loaded block, pinned while it's loaded.
+    ClientSideCursorBlockCacheEntry *m_cacheEntry;
+}ClientSideCursorBlockReader;
+
+// Function declarations
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* C++ */
+
+ClientSideCursorBlockWriter *createCscBlockWriter(int compress);
+ClientSideCursorBlockWriter *releaseCscBlockWriter(ClientSideCursorBlockWriter *pWriter);
+int addRowCscBlockWriter(ClientSideCursorBlockWriter *pWriter, PGresAttValue *tuple, int noOfCols);
+int isFullCscBlockWriter(ClientSideCursorBlockWriter *pWriter);
+int writeBlockCscBlockWriter(ClientSideCursorBlockWriter *pWriter, ClientSideCursorOutputStream *pCscOutputStream,
+                             int firstRowNumber, ClientSideCursorBlockDirEntry *pEntry);
+
+ClientSideCursorBlockDir *createCscBlockDir(void);
+ClientSideCursorBlockDir *releaseCscBlockDir(ClientSideCursorBlockDir *pDir);
+int addEntryCscBlockDir(ClientSideCursorBlockDir *pDir, ClientSideCursorBlockDirEntry *pEntry);
+int findEntryCscBlockDir(ClientSideCursorBlockDir *pDir, int rowNumber, ClientSideCursorBlockDirEntry *pEntry);
+
+ClientSideCursorBlockReader *createCscBlockReader(void);
+ClientSideCursorBlockReader *releaseCscBlockReader(ClientSideCursorBlockReader *pReader);
+int loadCscBlockReader(ClientSideCursorBlockReader *pReader, ClientSideCursorInputStream *pCscInputStream,
+                       ClientSideCursorBlockDirEntry *pEntry);
+int containsRowCscBlockReader(ClientSideCursorBlockReader *pReader, int rowNumber);
+PGresAttValue *readRowCscBlockReader(ClientSideCursorBlockReader *pReader, int rowNumber, long long *pRawRowLength);
+long long getRowLengthCscBlockReader(ClientSideCursorBlockReader *pReader, int rowNumber);
+void setCacheCscBlockReader(ClientSideCursorBlockReader *pReader, ClientSideCursorBlockCache *pCache, long long ownerId);
+
+ClientSideCursorBlockCache *createCscBlockCache(long long budget);
+ClientSideCursorBlockCache *addRefCscBlockCache(ClientSideCursorBlockCache *pCache);
+ClientSideCursorBlockCache *releaseCscBlockCache(ClientSideCursorBlockCache *pCache);
+long long newOwnerCscBlockCache(ClientSideCursorBlockCache *pCache);
+ClientSideCursorBlockCacheEntry *findCscBlockCache(ClientSideCursorBlockCache *pCache, long long ownerId, long long offset);
+ClientSideCursorBlockCacheEntry *addCscBlockCache(ClientSideCursorBlockCache *pCache, long long ownerId, long long offset,
+                                                  int rows, int cols, char *pPayload, long long payloadSize, long long *pColStart);
+void unpinCscBlockCache(ClientSideCursorBlockCache *pCache, ClientSideCursorBlockCacheEntry *pEntry);
+void removeOwnerCscBlockCache(ClientSideCursorBlockCache *pCache, long long ownerId);
+
+#ifdef __cplusplus
+}
+#endif /* C++ */
@@ -30,18 +30,33 @@ ClientSideCursorExecutor *createCscExecutor(PGconn *pConn)
         if (pConn->iCscEnable)
         {
             pCscExecutor->m_cscOptions = createCscOptions(pConn->iCscEnable, pConn->llCscThreshold, pConn->llCscMaxFileSize, pConn->szCscPath);
+
+            if(pCscExecutor->m_cscOptions)
+            {
+                setSyncWritesCscOption(pCscExecutor->m_cscOptions, pConn->iCscSyncWrites);
+                setFileFormatCscOption(pCscExecutor->m_cscOptions, pConn->iCscFileFormat);
+                setCacheSizeCscOption(pCscExecutor->m_cscOptions, pConn->llCscCacheSize);
+
+                if(getCacheSizeCscOption(pCscExecutor->m_cscOptions) > 0)
+                    pCscExecutor->m_cscBlockCache = createCscBlockCache(getCacheSizeCscOption(pCscExecutor->m_cscOptions));
+            }
         }
 
         pCscExecutor->m_conn = pConn;
 
+        // Result memory limit is for the whole process. -1 asks for the limit from the cgroup.
+        if(pConn->llResultMemoryLimit != 0)
+            rs_mem_set_limit((pConn->llResultMemoryLimit < 0) ? -1 : pConn->llResultMemoryLimit * 1024 * 1024);
+
         /* pConn->llCscThreshold and llCscMaxFileSize are in MB (user-configured input).
          * setThresholdCscOption/setMaxFileSizeCscOption convert them to bytes internally.
          * ClientSideCursorOptions.c logs the post-conversion byte values. Both labels are correct. */
         RS_LOG_DEBUG("CSCINF", "CSC executor created: CscEnable=%d, CscThreshold=%lld MB, CscMaxFileSize=%lld MB, "
-                    "CscPath=%s, StreamingCursorRows=%d",
+                    "CscPath=%s, CscSyncWrites=%d, CscFileFormat=%d, CscCacheSize=%lld MB, StreamingCursorRows=%d, "
+                    "ResultMemoryLimit=%lld MB (process limit=%lld bytes)",
                     pConn->iCscEnable, pConn->llCscThreshold, pConn->llCscMaxFileSize,
-                    pConn->szCscPath[0] ? pConn->szCscPath : "(default)",
-                    pConn->iStreamingCursorRows);
+                    pConn->szCscPath[0] ? pConn->szCscPath : "(default)", pConn->iCscSyncWrites, pConn->iCscFileFormat,
+                    pConn->llCscCacheSize, pConn->iStreamingCursorRows, pConn->llResultMemoryLimit, rs_mem_get_limit());
     }
 
     return pCscExecutor;
@@ -56,8 +71,10 @@ ClientSideCursorExecutor *releaseCscExecutor(ClientSideCursorExecutor *pCscExecu
 {
     if(pCscExecutor)
     {
-        RS_LOG_DEBUG("CSCINF", "CSC executor released");
+        RS_LOG_DEBUG("CSCINF", "CSC executor released: result memory used=%lld, peak=%lld bytes",
+                    rs_mem_get_used(), rs_mem_get_peak());
         pCscExecutor->m_cscOptions = releaseCscOptions(pCscExecutor->m_cscOptions);
+        pCscExecutor->m_cscBlockCache = releaseCscBlockCache(pCscExecutor->m_cscBlockCache);
 
         pCscExecutor = rs_free(pCscExecutor);
     }
@@ -92,6 +109,9 @@ ClientSideCursorResult *createCSCResultObj(void *_pCscExecutor, int maxRows, int
                         pCscExecutor->m_conn->be_pid, NULL, resultsettype, executeIndex) 
                     : NULL);
 
+    if(pCscResult)
+        setBlockCacheCsc(pCscResult, pCscExecutor->m_cscBlockCache);
+
     return pCscResult;
 }
 
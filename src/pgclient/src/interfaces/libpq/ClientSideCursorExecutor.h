@@ -39,6 +39,9 @@ typedef struct _ClientSideCursorExecutor
 
     // Parent object who created CSC
     PGconn *m_conn;
+
+    // Cache of decoded blocks, shared by all results of the connection. NULL means no cache.
+    ClientSideCursorBlockCache *m_cscBlockCache;
 }ClientSideCursorExecutor;
 
 #ifdef __cplusplus
@@ -8,6 +8,8 @@
 
 #include "ClientSideCursorInputStream.h"
 
+static void remapCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long needed);
+
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
@@ -23,8 +25,8 @@ ClientSideCursorInputStream *createCscInputStream(char *fileName, int resultsett
         
         pCscInputStream->m_dataInputStream = rs_fopen(fileName,"r+b");
 
-        if(pCscInputStream->m_dataInputStream)
-            setvbuf(pCscInputStream->m_dataInputStream, NULL, _IOFBF, 8 * 1024);
+        // Reads go through a mapped view of the file. stdio is used, if file can't be mapped.
+        pCscInputStream->m_useMap = (pCscInputStream->m_dataInputStream != NULL);
 
         // Set error, if we couldn't open the file.
         *pError = (pCscInputStream->m_dataInputStream == NULL);
@@ -61,6 +63,11 @@ int closeCscInputStream(ClientSideCursorInputStream *pCscInputStream)
 
     if(pCscInputStream->m_dataInputStream != NULL)
     {
+        rs_munmap(pCscInputStream->m_map, pCscInputStream->m_mapSize, pCscInputStream->m_mapHandle);
+        pCscInputStream->m_map = NULL;
+        pCscInputStream->m_mapSize = 0;
+        pCscInputStream->m_mapHandle = NULL;
+
         rc = fclose(pCscInputStream->m_dataInputStream);
 
         pCscInputStream->m_dataInputStream = NULL;
@@ -150,19 +157,121 @@ int seekCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long p
     int rc;
 
     if(!doesItForwardOnlyCursor(pCscInputStream->m_resultsettype))
+        rc = setPositionCscInputStream(pCscInputStream, pos);
+    else
+        rc = 0;
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Set the read position for any cursor type. 0 means successful.
+//
+int setPositionCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long pos) 
+{
+    int rc;
+
+    if(pCscInputStream->m_useMap)
+    {
+        pCscInputStream->m_pos = pos;
+        rc = 0;
+    }
+    else
     {
         rc = rs_fseeko(pCscInputStream->m_dataInputStream, pos, SEEK_SET);
 
         fflush(pCscInputStream->m_dataInputStream);
     }
-    else
-        rc = 0;
 
     return rc;
 }
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Grow the mapped view to the current file size, if it doesn't have needed bytes from the current position.
+// If file can't be mapped, switch to stdio at the current position.
+//
+static void remapCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long needed)
+{
+    long long fileSize;
+    void *pMap;
+    void *pMapHandle;
+
+    if(pCscInputStream->m_pos + needed <= pCscInputStream->m_mapSize)
+        return;
+
+    fileSize = rs_fsize(pCscInputStream->m_dataInputStream);
+
+    // Writer didn't commit more data yet.
+    if(fileSize >= 0 && fileSize <= pCscInputStream->m_mapSize)
+        return;
+
+    pMap = rs_mmap(pCscInputStream->m_dataInputStream, fileSize,
+                   doesItForwardOnlyCursor(pCscInputStream->m_resultsettype), &pMapHandle);
+
+    if(pMap != NULL)
+    {
+        rs_munmap(pCscInputStream->m_map, pCscInputStream->m_mapSize, pCscInputStream->m_mapHandle);
+        pCscInputStream->m_map = pMap;
+        pCscInputStream->m_mapSize = fileSize;
+        pCscInputStream->m_mapHandle = pMapHandle;
+    }
+    else
+    {
+        // Continue with stdio from the same position.
+        rs_munmap(pCscInputStream->m_map, pCscInputStream->m_mapSize, pCscInputStream->m_mapHandle);
+        pCscInputStream->m_map = NULL;
+        pCscInputStream->m_mapSize = 0;
+        pCscInputStream->m_mapHandle = NULL;
+        pCscInputStream->m_useMap = FALSE;
+
+        if(rs_fseeko(pCscInputStream->m_dataInputStream, pCscInputStream->m_pos, SEEK_SET) != 0)
+            setIOErrorCsc(&(pCscInputStream->m_error),TRUE);
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Read ahead len bytes at the offset in the background. Read position doesn't change.
+//
+void prefetchCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long offset, long long len)
+{
+    if(pCscInputStream->m_useMap && (offset + len <= pCscInputStream->m_mapSize))
+        rs_prefetch(NULL, pCscInputStream->m_map, offset, len);
+    else
+        rs_prefetch(pCscInputStream->m_dataInputStream, NULL, offset, len);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get len bytes from the current position in the mapped view and move past them, without copy.
+// Data is valid until next read from the stream. NULL means not mapped or not enough data, then read with readCscInputStream.
+//
+const char *readMappedCscInputStream(ClientSideCursorInputStream *pCscInputStream, int len)
+{
+    const char *pData = NULL;
+
+    if(pCscInputStream->m_useMap && len >= 0)
+    {
+        remapCscInputStream(pCscInputStream, len);
+
+        if(pCscInputStream->m_useMap && (pCscInputStream->m_pos + len <= pCscInputStream->m_mapSize))
+        {
+            pData = pCscInputStream->m_map + pCscInputStream->m_pos;
+            pCscInputStream->m_pos += len;
+        }
+    }
+
+    return pData;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Read, set IO error or eof
 //
@@ -170,6 +279,28 @@ size_t freadCsc(ClientSideCursorInputStream *pCscInputStream, void * _DstBuf, si
 {
     size_t rc;
 
+    if(pCscInputStream->m_useMap)
+        remapCscInputStream(pCscInputStream, (long long)(_ElementSize * _Count));
+
+    if(pCscInputStream->m_useMap)
+    {
+        long long avail = pCscInputStream->m_mapSize - pCscInputStream->m_pos;
+
+        rc = (avail > 0) ? (size_t)(avail / (long long)_ElementSize) : 0;
+        if(rc > _Count)
+            rc = _Count;
+
+        if(rc > 0)
+        {
+            memcpy(_DstBuf, pCscInputStream->m_map + pCscInputStream->m_pos, rc * _ElementSize);
+            pCscInputStream->m_pos += rc * _ElementSize;
+        }
+
+        // Same as stdio, partial read means end of the file.
+        if(rc < _Count)
+            pCscInputStream->m_eof = TRUE;
+    }
+    else
     if(!feof(pCscInputStream->m_dataInputStream))
     {
         rc = fread(_DstBuf,_ElementSize,_Count,pCscInputStream->m_dataInputStream);
@@ -51,6 +51,17 @@ typedef struct _ClientSideCursorInputStream
     // EOF indicator
     int m_eof;
 
+    // Read through memory mapped view of the file. FALSE means stdio is used.
+    int m_useMap;
+
+    // Mapped view. It grows as the writer commits more data.
+    char *m_map;
+    long long m_mapSize;
+    void *m_mapHandle;
+
+    // Read position in the mapped view
+    long long m_pos;
+
 }ClientSideCursorInputStream ;
 
 #ifdef __cplusplus
@@ -67,6 +78,9 @@ int readIntCscInputStream(ClientSideCursorInputStream *pCscInputStream);
 long long readLongLongCscInputStream(ClientSideCursorInputStream *pCscInputStream);
 int readCscInputStream(ClientSideCursorInputStream *pCscInputStream,char b[], int off, int len);
 int seekCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long pos);
+int setPositionCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long pos);
+const char *readMappedCscInputStream(ClientSideCursorInputStream *pCscInputStream, int len);
+void prefetchCscInputStream(ClientSideCursorInputStream *pCscInputStream, long long offset, long long len);
 int doesItForwardOnlyCursor(int resultsettype);
 void setIOErrorCsc(int *pError, int value);
 int getIOErrorCsc(int *pError);
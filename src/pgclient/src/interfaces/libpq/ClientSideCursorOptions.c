@@ -42,6 +42,8 @@ ClientSideCursorOptions *createCscOptions(int enable, long long threshold, long
         setThresholdCscOption(pCscOptions, threshold);
         setMaxFileSizeCscOption(pCscOptions, maxfilesize);
         setPathCscOption(pCscOptions, path);
+        setFileFormatCscOption(pCscOptions, DFLT_CSC_FILE_FORMAT);
+        setCacheSizeCscOption(pCscOptions, DFLT_CSC_CACHE_SIZE);
 
         RS_LOG_INFO("CSCINF", "CSC options: enable=%d, threshold=%lld bytes, maxfilesize=%lld bytes, path=%s",
                     pCscOptions->m_enable, pCscOptions->m_threshold, pCscOptions->m_maxfilesize, pCscOptions->m_path);
@@ -189,6 +191,56 @@ char *getPathCscOption(ClientSideCursorOptions *pCscOptions)
     return pCscOptions->m_path;
 }
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Set sync writes.
+//
+void setSyncWritesCscOption(ClientSideCursorOptions *pCscOptions, int syncWrites)
+{
+    pCscOptions->m_syncWrites = (syncWrites != 0);
+}
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get sync writes.
+//
+int getSyncWritesCscOption(ClientSideCursorOptions *pCscOptions)
+{
+    return pCscOptions->m_syncWrites;
+}
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Set file format. Unknown format means default.
+//
+void setFileFormatCscOption(ClientSideCursorOptions *pCscOptions, int fileFormat)
+{
+    pCscOptions->m_fileFormat = (fileFormat == CSC_FILE_FORMAT_ROW || fileFormat == CSC_FILE_FORMAT_BLOCK)
+                                    ? fileFormat
+                                    : DFLT_CSC_FILE_FORMAT;
+}
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get file format.
+//
+int getFileFormatCscOption(ClientSideCursorOptions *pCscOptions)
+{
+    return pCscOptions->m_fileFormat;
+}
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Set cache size. Input is in MB. 0 or negative means no cache.
+//
+void setCacheSizeCscOption(ClientSideCursorOptions *pCscOptions, long long cacheSize)
+{
+    pCscOptions->m_cacheSize = (cacheSize <= 0) ? 0 : (cacheSize * 1024L * 1024);
+}
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get cache size in bytes.
+//
+long long getCacheSizeCscOption(ClientSideCursorOptions *pCscOptions)
+{
+    return pCscOptions->m_cacheSize;
+}
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Set default csc path.
 //
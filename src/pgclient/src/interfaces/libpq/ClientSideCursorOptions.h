@@ -47,6 +47,16 @@
 // Default is 4000MB
 #define DFLT_CSC_MAX_FILE_SIZE  (4 * 1024L) // in MB
 
+// CSC file formats
+#define CSC_FILE_FORMAT_ROW     1 // Row by row, with an offset file for scrollable cursor
+#define CSC_FILE_FORMAT_BLOCK   2 // Compressed column-wise blocks
+
+// Default is block format
+#define DFLT_CSC_FILE_FORMAT    CSC_FILE_FORMAT_BLOCK
+
+// Default is 64MB
+#define DFLT_CSC_CACHE_SIZE     64 // in MB
+
 
 /**
  * This class contains configuration of Client side cursor.
@@ -67,6 +77,15 @@ typedef struct _ClientSideCursorOptions
     
     // CSC file storage path
     char m_path[MAX_PATH + 1];
+
+    // Flush and fsync the CSC file on every commit. Default is off.
+    int m_syncWrites;
+
+    // CSC file format
+    int m_fileFormat;
+
+    // Memory budget in bytes for decoded blocks, shared by all results of the connection. 0 means no cache.
+    long long m_cacheSize;
 }ClientSideCursorOptions ;    
 
 // Function declarations
@@ -86,6 +105,12 @@ int getEnableCscOption(ClientSideCursorOptions *pCscOptions);
 long long getThresholdCscOption(ClientSideCursorOptions *pCscOptions);
 long long  getMaxFileSizeCscOption(ClientSideCursorOptions *pCscOptions);
 char *getPathCscOption(ClientSideCursorOptions *pCscOptions);
+void setSyncWritesCscOption(ClientSideCursorOptions *pCscOptions, int syncWrites);
+int getSyncWritesCscOption(ClientSideCursorOptions *pCscOptions);
+void setFileFormatCscOption(ClientSideCursorOptions *pCscOptions, int fileFormat);
+int getFileFormatCscOption(ClientSideCursorOptions *pCscOptions);
+void setCacheSizeCscOption(ClientSideCursorOptions *pCscOptions, long long cacheSize);
+long long getCacheSizeCscOption(ClientSideCursorOptions *pCscOptions);
 ClientSideCursorOptions *releaseCscOptions(ClientSideCursorOptions *pCscOptions);
 void setDfltCscPath(void);
 
@@ -8,12 +8,20 @@
 
 #include "ClientSideCursorOutputStream.h"
 
+#ifdef WIN32
+void
+#endif
+#if defined LINUX 
+void *
+#endif
+runCscOutputThread(void *pArg);
+
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
 // Initialize the csc output stream.
 //
-ClientSideCursorOutputStream *createCscOutputStream(char *fileName, int resultsettype,int *pError) 
+ClientSideCursorOutputStream *createCscOutputStream(char *fileName, int resultsettype, int syncWrites, int *pError) 
 {
     ClientSideCursorOutputStream *pCscOutputStream = rs_calloc(1, sizeof(ClientSideCursorOutputStream));
 
@@ -21,18 +29,31 @@ ClientSideCursorOutputStream *createCscOutputStream(char *fileName, int resultse
     {
         char *mode =
 #ifdef WIN32
-           "w+bc"; // Sync mode for commit-to-disk when flush called.
+           (syncWrites) ? "w+bc" : "w+b"; // Sync mode for commit-to-disk when flush called.
 #endif
 #if defined LINUX 
             "w+b";
 #endif
             
         pCscOutputStream->m_resultsettype = resultsettype;
+        pCscOutputStream->m_syncWrites = syncWrites;
         
         pCscOutputStream->m_dataOutputStream = rs_fopen(fileName,mode);
 
         if(pCscOutputStream->m_dataOutputStream)
-            setvbuf(pCscOutputStream->m_dataOutputStream, NULL, _IOFBF, 8 * 1024);
+        {
+            if(syncWrites)
+                setvbuf(pCscOutputStream->m_dataOutputStream, NULL, _IOFBF, 8 * 1024);
+            else
+            {
+                // We buffer ourselves, so stdio buffer is only an extra copy.
+                setvbuf(pCscOutputStream->m_dataOutputStream, NULL, _IONBF, 0);
+
+                pCscOutputStream->m_buffer = rs_malloc(CSC_OUTPUT_BUFFER_SIZE);
+                pCscOutputStream->m_bufferSize = (pCscOutputStream->m_buffer) ? CSC_OUTPUT_BUFFER_SIZE : 0;
+                pCscOutputStream->m_bufferLen = 0;
+            }
+        }
 
         pCscOutputStream->m_fd = rs_fileno(pCscOutputStream->m_dataOutputStream);
         
@@ -56,10 +77,13 @@ ClientSideCursorOutputStream *releaseCscOutputStream(ClientSideCursorOutputStrea
 {
     if(pCscOutputStream)
     {
+        stopAsyncWritesCscOutputStream(pCscOutputStream);
+
         pCscOutputStream->m_resultsettype = 0;
         pCscOutputStream->m_dataOutputStream = NULL;
         pCscOutputStream->m_fd = 0;
         pCscOutputStream->m_written = 0;
+        pCscOutputStream->m_buffer = rs_free(pCscOutputStream->m_buffer);
         pCscOutputStream = rs_free(pCscOutputStream);
     }
 
@@ -77,7 +101,15 @@ int closeCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream)
 
     if(pCscOutputStream->m_dataOutputStream != NULL)
     {
+        int rc1 = stopAsyncWritesCscOutputStream(pCscOutputStream);
+        int rc2 = drainBufferCscOutputStream(pCscOutputStream);
+
+        if(!rc1)
+            rc1 = rc2;
+
         rc = fclose(pCscOutputStream->m_dataOutputStream);
+        if(!rc)
+            rc = rc1;
 
         pCscOutputStream->m_dataOutputStream = NULL;
         pCscOutputStream->m_fd = 0;
@@ -96,11 +128,7 @@ int closeCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream)
 //
 int writeShortCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream,short v) 
 {
-    size_t rc = fwrite(&v,sizeof(short),1,pCscOutputStream->m_dataOutputStream);
-
-    incCountCscOutputStream(pCscOutputStream,2);
-
-    return (rc == 0);
+    return appendCscOutputStream(pCscOutputStream, &v, sizeof(short));
 }
 
 /*====================================================================================================================================================*/
@@ -110,11 +138,7 @@ int writeShortCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream,sho
 //
 int writeIntCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream,int v) 
 {
-    size_t rc = fwrite(&v,sizeof(int),1,pCscOutputStream->m_dataOutputStream);
-
-    incCountCscOutputStream(pCscOutputStream, 4);
-
-    return (rc == 0);
+    return appendCscOutputStream(pCscOutputStream, &v, sizeof(int));
 }
 
 /*====================================================================================================================================================*/
@@ -124,11 +148,7 @@ int writeIntCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream,int v
 //
 int writeLongLongCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, long long v) 
 {
-    size_t rc = fwrite(&v,sizeof(long long),1,pCscOutputStream->m_dataOutputStream);
-
-    incCountCscOutputStream(pCscOutputStream, 8);
-
-    return (rc == 0);
+    return appendCscOutputStream(pCscOutputStream, &v, sizeof(long long));
 }
 
 /*====================================================================================================================================================*/
@@ -138,11 +158,99 @@ int writeLongLongCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream,
 //
 int writeCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, char b[], int off, int len) 
 {
-    size_t rc = fwrite(b+off,sizeof(char),len,pCscOutputStream->m_dataOutputStream);
+    return appendCscOutputStream(pCscOutputStream, b + off, len);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Append bytes to the write buffer. Large values bypass the buffer, unless writes are asynchronous. 0 means successful.
+//
+int appendCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, const void *b, int len) 
+{
+    int rc = 0;
+
+    if(len <= 0)
+        return 0;
+
+    if(pCscOutputStream->m_buffer == NULL)
+    {
+        rc = (fwrite(b,sizeof(char),len,pCscOutputStream->m_dataOutputStream) != (size_t)len);
+    }
+    else
+    if(pCscOutputStream->m_asyncWriter != NULL)
+    {
+        const char *pSrc = (const char *)b;
+        int left = len;
+
+        // Buffer belongs to the I/O thread once it's queued, so large values are copied in pieces.
+        while(rc == 0 && left > 0)
+        {
+            int space = pCscOutputStream->m_bufferSize - pCscOutputStream->m_bufferLen;
+            int copyLen = (left < space) ? left : space;
+
+            memcpy(pCscOutputStream->m_buffer + pCscOutputStream->m_bufferLen, pSrc, copyLen);
+            pCscOutputStream->m_bufferLen += copyLen;
+            pSrc += copyLen;
+            left -= copyLen;
+
+            if(pCscOutputStream->m_bufferLen == pCscOutputStream->m_bufferSize)
+                rc = queueBufferCscOutputStream(pCscOutputStream, -1);
+        }
+    }
+    else
+    {
+        if(len > pCscOutputStream->m_bufferSize - pCscOutputStream->m_bufferLen)
+            rc = drainBufferCscOutputStream(pCscOutputStream);
+
+        if(rc == 0)
+        {
+            if(len >= pCscOutputStream->m_bufferSize)
+                rc = (fwrite(b,sizeof(char),len,pCscOutputStream->m_dataOutputStream) != (size_t)len);
+            else
+            {
+                memcpy(pCscOutputStream->m_buffer + pCscOutputStream->m_bufferLen, b, len);
+                pCscOutputStream->m_bufferLen += len;
+            }
+        }
+    }
 
     incCountCscOutputStream(pCscOutputStream,len);
 
-    return (rc == 0);
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Hand over the write buffer to the OS. There is no fsync, so it's cheap. 0 means successful.
+// With asynchronous writes, it waits for the I/O thread to write all queued buffers.
+//
+int drainBufferCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream) 
+{
+    int rc = 0;
+
+    if(pCscOutputStream->m_asyncWriter != NULL)
+    {
+        int rc1;
+
+        if(pCscOutputStream->m_bufferLen > 0)
+            rc = queueBufferCscOutputStream(pCscOutputStream, -1);
+
+        rc1 = waitForQueueCscOutputStream(pCscOutputStream);
+        if(!rc)
+            rc = rc1;
+    }
+    else
+    if(pCscOutputStream->m_buffer != NULL && pCscOutputStream->m_bufferLen > 0)
+    {
+        size_t written = fwrite(pCscOutputStream->m_buffer,sizeof(char),pCscOutputStream->m_bufferLen,pCscOutputStream->m_dataOutputStream);
+
+        rc = (written != (size_t)pCscOutputStream->m_bufferLen);
+        pCscOutputStream->m_bufferLen = 0;
+    }
+
+    return rc;
 }
 
 /*====================================================================================================================================================*/
@@ -158,7 +266,7 @@ long long sizeCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream)
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Get file pointer position.
+// Get file pointer position. We track it ourselves, unless sync writes is on.
 //
 long long getPositionCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream) 
 {
@@ -167,36 +275,352 @@ long long getPositionCscOutputStream(ClientSideCursorOutputStream *pCscOutputStr
         return -1;
     }
     else
+    if(pCscOutputStream->m_syncWrites)
     {
         fflush(pCscOutputStream->m_dataOutputStream);
         
         return rs_ftello(pCscOutputStream->m_dataOutputStream);
     }
+    else
+        return pCscOutputStream->m_written;
 }
 
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
-// Flush the output. 0 means successful.
+// Flush the output, so reader can see all rows written so far. 0 means successful.
+// Only sync writes commit the file to disk.
 //
 int flushCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream) 
 {
     int rc;
 
-    if(doesItForwardOnlyCursor(pCscOutputStream->m_resultsettype))
+    if(pCscOutputStream->m_syncWrites)
     {
-        fflush(pCscOutputStream->m_dataOutputStream);
-
-        rc = rs_fsync(pCscOutputStream->m_fd);
+        if(doesItForwardOnlyCursor(pCscOutputStream->m_resultsettype))
+        {
+            fflush(pCscOutputStream->m_dataOutputStream);
+
+            rc = rs_fsync(pCscOutputStream->m_fd);
+        }
+        else
+            rc = 0;
     }
     else
-        rc = 0;
+        rc = drainBufferCscOutputStream(pCscOutputStream);
 
     return rc;
 } 
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Commit everything written so far and report the commit token through the commit callback, 
+// once it's in the file. With asynchronous writes, it doesn't wait for the I/O thread. 0 means successful.
+//
+int commitCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, long long commitToken) 
+{
+    int rc;
+
+    if(pCscOutputStream->m_asyncWriter != NULL)
+        return queueBufferCscOutputStream(pCscOutputStream, commitToken);
+
+    rc = flushCscOutputStream(pCscOutputStream);
+
+    if(!rc && pCscOutputStream->m_pfnCommit != NULL)
+        pCscOutputStream->m_pfnCommit(pCscOutputStream->m_commitContext, commitToken);
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Set the commit callback.
+//
+void setCommitCallbackCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, CSC_COMMIT_CALLBACK pfnCommit, void *pContext)
+{
+    pCscOutputStream->m_pfnCommit = pfnCommit;
+    pCscOutputStream->m_commitContext = pContext;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Start the I/O thread, so buffered writes don't block the writer. 
+// 1 means started. Otherwise writes stay on the caller thread.
+//
+int startAsyncWritesCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream)
+{
+    ClientSideCursorAsyncWriter *pWriter;
+    int started;
+    int i;
+
+    // Only buffered writes can be asynchronous.
+    if(pCscOutputStream->m_buffer == NULL || pCscOutputStream->m_asyncWriter != NULL)
+        return (pCscOutputStream->m_asyncWriter != NULL);
+
+    pWriter = rs_calloc(1, sizeof(ClientSideCursorAsyncWriter));
+    if(pWriter == NULL)
+        return FALSE;
+
+    // First buffer is the stream buffer, so rows already in it stay.
+    pWriter->m_buffers[0].m_data = pCscOutputStream->m_buffer;
+    started = TRUE;
+    for(i = 0; i < CSC_OUTPUT_BUFFER_COUNT; i++)
+    {
+        if(i > 0)
+        {
+            pWriter->m_buffers[i].m_data = rs_malloc(pCscOutputStream->m_bufferSize);
+            if(pWriter->m_buffers[i].m_data == NULL)
+                started = FALSE;
+        }
+
+        pWriter->m_buffers[i].m_commitToken = -1;
+    }
+
+    pWriter->m_lock = rsCreateMutex();
+    pWriter->m_queuedSem = rsCreateBinarySem(0);
+    pWriter->m_freeSem = rsCreateBinarySem(0);
+    pWriter->m_doneSem = rsCreateBinarySem(0);
+
+    if(started)
+        started = (pWriter->m_lock != NULL && pWriter->m_queuedSem != NULL && pWriter->m_freeSem != NULL && pWriter->m_doneSem != NULL);
+
+    if(started)
+    {
+        pCscOutputStream->m_asyncWriter = pWriter;
+        pWriter->m_hThread = rsCreateThread(runCscOutputThread, pCscOutputStream);
+
+        started = (pWriter->m_hThread != (THREAD_HANDLE)(long)NULL);
+#ifdef WIN32
+        started = (started && pWriter->m_hThread != INVALID_HANDLE_VALUE);
+#endif
+        if(!started)
+            pCscOutputStream->m_asyncWriter = NULL;
+    }
+
+    if(!started)
+        releaseCscAsyncWriter(pWriter);
+
+    return started;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Write all queued buffers and stop the I/O thread. 0 means successful.
+//
+int stopAsyncWritesCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream)
+{
+    ClientSideCursorAsyncWriter *pWriter = pCscOutputStream->m_asyncWriter;
+    int rc;
+
+    if(pWriter == NULL)
+        return 0;
+
+    rc = drainBufferCscOutputStream(pCscOutputStream);
+
+    rsLockMutex(pWriter->m_lock);
+    pWriter->m_stop = TRUE;
+    rsUnlockMutex(pWriter->m_lock);
+    rsUnlockSem(pWriter->m_queuedSem);
+
+    rsLockSem(pWriter->m_doneSem);
+#if defined LINUX 
+    rsJoinThread(pWriter->m_hThread);
+#endif
+    pWriter->m_hThread = (THREAD_HANDLE)(long)NULL;
+
+    if(!rc)
+        rc = pWriter->m_error;
+
+    // Back to the stream buffer.
+    pCscOutputStream->m_buffer = pWriter->m_buffers[0].m_data;
+    pCscOutputStream->m_bufferLen = 0;
+    pCscOutputStream->m_asyncWriter = releaseCscAsyncWriter(pWriter);
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Release the asynchronous writer. The first buffer belongs to the stream.
+//
+ClientSideCursorAsyncWriter *releaseCscAsyncWriter(ClientSideCursorAsyncWriter *pWriter)
+{
+    if(pWriter)
+    {
+        int i;
+
+        for(i = 1; i < CSC_OUTPUT_BUFFER_COUNT; i++)
+            pWriter->m_buffers[i].m_data = rs_free(pWriter->m_buffers[i].m_data);
+
+        rsDestroySem(pWriter->m_doneSem);
+        rsDestroySem(pWriter->m_freeSem);
+        rsDestroySem(pWriter->m_queuedSem);
+        rsDestroyMutex(pWriter->m_lock);
+        pWriter = rs_free(pWriter);
+    }
+
+    return NULL;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Queue the buffer being filled for the I/O thread and switch to the next one. 
+// It waits, if all buffers are queued. 0 means successful.
+//
+int queueBufferCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, long long commitToken)
+{
+    ClientSideCursorAsyncWriter *pWriter = pCscOutputStream->m_asyncWriter;
+    ClientSideCursorOutputBuffer *pBuffer = &(pWriter->m_buffers[pWriter->m_fillIndex]);
+    int rc;
+
+    pBuffer->m_len = pCscOutputStream->m_bufferLen;
+    pBuffer->m_commitToken = commitToken;
+
+    rsLockMutex(pWriter->m_lock);
+    (pWriter->m_queued)++;
+    rsUnlockMutex(pWriter->m_lock);
+    rsUnlockSem(pWriter->m_queuedSem);
+
+    // Buffers are written in order, so the next one is free when not all are queued.
+    pWriter->m_fillIndex = (pWriter->m_fillIndex + 1) % CSC_OUTPUT_BUFFER_COUNT;
+
+    rsLockMutex(pWriter->m_lock);
+    while(pWriter->m_queued == CSC_OUTPUT_BUFFER_COUNT)
+    {
+        rsUnlockMutex(pWriter->m_lock);
+        rsLockSem(pWriter->m_freeSem);
+        rsLockMutex(pWriter->m_lock);
+    }
+    rc = pWriter->m_error;
+    rsUnlockMutex(pWriter->m_lock);
+
+    pCscOutputStream->m_buffer = pWriter->m_buffers[pWriter->m_fillIndex].m_data;
+    pCscOutputStream->m_bufferLen = 0;
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Wait for the I/O thread to write all queued buffers. 0 means successful.
+//
+int waitForQueueCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream)
+{
+    ClientSideCursorAsyncWriter *pWriter = pCscOutputStream->m_asyncWriter;
+    int rc;
+
+    rsLockMutex(pWriter->m_lock);
+    while(pWriter->m_queued > 0)
+    {
+        rsUnlockMutex(pWriter->m_lock);
+        rsLockSem(pWriter->m_freeSem);
+        rsLockMutex(pWriter->m_lock);
+    }
+    rc = pWriter->m_error;
+    rsUnlockMutex(pWriter->m_lock);
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get write error of the I/O thread. 0 means no error.
+//
+int getAsyncErrorCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream)
+{
+    ClientSideCursorAsyncWriter *pWriter = pCscOutputStream->m_asyncWriter;
+    int rc = 0;
+
+    if(pWriter != NULL)
+    {
+        rsLockMutex(pWriter->m_lock);
+        rc = pWriter->m_error;
+        rsUnlockMutex(pWriter->m_lock);
+    }
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Run the I/O thread. It writes queued buffers in order and reports commits after their data is written.
+// After a write error, it only releases the buffers, so the writer never waits forever.
+//
+#ifdef WIN32
+void
+#endif
+#if defined LINUX 
+void *
+#endif
+runCscOutputThread(void *pArg)
+{
+    ClientSideCursorOutputStream *pCscOutputStream = (ClientSideCursorOutputStream *)pArg;
+    ClientSideCursorAsyncWriter *pWriter = pCscOutputStream->m_asyncWriter;
+
+    for(;;)
+    {
+        ClientSideCursorOutputBuffer *pBuffer;
+        int queued;
+        int stop;
+        int error;
+
+        rsLockMutex(pWriter->m_lock);
+        queued = pWriter->m_queued;
+        stop = pWriter->m_stop;
+        error = pWriter->m_error;
+        rsUnlockMutex(pWriter->m_lock);
+
+        if(queued == 0)
+        {
+            if(stop)
+                break;
+
+            rsLockSem(pWriter->m_queuedSem);
+            continue;
+        }
+
+        pBuffer = &(pWriter->m_buffers[pWriter->m_writeIndex]);
+
+        if(!error && pBuffer->m_len > 0)
+        {
+            size_t written = fwrite(pBuffer->m_data,sizeof(char),pBuffer->m_len,pCscOutputStream->m_dataOutputStream);
+
+            error = (written != (size_t)pBuffer->m_len);
+        }
+
+        if(!error && pBuffer->m_commitToken >= 0 && pCscOutputStream->m_pfnCommit != NULL)
+            pCscOutputStream->m_pfnCommit(pCscOutputStream->m_commitContext, pBuffer->m_commitToken);
+
+        pBuffer->m_len = 0;
+        pBuffer->m_commitToken = -1;
+        pWriter->m_writeIndex = (pWriter->m_writeIndex + 1) % CSC_OUTPUT_BUFFER_COUNT;
+
+        rsLockMutex(pWriter->m_lock);
+        if(error)
+            pWriter->m_error = error;
+        (pWriter->m_queued)--;
+        rsUnlockMutex(pWriter->m_lock);
+        rsUnlockSem(pWriter->m_freeSem);
+    }
+
+    rsUnlockSem(pWriter->m_doneSem);
+
+#if defined LINUX 
+    return NULL;
+#endif
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Check for ODBC cursor type.
 //
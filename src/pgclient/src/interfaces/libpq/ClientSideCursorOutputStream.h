@@ -29,8 +29,70 @@
 #endif
 
 #include "rsfile.h"
+#include "rslock.h"
 #include "rsmem.h"
 
+// Size of the user space write buffer.
+#define CSC_OUTPUT_BUFFER_SIZE  (1024 * 1024)
+
+// Number of write buffers with asynchronous writes. One is filled by the writer, while others wait for the I/O thread.
+#define CSC_OUTPUT_BUFFER_COUNT  3
+
+// Called when everything written before a commit is in the file. It runs on the I/O thread with asynchronous writes.
+typedef void (*CSC_COMMIT_CALLBACK)(void *pContext, long long commitToken);
+
+// Write buffer handed over to the I/O thread.
+typedef struct _ClientSideCursorOutputBuffer
+{
+    char *m_data;
+
+    // Bytes used in the buffer
+    int m_len;
+
+    // Commit token to report after the buffer is written. -1 means no commit.
+    long long m_commitToken;
+}ClientSideCursorOutputBuffer;
+
+/**
+ * Asynchronous writer. 
+ * The writer fills one buffer, while the I/O thread writes the queued ones in order.
+ * The writer waits, when all buffers are queued.
+ *
+ */
+typedef struct _ClientSideCursorAsyncWriter
+{
+    ClientSideCursorOutputBuffer m_buffers[CSC_OUTPUT_BUFFER_COUNT];
+
+    // Buffer being filled by the writer
+    int m_fillIndex;
+
+    // Next buffer to write by the I/O thread
+    int m_writeIndex;
+
+    // Buffers queued for the I/O thread
+    int m_queued;
+
+    // Stop the I/O thread, once the queue is empty.
+    int m_stop;
+
+    // Write error on the I/O thread. Writer gets it on its next call.
+    int m_error;
+
+    // Lock for m_queued, m_stop and m_error
+    MUTEX_HANDLE m_lock;
+
+    // Signaled when a buffer is queued or stop is requested.
+    SEM_HANDLE m_queuedSem;
+
+    // Signaled when the I/O thread is done with a buffer.
+    SEM_HANDLE m_freeSem;
+
+    // Signaled when the I/O thread exits. Windows thread handle couldn't be joined.
+    SEM_HANDLE m_doneSem;
+
+    THREAD_HANDLE m_hThread;
+}ClientSideCursorAsyncWriter;
+
 /**
  * Multiplex output stream for forward only cursor and scrollable cursor.
  * 
@@ -48,7 +110,28 @@ typedef struct _ClientSideCursorOutputStream
     
     // The number of bytes written to the data output stream so far. 
     // If this counter overflows, it will be wrapped to Long.MAX_VALUE.
+    // It is also the position of the next write, so we never ask stdio for it.
     long long m_written;
+
+    // User space write buffer. Rows are copied here and handed to the OS only on commit or when it is full.
+    char *m_buffer;
+
+    // Bytes used in the write buffer.
+    int m_bufferLen;
+
+    // Size of the write buffer.
+    int m_bufferSize;
+
+    // Sync writes: flush on every position query and fsync on every commit.
+    // The file is a throwaway spill, so it is off by default.
+    int m_syncWrites;
+
+    // Commit callback and its context
+    CSC_COMMIT_CALLBACK m_pfnCommit;
+    void *m_commitContext;
+
+    // Asynchronous writer. NULL means writes are done on the caller thread.
+    ClientSideCursorAsyncWriter *m_asyncWriter;
 }ClientSideCursorOutputStream;
 
 #ifdef __cplusplus
@@ -56,7 +139,7 @@ extern "C"
 {
 #endif /* C++ */
 
-ClientSideCursorOutputStream *createCscOutputStream(char *fileName, int resultsettype, int *pError);
+ClientSideCursorOutputStream *createCscOutputStream(char *fileName, int resultsettype, int syncWrites, int *pError);
 ClientSideCursorOutputStream *releaseCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
 int closeCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
 int writeShortCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream,short v);
@@ -66,6 +149,16 @@ int writeCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, char b[
 long long sizeCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
 long long getPositionCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
 int flushCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
+int commitCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, long long commitToken);
+void setCommitCallbackCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, CSC_COMMIT_CALLBACK pfnCommit, void *pContext);
+int drainBufferCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
+int appendCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, const void *b, int len);
+int startAsyncWritesCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
+int stopAsyncWritesCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
+ClientSideCursorAsyncWriter *releaseCscAsyncWriter(ClientSideCursorAsyncWriter *pWriter);
+int queueBufferCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, long long commitToken);
+int waitForQueueCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
+int getAsyncErrorCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream);
 int doesItForwardOnlyCursor(int resultsettype);
 void incCountCscOutputStream(ClientSideCursorOutputStream *pCscOutputStream, int value);
 void setIOErrorCsc(int *pError, int value);
@@ -13,6 +13,7 @@
 static MUTEX_HANDLE g_CscMethodLock = NULL;
 
 void _pgFreeTuplePointers(PGresult * res);
+static PGresAttValue **allocTuplesCsc(PGresult *res, int rows, int *pCapacity);
 
 /*====================================================================================================================================================*/
 
@@ -110,6 +111,14 @@ ClientSideCursorResult *createCscResultWithFileName(ClientSideCursorOptions *pCs
         
         pCsc->m_executeIndex  = executeIndex;
         pCsc->m_skipResult = FALSE;
+
+        // File opened for reading has no block directory, so it must be in row format.
+        pCsc->m_fileFormat = (pCscOptions != NULL && !openForReading) ? getFileFormatCscOption(pCscOptions) : CSC_FILE_FORMAT_ROW;
+        pCsc->m_cscBlockWriter = NULL;
+        pCsc->m_cscBlockReader = NULL;
+        pCsc->m_cscBlockDir = NULL;
+        pCsc->m_cscBlockCache = NULL;
+        pCsc->m_cacheOwnerId = 0;
     }
 
     return pCsc;
@@ -125,6 +134,16 @@ ClientSideCursorResult *releaseCsc(ClientSideCursorResult *pCsc)
     if(pCsc)
     {
         pCsc->m_cscLock = destroyCscLock(pCsc->m_cscLock);
+        pCsc->m_cscBlockWriter = releaseCscBlockWriter(pCsc->m_cscBlockWriter);
+        pCsc->m_cscBlockReader = releaseCscBlockReader(pCsc->m_cscBlockReader);
+        pCsc->m_cscBlockDir = releaseCscBlockDir(pCsc->m_cscBlockDir);
+
+        if(pCsc->m_cscBlockCache != NULL)
+        {
+            removeOwnerCscBlockCache(pCsc->m_cscBlockCache, pCsc->m_cacheOwnerId);
+            pCsc->m_cscBlockCache = releaseCscBlockCache(pCsc->m_cscBlockCache);
+        }
+
         pCsc = rs_free(pCsc);
     }
 
@@ -300,10 +319,34 @@ int createFileCsc(ClientSideCursorResult *pCsc, PGresult *pgResult)
         traceInfoCsc("createFile: Start creating data file: %s records count in mem:%d", pCsc->m_fileName, ((pgResult != NULL) ? PQntuples(pgResult) : 0)); 
     }
 
-    pCsc->m_cscOutputStream = createCscOutputStream(pCsc->m_fileName, pCsc->m_resultsettype, &(pCsc->m_ioe));
+    pCsc->m_cscOutputStream = createCscOutputStream(pCsc->m_fileName, pCsc->m_resultsettype, 
+                                                    getSyncWritesCscOption(pCsc->m_cscOptions), &(pCsc->m_ioe));
 
     if(pCsc->m_ioe)
         return pCsc->m_ioe;
+
+    // Rows are published for reading, once they are in the file.
+    setCommitCallbackCscOutputStream(pCsc->m_cscOutputStream, commitRowsCsc, pCsc);
+
+    // Without sync writes, the file is written on an I/O thread, so decoding of next rows overlaps the writes.
+    if(!getSyncWritesCscOption(pCsc->m_cscOptions))
+    {
+        int async = startAsyncWritesCscOutputStream(pCsc->m_cscOutputStream);
+
+        RS_LOG_DEBUG("CSCINF", "CSC data file async writes=%d", async);
+    }
+
+    if(isBlockFileFormatCsc(pCsc))
+    {
+        pCsc->m_cscBlockWriter = createCscBlockWriter(TRUE);
+        pCsc->m_cscBlockDir = createCscBlockDir();
+
+        if(pCsc->m_cscBlockWriter == NULL || pCsc->m_cscBlockDir == NULL)
+        {
+            pCsc->m_ioe = TRUE;
+            return pCsc->m_ioe;
+        }
+    }
     
     pCsc->m_fileCreated = TRUE;
 
@@ -330,9 +373,14 @@ int createFileCsc(ClientSideCursorResult *pCsc, PGresult *pgResult)
             traceInfoCsc("createFile: Start pushing first batch of data in file for scrollable cursor..."); 
         }
 
-        pCsc->m_cscOffsetOutputStream = createCscOutputStream(pCsc->m_offsetFileName, pCsc->m_resultsettype, &(pCsc->m_ioe));
-        if(pCsc->m_ioe)
-            return pCsc->m_ioe;
+        // Block format finds rows using the block directory.
+        if(!isBlockFileFormatCsc(pCsc))
+        {
+            pCsc->m_cscOffsetOutputStream = createCscOutputStream(pCsc->m_offsetFileName, pCsc->m_resultsettype, 
+                                                                    getSyncWritesCscOption(pCsc->m_cscOptions), &(pCsc->m_ioe));
+            if(pCsc->m_ioe)
+                return pCsc->m_ioe;
+        }
         
         noOfRows = (pgResult != NULL) ? PQntuples(pgResult) : 0;
         noOfCols = PQnfields(pgResult);
@@ -353,7 +401,9 @@ int createFileCsc(ClientSideCursorResult *pCsc, PGresult *pgResult)
         } // row loop
         
         // Remember position in file, from where next read will happen from file, because we already have first batch in memory.
-        pCsc->m_firstReadFromFileOffset =  getPositionCscOutputStream(pCsc->m_cscOutputStream);
+        // Block format reads by row number.
+        if(!isBlockFileFormatCsc(pCsc))
+            pCsc->m_firstReadFromFileOffset =  getPositionCscOutputStream(pCsc->m_cscOutputStream);
         
         pCsc->m_lastRowNumberInMem = pCsc->m_totalRows;
     }
@@ -370,8 +420,12 @@ int createFileCsc(ClientSideCursorResult *pCsc, PGresult *pgResult)
 //    for each column:
 //         4 bytes: column value length. 0 means empty string, -1 means NULL, otherwise actual data length in bytes.
 //         N bytes: column value in bytes.
+// Block format is described in ClientSideCursorBlock.h.
 int writeRowCsc(ClientSideCursorResult *pCsc, PGresAttValue *tuple, int noOfCols) 
 {
+    if(pCsc->m_cscBlockWriter != NULL)
+        return writeBlockRowCsc(pCsc, tuple, noOfCols);
+
     if(pCsc->m_cscOutputStream != NULL && tuple != NULL)
     {
         long long maxFileSize = getMaxFileSizeCscOption(pCsc->m_cscOptions);
@@ -387,8 +441,9 @@ int writeRowCsc(ClientSideCursorResult *pCsc, PGresAttValue *tuple, int noOfCols
                     // 8 bytes as offset in data file.
                     pCsc->m_ioe = writeLongLongCscOutputStream(pCsc->m_cscOffsetOutputStream, getPositionCscOutputStream(pCsc->m_cscOutputStream));
 
-                    // Flush the offset file for parallel reading.
-                    getPositionCscOutputStream(pCsc->m_cscOffsetOutputStream);
+                    // Flush the offset file for parallel reading. Without sync writes, it's done on commit.
+                    if(getSyncWritesCscOption(pCsc->m_cscOptions))
+                        getPositionCscOutputStream(pCsc->m_cscOffsetOutputStream);
                 }
             }
             
@@ -413,13 +468,13 @@ int writeRowCsc(ClientSideCursorResult *pCsc, PGresAttValue *tuple, int noOfCols
             
             if((pCsc->m_totalRows  % BATCH_SIZE_TO_PROCESS) == 0)
             {
-                pCsc->m_totalCommitedRows = pCsc->m_totalRows;
-                
-                // Flush the output
-                pCsc->m_ioe = flushCscOutputStream(pCsc->m_cscOutputStream);
-                
-                // Signal batch has been written
-                signalForBatchResultReadFromServerCsc(pCsc);
+                // Offsets of the batch must be in the file, before the batch is published.
+                if(!(pCsc->m_ioe) && pCsc->m_cscOffsetOutputStream != NULL)
+                    pCsc->m_ioe = flushCscOutputStream(pCsc->m_cscOffsetOutputStream);
+
+                // Flush the output, so reader can see the batch. It's published by commitRowsCsc.
+                if(!(pCsc->m_ioe))
+                    pCsc->m_ioe = commitCscOutputStream(pCsc->m_cscOutputStream, pCsc->m_totalRows);
             } 
 
 /*            if(!doesItForwardOnlyCursor(pCsc->m_resultsettype))
@@ -452,6 +507,88 @@ int writeRowCsc(ClientSideCursorResult *pCsc, PGresAttValue *tuple, int noOfCols
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Write one row in the block format. 0 means successful.
+// Rows are committed for reading when their block is written.
+//
+int writeBlockRowCsc(ClientSideCursorResult *pCsc, PGresAttValue *tuple, int noOfCols)
+{
+    if(pCsc->m_cscOutputStream != NULL && tuple != NULL)
+    {
+        long long maxFileSize = getMaxFileSizeCscOption(pCsc->m_cscOptions);
+
+        if((maxFileSize == 0) || (sizeCscOutputStream(pCsc->m_cscOutputStream) < maxFileSize))
+        {
+            pCsc->m_ioe = addRowCscBlockWriter(pCsc->m_cscBlockWriter, tuple, noOfCols);
+
+            (pCsc->m_totalRows)++;
+
+            if(!(pCsc->m_ioe) && isFullCscBlockWriter(pCsc->m_cscBlockWriter))
+                pCsc->m_ioe = commitBlockCsc(pCsc);
+        }
+        else
+        {
+            // File max size reached.
+            if(IS_TRACE_ON_CSC())
+            {
+                traceInfoCsc("writeBlockRow: File max size reached. file max size = %lld", maxFileSize); 
+            }
+
+           pCsc->m_ioe = TRUE;
+           // Drain current result
+           pCsc->m_skipResult = TRUE;
+        }
+    }
+
+    return pCsc->m_ioe;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Write the current block, make it visible to the reader and signal it. 0 means successful.
+//
+int commitBlockCsc(ClientSideCursorResult *pCsc)
+{
+    ClientSideCursorBlockDirEntry entry;
+    int rc;
+
+    if(pCsc->m_cscBlockWriter == NULL || pCsc->m_cscBlockWriter->m_rows == 0)
+        return 0;
+
+    rc = writeBlockCscBlockWriter(pCsc->m_cscBlockWriter, pCsc->m_cscOutputStream,
+                                  pCsc->m_totalRows - pCsc->m_cscBlockWriter->m_rows + 1, &entry);
+
+    // Reader doesn't look up rows beyond the committed rows, so the entry can go first.
+    if(!rc)
+        rc = addEntryCscBlockDir(pCsc->m_cscBlockDir, &entry);
+
+    // Flush the output, so reader can see the block. It's published by commitRowsCsc.
+    if(!rc)
+        rc = commitCscOutputStream(pCsc->m_cscOutputStream, entry.m_firstRowNumber + entry.m_rows - 1);
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Commit callback of the data file. Rows up to commitToken are in the file.
+// It runs on the I/O thread with asynchronous writes.
+//
+void commitRowsCsc(void *pContext, long long commitToken)
+{
+    ClientSideCursorResult *pCsc = (ClientSideCursorResult *)pContext;
+
+    // Publish the committed rows watermark. Reader never reads beyond it while we are writing.
+    pCsc->m_totalCommitedRows = (int)commitToken;
+
+    // Signal batch has been written
+    signalForBatchResultReadFromServerCsc(pCsc);
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Close the csc file.
 //
@@ -468,15 +605,28 @@ int closeOutputFileCsc(ClientSideCursorResult *pCsc)
             traceInfoCsc("closeOutputFile: End pushing data in file...%s", pCsc->m_fileName); 
         }
 
-        pCsc->m_totalCommitedRows = pCsc->m_totalRows;
+        // Write the last block
+        rc1 = 0;
+        if(pCsc->m_cscBlockWriter != NULL)
+        {
+            if(!(pCsc->m_ioe))
+                rc1 = commitBlockCsc(pCsc);
 
+            pCsc->m_cscBlockWriter = releaseCscBlockWriter(pCsc->m_cscBlockWriter);
+        }
+
+        // Close waits for the I/O thread, so all rows are in the files after it.
         rc = closeCscOutputStream(pCsc->m_cscOutputStream);
-        
+        if(!rc)
+            rc = rc1;
+
         pCsc->m_cscOutputStream = releaseCscOutputStream(pCsc->m_cscOutputStream);
         
         rc1 = closeOffsetOutputFileCsc(pCsc);
         if(!rc)
             rc = rc1;
+
+        pCsc->m_totalCommitedRows = pCsc->m_totalRows;
     }
     else
         rc = 0;
@@ -607,6 +757,16 @@ int pgCloseCsc(PGresult * pgResult)
     return rc;
 }
 
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether rows of the pgResult are in a csc file, rather than all in memory.
+//
+int pgHasCsc(PGresult * pgResult) 
+{
+    return ((pgResult) && (pgResult->m_cscResult != NULL));
+}
+
 
 //---------------------------------------------------------------------------------------------------------igarish
 // Close the csc. i.e. delete the file associated with it. 0 means successful.
@@ -786,6 +946,9 @@ PGresAttValue **readNextBatchOfRowsCsc(ClientSideCursorResult *pCsc, PGresult *
 PGresAttValue *readRowCsc(ClientSideCursorResult *pCsc, int *piError,int *piEof) 
 {
     PGresAttValue *tuple = NULL;
+
+    if(pCsc->m_cscBlockReader != NULL)
+        return readBlockRowCsc(pCsc, piError, piEof);
     
     pCsc->m_rawRowLengthFromFile = 0;
     *piError = 0;
@@ -882,6 +1045,116 @@ PGresAttValue *readRowCsc(ClientSideCursorResult *pCsc, int *piError,int *piEof)
 }
 
 
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Read a single row from the file in block format. Next row is m_lastRowNumberInMem + 1.
+//
+PGresAttValue *readBlockRowCsc(ClientSideCursorResult *pCsc, int *piError, int *piEof)
+{
+    PGresAttValue *tuple = NULL;
+    int rowNumber = pCsc->m_lastRowNumberInMem + 1;
+
+    pCsc->m_rawRowLengthFromFile = 0;
+    *piError = 0;
+    *piEof = 0;
+
+    if(rowNumber > pCsc->m_totalCommitedRows)
+    {
+        // Writer didn't commit the row yet or no more rows.
+        *piEof = TRUE;
+    }
+    else
+    {
+        *piError = loadBlockOfRowCsc(pCsc, rowNumber);
+
+        if(*piError == 0)
+        {
+            tuple = readRowCscBlockReader(pCsc->m_cscBlockReader, rowNumber, &(pCsc->m_rawRowLengthFromFile));
+
+            if(tuple != NULL)
+                (pCsc->m_lastRowNumberInMem)++;
+            else
+                *piError = 1;
+        }
+    }
+
+    return tuple;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Load the block which has given row number, if it's not loaded. Row number start from 1. 0 means successful.
+//
+int loadBlockOfRowCsc(ClientSideCursorResult *pCsc, int rowNumber)
+{
+    int rc = 0;
+
+    if(pCsc->m_cscBlockReader == NULL)
+        return 1;
+
+    if(!containsRowCscBlockReader(pCsc->m_cscBlockReader, rowNumber))
+    {
+        ClientSideCursorBlockDirEntry entry;
+        ClientSideCursorBlockReader *pReader = pCsc->m_cscBlockReader;
+
+        // Scroll direction, compared to the block loaded before
+        int forward = (pReader->m_block.m_rows == 0) || (rowNumber >= pReader->m_block.m_firstRowNumber);
+
+        if(findEntryCscBlockDir(pCsc->m_cscBlockDir, rowNumber, &entry))
+            rc = loadCscBlockReader(pReader, pCsc->m_cscInputStream, &entry);
+        else
+            rc = 1;
+
+        if(rc)
+        {
+            if(IS_TRACE_ON_CSC())
+            {
+                traceInfoCsc("loadBlockOfRow: File read error. File name = %s. Row number = %d", pCsc->m_fileName, rowNumber); 
+            }
+        }
+        else
+        {
+            // Read ahead the next block in the scroll direction, so it's in memory when the reader gets there.
+            ClientSideCursorBlockDirEntry next;
+            int nextRowNumber = (forward) ? (entry.m_firstRowNumber + entry.m_rows) : (entry.m_firstRowNumber - 1);
+
+            if(nextRowNumber >= 1 && nextRowNumber <= pCsc->m_totalCommitedRows
+                && findEntryCscBlockDir(pCsc->m_cscBlockDir, nextRowNumber, &next))
+            {
+                prefetchCscInputStream(pCsc->m_cscInputStream, next.m_offset, next.m_size);
+            }
+        }
+    }
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Use the block cache of the connection. Result holds a reference to it, because it can outlive the connection.
+//
+void setBlockCacheCsc(ClientSideCursorResult *pCsc, ClientSideCursorBlockCache *pCache)
+{
+    if(pCsc->m_cscBlockCache == NULL && pCache != NULL)
+    {
+        pCsc->m_cscBlockCache = addRefCscBlockCache(pCache);
+        pCsc->m_cacheOwnerId = newOwnerCscBlockCache(pCache);
+    }
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Is the file in block format?
+//
+int isBlockFileFormatCsc(ClientSideCursorResult *pCsc)
+{
+    return (pCsc->m_fileFormat == CSC_FILE_FORMAT_BLOCK);
+}
+
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
@@ -896,6 +1169,11 @@ int closeInputFileCsc(ClientSideCursorResult *pCsc)
         rc = closeCscInputStream(pCsc->m_cscInputStream);
         
         pCsc->m_cscInputStream = releaseCscInputStream(pCsc->m_cscInputStream);
+        pCsc->m_cscBlockReader = releaseCscBlockReader(pCsc->m_cscBlockReader);
+
+        // Cached blocks of the file aren't needed anymore.
+        if(pCsc->m_cscBlockCache != NULL)
+            removeOwnerCscBlockCache(pCsc->m_cscBlockCache, pCsc->m_cacheOwnerId);
     }
     else
         rc = 0;
@@ -1032,10 +1310,11 @@ PGresAttValue **readNextBatchOfRowsFromOffsetCsc(ClientSideCursorResult *pCsc, l
                     int row = 0;
                     PGresAttValue *tuple;
             
-                    // Jump to the start row offset
-                    pCsc->m_ioe = seekCscInputStream(pCsc->m_cscInputStream,startRowOffset);
+                    // Jump to the start row offset. Block format reads by row number.
+                    if(!isBlockFileFormatCsc(pCsc))
+                        pCsc->m_ioe = seekCscInputStream(pCsc->m_cscInputStream,startRowOffset);
                     
-                    tuples = rs_calloc(rows, sizeof(PGresAttValue *));
+                    tuples = allocTuplesCsc(res, rows, NULL);
 
                     pCsc->m_firstRowNumberInMem = startRowNumber;
                     pCsc->m_lastRowNumberInMem  =  pCsc->m_firstRowNumberInMem - 1;
@@ -1373,6 +1652,34 @@ PGresAttValue **readPreviousBatchOfRowsFromRowNumberCsc(ClientSideCursorResult *
 {
     PGresAttValue **tuples = NULL;
     
+    if(rowNumber > 0 && isBlockFileFormatCsc(pCsc))
+    {
+        int rows = 1;
+
+        // Read memory size using block lengths, start from rowNumber and moving backward.
+        pCsc->m_inMemoryResultSizeFromFile = 0;
+
+        while(rowNumber > 1)
+        {
+            pCsc->m_ioe = loadBlockOfRowCsc(pCsc, rowNumber - 1);
+            if(pCsc->m_ioe)
+                return tuples;
+
+            // Compare size, to check fit into memory or not
+            if(checkForThresholdLimitReachCsc(pCsc, pCsc->m_cols, 
+                                              getRowLengthCscBlockReader(pCsc->m_cscBlockReader, rowNumber - 1), FALSE))
+            {
+                break;
+            }
+
+            rowNumber--;
+            rows++;
+        } // Rows loop
+
+        // Read rows using start row number and number of rows
+        tuples = readNextBatchOfRowsFromOffsetCsc(pCsc, 0, rowNumber, rows, res, pntups);
+    }
+    else
     if(rowNumber > 0)
     {
         long long startRowOffset;
@@ -1456,6 +1763,15 @@ int checkAndOpenInputStreamCsc(ClientSideCursorResult *pCsc, int seekForNext)
 
         // create it on first call
         pCsc->m_cscInputStream = createCscInputStream(pCsc->m_fileName, pCsc->m_resultsettype,&rc);
+
+        if((rc == 0) && isBlockFileFormatCsc(pCsc))
+        {
+            pCsc->m_cscBlockReader = createCscBlockReader();
+            rc = (pCsc->m_cscBlockReader == NULL);
+
+            if((rc == 0) && pCsc->m_cscBlockCache != NULL)
+                setCacheCscBlockReader(pCsc->m_cscBlockReader, pCsc->m_cscBlockCache, pCsc->m_cacheOwnerId);
+        }
         
         if(!doesItForwardOnlyCursor(pCsc->m_resultsettype))
         {
@@ -1544,8 +1860,9 @@ PGresAttValue **readNextBatchOfRowsUntilThresholdCsc(ClientSideCursorResult *pCs
                 int reachedThreshold = FALSE;
                 long long rowCount = 0;
                 PGresAttValue *tuple;
+                int capacity;
                 
-                tuples = rs_calloc(BATCH_SIZE_TO_PROCESS, sizeof(PGresAttValue *));
+                tuples = allocTuplesCsc(res, BATCH_SIZE_TO_PROCESS, &capacity);
                 
                 // Reset in memory size to zero.
                 pCsc->m_inMemoryResultSizeFromFile = 0;
@@ -1577,6 +1894,12 @@ PGresAttValue **readNextBatchOfRowsUntilThresholdCsc(ClientSideCursorResult *pCs
                             }
                         }
                     }
+
+                    // Rows after the committed watermark may still be in writer's buffer.
+                    while(!isFullResultReadFromServerCsc(pCsc) && (pCsc->m_lastRowNumberInMem >= pCsc->m_totalCommitedRows))
+                    {
+                        waitForBatchResultReadFromServerCsc(pCsc);
+                    }
                     
                     if(!doesItForwardOnlyCursor(pCsc->m_resultsettype) 
                             && (pCsc->m_lastRowNumberInMem >= pCsc->m_totalRows) 
@@ -1619,9 +1942,10 @@ PGresAttValue **readNextBatchOfRowsUntilThresholdCsc(ClientSideCursorResult *pCs
                     }
                     
                     // Add row in memory
-                    if(((rowCount + 1) % BATCH_SIZE_TO_PROCESS) == 0)
+                    if((rowCount + 1) >= capacity)
                     {
-                        tuples = rs_realloc(tuples, sizeof(PGresAttValue *) * (rowCount + BATCH_SIZE_TO_PROCESS));
+                        capacity = (int)(rowCount + BATCH_SIZE_TO_PROCESS);
+                        tuples = rs_realloc(tuples, sizeof(PGresAttValue *) * capacity);
                     }
 
                     tuples[rowCount] = tuple;
@@ -1670,6 +1994,39 @@ PGresAttValue **readNextBatchOfRowsUntilThresholdCsc(ClientSideCursorResult *pCs
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------
+// Get a tuples array with room for at least the given rows: the spare array of an older batch of the result,
+// or a new one. Capacity, if not NULL, gets the rows the array has room for.
+//
+static PGresAttValue **allocTuplesCsc(PGresult *res, int rows, int *pCapacity)
+{
+    PGresAttValue **tuples;
+    int capacity;
+
+    if(res->m_cscSpareTuples != NULL && res->m_cscSpareTupArrSize >= rows)
+    {
+        tuples = res->m_cscSpareTuples;
+        capacity = res->m_cscSpareTupArrSize;
+
+        res->m_cscSpareTuples = NULL;
+        res->m_cscSpareTupArrSize = 0;
+
+        memset(tuples, 0, sizeof(PGresAttValue *) * capacity);
+    }
+    else
+    {
+        tuples = rs_calloc(rows, sizeof(PGresAttValue *));
+        capacity = (tuples != NULL) ? rows : 0;
+    }
+
+    if(pCapacity)
+        *pCapacity = capacity;
+
+    return tuples;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Read first batch of rows.
 //
@@ -1727,8 +2084,9 @@ PGresAttValue **readFirstBatchOfRowsCsc(ClientSideCursorResult *pCsc, PGresult *
 
                 if(pCsc->m_ioe == 0)
                 {
-                    // Jump to the first row offset
-                    pCsc->m_ioe = seekCscInputStream(pCsc->m_cscInputStream,0);
+                    // Jump to the first row offset. Block format reads by row number.
+                    if(!isBlockFileFormatCsc(pCsc))
+                        pCsc->m_ioe = seekCscInputStream(pCsc->m_cscInputStream,0);
                     
                     pCsc->m_firstRowNumberInMem = 1;
                     pCsc->m_lastRowNumberInMem  =  pCsc->m_firstRowNumberInMem - 1;
@@ -1908,12 +2266,13 @@ PGresAttValue **readAbsoluteBatchOfRowsCsc(ClientSideCursorResult *pCsc, PGresul
 
                         if(pCsc->m_ioe == 0)
                         {
-                            // Jump to the given row 
-                            rowOffset = readDataFileOffsetCsc(pCsc, rowNumber);
+                            // Jump to the given row. Block format reads by row number.
+                            rowOffset = (isBlockFileFormatCsc(pCsc)) ? 0 : readDataFileOffsetCsc(pCsc, rowNumber);
                             
                             if(rowOffset != -1)
                             {
-                                pCsc->m_ioe = seekCscInputStream(pCsc->m_cscInputStream, rowOffset);
+                                if(!isBlockFileFormatCsc(pCsc))
+                                    pCsc->m_ioe = seekCscInputStream(pCsc->m_cscInputStream, rowOffset);
 
                                 pCsc->m_firstRowNumberInMem = rowNumber;
                                 pCsc->m_lastRowNumberInMem  =  pCsc->m_firstRowNumberInMem - 1;
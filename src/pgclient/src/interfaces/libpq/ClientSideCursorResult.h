@@ -37,6 +37,7 @@
 #include "ClientSideCursorOutputStream.h"
 #include "ClientSideCursorInputStream.h"
 #include "ClientSideCursorLock.h"
+#include "ClientSideCursorBlock.h"
 #include "ClientSideCursorTrace.h"
 
 #include "libpq-fe.h"
@@ -169,6 +170,22 @@ typedef struct _ClientSideCursorResult
 
     // IOException error code
     int m_ioe;
+
+    // File format. See CSC_FILE_FORMAT_*.
+    int m_fileFormat;
+
+    // Block writer for block format
+    ClientSideCursorBlockWriter *m_cscBlockWriter;
+
+    // Block reader for block format
+    ClientSideCursorBlockReader *m_cscBlockReader;
+
+    // Directory of written blocks. It replaces the offset file in block format.
+    ClientSideCursorBlockDir *m_cscBlockDir;
+
+    // Cache of decoded blocks shared with other results of the connection and our owner id in it. NULL means no cache.
+    ClientSideCursorBlockCache *m_cscBlockCache;
+    long long m_cacheOwnerId;
 }ClientSideCursorResult;
 
 // Function declarations
@@ -201,6 +218,9 @@ int doesMaxRowsReachCsc(ClientSideCursorResult *pCsc);
 long long getRowCountCsc(ClientSideCursorResult *pCsc);
 int createFileCsc(ClientSideCursorResult *pCsc, PGresult * pgResult);
 int writeRowCsc(ClientSideCursorResult *pCsc, PGresAttValue *tuple, int noOfCols);
+int writeBlockRowCsc(ClientSideCursorResult *pCsc, PGresAttValue *tuple, int noOfCols);
+int commitBlockCsc(ClientSideCursorResult *pCsc);
+void commitRowsCsc(void *pContext, long long commitToken);
 int closeOutputFileCsc(ClientSideCursorResult *pCsc);
 int closeOffsetOutputFileCsc(ClientSideCursorResult *pCsc);
 int deleteDataFileCsc(ClientSideCursorResult *pCsc);
@@ -208,6 +228,10 @@ int deleteOffsetFileCsc(ClientSideCursorResult *pCsc);
 int closeCsc(ClientSideCursorResult *pCsc, int iCalledFromShutdownHook);
 PGresAttValue **readNextBatchOfRowsCsc(ClientSideCursorResult *pCsc, PGresult * res, int *pntups);
 PGresAttValue *readRowCsc(ClientSideCursorResult *pCsc, int *piError, int *piEof);
+PGresAttValue *readBlockRowCsc(ClientSideCursorResult *pCsc, int *piError, int *piEof);
+int loadBlockOfRowCsc(ClientSideCursorResult *pCsc, int rowNumber);
+int isBlockFileFormatCsc(ClientSideCursorResult *pCsc);
+void setBlockCacheCsc(ClientSideCursorResult *pCsc, ClientSideCursorBlockCache *pCache);
 int closeInputFileCsc(ClientSideCursorResult *pCsc);
 int closeOffsetInputFileCsc(ClientSideCursorResult *pCsc);
 PGresAttValue **readPreviousBatchOfRowsCsc(ClientSideCursorResult *pCsc, PGresult * res, int *pntups); 
@@ -243,6 +267,7 @@ int getIOErrorCsc(int *pError);
 void resetIOErrorCsc(int *pError);
 
 int pgCloseCsc(PGresult * pgResult);
+int pgHasCsc(PGresult * pgResult);
 int pgGetExecuteNumberCsc(PGresult * pgResult);
 int pgGetFirstRowIndexCsc(PGresult * res);
 int pgIsFileCreatedCsc(PGresult * pgResult);
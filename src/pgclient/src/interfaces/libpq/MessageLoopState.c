@@ -434,6 +434,87 @@ void setStreamingCursorRows(void *_pCscStatementContext, int iStreamingCursorRow
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Set byte budget of a streaming cursor batch and rowset size of the application. 0 bytes means batches of
+// m_streamingCursorRows rows.
+//
+void setStreamingCursorBatchSize(void *_pCscStatementContext, long long llBatchBytes, int iRowsetSize)
+{
+    struct _CscStatementContext *pCscStatementContext = (struct _CscStatementContext *)_pCscStatementContext;
+
+    pCscStatementContext->m_StreamingCursorInfo.m_streamingCursorBatchBytes = (llBatchBytes > 0) ? llBatchBytes : 0;
+    pCscStatementContext->m_StreamingCursorInfo.m_streamingCursorRowsetSize = (iRowsetSize > 1) ? iRowsetSize : 1;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether rows read in the result complete a streaming cursor batch. With a byte budget the batch ends once
+// its rows use that many bytes, otherwise at m_streamingCursorRows rows. Either way it ends at a multiple of the
+// rowset size, so a rowset never spans a refill.
+//
+int isEndOfStreamingCursorBatch(struct _CscStatementContext *pCscStatementContext, PGresult *pgResult)
+{
+    StreamingCursorInfo *pInfo = &(pCscStatementContext->m_StreamingCursorInfo);
+    int rowsetSize = (pInfo->m_streamingCursorRowsetSize > 1) ? pInfo->m_streamingCursorRowsetSize : 1;
+    int rows = (pgResult) ? pgResult->totalntups : 0;
+    long long bytes;
+    int endOfBatch;
+
+    if(rows <= 0 || (rows % rowsetSize) != 0)
+        return FALSE;
+
+    // Values and their field array
+    bytes = (long long)pgResult->mem_used + (long long)rows * pgResult->numAttributes * sizeof(PGresAttValue);
+
+    if(pInfo->m_streamingCursorBatchBytes > 0)
+        endOfBatch = (bytes >= pInfo->m_streamingCursorBatchBytes);
+    else
+    {
+        int maxRows = pInfo->m_streamingCursorRows - (pInfo->m_streamingCursorRows % rowsetSize);
+
+        endOfBatch = (rows >= ((maxRows > 0) ? maxRows : rowsetSize));
+    }
+
+    if(endOfBatch)
+    {
+        pInfo->m_batchCount++;
+        if(pInfo->m_batchMinRows == 0 || rows < pInfo->m_batchMinRows)
+            pInfo->m_batchMinRows = rows;
+        if(rows > pInfo->m_batchMaxRows)
+            pInfo->m_batchMaxRows = rows;
+        pInfo->m_batchLastRows = rows;
+        pInfo->m_batchLastBytes = bytes;
+
+        RS_LOG_DEBUG("SCURS", "Streaming cursor batch %d: rows=%d, bytes=%lld, rowsetSize=%d, batchBytes=%lld",
+                    pInfo->m_batchCount, rows, bytes, rowsetSize, pInfo->m_streamingCursorBatchBytes);
+    }
+
+    return endOfBatch;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get batch sizes chosen for the current streaming cursor result.
+//
+void getStreamingCursorBatchStats(void *_pCscStatementContext, int *piBatches, int *piMinRows, int *piMaxRows, int *piLastRows)
+{
+    struct _CscStatementContext *pCscStatementContext = (struct _CscStatementContext *)_pCscStatementContext;
+    StreamingCursorInfo *pInfo = &(pCscStatementContext->m_StreamingCursorInfo);
+
+    if(piBatches)
+        *piBatches = pInfo->m_batchCount;
+    if(piMinRows)
+        *piMinRows = pInfo->m_batchMinRows;
+    if(piMaxRows)
+        *piMaxRows = pInfo->m_batchMaxRows;
+    if(piLastRows)
+        *piLastRows = pInfo->m_batchLastRows;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Reset end of streaming cursor
 //
@@ -557,6 +638,26 @@ void resetStreamingCursorStatementConext(void *_pCscStatementContext)
 
 	// Reset skip flag
 	setSkipResultOfStreamingCursor(_pCscStatementContext,FALSE);
+
+	// Reset batch sizes
+	resetStreamingCursorBatchStats(_pCscStatementContext);
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Reset batch sizes chosen for the streaming cursor result.
+//
+void resetStreamingCursorBatchStats(void *_pCscStatementContext)
+{
+    struct _CscStatementContext *pCscStatementContext = (struct _CscStatementContext *)_pCscStatementContext;
+    StreamingCursorInfo *pInfo = &(pCscStatementContext->m_StreamingCursorInfo);
+
+    pInfo->m_batchCount = 0;
+    pInfo->m_batchMinRows = 0;
+    pInfo->m_batchMaxRows = 0;
+    pInfo->m_batchLastRows = 0;
+    pInfo->m_batchLastBytes = 0;
 }
 
 /*====================================================================================================================================================*/
@@ -590,8 +691,17 @@ void  checkForIOExceptionCsc(void *_pCscStatementContext)
 
 void resetAfterOneResultReadFromServerFinishForStreamingCursor(struct _CscStatementContext *pCscStatementContext, PGconn *conn)
 {
+	StreamingCursorInfo *pInfo = &(pCscStatementContext->m_StreamingCursorInfo);
+
 	// Indicate end of the rows
-	pCscStatementContext->m_StreamingCursorInfo.m_endOfStreamingCursor = TRUE;
+	pInfo->m_endOfStreamingCursor = TRUE;
+
+	if(pInfo->m_batchCount > 0)
+	{
+		RS_LOG_DEBUG("SCURS", "Streaming cursor result read: statementBatches=%d, minRows=%d, maxRows=%d, lastRows=%d, lastBytes=%lld, lastBatchRows=%d",
+					pInfo->m_batchCount, pInfo->m_batchMinRows, pInfo->m_batchMaxRows, pInfo->m_batchLastRows,
+					pInfo->m_batchLastBytes, (conn->result) ? conn->result->totalntups : 0);
+	}
 
 	// We need to make it null because, we already pass the result back to caller.
 	if(pCscStatementContext->m_StreamingCursorInfo.m_streamResultBatchNumber > 0)
@@ -60,6 +60,15 @@ typedef struct _StreamingCursorInfo
 	int	  m_streamResultBatchNumber; // 0 means we haven't stop the loop bcoz rows exceeds batch count.
 	int	  m_endOfStreamingCursorQuery; // End of all result indicator
 	int   m_skipStreamingCursor; // 0 means no skip, 1 means skip current result
+	long long m_streamingCursorBatchBytes; // > 0 means batch ends at this many bytes of rows, instead of at m_streamingCursorRows
+	int   m_streamingCursorRowsetSize; // Batch ends at a multiple of the rowset size of the application
+
+	// Batch sizes chosen for the current result
+	int   m_batchCount;
+	int   m_batchMinRows;
+	int   m_batchMaxRows;
+	int   m_batchLastRows;
+	long long m_batchLastBytes;
 }StreamingCursorInfo;
 
 
@@ -122,12 +131,16 @@ void  checkForIOExceptionCsc(void *_pCscStatementContext);
 void setEndOfStreamingCursor(void *_pCscStatementContext, int flag);
 int isEndOfStreamingCursor(void *_pCscStatementContext);
 void setStreamingCursorRows(void *_pCscStatementContext, int iStreamingCursorRows);
+void setStreamingCursorBatchSize(void *_pCscStatementContext, long long llBatchBytes, int iRowsetSize);
+int isEndOfStreamingCursorBatch(struct _CscStatementContext *pCscStatementContext, PGresult *pgResult);
+void getStreamingCursorBatchStats(void *_pCscStatementContext, int *piBatches, int *piMinRows, int *piMaxRows, int *piLastRows);
 void resetStreamingCursorBatchNumber(void *_pCscStatementContext);
 void setEndOfStreamingCursorQuery(void *_pCscStatementContext, int flag);
 int isEndOfStreamingCursorQuery(void *_pCscStatementContext);
 int isStreamingCursorMode(void *pCallerContext);
 void setSkipResultOfStreamingCursor(void *_pCscStatementContext, int flag);
 void resetStreamingCursorStatementConext(void *_pCscStatementContext);
+void resetStreamingCursorBatchStats(void *_pCscStatementContext);
 int getStreamingCursorBatchNumber(void *_pCscStatementContext);
 void resetAfterOneResultReadFromServerFinishForStreamingCursor(struct _CscStatementContext *pCscStatementContext, PGconn *conn);
 
@@ -271,9 +271,24 @@ static const PQconninfoOption PQconninfoOptions[] = {
 	{"CscThreshold", NULL, NULL, NULL,
 	    "CscThreshold", "", 10},
 
+	{"CscSyncWrites", NULL, NULL, NULL,
+	    "CscSyncWrites", "", 10},
+
+	{"CscFileFormat", NULL, NULL, NULL,
+	    "CscFileFormat", "", 10},
+
+	{"CscCacheSize", NULL, NULL, NULL,
+	    "CscCacheSize", "", 10},
+
+	{"ResultMemoryLimit", NULL, NULL, NULL,
+	    "ResultMemoryLimit", "", 10},
+
 	{"StreamingCursorRows", NULL, NULL, NULL,
 	    "StreamingCursorRows", "", 10},
 
+	{"LazyRowDecode", NULL, NULL, NULL,
+	    "LazyRowDecode", "", 10},
+
 	{ "client_protocol_version", NULL, NULL, NULL,
 		"Extended-Redshift-Protocol-Version", "", 60 },
 
@@ -975,12 +990,42 @@ fillPGconn(PGconn *conn, PQconninfoOption *connOptions)
     else
         conn->llCscThreshold = 1;
 
+	tmp = conninfo_getval(connOptions, "CscSyncWrites");
+    if(tmp)
+	    sscanf(tmp,"%d",&(conn->iCscSyncWrites));
+    else
+        conn->iCscSyncWrites = FALSE;
+
+	tmp = conninfo_getval(connOptions, "CscFileFormat");
+    if(tmp)
+	    sscanf(tmp,"%d",&(conn->iCscFileFormat));
+    else
+        conn->iCscFileFormat = 0;
+
+	tmp = conninfo_getval(connOptions, "CscCacheSize");
+    if(tmp)
+	    sscanf(tmp,"%lld",&(conn->llCscCacheSize));
+    else
+        conn->llCscCacheSize = 64;
+
+	tmp = conninfo_getval(connOptions, "ResultMemoryLimit");
+    if(tmp)
+	    sscanf(tmp,"%lld",&(conn->llResultMemoryLimit));
+    else
+        conn->llResultMemoryLimit = 0;
+
 	tmp = conninfo_getval(connOptions, "StreamingCursorRows");
     if(tmp)
 	    sscanf(tmp,"%d",&(conn->iStreamingCursorRows));
     else
         conn->iStreamingCursorRows = 0;
 
+	tmp = conninfo_getval(connOptions, "LazyRowDecode");
+    if(tmp)
+	    sscanf(tmp,"%d",&(conn->iLazyRowDecode));
+    else
+        conn->iLazyRowDecode = 0;
+
 	// CSC will override Streaming Cursor
 	if(conn->iCscEnable)
         conn->iStreamingCursorRows = 0;
@@ -3368,6 +3413,9 @@ makeEmptyPGconn(void)
 	initPQExpBuffer(&conn->workBuffer);
     conn->m_pCscExecutor = NULL;
 
+    // Without the pool, results malloc and free their blocks.
+    conn->blockPool = pqCreateBlockPool();
+
 	if (conn->inBuffer == NULL ||
 		conn->outBuffer == NULL ||
 		PQExpBufferBroken(&conn->errorMessage) ||
@@ -3523,6 +3571,10 @@ freePGconn(PGconn *conn)
 	conn->addrlist = NULL;
 	conn->addr_cur = NULL;
 
+    // Results of the connection can still hold a reference to the pool.
+    conn->blockPool = pqReleaseBlockPool(conn->blockPool);
+
+    pqClearPendingCloses(conn);
 
 	free(conn);
 
@@ -3581,6 +3633,7 @@ closePGconn(PGconn *conn)
 										 * absent */
 	conn->asyncStatus = PGASYNC_IDLE;
 	pqClearAsyncResult(conn);	/* deallocate result and curTuple */
+	pqClearPendingCloses(conn);	/* statements are gone with the session */
 	pg_freeaddrinfo_all(conn->addrlist_family, conn->addrlist);
 	conn->addrlist = NULL;
 	conn->addr_cur = NULL;
@@ -3602,6 +3655,7 @@ closePGconn(PGconn *conn)
 		free(prev);
 	}
 	conn->pstatus = NULL;
+	conn->session_timezone = NULL;
 	if (conn->lobjfuncs)
 		free(conn->lobjfuncs);
 	conn->lobjfuncs = NULL;
@@ -3849,7 +3903,7 @@ PQfreeCancel(PGcancel *cancel)
  */
 static int
 internal_cancel(SockAddr *raddr, int be_pid, int be_key,
-				char *errbuf, int errbufsize, PGconn* conn)
+				char *errbuf, int errbufsize, PGconn* conn, int timeout)
 {
 	int			save_errno = SOCK_ERRNO;
 	int			tmpsock = -1;
@@ -3881,6 +3935,30 @@ internal_cancel(SockAddr *raddr, int be_pid, int be_key,
             goto cancel_errReturn;
         }
     }
+
+	/*
+	 * Redshift modified: bound connect, send and the wait for EOF, so a
+	 * cancel to an unreachable server doesn't block the caller.  Windows
+	 * applies the timeout only to send and recv.
+	 */
+	if (timeout > 0)
+	{
+#ifdef WIN32
+		DWORD		tv = (DWORD) timeout * 1000;
+#else
+		struct timeval tv;
+
+		tv.tv_sec = timeout;
+		tv.tv_usec = 0;
+#endif
+		if (setsockopt(tmpsock, SOL_SOCKET, SO_SNDTIMEO, (char *) &tv, sizeof(tv)) < 0
+			|| setsockopt(tmpsock, SOL_SOCKET, SO_RCVTIMEO, (char *) &tv, sizeof(tv)) < 0)
+		{
+			strlcpy(errbuf, "PQcancel() -- setsockopt() failed: ", errbufsize);
+			goto cancel_errReturn;
+		}
+	}
+
 retry3:
 	if (connect_using_proxy(tmpsock, conn) < 0) // Redshift modified
 	{
@@ -3971,7 +4049,27 @@ PQcancel(PGcancel *cancel, char *errbuf, int errbufsize)
 	}
 
 	return internal_cancel(&cancel->raddr, cancel->be_pid, cancel->be_key,
-						   errbuf, errbufsize, cancel->conn);
+						   errbuf, errbufsize, cancel->conn, 0);
+}
+
+/*
+ * PQcancelTimeout: request query cancel, giving up after timeout seconds
+ *
+ * Redshift Extension.  Same as PQcancel, except connect, send and the wait
+ * for the server to close the connection each fail after timeout seconds.
+ * A timeout of 0 waits as long as PQcancel.
+ */
+int
+PQcancelTimeout(PGcancel *cancel, char *errbuf, int errbufsize, int timeout)
+{
+	if (!cancel)
+	{
+		strlcpy(errbuf, "PQcancel() -- no cancel object supplied", errbufsize);
+		return FALSE;
+	}
+
+	return internal_cancel(&cancel->raddr, cancel->be_pid, cancel->be_key,
+						   errbuf, errbufsize, cancel->conn, timeout);
 }
 
 /*
@@ -4006,7 +4104,7 @@ PQrequestCancel(PGconn *conn)
 	}
 
 	r = internal_cancel(&conn->raddr, conn->be_pid, conn->be_key,
-						conn->errorMessage.data, conn->errorMessage.maxlen, conn);
+						conn->errorMessage.data, conn->errorMessage.maxlen, conn, 0);
 
 	if (!r)
 		conn->errorMessage.len = strlen(conn->errorMessage.data);
@@ -5385,6 +5483,20 @@ PQparameterStatus(const PGconn *conn, const char *paramName)
 	return NULL;
 }
 
+/*
+ * PQsessionTimeZone
+ *
+ * Same as PQparameterStatus(conn, "TimeZone") but without the list walk.
+ * The result is only valid until the next ParameterStatus for TimeZone.
+ */
+const char *
+PQsessionTimeZone(const PGconn *conn)
+{
+	if (!conn)
+		return NULL;
+	return conn->session_timezone;
+}
+
 int
 PQprotocolVersion(const PGconn *conn)
 {
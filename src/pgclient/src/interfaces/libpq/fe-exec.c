@@ -29,6 +29,7 @@
 #endif
 
 #include "MessageLoopState.h"
+#include "rslock.h"
 #include <rslog.h>
 
 /* keep this in same order as ExecStatusType in libpq-fe.h */
@@ -79,6 +80,13 @@ extern int getResultConcurrencyTypeForCsc(void *pCallerContext);
 void _pgFreeTuplePointers(PGresult * res);
 static void pqClearForStreamingCursor(PGresult *res, PGconn *conn);
 extern int isStreamingCursorMode(void *pCallerContext);
+static int	pqPutPendingCloses(PGconn *conn);
+
+/*
+ * Most prepared statements closed without a round trip. Reaching it, the
+ * closes are sent on their own when the connection is idle.
+ */
+#define PQ_MAX_PENDING_CLOSES	64
 
 /* ----------------
  * Space management for PGresult.
@@ -101,10 +109,20 @@ extern int isStreamingCursorMode(void *pCallerContext);
  * we need to be able to enlarge it via realloc, and our trivial space
  * allocator doesn't handle that effectively.  (Too bad the FE/BE protocol
  * doesn't tell us up front how many tuples will be returned.)
- * All other subsidiary storage for a PGresult is kept in PGresult_data blocks
- * of size PGRESULT_DATA_BLOCKSIZE.  The overhead at the start of each block
- * is just a link to the next one, if any.	Free-space management info is
- * kept in the owning PGresult.
+ * All other subsidiary storage for a PGresult is kept in PGresult_data blocks.
+ * The overhead at the start of each block is a link to the next one, if any,
+ * and the size of the block.  Free-space management info is kept in the
+ * owning PGresult.
+ *
+ * The first standard block of a result is PGRESULT_DATA_BLOCKSIZE bytes, and
+ * each new one is twice the size of the one before, up to
+ * PGRESULT_MAX_BLOCKSIZE, so a big result needs few malloc calls and a small
+ * one doesn't waste much.  Blocks a result no longer needs go back to the
+ * block pool of its connection, and the next results of the connection take
+ * them from there instead of calling malloc.  The pool keeps up to
+ * PGRESULT_POOL_MAX_BYTES; anything over that is freed.  A streaming cursor
+ * result keeps the blocks of a batch on its own free list and fills them
+ * again with the next batch.
  * A query returning a small amount of data will thus require three malloc
  * calls: one for the PGresult, one for the tuples pointer array, and one
  * PGresult_data block.
@@ -116,16 +134,18 @@ extern int isStreamingCursorMode(void *pCallerContext);
  * around very long anyway, so some wasted space within one is not a problem.
  *
  * Tuning constants for the space allocator are:
- * PGRESULT_DATA_BLOCKSIZE: size of a standard allocation block, in bytes
+ * PGRESULT_DATA_BLOCKSIZE: size of the first standard allocation block, in bytes
+ * PGRESULT_MAX_BLOCKSIZE: size standard allocation blocks grow up to
  * PGRESULT_ALIGN_BOUNDARY: assumed alignment requirement for binary data
  * PGRESULT_SEP_ALLOC_THRESHOLD: objects bigger than this are given separate
- *	 blocks, instead of being crammed into a regular allocation block.
+ *	 blocks, instead of being crammed into a regular allocation block.  It's
+ *	 half the size of the next standard block.
+ * PGRESULT_POOL_MAX_BYTES: free blocks the pool of a connection keeps
  * Requirements for correct function are:
  * PGRESULT_ALIGN_BOUNDARY must be a multiple of the alignment requirements
  *		of all machine data types.	(Currently this is set from configure
  *		tests, so it should be OK automatically.)
- * PGRESULT_SEP_ALLOC_THRESHOLD + PGRESULT_BLOCK_OVERHEAD <=
- *			PGRESULT_DATA_BLOCKSIZE
+ * PGRESULT_SEP_ALLOC_THRESHOLD + PGRESULT_BLOCK_OVERHEAD <= block size
  *		pqResultAlloc assumes an object smaller than the threshold will fit
  *		in a new block.
  * The amount of space wasted at the end of a block could be as much as
@@ -134,9 +154,28 @@ extern int isStreamingCursorMode(void *pCallerContext);
  */
 
 #define PGRESULT_DATA_BLOCKSIZE		2048
+#define PGRESULT_MAX_BLOCKSIZE		65536
 #define PGRESULT_ALIGN_BOUNDARY		MAXIMUM_ALIGNOF		/* from configure */
 #define PGRESULT_BLOCK_OVERHEAD		Max(sizeof(PGresult_data), PGRESULT_ALIGN_BOUNDARY)
-#define PGRESULT_SEP_ALLOC_THRESHOLD	(PGRESULT_DATA_BLOCKSIZE / 2)
+#define PGRESULT_SEP_ALLOC_THRESHOLD(blockSize)	((size_t) (blockSize) / 2)
+#define PGRESULT_POOL_MAX_BYTES		(1024 * 1024)
+#define PGRESULT_POOL_CLASSES		6	/* 2 KB, 4 KB, ... 64 KB */
+
+/* Free standard blocks of the results of a connection, by size. */
+struct pg_block_pool
+{
+	PGresult_data *freeBlocks[PGRESULT_POOL_CLASSES];
+	size_t		bytes;			/* bytes in free blocks */
+	int			refs;			/* the connection and its results */
+	long long	hits;			/* blocks taken from the pool */
+	long long	misses;			/* blocks malloc'd, because none was free */
+	MUTEX_HANDLE lock;			/* results can be cleared on any thread */
+};
+
+static int	pqBlockPoolClass(size_t size);
+static PGresult_data *pqTakeBlockPool(PGblockPool *pool, size_t size);
+static void pqPutBlockPool(PGblockPool *pool, PGresult_data *block);
+static PGresult_data *pqGetResultBlock(PGresult *res);
 
 
 /*
@@ -158,12 +197,16 @@ PQmakeEmptyPGresult(PGconn *conn, ExecStatusType status)
 	result->totalntups = 0;
 	result->capped = 0;
 	result->mem_used = 0; /* track bytes used for results */
+	result->mem_charged = 0;
 
 	result->ntups = 0;
 	result->numAttributes = 0;
 	result->attDescs = NULL;
 	result->tuples = NULL;
 	result->tupArrSize = 0;
+	result->rawTuples = NULL;
+	result->rawArrSize = 0;
+	result->lazyDecode = FALSE;
 	result->numParameters = 0;
 	result->paramDescs = NULL;
 	result->resultStatus = status;
@@ -177,9 +220,14 @@ PQmakeEmptyPGresult(PGconn *conn, ExecStatusType status)
 	result->curBlock = NULL;
 	result->curOffset = 0;
 	result->spaceLeft = 0;
+	result->blockSize = PGRESULT_DATA_BLOCKSIZE;
+	result->freeBlocks = NULL;
+	result->blockPool = (conn) ? pqAddRefBlockPool(conn->blockPool) : NULL;
 
     result->m_cscResult = NULL;
     result->m_tuplesAllocatedByCscRead = FALSE;
+    result->m_cscSpareTuples = NULL;
+    result->m_cscSpareTupArrSize = 0;
 
 	if (conn)
 	{
@@ -354,11 +402,19 @@ PQcopyResult(const PGresult *src, int flags)
 
 		for (tup = 0; tup < src->ntups; tup++)
 		{
+			PGresAttValue *srcTup = pqGetTuple(src, tup);
+
+			if (srcTup == NULL)
+			{
+				PQclear(dest);
+				return NULL;
+			}
+
 			for (field = 0; field < src->numAttributes; field++)
 			{
 				if (!PQsetvalue(dest, tup, field,
-								src->tuples[tup][field].value,
-								src->tuples[tup][field].len))
+								srcTup[field].value,
+								srcTup[field].len))
 				{
 					PQclear(dest);
 					return NULL;
@@ -405,6 +461,42 @@ PQcopyResult(const PGresult *src, int flags)
 	return dest;
 }
 
+/*
+ * pqCopyDescribeResult -
+ *		copy of the result of a Parse or Describe message: status, attributes
+ *		and parameter descriptions, without tuples.
+ */
+PGresult *
+pqCopyDescribeResult(const PGresult *src)
+{
+	PGresult   *dest;
+
+	if (!src)
+		return NULL;
+
+	dest = PQcopyResult(src, PG_COPYRES_ATTRS | PG_COPYRES_NOTICEHOOKS);
+	if (!dest)
+		return NULL;
+
+	dest->resultStatus = src->resultStatus;
+	dest->binary = src->binary;
+
+	if (src->numParameters > 0)
+	{
+		dest->paramDescs = (PGresParamDesc *)
+			pqResultAlloc(dest, src->numParameters * sizeof(PGresParamDesc), TRUE);
+		if (!dest->paramDescs)
+		{
+			PQclear(dest);
+			return NULL;
+		}
+		memcpy(dest->paramDescs, src->paramDescs, src->numParameters * sizeof(PGresParamDesc));
+		dest->numParameters = src->numParameters;
+	}
+
+	return dest;
+}
+
 /*
  * Copy an array of PGEvents (with no extra space for more).
  * Does not duplicate the event instance data, sets this to NULL.
@@ -453,6 +545,7 @@ int
 PQsetvalue(PGresult *res, int tup_num, int field_num, const char *value, int len)
 {
 	PGresAttValue *attval;
+	PGresAttValue *tup;
 
 	if (!check_field_number(res, field_num))
 		return FALSE;
@@ -464,7 +557,6 @@ PQsetvalue(PGresult *res, int tup_num, int field_num, const char *value, int len
 	/* need to allocate a new tuple? */
 	if (tup_num == res->ntups)
 	{
-		PGresAttValue *tup;
 		int			i;
 
 		tup = (PGresAttValue *)
@@ -486,7 +578,10 @@ PQsetvalue(PGresult *res, int tup_num, int field_num, const char *value, int len
 			return FALSE;
 	}
 
-	attval = &res->tuples[tup_num][field_num];
+	tup = pqGetTuple(res, tup_num);
+	if (tup == NULL)
+		return FALSE;
+	attval = &tup[field_num];
 
 	/* treat either NULL_LEN or NULL value pointer as a NULL field */
 	if (len == NULL_LEN || value == NULL)
@@ -576,11 +671,13 @@ pqResultAlloc(PGresult *res, size_t nBytes, bool isBinary)
 	 * block.  (We'd have to special-case requests bigger than the block size
 	 * anyway.)  The object is always given binary alignment in this case.
 	 */
-	if (nBytes >= PGRESULT_SEP_ALLOC_THRESHOLD)
+	if (nBytes >= PGRESULT_SEP_ALLOC_THRESHOLD(res->blockSize))
 	{
 		block = (PGresult_data *) malloc(nBytes + PGRESULT_BLOCK_OVERHEAD);
 		if (!block)
 			return NULL;
+		block->hdr.size = nBytes + PGRESULT_BLOCK_OVERHEAD;
+		pqResultCharge(res, block->hdr.size);
 		space = block->space + PGRESULT_BLOCK_OVERHEAD;
 		if (res->curBlock)
 		{
@@ -588,13 +685,13 @@ pqResultAlloc(PGresult *res, size_t nBytes, bool isBinary)
 			 * Tuck special block below the active block, so that we don't
 			 * have to waste the free space in the active block.
 			 */
-			block->next = res->curBlock->next;
-			res->curBlock->next = block;
+			block->hdr.next = res->curBlock->hdr.next;
+			res->curBlock->hdr.next = block;
 		}
 		else
 		{
 			/* Must set up the new block as the first active block. */
-			block->next = NULL;
+			block->hdr.next = NULL;
 			res->curBlock = block;
 			res->spaceLeft = 0; /* be sure it's marked full */
 		}
@@ -602,22 +699,23 @@ pqResultAlloc(PGresult *res, size_t nBytes, bool isBinary)
 	}
 
 	/* Otherwise, start a new block. */
-	block = (PGresult_data *) malloc(PGRESULT_DATA_BLOCKSIZE);
+	block = pqGetResultBlock(res);
 	if (!block)
 		return NULL;
-	block->next = res->curBlock;
+	pqResultCharge(res, block->hdr.size);
+	block->hdr.next = res->curBlock;
 	res->curBlock = block;
 	if (isBinary)
 	{
 		/* object needs full alignment */
 		res->curOffset = PGRESULT_BLOCK_OVERHEAD;
-		res->spaceLeft = PGRESULT_DATA_BLOCKSIZE - PGRESULT_BLOCK_OVERHEAD;
+		res->spaceLeft = (int) block->hdr.size - PGRESULT_BLOCK_OVERHEAD;
 	}
 	else
 	{
-		/* we can cram it right after the overhead pointer */
+		/* we can cram it right after the overhead */
 		res->curOffset = sizeof(PGresult_data);
-		res->spaceLeft = PGRESULT_DATA_BLOCKSIZE - sizeof(PGresult_data);
+		res->spaceLeft = (int) block->hdr.size - sizeof(PGresult_data);
 	}
 
 	space = block->space + res->curOffset;
@@ -626,6 +724,268 @@ pqResultAlloc(PGresult *res, size_t nBytes, bool isBinary)
 	return space;
 }
 
+/*
+ * pqGetResultBlock -
+ *		get a standard block for a result: one the result kept from an
+ *		earlier batch, a free one of the connection, or a new one.  The
+ *		next standard block is twice the size, up to PGRESULT_MAX_BLOCKSIZE.
+ */
+static PGresult_data *
+pqGetResultBlock(PGresult *res)
+{
+	PGresult_data *block = res->freeBlocks;
+
+	/* Kept blocks are all of the current size */
+	if (block)
+	{
+		res->freeBlocks = block->hdr.next;
+		return block;
+	}
+
+	block = pqTakeBlockPool(res->blockPool, res->blockSize);
+	if (!block)
+	{
+		block = (PGresult_data *) malloc(res->blockSize);
+		if (!block)
+			return NULL;
+		block->hdr.size = res->blockSize;
+	}
+
+	if (res->blockSize < PGRESULT_MAX_BLOCKSIZE)
+		res->blockSize *= 2;
+
+	return block;
+}
+
+/*
+ * pqResultReleaseBlock -
+ *		release a block the result no longer uses.  A block of the current
+ *		standard size is kept for the next allocations of the result, others
+ *		go to the block pool of the connection.  Caller releases the charge.
+ */
+void
+pqResultReleaseBlock(PGresult *res, PGresult_data *block)
+{
+	if (block->hdr.size == (size_t) res->blockSize)
+	{
+		block->hdr.next = res->freeBlocks;
+		res->freeBlocks = block;
+	}
+	else
+		pqPutBlockPool(res->blockPool, block);
+}
+
+/*
+ * pqCreateBlockPool -
+ *		create the block pool of a connection. Caller has the first reference.
+ *		Returns NULL when out of memory; results malloc their blocks then.
+ */
+PGblockPool *
+pqCreateBlockPool(void)
+{
+	PGblockPool *pool = (PGblockPool *) calloc(1, sizeof(PGblockPool));
+
+	if (pool)
+	{
+		pool->refs = 1;
+		pool->lock = rsCreateMutex();
+
+		if (pool->lock == NULL)
+		{
+			free(pool);
+			pool = NULL;
+		}
+	}
+
+	return pool;
+}
+
+/*
+ * pqAddRefBlockPool -
+ *		add a reference to the block pool. Results can outlive the connection.
+ */
+PGblockPool *
+pqAddRefBlockPool(PGblockPool *pool)
+{
+	if (pool)
+	{
+		rsLockMutex(pool->lock);
+		pool->refs++;
+		rsUnlockMutex(pool->lock);
+	}
+
+	return pool;
+}
+
+/*
+ * pqReleaseBlockPool -
+ *		release a reference to the block pool. Last one frees the pool and
+ *		its blocks. Returns NULL.
+ */
+PGblockPool *
+pqReleaseBlockPool(PGblockPool *pool)
+{
+	if (pool)
+	{
+		int			refs;
+
+		rsLockMutex(pool->lock);
+		refs = --(pool->refs);
+		rsUnlockMutex(pool->lock);
+
+		if (refs == 0)
+		{
+			int			i;
+
+			for (i = 0; i < PGRESULT_POOL_CLASSES; i++)
+			{
+				PGresult_data *block;
+
+				while ((block = pool->freeBlocks[i]) != NULL)
+				{
+					pool->freeBlocks[i] = block->hdr.next;
+					free(block);
+				}
+			}
+
+			rsDestroyMutex(pool->lock);
+			free(pool);
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * pqGetBlockPoolStats -
+ *		blocks taken from the pool, blocks malloc'd because none was free,
+ *		and bytes in free blocks. Any pointer can be NULL.
+ */
+void
+pqGetBlockPoolStats(PGblockPool *pool, long long *pllHits, long long *pllMisses, long long *pllBytes)
+{
+	long long	hits = 0;
+	long long	misses = 0;
+	long long	bytes = 0;
+
+	if (pool)
+	{
+		rsLockMutex(pool->lock);
+		hits = pool->hits;
+		misses = pool->misses;
+		bytes = (long long) pool->bytes;
+		rsUnlockMutex(pool->lock);
+	}
+
+	if (pllHits)
+		*pllHits = hits;
+	if (pllMisses)
+		*pllMisses = misses;
+	if (pllBytes)
+		*pllBytes = bytes;
+}
+
+/*
+ * pqBlockPoolClass -
+ *		index of the free list for blocks of the size, or -1 if blocks of
+ *		the size aren't pooled.
+ */
+static int
+pqBlockPoolClass(size_t size)
+{
+	size_t		classSize = PGRESULT_DATA_BLOCKSIZE;
+	int			i;
+
+	for (i = 0; i < PGRESULT_POOL_CLASSES; i++, classSize *= 2)
+	{
+		if (size == classSize)
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+ * pqTakeBlockPool -
+ *		take a free block of the size from the pool. NULL if there is none.
+ */
+static PGresult_data *
+pqTakeBlockPool(PGblockPool *pool, size_t size)
+{
+	PGresult_data *block = NULL;
+	int			i = pqBlockPoolClass(size);
+
+	if (pool && i >= 0)
+	{
+		rsLockMutex(pool->lock);
+		block = pool->freeBlocks[i];
+		if (block)
+		{
+			pool->freeBlocks[i] = block->hdr.next;
+			pool->bytes -= block->hdr.size;
+			pool->hits++;
+		}
+		else
+			pool->misses++;
+		rsUnlockMutex(pool->lock);
+	}
+
+	return block;
+}
+
+/*
+ * pqPutBlockPool -
+ *		give a block to the pool, or free it if the pool doesn't take blocks
+ *		of its size or is full.
+ */
+static void
+pqPutBlockPool(PGblockPool *pool, PGresult_data *block)
+{
+	int			i = pqBlockPoolClass(block->hdr.size);
+
+	if (pool && i >= 0)
+	{
+		rsLockMutex(pool->lock);
+		if (pool->bytes + block->hdr.size <= PGRESULT_POOL_MAX_BYTES)
+		{
+			block->hdr.next = pool->freeBlocks[i];
+			pool->freeBlocks[i] = block;
+			pool->bytes += block->hdr.size;
+			block = NULL;
+		}
+		rsUnlockMutex(pool->lock);
+	}
+
+	if (block)
+		free(block);
+}
+
+/*
+ * PQresultMemorySize -
+ *		bytes malloc'd for the result, including the PGresult itself.
+ */
+size_t
+PQresultMemorySize(const PGresult *res)
+{
+	if (!res)
+		return 0;
+
+	return sizeof(PGresult) + (size_t) res->mem_charged;
+}
+
+/*
+ * pqResultCharge -
+ *		charge bytes malloc'd for a PGresult to the result memory of the
+ *		process, so results can be spilled when the process is over its limit.
+ *		Negative bytes release the charge.
+ */
+void
+pqResultCharge(PGresult *res, long long bytes)
+{
+	res->mem_charged += bytes;
+	rs_mem_charge(bytes);
+}
+
 /*
  * pqResultStrdup -
  *		Like strdup, but the space is subsidiary PGresult space.
@@ -711,16 +1071,27 @@ PQclear(PGresult *res)
 		res->events = NULL;
 	}
 
-	/* Free all the subsidiary blocks */
+	/* Give all the subsidiary blocks to the connection, for its next results */
 	while ((block = res->curBlock) != NULL)
 	{
-		res->curBlock = block->next;
-		free(block);
+		res->curBlock = block->hdr.next;
+		pqPutBlockPool(res->blockPool, block);
 	}
+	while ((block = res->freeBlocks) != NULL)
+	{
+		res->freeBlocks = block->hdr.next;
+		pqPutBlockPool(res->blockPool, block);
+	}
+	res->blockPool = pqReleaseBlockPool(res->blockPool);
 
 	/* Free the top-level tuple pointer array */
     _pgFreeTuplePointers(res);
 
+	if (res->m_cscSpareTuples)
+		res->m_cscSpareTuples = rs_free(res->m_cscSpareTuples);
+
+	pqResultCharge(res, -res->mem_charged);
+
 	/* zero out the pointer fields to catch programming errors */
 	res->attDescs = NULL;
 	res->tuples = NULL;
@@ -920,6 +1291,7 @@ pqAddTuple(PGresult *res, PGresAttValue *tup, int iStreamingCursorRows)
 
 		if (!newTuples)
 			return FALSE;		/* malloc or realloc failed */
+		pqResultCharge(res, (long long) (newSize - res->tupArrSize) * sizeof(PGresAttValue *));
 		res->tupArrSize = newSize;
 		res->tuples = newTuples;
 	}
@@ -928,6 +1300,128 @@ pqAddTuple(PGresult *res, PGresAttValue *tup, int iStreamingCursorRows)
 	return TRUE;
 }
 
+/*
+ * pqAddRawTuple
+ *	  add a raw row of lazy decode mode to the PGresult structure. The raw row
+ *	  is the field length of the body followed by the fields of the DataRow
+ *	  message and one spare byte. Its tuple pointer stays NULL until the row
+ *	  is accessed.
+ *	  Returns TRUE if OK, FALSE if not enough memory to add the row
+ */
+int
+pqAddRawTuple(PGresult *res, char *raw)
+{
+	if (res->ntups >= res->rawArrSize)
+	{
+		int			newSize = (res->rawArrSize > 0) ? res->rawArrSize * 2 : 128;
+		char	  **newRawTuples;
+
+		if (newSize <= res->ntups)
+			newSize = res->ntups + 1;
+
+		if (res->rawTuples == NULL)
+			newRawTuples = (char **) malloc(newSize * sizeof(char *));
+		else
+			newRawTuples = (char **) realloc(res->rawTuples, newSize * sizeof(char *));
+
+		if (!newRawTuples)
+			return FALSE;		/* malloc or realloc failed */
+		pqResultCharge(res, (long long) (newSize - res->rawArrSize) * sizeof(char *));
+		res->rawArrSize = newSize;
+		res->rawTuples = newRawTuples;
+	}
+
+	if (!pqAddTuple(res, NULL, 0))
+		return FALSE;
+
+	res->rawTuples[res->ntups - 1] = raw;
+	return TRUE;
+}
+
+/*
+ * pqDecodeRawTuple
+ *	  build the field array of a raw row. Values point into the raw row and are
+ *	  terminated in place, over the length of the next field, once all lengths
+ *	  are read. Returns NULL if out of memory or the row is malformed.
+ */
+static PGresAttValue *
+pqDecodeRawTuple(PGresult *res, char *raw)
+{
+	int			nfields = res->numAttributes;
+	int			rawLen;
+	char	   *pos;
+	char	   *end;
+	PGresAttValue *tup;
+	int			i;
+
+	memcpy(&rawLen, raw, sizeof(int));
+	pos = raw + sizeof(int);
+	end = pos + rawLen;
+
+	tup = (PGresAttValue *) pqResultAlloc(res, nfields * sizeof(PGresAttValue), TRUE);
+	if (tup == NULL)
+		return NULL;
+
+	for (i = 0; i < nfields; i++)
+	{
+		const unsigned char *p = (const unsigned char *) pos;
+		int			vlen;
+
+		if (end - pos < 4)
+			return NULL;
+
+		vlen = (int) (((unsigned int) p[0] << 24) | ((unsigned int) p[1] << 16)
+					  | ((unsigned int) p[2] << 8) | (unsigned int) p[3]);
+		pos += 4;
+
+		if (vlen == -1)
+		{
+			/* null field */
+			tup[i].value = res->null_field;
+			tup[i].len = NULL_LEN;
+			continue;
+		}
+		if (vlen < 0)
+			vlen = 0;
+		if (end - pos < vlen)
+			return NULL;
+
+		tup[i].value = pos;
+		tup[i].len = vlen;
+		pos += vlen;
+	}
+
+	for (i = 0; i < nfields; i++)
+	{
+		if (tup[i].len != NULL_LEN)
+			tup[i].value[tup[i].len] = '\0';
+	}
+
+	return tup;
+}
+
+/*
+ * pqGetTuple
+ *	  get the field array of a row, decoding the raw row of lazy decode mode
+ *	  on first access. Returns NULL if the raw row can't be decoded.
+ */
+PGresAttValue *
+pqGetTuple(const PGresult *res, int tup_num)
+{
+	PGresAttValue *tup = res->tuples[tup_num];
+
+	if (tup == NULL && res->rawTuples != NULL && tup_num < res->rawArrSize)
+	{
+		/* Decoding doesn't change the values seen through the result */
+		PGresult   *mutableRes = (PGresult *) res;
+
+		tup = pqDecodeRawTuple(mutableRes, res->rawTuples[tup_num]);
+		mutableRes->tuples[tup_num] = tup;
+	}
+
+	return tup;
+}
+
 /*
  * pqSaveMessageField - save one field of an error or notice message
  */
@@ -1042,6 +1536,15 @@ pqSaveParameterStatus(PGconn *conn, const char *name, const char *value)
 		/* server response version. */
 		sscanf(value, "%d", &(conn->server_protocol_version));
 	}
+	else if (strcmp(name, "TimeZone") == 0)
+	{
+		/*
+		 * Snapshot the session time zone so that per-row timestamptz
+		 * formatting doesn't have to walk the pstatus list. The old
+		 * entry was freed above, so always refresh the pointer.
+		 */
+		conn->session_timezone = (pstatus) ? pstatus->value : NULL;
+	}
 }
 
 
@@ -1170,6 +1673,10 @@ PQsendPrepare(PGconn *conn,
 		return 0;
 	}
 
+	/* close the statements released since the last request */
+	if (pqPutPendingCloses(conn) < 0)
+		goto sendFailed;
+
 	/* construct the Parse message */
 	if (pqPutMsgStart('P', false, conn) < 0 ||
 		pqPuts(stmtName, conn) < 0 ||
@@ -1263,6 +1770,10 @@ pqSendPrepareAndDescribe(PGconn *conn,
 		return 0;
 	}
 
+	/* close the statements released since the last request */
+	if (pqPutPendingCloses(conn) < 0)
+		goto sendFailed;
+
 	/* construct the Parse message */
 	if (pqPutMsgStart('P', false, conn) < 0 ||
 		pqPuts(stmtName, conn) < 0 ||
@@ -1434,6 +1945,10 @@ PQsendQueryGuts(PGconn *conn,
 	 * using specified statement name and the unnamed portal.
 	 */
 
+	/* close the statements released since the last request */
+	if (pqPutPendingCloses(conn) < 0)
+		goto sendFailed;
+
 	if (command)
 	{
 		/* construct the Parse message */
@@ -2306,6 +2821,10 @@ PQsendDescribe(PGconn *conn, char desc_type, const char *desc_target)
 		return 0;
 	}
 
+	/* close the statements released since the last request */
+	if (pqPutPendingCloses(conn) < 0)
+		goto sendFailed;
+
 	/* construct the Describe message */
 	if (pqPutMsgStart('D', false, conn) < 0 ||
 		pqPutc(desc_type, conn) < 0 ||
@@ -2344,6 +2863,164 @@ sendFailed:
 	return 0;
 }
 
+/*
+ * pqQueueClosePrepared
+ *	 Close a prepared statement with the next extended query request, instead
+ *	 of a DEALLOCATE round trip of its own. The CloseComplete replies are
+ *	 consumed with the replies of that request; closing a statement that
+ *	 doesn't exist isn't an error. The closes go ahead of the messages of the
+ *	 request, so it can prepare a statement under the same name again.
+ *
+ * Returns: 1 if queued or closed
+ *			0 if error (conn->errorMessage is set)
+ */
+int
+pqQueueClosePrepared(PGconn *conn, const char *stmtName)
+{
+	char	   *name;
+
+	if (!conn)
+		return 0;
+
+	if (!stmtName)
+	{
+		printfPQExpBuffer(&conn->errorMessage,
+						libpq_gettext("statement name is a null pointer\n"));
+		return 0;
+	}
+
+	if (conn->nPendingCloses >= conn->pendingClosesSize)
+	{
+		int			newSize = (conn->pendingClosesSize > 0) ? conn->pendingClosesSize * 2 : 8;
+		char	  **newCloses = (char **) realloc(conn->pendingCloses, newSize * sizeof(char *));
+
+		if (!newCloses)
+		{
+			printfPQExpBuffer(&conn->errorMessage,
+							  libpq_gettext("out of memory\n"));
+			return 0;
+		}
+		conn->pendingCloses = newCloses;
+		conn->pendingClosesSize = newSize;
+	}
+
+	name = strdup(stmtName);
+	if (!name)
+	{
+		printfPQExpBuffer(&conn->errorMessage,
+						  libpq_gettext("out of memory\n"));
+		return 0;
+	}
+	conn->pendingCloses[conn->nPendingCloses++] = name;
+
+	/*
+	 * Too many statements still open on the server. Close them now, unless
+	 * a request is in progress; they go with the request after it then.
+	 */
+	if (conn->nPendingCloses >= PQ_MAX_PENDING_CLOSES &&
+		conn->asyncStatus == PGASYNC_IDLE &&
+		conn->status == CONNECTION_OK)
+		return pqClosePendingPrepared(conn);
+
+	return 1;
+}
+
+/*
+ * pqClosePendingPrepared
+ *	 Send the queued Close messages with a Sync of their own and wait for the
+ *	 replies.
+ *
+ * Returns: 1 if closed (or nothing to close)
+ *			0 if error (conn->errorMessage is set)
+ */
+int
+pqClosePendingPrepared(PGconn *conn)
+{
+	PGresult   *result;
+	int			ok;
+
+	if (!conn)
+		return 0;
+	if (conn->nPendingCloses == 0)
+		return 1;
+
+	if (!PQexecStart(conn))
+		return 0;
+	if (!PQsendQueryStart(conn))
+		return 0;
+
+	/* This isn't gonna work on a 2.0 server */
+	if (PG_PROTOCOL_MAJOR(conn->pversion) < 3)
+	{
+		pqClearPendingCloses(conn);
+		return 1;
+	}
+
+	if (pqPutPendingCloses(conn) < 0 ||
+		pqPutMsgStart('S', false, conn) < 0 ||
+		pqPutMsgEnd(conn) < 0 ||
+		pqFlush(conn) < 0)
+	{
+		pqHandleSendFailure(conn);
+		return 0;
+	}
+
+	/* no result of its own, like a Describe without a reply */
+	conn->queryclass = PGQUERY_DESCRIBE;
+	conn->asyncStatus = PGASYNC_BUSY;
+
+	result = PQexecFinish(conn);
+	ok = (result == NULL || result->resultStatus == PGRES_COMMAND_OK) &&
+		conn->status == CONNECTION_OK;
+	PQclear(result);
+
+	return ok;
+}
+
+/*
+ * pqPutPendingCloses
+ *	 Put a Close Statement message for each queued statement into the output
+ *	 buffer, ahead of the messages of the request being sent.
+ *
+ * Returns 0 on success, EOF on error. The queue is empty after.
+ */
+static int
+pqPutPendingCloses(PGconn *conn)
+{
+	int			i;
+	int			ret = 0;
+
+	for (i = 0; i < conn->nPendingCloses && ret == 0; i++)
+	{
+		if (pqPutMsgStart('C', false, conn) < 0 ||
+			pqPutc('S', conn) < 0 ||
+			pqPuts(conn->pendingCloses[i], conn) < 0 ||
+			pqPutMsgEnd(conn) < 0)
+			ret = EOF;
+	}
+
+	pqClearPendingCloses(conn);
+
+	return ret;
+}
+
+/*
+ * pqClearPendingCloses
+ *	 Forget the queued statements, when they are sent or the session ends.
+ */
+void
+pqClearPendingCloses(PGconn *conn)
+{
+	int			i;
+
+	for (i = 0; i < conn->nPendingCloses; i++)
+		free(conn->pendingCloses[i]);
+	free(conn->pendingCloses);
+	conn->pendingCloses = NULL;
+	conn->nPendingCloses = 0;
+	conn->pendingClosesSize = 0;
+}
+
 /*
  * PQnotifies
  *	  returns a PGnotify* structure of the latest async notification
@@ -2967,9 +3644,14 @@ interpret_error:
 char *
 PQgetvalue(const PGresult *res, int tup_num, int field_num)
 {
+	PGresAttValue *tup;
+
 	if (!check_tuple_field_number(res, tup_num, field_num))
 		return NULL;
-	return res->tuples[tup_num][field_num].value;
+	tup = pqGetTuple(res, tup_num);
+	if (tup == NULL)
+		return NULL;
+	return tup[field_num].value;
 }
 
 
@@ -3066,10 +3748,13 @@ getPQResultAttrsType(PGresult *res, int i){
 int
 PQgetlength(const PGresult *res, int tup_num, int field_num)
 {
+	PGresAttValue *tup;
+
 	if (!check_tuple_field_number(res, tup_num, field_num))
 		return 0;
-	if (res->tuples[tup_num][field_num].len != NULL_LEN)
-		return res->tuples[tup_num][field_num].len;
+	tup = pqGetTuple(res, tup_num);
+	if (tup != NULL && tup[field_num].len != NULL_LEN)
+		return tup[field_num].len;
 	else
 		return 0;
 }
@@ -3080,9 +3765,12 @@ PQgetlength(const PGresult *res, int tup_num, int field_num)
 int
 PQgetisnull(const PGresult *res, int tup_num, int field_num)
 {
+	PGresAttValue *tup;
+
 	if (!check_tuple_field_number(res, tup_num, field_num))
 		return 1;				/* pretend it is null */
-	if (res->tuples[tup_num][field_num].len == NULL_LEN)
+	tup = pqGetTuple(res, tup_num);
+	if (tup == NULL || tup[field_num].len == NULL_LEN)
 		return 1;
 	else
 		return 0;
@@ -3503,9 +4191,18 @@ PQunescapeBytea(const unsigned char *strtext, size_t *retbuflen)
 // IHG
 PGresAttValue **pqGetTuples(PGresult * res)
 {
+	int			row;
+
 	if (!res)
 		return NULL;			
 
+    /* Callers walk all fields, so decode the raw rows of lazy decode mode */
+    for (row = 0; row < res->ntups; row++)
+    {
+        if (pqGetTuple(res, row) == NULL)
+            return NULL;
+    }
+
     return res->tuples;
 }
 
@@ -3536,14 +4233,35 @@ void _pgFreeTuplePointers(PGresult * res)
                     res->tuples[row] = rs_free(res->tuples[row]);
                 }
 
-                res->tuples = rs_free(res->tuples);
+                // Keep the array for a later batch. Next batch is read before this one is freed,
+                // so the spare is the array of the batch before this one.
+                if(res->m_cscSpareTuples)
+                    rs_free(res->m_cscSpareTuples);
+
+                res->m_cscSpareTuples = res->tuples;
+                res->m_cscSpareTupArrSize = res->ntups;
+                res->tuples = NULL;
             }
-            else 
+            else
+            {
+                /* Release the charge of the array pqAddTuple made */
 		        free(res->tuples);
+                pqResultCharge(res, -((long long) res->tupArrSize * sizeof(PGresAttValue *)));
+            }
 
             res->tuples = NULL;
+            res->tupArrSize = 0;
             res->ntups = 0;
         }
+
+        /* Free the raw tuple pointer array of lazy decode mode */
+        if (res->rawTuples)
+        {
+            free(res->rawTuples);
+            pqResultCharge(res, -((long long) res->rawArrSize * sizeof(char *)));
+            res->rawTuples = NULL;
+            res->rawArrSize = 0;
+        }
     }
 }
 
@@ -3577,20 +4295,22 @@ static void pqClearForStreamingCursor(PGresult *res, PGconn *conn)
 		res->events = NULL;
 	}
 
-	/* Free all the subsidiary blocks */
+	/* Keep the subsidiary blocks for the rows of the next batch */
 	while ((block = res->curBlock) != NULL)
 	{
-		res->curBlock = block->next;
-		free(block);
+		res->curBlock = block->hdr.next;
+		pqResultReleaseBlock(res, block);
 	}
 	res->curBlock=NULL;
 
-	/* Free the top-level tuple pointer array */
-    _pgFreeTuplePointers(res);
+	/* Keep the top-level tuple pointer array for the rows of the next batch */
+    if(res->m_tuplesAllocatedByCscRead)
+        _pgFreeTuplePointers(res);
+
+    pqResultCharge(res, -(res->mem_charged - ((res->tuples) ? (long long) res->tupArrSize * sizeof(PGresAttValue *) : 0)));
 
 	/* zero out the pointer fields to catch programming errors */
 	res->attDescs = NULL; // TODO: Don't release it.
-	res->tuples = NULL;
 	res->paramDescs = NULL;
 	res->errFields = NULL;
 	res->events = NULL;
@@ -3604,7 +4324,6 @@ static void pqClearForStreamingCursor(PGresult *res, PGconn *conn)
 
 	res->curOffset = 0;
 	res->spaceLeft = 0;
-	res->tupArrSize = 0;
 	res->myntups = 0;
 	res->totalntups = 0;
 	res->capped = 0;
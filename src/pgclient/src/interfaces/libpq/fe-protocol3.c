@@ -546,6 +546,7 @@ void _pqParseInput3(void *_pCscStatementContext,int *piStop)
 	                PGresult_data *_nextBlock = NULL;	/* most recently allocated block */
 	                int			_curOffset = 0;		/* start offset of free space in block */
 	                int			_spaceLeft = 0;		/* number of free bytes remaining in block */
+	                long long	_memCharged = 0;	/* bytes charged to process result memory */
                     int         iSavedResultBlockStatus = FALSE; // Just indicate whether we save the status or not.
                     PGresult   *result; 
 
@@ -588,7 +589,8 @@ void _pqParseInput3(void *_pCscStatementContext,int *piStop)
                                 _curBlock = result->curBlock;
                                 _curOffset = result->curOffset;
                                 _spaceLeft = result->spaceLeft;
-                                _nextBlock = result->curBlock->next;
+                                _nextBlock = result->curBlock->hdr.next;
+                                _memCharged = result->mem_charged;
                                 iSavedResultBlockStatus = TRUE;
                             }
 
@@ -621,6 +623,14 @@ void _pqParseInput3(void *_pCscStatementContext,int *piStop)
 	                            if(!doesThresholdReachCsc(pCscResult))
 	                            {
 	                    	        int reachThresholdLimit = checkForThresholdLimitReachCsc(pCscResult,0, getRawRowLengthCsc(pCscResult), TRUE);
+
+	                    	        // Results of the process use more memory than the limit, so spill this one too.
+	                    	        if(!reachThresholdLimit && rs_mem_over_limit())
+	                    	        {
+	                    	            RS_LOG_DEBUG("CSCINF", "Result memory limit reached: used=%lld, limit=%lld, result=%lld",
+	                    	                        rs_mem_get_used(), rs_mem_get_limit(), conn->result->mem_charged);
+	                    	            reachThresholdLimit = TRUE;
+	                    	        }
         	                    	
 	                    	        if(reachThresholdLimit)
 	                    	        {
@@ -653,13 +663,13 @@ void _pqParseInput3(void *_pCscStatementContext,int *piStop)
 
                                     conn->curTuple = _curTuple;
 
-                                    // Free any new block(s) added in front
+                                    // Release any new block(s) added in front, for the next row
                                     while ((block = result->curBlock) != _curBlock)
                                     {
                                         if(block)
                                         {
-	                                        result->curBlock = block->next;
-	                                        free(block);
+	                                        result->curBlock = block->hdr.next;
+	                                        pqResultReleaseBlock(result, block);
                                         }
                                         else
                                             break;
@@ -667,13 +677,13 @@ void _pqParseInput3(void *_pCscStatementContext,int *piStop)
 
                                     if(result->curBlock)
                                     {
-                                        // Free any new block(s) added at next
-                                        while ((block = result->curBlock->next) != _nextBlock)
+                                        // Release any new block(s) added at next
+                                        while ((block = result->curBlock->hdr.next) != _nextBlock)
                                         {
                                             if(block)
                                             {
-	                                            result->curBlock->next = block->next;
-	                                            free(block);
+	                                            result->curBlock->hdr.next = block->hdr.next;
+	                                            pqResultReleaseBlock(result, block);
                                             }
                                             else
                                                 break;
@@ -683,6 +693,9 @@ void _pqParseInput3(void *_pCscStatementContext,int *piStop)
                                     // Restore cur block status
                                     result->curOffset = _curOffset;
                                     result->spaceLeft = _spaceLeft;
+
+                                    // Release the charge of the freed block(s)
+                                    pqResultCharge(result, _memCharged - result->mem_charged);
                                 }
                             }
                             else
@@ -698,7 +711,7 @@ void _pqParseInput3(void *_pCscStatementContext,int *piStop)
 									if(iStreamingCursorMode)
 									{
 										if(conn->result 
-											&& 	conn->result->totalntups == pCscStatementContext->m_StreamingCursorInfo.m_streamingCursorRows)
+											&& 	isEndOfStreamingCursorBatch(pCscStatementContext, conn->result))
 										{
 											/* Normal case: parsing agrees with specified length */
 											conn->inStart = conn->inCursor;
@@ -881,6 +894,9 @@ getRowDescriptions(PGconn *conn)
 	/* result->binary is true only if ALL columns are binary */
 	result->binary = (nfields > 0) ? 1 : 0;
 
+	/* lazy decode keeps text values in the raw row, binary ones need alignment */
+	result->lazyDecode = conn->iLazyRowDecode;
+
 	/* get type info */
 	for (i = 0; i < nfields; i++)
 	{
@@ -924,6 +940,8 @@ getRowDescriptions(PGconn *conn)
 
 		if (format != 1)
 			result->binary = 0;
+		if (format != 0)
+			result->lazyDecode = FALSE;
 
 		if (conn->server_protocol_version >= EXTENDED_RESULT_METADATA_SERVER_PROTOCOL_VERSION)
 		{
@@ -1115,6 +1133,49 @@ getAnotherTuple(PGconn *conn, int msgLength, PGresAttValue **pTup, int iStreamin
             }
         }
 
+	    /*
+	     * In lazy decode mode keep the fields of the message as they are, in one
+	     * block, and decode them when the row is accessed. Rows going to the CSC
+	     * file or a streaming cursor batch are decoded now.
+	     */
+	    if (result->lazyDecode && pTup == NULL && iStreamingCursorRows <= 0)
+	    {
+		    int			rawLen = msgLength - 2;
+		    char	   *raw;
+
+		    if (pqGetInt(&tupnfields, 2, conn))
+			    return EOF;
+
+		    if (tupnfields != nfields || rawLen < 0)
+		    {
+			    printfPQExpBuffer(&conn->errorMessage,
+				    	 libpq_gettext("unexpected field count in \"D\" message\n"));
+			    pqSaveErrorResult(conn);
+			    conn->inCursor = conn->inStart + 5 + msgLength;
+			    return 0;
+		    }
+
+		    /* length of the fields, the fields and a spare byte to terminate the last one */
+		    raw = (char *) pqResultAlloc(result, sizeof(int) + rawLen + 1, TRUE);
+		    if (raw == NULL)
+			    goto outOfMemory;
+
+		    memcpy(raw, &rawLen, sizeof(int));
+		    if (rawLen > 0)
+			    if (pqGetnchar(raw + sizeof(int), rawLen, conn))
+				    return EOF;
+
+		    result->mem_used += rawLen + 1;
+
+		    if (!pqAddRawTuple(result, raw))
+			    goto outOfMemory;
+
+		    result->totalntups++;
+		    conn->curTuple = NULL;
+
+		    return 0;
+	    }
+
 	    /* Allocate tuple space if first time for this data message */
 	    if (conn->curTuple == NULL)
 	    {
@@ -304,6 +304,9 @@ extern void PQfreeCancel(PGcancel *cancel);
 /* issue a cancel request */
 extern int	PQcancel(PGcancel *cancel, char *errbuf, int errbufsize);
 
+/* Redshift Extension: issue a cancel request, bounding the socket operations by timeout seconds */
+extern int	PQcancelTimeout(PGcancel *cancel, char *errbuf, int errbufsize, int timeout);
+
 /* backwards compatible version of PQcancel; not thread-safe */
 extern int	PQrequestCancel(PGconn *conn);
 
@@ -320,6 +323,7 @@ extern ConnStatusType PQstatus(const PGconn *conn);
 extern PGTransactionStatusType PQtransactionStatus(const PGconn *conn);
 extern const char *PQparameterStatus(const PGconn *conn,
 				  const char *paramName);
+extern const char *PQsessionTimeZone(const PGconn *conn);
 extern int	PQprotocolVersion(const PGconn *conn);
 extern int	PQserverVersion(const PGconn *conn);
 extern char *PQerrorMessage(const PGconn *conn);
@@ -519,6 +523,7 @@ extern PGresult *PQmakeEmptyPGresult(PGconn *conn, ExecStatusType status);
 extern PGresult *PQcopyResult(const PGresult *src, int flags);
 extern int	PQsetResultAttrs(PGresult *res, int numAttributes, PGresAttDesc *attDescs);
 extern void *PQresultAlloc(PGresult *res, size_t nBytes);
+extern size_t PQresultMemorySize(const PGresult *res);
 extern int	PQsetvalue(PGresult *res, int tup_num, int field_num, const char *value, int len);
 
 extern unsigned char *PQescapeByteaConn(PGconn *conn,
@@ -614,6 +619,9 @@ extern int pqSendPrepareAndDescribe(PGconn *conn,
 			  int nParams, const Oid *paramTypes);
 
 extern PGresult *pqgetResultForDescribeParam(PGconn *conn);
+extern PGresult *pqCopyDescribeResult(const PGresult *src);
+extern int pqQueueClosePrepared(PGconn *conn, const char *stmtName);
+extern int pqClosePendingPrepared(PGconn *conn);
 extern PGresult *pqexecParams(PGconn *conn,
 			 const char *command,
 			 int nParams,
@@ -114,10 +114,17 @@ typedef union pgresult_data PGresult_data;
 
 union pgresult_data
 {
-	PGresult_data *next;		/* link to next block, or NULL */
+	struct
+	{
+		PGresult_data *next;	/* link to next block, or NULL */
+		size_t		size;		/* malloc'd size of the block, with header */
+	}			hdr;
 	char		space[1];		/* dummy for accessing block as bytes */
 };
 
+/* Free data blocks of the results of a connection. See fe-exec.c. */
+typedef struct pg_block_pool PGblockPool;
+
 /* Data about a single parameter of a prepared statement */
 typedef struct pgresParamDesc
 {
@@ -183,6 +190,7 @@ struct pg_result
 	int			myntups;
 	int         totalntups;
 	int			mem_used;     /* Track bytes allocated for result */
+	long long	mem_charged;  /* Bytes charged to the result memory of the process */
 	bool		capped;  /* Results mem cap reached. This isnt full result set */
 
 	int			numAttributes;
@@ -190,6 +198,10 @@ struct pg_result
 	PGresAttValue **tuples;		/* each PGresTuple is an array of
 								 * PGresAttValue's */
 	int			tupArrSize;		/* allocated size of tuples array */
+	char	  **rawTuples;		/* raw DataRow of each tuple in lazy decode
+								 * mode, decoded into tuples on first access */
+	int			rawArrSize;		/* allocated size of rawTuples array */
+	int			lazyDecode;		/* keep rows raw, set when all columns are text */
 	int			numParameters;
 	PGresParamDesc *paramDescs;
 	ExecStatusType resultStatus;
@@ -225,9 +237,14 @@ struct pg_result
 	PGresult_data *curBlock;	/* most recently allocated block */
 	int			curOffset;		/* start offset of free space in block */
 	int			spaceLeft;		/* number of free bytes remaining in block */
+	int			blockSize;		/* size of the next standard block */
+	PGresult_data *freeBlocks;	/* blocks of blockSize kept for reuse */
+	PGblockPool *blockPool;		/* free blocks of the connection, or NULL */
 
 	struct _ClientSideCursorResult *m_cscResult; /* CSC */
     int  m_tuplesAllocatedByCscRead; /* 1 means tuples are allocated by CSC read, 0 otherwise */
+    PGresAttValue **m_cscSpareTuples; /* tuples array of an older CSC batch, for the next batch */
+    int  m_cscSpareTupArrSize; /* rows the spare tuples array has room for */
 };
 
 /* PGAsyncStatusType defines the state of the query-execution state machine */
@@ -392,6 +409,7 @@ struct pg_conn
 	int			be_key;			/* key of backend --- needed for cancels */
 	char		md5Salt[4];		/* password salt received from backend */
 	pgParameterStatus *pstatus; /* ParameterStatus data */
+	const char *session_timezone; /* TimeZone value inside pstatus, or NULL */
 	int			client_encoding;	/* encoding id */
 	bool		std_strings;	/* standard_conforming_strings */
 	PGVerbosity verbosity;		/* error/notice message verbosity */
@@ -472,10 +490,27 @@ struct pg_conn
     long long llCscThreshold;
     long long llCscMaxFileSize;
     char szCscPath[MAX_PATH + 1];
+    int iCscSyncWrites;
+    int iCscFileFormat;
+    long long llCscCacheSize;
+
+    // Result memory limit of the process in MB. 0 means no limit, -1 means derived from the cgroup.
+    long long llResultMemoryLimit;
 
 	// Streaming Cursor
 	int iStreamingCursorRows;
 
+    // Keep DataRow messages raw and decode the fields of a row on first access.
+    int iLazyRowDecode;
+
+    // Free data blocks of the results of the connection
+    PGblockPool *blockPool;
+
+    // Prepared statements to close with the next extended query request
+    char **pendingCloses;
+    int nPendingCloses;
+    int pendingClosesSize;
+
 	// Added Redshift protocol options
 	int	   server_protocol_version;		/* Redshift server protocol version */
 	char *client_protocol_version;
@@ -572,6 +607,13 @@ extern pgthreadlock_t pg_g_threadlock;
 extern void pqSetResultError(PGresult *res, const char *msg);
 extern void pqCatenateResultError(PGresult *res, const char *msg);
 extern void *pqResultAlloc(PGresult *res, size_t nBytes, bool isBinary);
+extern void pqResultCharge(PGresult *res, long long bytes);
+extern void pqResultReleaseBlock(PGresult *res, PGresult_data *block);
+extern PGblockPool *pqCreateBlockPool(void);
+extern PGblockPool *pqAddRefBlockPool(PGblockPool *pool);
+extern PGblockPool *pqReleaseBlockPool(PGblockPool *pool);
+extern void pqGetBlockPoolStats(PGblockPool *pool, long long *pllHits, long long *pllMisses, long long *pllBytes);
+extern void pqClearPendingCloses(PGconn *conn);
 extern char *pqResultStrdup(PGresult *res, const char *str);
 extern void pqClearAsyncResult(PGconn *conn);
 extern void pqSaveErrorResult(PGconn *conn);
@@ -581,6 +623,8 @@ pqInternalNotice(const PGNoticeHooks *hooks, const char *fmt,...)
 /* This lets gcc check the format string for consistency. */
 __attribute__((format(PG_PRINTF_ATTRIBUTE, 2, 3)));
 extern int	pqAddTuple(PGresult *res, PGresAttValue *tup, int iStreamingCursorRows);
+extern int	pqAddRawTuple(PGresult *res, char *raw);
+extern PGresAttValue *pqGetTuple(const PGresult *res, int tup_num);
 extern void pqSaveMessageField(PGresult *res, char code,
 				   const char *value);
 extern void pqSaveParameterStatus(PGconn *conn, const char *name,
@@ -11,8 +11,16 @@
 #if defined LINUX32 
 #include <stdio.h>
 #endif
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 #include "rsfile.h"
+#ifdef WIN32
+#include <io.h>
+#endif
 
 /*====================================================================================================================================================*/
 
@@ -76,6 +84,135 @@ int rs_fsync(int fd)
 
 /*====================================================================================================================================================*/
 
+//---------------------------------------------------------------------------------------------------------igarish
+// Get current size of the file on disk. Data buffered in FILE is not counted. -1 means error.
+//
+long long rs_fsize(FILE *_file)
+{
+    long long size = -1;
+
+#ifdef WIN32
+    LARGE_INTEGER fileSize;
+
+    if(GetFileSizeEx((HANDLE)_get_osfhandle(_fileno(_file)), &fileSize))
+        size = fileSize.QuadPart;
+#endif
+
+#if defined LINUX 
+    struct stat st;
+
+    if(fstat(fileno(_file), &st) == 0)
+        size = st.st_size;
+#endif
+
+    return size;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Map first size bytes of the file for reading. sequential is a hint that the view is read from start to end.
+// *ppMapHandle gets the handle to pass to rs_munmap. NULL means error.
+//
+void *rs_mmap(FILE *_file, long long size, int sequential, void **ppMapHandle)
+{
+    void *pMap = NULL;
+
+    *ppMapHandle = NULL;
+
+    if(_file == NULL || size <= 0 || (unsigned long long)size > (size_t)-1)
+        return NULL;
+
+#ifdef WIN32
+    {
+        HANDLE hMap = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(_file)), NULL, PAGE_READONLY,
+                                        (DWORD)(((unsigned long long)size) >> 32), (DWORD)(size & 0xFFFFFFFF), NULL);
+
+        if(hMap != NULL)
+        {
+            pMap = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, (SIZE_T)size);
+
+            if(pMap != NULL)
+                *ppMapHandle = hMap;
+            else
+                CloseHandle(hMap);
+        }
+    }
+#endif
+
+#if defined LINUX 
+    pMap = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, fileno(_file), 0);
+
+    if(pMap == MAP_FAILED)
+        pMap = NULL;
+    else
+    if(sequential)
+        madvise(pMap, (size_t)size, MADV_SEQUENTIAL);
+#endif
+
+    return pMap;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Unmap the view created by rs_mmap. 0 means successful.
+//
+int rs_munmap(void *pMap, long long size, void *pMapHandle)
+{
+    int rc = 0;
+
+    if(pMap != NULL)
+    {
+#ifdef WIN32
+        rc = !UnmapViewOfFile(pMap);
+
+        if(pMapHandle != NULL)
+            CloseHandle((HANDLE)pMapHandle);
+#endif
+
+#if defined LINUX 
+        rc = munmap(pMap, (size_t)size);
+#endif
+    }
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Hint the OS to read the range ahead of use. It doesn't wait for the read.
+// Range is in the mapped view, if pMap isn't NULL. Otherwise it's in the file. 0 means successful.
+//
+int rs_prefetch(FILE *_file, void *pMap, long long offset, long long len)
+{
+    int rc = 0;
+
+    if(len <= 0 || offset < 0)
+        return 0;
+
+#if defined LINUX 
+    if(pMap != NULL)
+    {
+        long long pageSize = sysconf(_SC_PAGESIZE);
+        long long start = (pageSize > 0) ? (offset - (offset % pageSize)) : offset;
+
+        rc = madvise((char *)pMap + start, (size_t)(len + offset - start), MADV_WILLNEED);
+    }
+#if !defined(__APPLE__)
+    // macOS builds with LINUX too, but has no posix_fadvise
+    else
+    if(_file != NULL)
+        rc = posix_fadvise(fileno(_file), (off_t)offset, (off_t)len, POSIX_FADV_WILLNEED);
+#endif
+#endif
+
+    return rc;
+}
+
+/*====================================================================================================================================================*/
+
 //---------------------------------------------------------------------------------------------------------igarish
 // Return current time as millisec
 //
@@ -50,6 +50,10 @@ extern "C"
 FILE *rs_fopen(const char * _Filename, const char * _Mode);
 int rs_fileno(FILE *_file);
 int rs_fsync(int fd);
+long long rs_fsize(FILE *_file);
+void *rs_mmap(FILE *_file, long long size, int sequential, void **ppMapHandle);
+int rs_munmap(void *pMap, long long size, void *pMapHandle);
+int rs_prefetch(FILE *_file, void *pMap, long long offset, long long len);
 long long getCurrentTimeInMilli(void);
 int fileExists(char * pFileName); // Define in file_util.c
 
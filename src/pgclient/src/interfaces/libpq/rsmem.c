@@ -8,6 +8,21 @@
 
 #include "rsmem.h"
 
+#include <stdio.h>
+
+#ifdef WIN32
+#define RS_MEM_ADD(pVal, delta)                 (InterlockedExchangeAdd64((pVal), (delta)) + (delta))
+#define RS_MEM_CAS(pVal, oldVal, newVal)        (InterlockedCompareExchange64((pVal), (newVal), (oldVal)) == (oldVal))
+#else
+#define RS_MEM_ADD(pVal, delta)                 __sync_add_and_fetch((pVal), (delta))
+#define RS_MEM_CAS(pVal, oldVal, newVal)        __sync_bool_compare_and_swap((pVal), (oldVal), (newVal))
+#endif
+
+// Result memory accounting of the process. Limit 0 means no limit.
+static volatile long long g_memUsed = 0;
+static volatile long long g_memPeak = 0;
+static volatile long long g_memLimit = 0;
+
 /*====================================================================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------------igarish
@@ -51,4 +66,135 @@ void *rs_free(void * block)
     return NULL;
 }
 
-void RsFree(void* p) { free(p); }  // uses the DLL's CRT
\ No newline at end of file
+void RsFree(void* p) { free(p); }  // uses the DLL's CRT
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Set the result memory limit of the process in bytes. Negative means derive it from the cgroup memory limit.
+// Connections can ask for different limits, so the lowest one stays.
+//
+void rs_mem_set_limit(long long limit)
+{
+    long long curLimit;
+
+    if(limit < 0)
+        limit = rs_mem_get_cgroup_limit() / 100 * RS_MEM_CGROUP_PERCENT;
+
+    if(limit <= 0)
+        return;
+
+    do
+    {
+        curLimit = g_memLimit;
+
+        if(curLimit != 0 && curLimit <= limit)
+            break;
+    } while(!RS_MEM_CAS(&g_memLimit, curLimit, limit));
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Replace the result memory limit of the process, even with a higher one. 0 means no limit.
+//
+void rs_mem_reset_limit(long long limit)
+{
+    g_memLimit = (limit > 0) ? limit : 0;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get the result memory limit of the process. 0 means no limit.
+//
+long long rs_mem_get_limit(void)
+{
+    return g_memLimit;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get the memory limit of the cgroup of the process. 0 means no limit or not known.
+//
+long long rs_mem_get_cgroup_limit(void)
+{
+    long long limit = 0;
+
+#ifdef LINUX
+    // cgroup v2, then v1
+    const char *files[] = { "/sys/fs/cgroup/memory.max", "/sys/fs/cgroup/memory/memory.limit_in_bytes" };
+    int i;
+
+    for(i = 0; i < (int)(sizeof(files) / sizeof(files[0])) && limit == 0; i++)
+    {
+        FILE *fp = fopen(files[i], "r");
+
+        if(fp)
+        {
+            // v2 has "max" and v1 has a huge number for no limit.
+            if(fscanf(fp, "%lld", &limit) != 1 || limit <= 0 || limit >= (1LL << 60))
+                limit = 0;
+
+            fclose(fp);
+        }
+    }
+#endif
+
+    return limit;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Add bytes allocated for results to the process usage. Negative bytes are freed bytes.
+//
+void rs_mem_charge(long long bytes)
+{
+    long long used = RS_MEM_ADD(&g_memUsed, bytes);
+    long long peak;
+
+    if(bytes <= 0)
+        return;
+
+    do
+    {
+        peak = g_memPeak;
+
+        if(used <= peak)
+            break;
+    } while(!RS_MEM_CAS(&g_memPeak, peak, used));
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get bytes used by results in the process.
+//
+long long rs_mem_get_used(void)
+{
+    return g_memUsed;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Get the highest bytes used by results in the process.
+//
+long long rs_mem_get_peak(void)
+{
+    return g_memPeak;
+}
+
+/*====================================================================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------------igarish
+// Check whether results of the process use more than the limit.
+//
+int rs_mem_over_limit(void)
+{
+    long long limit = g_memLimit;
+
+    return (limit > 0 && g_memUsed > limit);
+}
\ No newline at end of file
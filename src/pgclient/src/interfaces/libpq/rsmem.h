@@ -14,6 +14,9 @@
 
 #include <stdlib.h>
 
+// Part of the cgroup memory limit used as result memory limit, when the limit comes from the cgroup.
+#define RS_MEM_CGROUP_PERCENT 50
+
 #ifdef __cplusplus
 extern "C" 
 {
@@ -25,6 +28,15 @@ void *rs_realloc(void *memory, size_t newSize);
 void *rs_free(void * block);
 void RsFree(void* block); //returns void not void* and also aims to use the DLL's CRT
 
+void rs_mem_set_limit(long long limit);
+void rs_mem_reset_limit(long long limit);
+long long rs_mem_get_limit(void);
+long long rs_mem_get_cgroup_limit(void);
+void rs_mem_charge(long long bytes);
+long long rs_mem_get_used(void);
+long long rs_mem_get_peak(void);
+int rs_mem_over_limit(void);
+
 #ifdef __cplusplus
 }
 #endif /* C++ */
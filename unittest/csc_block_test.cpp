@@ -0,0 +1,228 @@
+#include "common.h"
+#include "ClientSideCursorBlock.h"
+#include <string>
+#include <vector>
+
+#define CSC_SCROLLABLE_CURSOR 3 // SQL_CURSOR_STATIC
+
+class CscBlockTest : public ::testing::Test {
+  protected:
+    std::string fileName;
+
+    void SetUp() override {
+        fileName = ::testing::TempDir() + "csc_block_test.cursor";
+    }
+
+    void TearDown() override { remove(fileName.c_str()); }
+
+    // Column 0 is text, column 1 is NULL on every third row and column 2 is an empty string.
+    static std::string cellValue(int row, int col) {
+        if (col == 0)
+            return "customer-" + std::to_string(row) + " some repeated text";
+        if (col == 1)
+            return std::to_string(row * 7);
+        return "";
+    }
+
+    static bool isNull(int row, int col) { return col == 1 && row % 3 == 0; }
+
+    static void fillTuple(PGresAttValue *tuple, std::vector<std::string> &vals, int row) {
+        for (int col = 0; col < 3; col++) {
+            vals[col] = cellValue(row, col);
+            tuple[col].len = (int)vals[col].size();
+            tuple[col].value = isNull(row, col) ? NULL : (char *)vals[col].c_str();
+        }
+    }
+
+    static void checkTuple(PGresAttValue *tuple, int row) {
+        for (int col = 0; col < 3; col++) {
+            if (isNull(row, col)) {
+                EXPECT_EQ(tuple[col].len, -1);
+                EXPECT_EQ(tuple[col].value, nullptr);
+            } else {
+                ASSERT_NE(tuple[col].value, nullptr);
+                EXPECT_EQ(std::string(tuple[col].value, tuple[col].len), cellValue(row, col));
+            }
+        }
+    }
+
+    static void freeTuple(PGresAttValue *tuple) {
+        for (int col = 0; col < 3; col++)
+            rs_free(tuple[col].value);
+        rs_free(tuple);
+    }
+
+    // Write rows 1..totalRows, starting a new block every rowsPerBlock rows.
+    void writeBlocks(ClientSideCursorBlockDir *pDir, int totalRows, int rowsPerBlock, int compress) {
+        int err = 0;
+        std::vector<std::string> vals(3);
+        PGresAttValue tuple[3];
+        ClientSideCursorBlockDirEntry entry;
+
+        ClientSideCursorOutputStream *pOut = createCscOutputStream(
+            (char *)fileName.c_str(), CSC_SCROLLABLE_CURSOR, FALSE, &err);
+        ASSERT_EQ(err, 0);
+        ClientSideCursorBlockWriter *pWriter = createCscBlockWriter(compress);
+        ASSERT_NE(pWriter, nullptr);
+
+        int firstRow = 1;
+        for (int row = 1; row <= totalRows; row++) {
+            fillTuple(tuple, vals, row);
+            ASSERT_EQ(addRowCscBlockWriter(pWriter, tuple, 3), 0);
+            if (row - firstRow + 1 == rowsPerBlock || row == totalRows) {
+                ASSERT_EQ(writeBlockCscBlockWriter(pWriter, pOut, firstRow, &entry), 0);
+                EXPECT_EQ(entry.m_firstRowNumber, firstRow);
+                EXPECT_EQ(entry.m_rows, row - firstRow + 1);
+                ASSERT_EQ(addEntryCscBlockDir(pDir, &entry), 0);
+                firstRow = row + 1;
+            }
+        }
+
+        EXPECT_EQ(closeCscOutputStream(pOut), 0);
+        releaseCscOutputStream(pOut);
+        releaseCscBlockWriter(pWriter);
+    }
+
+    // Read the given rows in order through the directory and check them.
+    void readRows(ClientSideCursorBlockDir *pDir, const std::vector<int> &rowNumbers,
+                  ClientSideCursorBlockCache *pCache = nullptr, long long ownerId = 0) {
+        int err = 0;
+        ClientSideCursorInputStream *pIn = createCscInputStream(
+            (char *)fileName.c_str(), CSC_SCROLLABLE_CURSOR, &err);
+        ASSERT_EQ(err, 0);
+        ClientSideCursorBlockReader *pReader = createCscBlockReader();
+        ASSERT_NE(pReader, nullptr);
+        if (pCache)
+            setCacheCscBlockReader(pReader, pCache, ownerId);
+
+        for (int rowNumber : rowNumbers) {
+            if (!containsRowCscBlockReader(pReader, rowNumber)) {
+                ClientSideCursorBlockDirEntry entry;
+                ASSERT_TRUE(findEntryCscBlockDir(pDir, rowNumber, &entry));
+                ASSERT_EQ(loadCscBlockReader(pReader, pIn, &entry), 0);
+            }
+
+            long long rawRowLength = 0;
+            PGresAttValue *tuple = readRowCscBlockReader(pReader, rowNumber, &rawRowLength);
+            ASSERT_NE(tuple, nullptr);
+            checkTuple(tuple, rowNumber);
+            EXPECT_EQ(rawRowLength, getRowLengthCscBlockReader(pReader, rowNumber));
+            freeTuple(tuple);
+        }
+
+        EXPECT_EQ(closeCscInputStream(pIn), 0);
+        releaseCscInputStream(pIn);
+        releaseCscBlockReader(pReader);
+    }
+};
+
+// Rows written in several compressed blocks read back the same, forward and in random order.
+TEST_F(CscBlockTest, CompressedRoundTrip) {
+    ClientSideCursorBlockDir *pDir = createCscBlockDir();
+    writeBlocks(pDir, 2500, 1000, TRUE);
+    EXPECT_EQ(pDir->m_count, 3);
+
+    std::vector<int> forward;
+    for (int row = 1; row <= 2500; row++)
+        forward.push_back(row);
+    readRows(pDir, forward);
+
+    readRows(pDir, {2500, 1, 1500, 999, 1000, 1001, 2001, 17, 2499});
+    releaseCscBlockDir(pDir);
+}
+
+// Text-heavy rows take less space than their raw size in compressed blocks.
+TEST_F(CscBlockTest, CompressionShrinksFile) {
+    ClientSideCursorBlockDir *pDir = createCscBlockDir();
+    writeBlocks(pDir, 5000, 5000, TRUE);
+
+    FILE *fp = fopen(fileName.c_str(), "rb");
+    ASSERT_NE(fp, nullptr);
+    fseek(fp, 0, SEEK_END);
+    long compressedSize = ftell(fp);
+    fclose(fp);
+    releaseCscBlockDir(pDir);
+
+    pDir = createCscBlockDir();
+    writeBlocks(pDir, 5000, 5000, FALSE);
+    fp = fopen(fileName.c_str(), "rb");
+    ASSERT_NE(fp, nullptr);
+    fseek(fp, 0, SEEK_END);
+    long rawSize = ftell(fp);
+    fclose(fp);
+
+    EXPECT_LT(compressedSize * 3, rawSize);
+    releaseCscBlockDir(pDir);
+}
+
+// Uncompressed blocks read back the same.
+TEST_F(CscBlockTest, UncompressedRoundTrip) {
+    ClientSideCursorBlockDir *pDir = createCscBlockDir();
+    writeBlocks(pDir, 10, 4, FALSE);
+    EXPECT_EQ(pDir->m_count, 3);
+    readRows(pDir, {10, 9, 1, 2, 3, 4, 5, 8});
+    releaseCscBlockDir(pDir);
+}
+
+// Row number outside of written blocks isn't found.
+TEST_F(CscBlockTest, DirectoryLookup) {
+    ClientSideCursorBlockDir *pDir = createCscBlockDir();
+    ClientSideCursorBlockDirEntry entry;
+    writeBlocks(pDir, 10, 4, TRUE);
+
+    ASSERT_TRUE(findEntryCscBlockDir(pDir, 5, &entry));
+    EXPECT_EQ(entry.m_firstRowNumber, 5);
+    EXPECT_EQ(entry.m_rows, 4);
+    EXPECT_FALSE(findEntryCscBlockDir(pDir, 0, &entry));
+    EXPECT_FALSE(findEntryCscBlockDir(pDir, 11, &entry));
+    releaseCscBlockDir(pDir);
+}
+
+// Blocks read before come from the cache, until they are evicted or their owner goes away.
+TEST_F(CscBlockTest, CacheServesRevisitedBlocks) {
+    ClientSideCursorBlockDir *pDir = createCscBlockDir();
+    writeBlocks(pDir, 3000, 1000, TRUE);
+    ClientSideCursorBlockCache *pCache = createCscBlockCache(64 * 1024 * 1024);
+    ASSERT_NE(pCache, nullptr);
+    long long ownerId = newOwnerCscBlockCache(pCache);
+
+    readRows(pDir, {1, 1500, 2500}, pCache, ownerId);
+    EXPECT_EQ(pCache->m_misses, 3);
+    EXPECT_EQ(pCache->m_hits, 0);
+
+    // Scroll back over the same blocks.
+    readRows(pDir, {2999, 1001, 2}, pCache, ownerId);
+    EXPECT_EQ(pCache->m_misses, 3);
+    EXPECT_EQ(pCache->m_hits, 3);
+
+    // Other result doesn't see them.
+    long long otherOwnerId = newOwnerCscBlockCache(pCache);
+    readRows(pDir, {1}, pCache, otherOwnerId);
+    EXPECT_EQ(pCache->m_misses, 4);
+
+    removeOwnerCscBlockCache(pCache, ownerId);
+    removeOwnerCscBlockCache(pCache, otherOwnerId);
+    EXPECT_EQ(pCache->m_head, nullptr);
+    EXPECT_EQ(pCache->m_used, 0);
+
+    releaseCscBlockCache(pCache);
+    releaseCscBlockDir(pDir);
+}
+
+// Least recently used blocks are evicted to stay in the budget. Loaded block stays.
+TEST_F(CscBlockTest, CacheStaysInBudget) {
+    ClientSideCursorBlockDir *pDir = createCscBlockDir();
+    writeBlocks(pDir, 3000, 1000, TRUE);
+    ClientSideCursorBlockCache *pCache = createCscBlockCache(1);
+    ASSERT_NE(pCache, nullptr);
+    long long ownerId = newOwnerCscBlockCache(pCache);
+
+    readRows(pDir, {1, 1001, 2001, 1, 1001}, pCache, ownerId);
+    EXPECT_EQ(pCache->m_hits, 0);
+    EXPECT_EQ(pCache->m_misses, 5);
+    EXPECT_EQ(pCache->m_head, nullptr);
+    EXPECT_EQ(pCache->m_used, 0);
+
+    releaseCscBlockCache(pCache);
+    releaseCscBlockDir(pDir);
+}
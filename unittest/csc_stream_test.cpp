@@ -0,0 +1,241 @@
+#include "common.h"
+#include "ClientSideCursorOutputStream.h"
+#include "ClientSideCursorInputStream.h"
+#include <string>
+#include <vector>
+
+#define CSC_SCROLLABLE_CURSOR 3 // SQL_CURSOR_STATIC
+
+class CscStreamTest : public ::testing::TestWithParam<int> {
+  protected:
+    std::string fileName;
+
+    void SetUp() override {
+        fileName = ::testing::TempDir() + "csc_stream_test_" +
+                   std::to_string(GetParam()) + ".cursor";
+    }
+
+    void TearDown() override { remove(fileName.c_str()); }
+};
+
+// Values written through the stream read back the same, whether they go through the
+// write buffer or bypass it, and the tracked position matches the bytes written.
+TEST_P(CscStreamTest, RoundTrip) {
+    int err = 0;
+    int syncWrites = GetParam();
+    std::vector<char> big(CSC_OUTPUT_BUFFER_SIZE + 10, 'x');
+
+    ClientSideCursorOutputStream *pOut = createCscOutputStream(
+        (char *)fileName.c_str(), CSC_SCROLLABLE_CURSOR, syncWrites, &err);
+    ASSERT_EQ(err, 0);
+    EXPECT_EQ(pOut->m_buffer == NULL, syncWrites != 0);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(writeIntCscOutputStream(pOut, i), 0);
+    }
+    EXPECT_EQ(getPositionCscOutputStream(pOut), 4000);
+
+    ASSERT_EQ(writeCscOutputStream(pOut, big.data(), 0, (int)big.size()), 0);
+    ASSERT_EQ(writeShortCscOutputStream(pOut, 7), 0);
+    ASSERT_EQ(writeLongLongCscOutputStream(pOut, 1LL << 40), 0);
+    EXPECT_EQ(getPositionCscOutputStream(pOut), 4000 + (long long)big.size() + 10);
+    ASSERT_EQ(flushCscOutputStream(pOut), 0);
+
+    // Reader sees everything flushed while the writer is still open.
+    ClientSideCursorInputStream *pIn = createCscInputStream(
+        (char *)fileName.c_str(), CSC_SCROLLABLE_CURSOR, &err);
+    ASSERT_EQ(err, 0);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(readIntCscInputStream(pIn), i);
+    }
+    ASSERT_EQ(seekCscInputStream(pIn, 4000 + (long long)big.size()), 0);
+    EXPECT_EQ(readShortCscInputStream(pIn), 7);
+    EXPECT_EQ(readLongLongCscInputStream(pIn), 1LL << 40);
+
+    EXPECT_EQ(closeCscInputStream(pIn), 0);
+    releaseCscInputStream(pIn);
+    EXPECT_EQ(closeCscOutputStream(pOut), 0);
+    releaseCscOutputStream(pOut);
+}
+
+// Buffered rows only reach the file when the writer commits.
+TEST(CscStreamBufferTest, FlushPublishesBufferedRows) {
+    int err = 0;
+    std::string fileName = ::testing::TempDir() + "csc_stream_test_flush.cursor";
+
+    ClientSideCursorOutputStream *pOut = createCscOutputStream(
+        (char *)fileName.c_str(), CSC_SCROLLABLE_CURSOR, FALSE, &err);
+    ASSERT_EQ(err, 0);
+    ASSERT_EQ(writeIntCscOutputStream(pOut, 42), 0);
+    EXPECT_EQ(pOut->m_bufferLen, 4);
+
+    FILE *fp = fopen(fileName.c_str(), "rb");
+    ASSERT_NE(fp, nullptr);
+    fseek(fp, 0, SEEK_END);
+    EXPECT_EQ(ftell(fp), 0);
+
+    ASSERT_EQ(flushCscOutputStream(pOut), 0);
+    EXPECT_EQ(pOut->m_bufferLen, 0);
+    fseek(fp, 0, SEEK_END);
+    EXPECT_EQ(ftell(fp), 4);
+    fclose(fp);
+
+    EXPECT_EQ(closeCscOutputStream(pOut), 0);
+    releaseCscOutputStream(pOut);
+    remove(fileName.c_str());
+}
+
+// Reader maps the file and grows the view as the writer commits more data.
+TEST(CscStreamMapTest, ReaderFollowsWriter) {
+    int err = 0;
+    std::string fileName = ::testing::TempDir() + "csc_stream_test_map.cursor";
+
+    ClientSideCursorOutputStream *pOut = createCscOutputStream(
+        (char *)fileName.c_str(), CSC_SCROLLABLE_CURSOR, FALSE, &err);
+    ASSERT_EQ(err, 0);
+    ClientSideCursorInputStream *pIn = createCscInputStream(
+        (char *)fileName.c_str(), CSC_SCROLLABLE_CURSOR, &err);
+    ASSERT_EQ(err, 0);
+    EXPECT_TRUE(pIn->m_useMap);
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(writeIntCscOutputStream(pOut, i), 0);
+    }
+    ASSERT_EQ(flushCscOutputStream(pOut), 0);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(readIntCscInputStream(pIn), i);
+    }
+    EXPECT_EQ(pIn->m_mapSize, 400);
+
+    // Nothing more is committed yet.
+    EXPECT_EQ(readMappedCscInputStream(pIn, 4), nullptr);
+    EXPECT_FALSE(feofCscInputStream(pIn));
+
+    for (int i = 100; i < 200; i++) {
+        ASSERT_EQ(writeIntCscOutputStream(pOut, i), 0);
+    }
+    ASSERT_EQ(flushCscOutputStream(pOut), 0);
+    const char *pData = readMappedCscInputStream(pIn, 4);
+    ASSERT_NE(pData, nullptr);
+    EXPECT_EQ(*(const int *)pData, 100);
+    EXPECT_EQ(pIn->m_mapSize, 800);
+
+    // Scrolling back is only a position change.
+    ASSERT_EQ(seekCscInputStream(pIn, 40), 0);
+    EXPECT_EQ(readIntCscInputStream(pIn), 10);
+    ASSERT_EQ(seekCscInputStream(pIn, 796), 0);
+    EXPECT_EQ(readIntCscInputStream(pIn), 199);
+    readIntCscInputStream(pIn);
+    EXPECT_TRUE(feofCscInputStream(pIn));
+
+    EXPECT_EQ(closeCscInputStream(pIn), 0);
+    releaseCscInputStream(pIn);
+    EXPECT_EQ(closeCscOutputStream(pOut), 0);
+    releaseCscOutputStream(pOut);
+    remove(fileName.c_str());
+}
+
+struct CscCommitLog {
+    std::string fileName;
+    std::vector<long long> tokens;
+    std::vector<long long> fileSizes;
+};
+
+static void logCommit(void *pContext, long long commitToken) {
+    CscCommitLog *pLog = (CscCommitLog *)pContext;
+    FILE *fp = fopen(pLog->fileName.c_str(), "rb");
+    long long size = -1;
+
+    if (fp) {
+        fseek(fp, 0, SEEK_END);
+        size = ftell(fp);
+        fclose(fp);
+    }
+    pLog->tokens.push_back(commitToken);
+    pLog->fileSizes.push_back(size);
+}
+
+// I/O thread writes the buffers in order and reports each commit only after its data is in the file.
+TEST(CscStreamAsyncTest, CommitAfterWrite) {
+    int err = 0;
+    CscCommitLog log;
+    log.fileName = ::testing::TempDir() + "csc_stream_test_async.cursor";
+    std::vector<char> big(CSC_OUTPUT_BUFFER_SIZE * 2 + 10, 'y');
+
+    ClientSideCursorOutputStream *pOut = createCscOutputStream(
+        (char *)log.fileName.c_str(), CSC_SCROLLABLE_CURSOR, FALSE, &err);
+    ASSERT_EQ(err, 0);
+    setCommitCallbackCscOutputStream(pOut, logCommit, &log);
+    ASSERT_TRUE(startAsyncWritesCscOutputStream(pOut));
+
+    // More than all buffers together, so the writer has to wait for the I/O thread.
+    const int ints = CSC_OUTPUT_BUFFER_SIZE;
+    for (int i = 0; i < ints; i++) {
+        ASSERT_EQ(writeIntCscOutputStream(pOut, i), 0);
+        if ((i + 1) % 100000 == 0)
+            ASSERT_EQ(commitCscOutputStream(pOut, (i + 1) * 4LL), 0);
+    }
+    ASSERT_EQ(writeCscOutputStream(pOut, big.data(), 0, (int)big.size()), 0);
+    long long total = ints * 4LL + (long long)big.size();
+    ASSERT_EQ(commitCscOutputStream(pOut, total), 0);
+    EXPECT_EQ(getPositionCscOutputStream(pOut), total);
+
+    ASSERT_EQ(flushCscOutputStream(pOut), 0);
+    ASSERT_EQ(log.tokens.size(), (size_t)(ints / 100000 + 1));
+    for (size_t i = 0; i < log.tokens.size(); i++) {
+        if (i > 0)
+            EXPECT_GT(log.tokens[i], log.tokens[i - 1]);
+        EXPECT_GE(log.fileSizes[i], log.tokens[i]);
+    }
+
+    EXPECT_EQ(closeCscOutputStream(pOut), 0);
+    EXPECT_EQ(pOut->m_asyncWriter, nullptr);
+    releaseCscOutputStream(pOut);
+
+    int errIn = 0;
+    ClientSideCursorInputStream *pIn = createCscInputStream(
+        (char *)log.fileName.c_str(), CSC_SCROLLABLE_CURSOR, &errIn);
+    ASSERT_EQ(errIn, 0);
+    for (int i = 0; i < ints; i++) {
+        ASSERT_EQ(readIntCscInputStream(pIn), i);
+    }
+    ASSERT_EQ(seekCscInputStream(pIn, total - 1), 0);
+    char c = 0;
+    ASSERT_EQ(readCscInputStream(pIn, &c, 0, 1), 1);
+    EXPECT_EQ(c, 'y');
+    EXPECT_EQ(closeCscInputStream(pIn), 0);
+    releaseCscInputStream(pIn);
+    remove(log.fileName.c_str());
+}
+
+#ifdef __linux__
+// Write error on the I/O thread reaches the writer and no commit is reported after it.
+TEST(CscStreamAsyncTest, WriteErrorReachesWriter) {
+    int err = 0;
+    CscCommitLog log;
+    log.fileName = "/dev/full";
+
+    ClientSideCursorOutputStream *pOut = createCscOutputStream(
+        (char *)log.fileName.c_str(), CSC_SCROLLABLE_CURSOR, FALSE, &err);
+    ASSERT_EQ(err, 0);
+    setCommitCallbackCscOutputStream(pOut, logCommit, &log);
+    ASSERT_TRUE(startAsyncWritesCscOutputStream(pOut));
+
+    int rc = 0;
+    for (int i = 0; i < CSC_OUTPUT_BUFFER_SIZE && rc == 0; i++) {
+        rc = writeIntCscOutputStream(pOut, i);
+    }
+    if (rc == 0)
+        rc = commitCscOutputStream(pOut, 1);
+    if (rc == 0)
+        rc = flushCscOutputStream(pOut);
+    EXPECT_NE(rc, 0);
+    EXPECT_NE(getAsyncErrorCscOutputStream(pOut), 0);
+    EXPECT_TRUE(log.tokens.empty());
+
+    EXPECT_NE(closeCscOutputStream(pOut), 0);
+    releaseCscOutputStream(pOut);
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(SyncWrites, CscStreamTest, ::testing::Values(0, 1));
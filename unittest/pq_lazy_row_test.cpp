@@ -0,0 +1,111 @@
+#include "common.h"
+#include "libpq-fe.h"
+extern "C" {
+#include "libpq-int.h"
+}
+#include <string>
+#include <vector>
+
+// Raw row in the layout getAnotherTuple keeps in lazy decode mode: length of the fields, the
+// fields of the DataRow message and a spare byte. NULL_VALUE marks a NULL field.
+static const char *NULL_VALUE = "\x01null";
+
+static char *makeRawRow(PGresult *res, const std::vector<const char *> &values) {
+    std::string fields;
+
+    for (const char *value : values) {
+        int vlen = (value == NULL_VALUE) ? -1 : (int)strlen(value);
+        unsigned int n = (unsigned int)vlen;
+
+        fields += (char)(n >> 24);
+        fields += (char)(n >> 16);
+        fields += (char)(n >> 8);
+        fields += (char)n;
+        if (vlen > 0)
+            fields += value;
+    }
+
+    int rawLen = (int)fields.size();
+    char *raw = (char *)pqResultAlloc(res, sizeof(int) + rawLen + 1, TRUE);
+    memcpy(raw, &rawLen, sizeof(int));
+    memcpy(raw + sizeof(int), fields.data(), rawLen);
+    return raw;
+}
+
+static PGresult *makeLazyResult() {
+    PGresAttDesc attrs[3];
+    memset(attrs, 0, sizeof(attrs));
+    attrs[0].name = (char *)"a";
+    attrs[1].name = (char *)"b";
+    attrs[2].name = (char *)"c";
+
+    PGresult *res = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+    EXPECT_TRUE(PQsetResultAttrs(res, 3, attrs));
+    res->lazyDecode = TRUE;
+    return res;
+}
+
+// Fields of raw rows read back terminated, with NULL and empty values, in any order.
+TEST(PqLazyRowTest, RawRowsDecodeOnAccess) {
+    PGresult *res = makeLazyResult();
+
+    for (int row = 0; row < 300; row++) {
+        std::string a = "value-" + std::to_string(row);
+        ASSERT_TRUE(pqAddRawTuple(res, makeRawRow(res, {a.c_str(), NULL_VALUE, ""})));
+    }
+    ASSERT_EQ(PQntuples(res), 300);
+    EXPECT_EQ(res->tuples[299], nullptr);
+
+    EXPECT_STREQ(PQgetvalue(res, 299, 0), "value-299");
+    EXPECT_NE(res->tuples[299], nullptr);
+    EXPECT_EQ(res->tuples[298], nullptr);
+
+    for (int row = 0; row < 300; row++) {
+        std::string a = "value-" + std::to_string(row);
+        EXPECT_STREQ(PQgetvalue(res, row, 0), a.c_str());
+        EXPECT_EQ(PQgetlength(res, row, 0), (int)a.size());
+        EXPECT_TRUE(PQgetisnull(res, row, 1));
+        EXPECT_FALSE(PQgetisnull(res, row, 2));
+        EXPECT_STREQ(PQgetvalue(res, row, 2), "");
+    }
+
+    PQclear(res);
+}
+
+// Copies and new values of a lazy result see the decoded fields.
+TEST(PqLazyRowTest, CopyAndSetValue) {
+    PGresult *res = makeLazyResult();
+
+    ASSERT_TRUE(pqAddRawTuple(res, makeRawRow(res, {"x", "yy", NULL_VALUE})));
+    ASSERT_TRUE(PQsetvalue(res, 0, 1, "zzz", 3));
+    ASSERT_TRUE(PQsetvalue(res, 1, 0, "new", 3));
+
+    PGresult *copy = PQcopyResult(res, PG_COPYRES_ATTRS | PG_COPYRES_TUPLES);
+    ASSERT_NE(copy, nullptr);
+    EXPECT_EQ(PQntuples(copy), 2);
+    EXPECT_STREQ(PQgetvalue(copy, 0, 0), "x");
+    EXPECT_STREQ(PQgetvalue(copy, 0, 1), "zzz");
+    EXPECT_TRUE(PQgetisnull(copy, 0, 2));
+    EXPECT_STREQ(PQgetvalue(copy, 1, 0), "new");
+
+    PQclear(copy);
+    PQclear(res);
+}
+
+// Row with a field length past its end isn't decoded.
+TEST(PqLazyRowTest, MalformedRowIsNull) {
+    PGresult *res = makeLazyResult();
+    char *raw = makeRawRow(res, {"abc", "d", "e"});
+    int rawLen = 0;
+
+    memcpy(&rawLen, raw, sizeof(int));
+    rawLen -= 2;
+    memcpy(raw, &rawLen, sizeof(int));
+    ASSERT_TRUE(pqAddRawTuple(res, raw));
+
+    EXPECT_EQ(PQgetvalue(res, 0, 0), nullptr);
+    EXPECT_TRUE(PQgetisnull(res, 0, 0));
+    EXPECT_EQ(PQgetlength(res, 0, 2), 0);
+
+    PQclear(res);
+}
@@ -0,0 +1,46 @@
+#include "common.h"
+#include "libpq-fe.h"
+extern "C" {
+#include "libpq-int.h"
+}
+#include <string>
+
+class PqPendingCloseTest : public ::testing::Test {
+  protected:
+    PGconn *conn = nullptr;
+
+    void SetUp() override {
+        conn = (PGconn *)calloc(1, sizeof(PGconn));
+        initPQExpBuffer(&conn->errorMessage);
+        conn->status = CONNECTION_OK;
+        conn->asyncStatus = PGASYNC_BUSY;
+    }
+
+    void TearDown() override {
+        pqClearPendingCloses(conn);
+        termPQExpBuffer(&conn->errorMessage);
+        free(conn);
+    }
+};
+
+// Closes wait for the next request while one is in progress, past the cap too.
+TEST_F(PqPendingCloseTest, QueueWhileBusy) {
+    for (int i = 0; i < 100; i++) {
+        std::string name = "stmt_" + std::to_string(i);
+        ASSERT_EQ(pqQueueClosePrepared(conn, name.c_str()), 1);
+    }
+    ASSERT_EQ(conn->nPendingCloses, 100);
+    EXPECT_STREQ(conn->pendingCloses[0], "stmt_0");
+    EXPECT_STREQ(conn->pendingCloses[99], "stmt_99");
+
+    pqClearPendingCloses(conn);
+    EXPECT_EQ(conn->nPendingCloses, 0);
+    EXPECT_EQ(conn->pendingCloses, nullptr);
+}
+
+// Statement without a name isn't queued.
+TEST_F(PqPendingCloseTest, NullNameFails) {
+    EXPECT_EQ(pqQueueClosePrepared(conn, NULL), 0);
+    EXPECT_EQ(conn->nPendingCloses, 0);
+    EXPECT_EQ(pqClosePendingPrepared(conn), 1);
+}
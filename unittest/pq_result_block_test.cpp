@@ -0,0 +1,103 @@
+#include "common.h"
+#include "libpq-fe.h"
+extern "C" {
+#include "libpq-int.h"
+}
+#include <algorithm>
+#include <set>
+
+// Result taking its blocks from the pool, like the results of a connection.
+static PGresult *makeResult(PGblockPool *pool) {
+    PGresult *res = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+    res->blockPool = pqAddRefBlockPool(pool);
+    return res;
+}
+
+static void fill(PGresult *res, int values) {
+    for (int i = 0; i < values; i++)
+        ASSERT_NE(pqResultAlloc(res, 100, FALSE), nullptr);
+}
+
+// Standard blocks double in size up to 64 KB.
+TEST(PqResultBlockTest, BlocksGrow) {
+    PGresult *res = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+    fill(res, 10000);
+
+    size_t maxSize = 0;
+    int blocks = 0;
+    for (PGresult_data *block = res->curBlock; block != NULL; block = block->hdr.next) {
+        maxSize = std::max(maxSize, block->hdr.size);
+        blocks++;
+    }
+    EXPECT_EQ(maxSize, 65536u);
+    EXPECT_LT(blocks, 30);
+
+    // Big object still gets its own block.
+    ASSERT_NE(pqResultAlloc(res, 100000, TRUE), nullptr);
+    EXPECT_GT(res->curBlock->hdr.next->hdr.size, 100000u);
+
+    PQclear(res);
+}
+
+// Blocks of a cleared result are used by the next result of the connection.
+TEST(PqResultBlockTest, PoolReusesBlocks) {
+    PGblockPool *pool = pqCreateBlockPool();
+    ASSERT_NE(pool, nullptr);
+
+    PGresult *res = makeResult(pool);
+    fill(res, 100);
+    PQclear(res);
+
+    long long hits = 0, misses = 0, bytes = 0;
+    pqGetBlockPoolStats(pool, &hits, &misses, &bytes);
+    EXPECT_EQ(hits, 0);
+    EXPECT_GT(misses, 0);
+    EXPECT_GT(bytes, 0);
+
+    res = makeResult(pool);
+    fill(res, 100);
+    long long hitsAfter = 0, bytesAfter = 0;
+    pqGetBlockPoolStats(pool, &hitsAfter, NULL, &bytesAfter);
+    EXPECT_EQ(hitsAfter, misses);
+    EXPECT_EQ(bytesAfter, 0);
+
+    // Result outlives the connection's reference.
+    pool = pqReleaseBlockPool(pool);
+    PQclear(res);
+}
+
+// Released blocks of the current size stay with the result, for the next batch.
+TEST(PqResultBlockTest, ReleasedBlocksRefill) {
+    PGblockPool *pool = pqCreateBlockPool();
+    PGresult *res = makeResult(pool);
+    fill(res, 5000);
+
+    std::set<PGresult_data *> batch;
+    PGresult_data *block;
+    for (block = res->curBlock; block != NULL; block = block->hdr.next)
+        if (block->hdr.size == (size_t)res->blockSize)
+            batch.insert(block);
+    ASSERT_FALSE(batch.empty());
+
+    // Clear the batch, the way the streaming cursor does.
+    while ((block = res->curBlock) != NULL) {
+        res->curBlock = block->hdr.next;
+        pqResultReleaseBlock(res, block);
+    }
+    res->curOffset = 0;
+    res->spaceLeft = 0;
+
+    long long misses = 0;
+    pqGetBlockPoolStats(pool, NULL, &misses, NULL);
+
+    fill(res, 2000);
+    for (block = res->curBlock; block != NULL; block = block->hdr.next)
+        EXPECT_TRUE(batch.count(block) == 1);
+
+    long long missesAfter = 0;
+    pqGetBlockPoolStats(pool, NULL, &missesAfter, NULL);
+    EXPECT_EQ(missesAfter, misses);
+
+    PQclear(res);
+    pqReleaseBlockPool(pool);
+}
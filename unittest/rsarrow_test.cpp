@@ -0,0 +1,168 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rsarrow.h"
+#include <string>
+
+#define RSARROW_TEST_SUITE RSArrowTest
+
+class RSARROW_TEST_SUITE : public ::testing::Test {
+  protected:
+    RS_CONN_INFO conn{nullptr};
+    RS_STMT_INFO *pStmt = nullptr;
+    PGresult *pgResult = nullptr;
+    RS_DESC_REC descRecs[3];
+
+    void SetUp() override {
+        conn.pConnAttr = new RS_CONN_ATTR_INFO();
+        conn.pConnectProps = new RS_CONNECT_PROPS_INFO();
+        pStmt = new RS_STMT_INFO(&conn);
+        pStmt->pIRD = new RS_DESC_INFO(&conn, RS_IRD, SQL_DESC_ALLOC_AUTO);
+        pStmt->pStmtAttr = new RS_STMT_ATTR_INFO(&conn, pStmt);
+
+        // id INT4, name VARCHAR, amount NUMERIC(10,2). All text format.
+        PGresAttDesc attrs[3];
+        memset(attrs, 0, sizeof(attrs));
+        attrs[0].name = (char *)"id";
+        attrs[0].typid = INT4OID;
+        attrs[1].name = (char *)"name";
+        attrs[1].typid = VARCHAROID;
+        attrs[2].name = (char *)"amount";
+        attrs[2].typid = NUMERICOID;
+
+        pgResult = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+        ASSERT_TRUE(PQsetResultAttrs(pgResult, 3, attrs));
+        setRow(0, "1", "a", "1.50");
+        setRow(1, NULL, "bc", "-2.25");
+        setRow(2, "3", NULL, NULL);
+
+        for (int i = 0; i < 3; i++) {
+            descRecs[i] = RS_DESC_REC();
+            strcpy(descRecs[i].szName, attrs[i].name);
+            descRecs[i].hNullable = SQL_NULLABLE;
+        }
+        descRecs[2].iPrecision = 10;
+        descRecs[2].hScale = 2;
+        pStmt->pIRD->pDescRecHead = descRecs;
+
+        RS_RESULT_INFO *pResult = new RS_RESULT_INFO(pStmt, pgResult);
+        pResult->iNumberOfCols = 3;
+        pResult->iNumberOfRowsInMem = 3;
+        pStmt->pResultHead = pResult;
+    }
+
+    void TearDown() override {
+        delete pStmt->pResultHead;
+        PQclear(pgResult);
+        pStmt->pIRD->pDescRecHead = nullptr;
+        delete pStmt->pIRD;
+        delete pStmt->pStmtAttr;
+        delete pStmt;
+        delete conn.pConnectProps;
+        delete conn.pConnAttr;
+    }
+
+    void setRow(int row, const char *id, const char *name, const char *amount) {
+        const char *vals[3] = {id, name, amount};
+        for (int col = 0; col < 3; col++) {
+            PQsetvalue(pgResult, row, col, (char *)vals[col],
+                       vals[col] ? (int)strlen(vals[col]) : -1);
+        }
+    }
+
+    static bool isValid(const struct ArrowArray *pArray, int i) {
+        const unsigned char *pValidity = (const unsigned char *)pArray->buffers[0];
+        return (pValidity[i >> 3] >> (i & 7)) & 1;
+    }
+};
+
+TEST_F(RSARROW_TEST_SUITE, InvalidArguments) {
+    struct ArrowArrayStream stream;
+
+    EXPECT_EQ(RsGetArrowArrayStream(SQL_NULL_HSTMT, &stream), SQL_INVALID_HANDLE);
+
+    EXPECT_EQ(RsGetArrowArrayStream(pStmt, nullptr), SQL_ERROR);
+    ASSERT_NE(pStmt->pErrorList, nullptr);
+    EXPECT_STREQ(pStmt->pErrorList->szSqlState, "HY009");
+
+    RS_STMT_INFO noResult(nullptr);
+    EXPECT_EQ(RsGetArrowArrayStream(&noResult, &stream), SQL_ERROR);
+    ASSERT_NE(noResult.pErrorList, nullptr);
+    EXPECT_STREQ(noResult.pErrorList->szSqlState, "24000");
+}
+
+TEST_F(RSARROW_TEST_SUITE, SchemaFollowsSqlTypeMapping) {
+    struct ArrowArrayStream stream;
+    struct ArrowSchema schema;
+
+    ASSERT_EQ(RsGetArrowArrayStream(pStmt, &stream), SQL_SUCCESS);
+    ASSERT_EQ(stream.get_schema(&stream, &schema), 0);
+
+    EXPECT_STREQ(schema.format, "+s");
+    ASSERT_EQ(schema.n_children, 3);
+    EXPECT_STREQ(schema.children[0]->format, "i");
+    EXPECT_STREQ(schema.children[0]->name, "id");
+    EXPECT_STREQ(schema.children[1]->format, "u");
+#ifdef RS_HAVE_INT128
+    EXPECT_STREQ(schema.children[2]->format, "d:10,2");
+#else
+    EXPECT_STREQ(schema.children[2]->format, "u");
+#endif
+    EXPECT_EQ(schema.children[2]->flags, ARROW_FLAG_NULLABLE);
+
+    schema.release(&schema);
+    EXPECT_EQ(schema.release, nullptr);
+    stream.release(&stream);
+}
+
+TEST_F(RSARROW_TEST_SUITE, BatchesAdvanceCursor) {
+    struct ArrowArrayStream stream;
+    struct ArrowArray batch;
+
+    pStmt->pStmtAttr->iArrowBatchRows = 2;
+    ASSERT_EQ(RsGetArrowArrayStream(pStmt, &stream), SQL_SUCCESS);
+
+    // First batch
+    ASSERT_EQ(stream.get_next(&stream, &batch), 0);
+    ASSERT_NE(batch.release, nullptr);
+    EXPECT_EQ(batch.length, 2);
+    ASSERT_EQ(batch.n_children, 3);
+
+    const struct ArrowArray *pId = batch.children[0];
+    EXPECT_EQ(pId->null_count, 1);
+    EXPECT_TRUE(isValid(pId, 0));
+    EXPECT_FALSE(isValid(pId, 1));
+    EXPECT_EQ(((const int *)pId->buffers[1])[0], 1);
+
+    const struct ArrowArray *pName = batch.children[1];
+    const int *piOffsets = (const int *)pName->buffers[1];
+    const char *pData = (const char *)pName->buffers[2];
+    EXPECT_EQ(std::string(pData + piOffsets[0], piOffsets[1] - piOffsets[0]), "a");
+    EXPECT_EQ(std::string(pData + piOffsets[1], piOffsets[2] - piOffsets[1]), "bc");
+
+#ifdef RS_HAVE_INT128
+    const struct ArrowArray *pAmount = batch.children[2];
+    __int128 amount[2];
+    memcpy(amount, pAmount->buffers[1], sizeof(amount));
+    EXPECT_TRUE(amount[0] == 150);
+    EXPECT_TRUE(amount[1] == -225);
+#endif
+    batch.release(&batch);
+    EXPECT_EQ(pStmt->pResultHead->iCurRow, 1);
+
+    // Second batch has the remaining row
+    ASSERT_EQ(stream.get_next(&stream, &batch), 0);
+    ASSERT_NE(batch.release, nullptr);
+    EXPECT_EQ(batch.length, 1);
+    EXPECT_EQ(((const int *)batch.children[0]->buffers[1])[0], 3);
+    EXPECT_EQ(batch.children[1]->null_count, 1);
+    EXPECT_EQ(batch.children[2]->null_count, 1);
+    batch.release(&batch);
+
+    // End of stream
+    ASSERT_EQ(stream.get_next(&stream, &batch), 0);
+    EXPECT_EQ(batch.release, nullptr);
+    EXPECT_EQ(stream.get_last_error(&stream), nullptr);
+
+    stream.release(&stream);
+    EXPECT_EQ(stream.release, nullptr);
+}
@@ -0,0 +1,97 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rscancel.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Cancel blocked until released, counting its calls.
+struct BlockedCancel {
+    std::mutex lock;
+    std::condition_variable cv;
+    bool bRelease = false;
+    std::atomic<int> iCalls{0};
+
+    std::function<int(char *, int, int)> get() {
+        return [this](char *, int, int) {
+            iCalls++;
+            std::unique_lock<std::mutex> guard(lock);
+            cv.wait(guard, [this]() { return bRelease; });
+            return TRUE;
+        };
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            bRelease = true;
+        }
+        cv.notify_all();
+    }
+};
+
+// Cancel of the same backend while one is pending isn't sent again.
+TEST(RsCancelSenderTest, CoalescePending) {
+    RS_CANCEL_SENDER sender(2, 5);
+    BlockedCancel cancel;
+    int conn;
+
+    ASSERT_TRUE(sender.send(&conn, 100, cancel.get()));
+    ASSERT_TRUE(sender.send(&conn, 100, cancel.get()));
+    cancel.release();
+    sender.wait(&conn);
+
+    long long llSent, llCoalesced, llFailed;
+    sender.getStats(&llSent, &llCoalesced, &llFailed);
+    EXPECT_EQ(cancel.iCalls.load(), 1);
+    EXPECT_EQ(llSent, 1);
+    EXPECT_EQ(llCoalesced, 1);
+    EXPECT_EQ(llFailed, 0);
+
+    // Sent again once the pending one is done
+    ASSERT_TRUE(sender.send(&conn, 100, cancel.get()));
+    sender.wait(&conn);
+    EXPECT_EQ(cancel.iCalls.load(), 2);
+}
+
+// Wait is for the cancels of the connection only.
+TEST(RsCancelSenderTest, WaitForConnection) {
+    RS_CANCEL_SENDER sender(2, 5);
+    BlockedCancel cancel;
+    int conn1, conn2;
+    std::atomic<int> iDone(0);
+
+    ASSERT_TRUE(sender.send(&conn1, 100, cancel.get()));
+    sender.wait(&conn2);
+
+    std::thread waiter([&]() {
+        sender.wait(&conn1);
+        iDone++;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(iDone.load(), 0);
+
+    cancel.release();
+    waiter.join();
+    EXPECT_EQ(iDone.load(), 1);
+}
+
+// Cancel gets the timeout, and its failure is counted.
+TEST(RsCancelSenderTest, TimeoutAndFailure) {
+    RS_CANCEL_SENDER sender(1, 7);
+    int conn;
+    int iTimeout = 0;
+
+    ASSERT_TRUE(sender.send(&conn, 100, [&iTimeout](char *errBuf, int errBufLen, int iTimeoutSeconds) {
+        iTimeout = iTimeoutSeconds;
+        snprintf(errBuf, errBufLen, "connect() failed");
+        return FALSE;
+    }));
+    sender.wait(&conn);
+
+    long long llFailed;
+    sender.getStats(NULL, NULL, &llFailed);
+    EXPECT_EQ(iTimeout, 7);
+    EXPECT_EQ(llFailed, 1);
+}
@@ -0,0 +1,91 @@
+#include "common.h"
+#include "rshex.h"
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Byte-at-a-time reference the SIMD kernels must agree with
+static std::string referenceHexEncode(const std::vector<unsigned char> &src) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : src) {
+        out.push_back(hex[c >> 4]);
+        out.push_back(hex[c & 0xF]);
+    }
+    return out;
+}
+
+static std::vector<unsigned char> makeBytes(size_t len) {
+    std::vector<unsigned char> bytes(len);
+    for (size_t i = 0; i < len; i++)
+        bytes[i] = (unsigned char)((i * 37 + 11) & 0xFF);
+    return bytes;
+}
+
+TEST(RSHEX_TEST_SUITE, KernelIsSelected) {
+    std::string name = rsHexKernelName();
+    EXPECT_TRUE(name == "avx2" || name == "sse2" || name == "scalar") << name;
+}
+
+TEST(RSHEX_TEST_SUITE, EncodeMatchesReferenceForAllTailLengths) {
+    // Cover empty input, every SIMD tail length and several full blocks
+    for (size_t len = 0; len <= 130; len++) {
+        std::vector<unsigned char> src = makeBytes(len);
+        std::string out(2 * len, '\0');
+        rsHexEncode(src.data(), len, &out[0]);
+        EXPECT_EQ(out, referenceHexEncode(src)) << "len=" << len;
+    }
+}
+
+TEST(RSHEX_TEST_SUITE, EncodeWideMatchesReference) {
+    for (size_t charSize : {2, 4}) {
+        for (size_t len = 0; len <= 70; len++) {
+            std::vector<unsigned char> src = makeBytes(len);
+            std::string expected = referenceHexEncode(src);
+            // One extra character to catch overruns
+            std::vector<unsigned char> out((2 * len + 1) * charSize, 0xEE);
+            rsHexEncodeW(src.data(), len, out.data(), charSize);
+            for (size_t i = 0; i < 2 * len; i++) {
+                uint32_t ch = 0;
+                memcpy(&ch, &out[i * charSize], charSize);
+                ASSERT_EQ(ch, (uint32_t)expected[i])
+                    << "charSize=" << charSize << " len=" << len << " i=" << i;
+            }
+            EXPECT_EQ(out[2 * len * charSize], 0xEE);
+        }
+    }
+}
+
+TEST(RSHEX_TEST_SUITE, DecodeRoundTripsMixedCase) {
+    for (size_t len = 0; len <= 130; len++) {
+        std::vector<unsigned char> src = makeBytes(len);
+        std::string hex = referenceHexEncode(src);
+        // Lower case every other letter
+        for (size_t i = 0; i < hex.size(); i += 2)
+            hex[i] = (char)tolower(hex[i]);
+        std::vector<unsigned char> out(len + 1, 0xEE);
+        rsHexDecode(hex.data(), len, out.data());
+        EXPECT_TRUE(std::equal(src.begin(), src.end(), out.begin())) << "len=" << len;
+        EXPECT_EQ(out[len], 0xEE);
+    }
+}
+
+TEST(RSHEX_TEST_SUITE, DecodeInvalidCharactersAsZero) {
+    // 64 characters so the SIMD path is used
+    std::string hex = "G0@1`2/3:4zZ\x80" "5"
+                      "0123456789ABCDEF0123456789abcdef0123456789ABCDEF01";
+    ASSERT_EQ(hex.size(), 64u);
+    std::vector<unsigned char> out(32);
+    rsHexDecode(hex.data(), out.size(), out.data());
+    EXPECT_EQ(out[0], 0x00);
+    EXPECT_EQ(out[1], 0x01);
+    EXPECT_EQ(out[2], 0x02);
+    EXPECT_EQ(out[3], 0x03);
+    EXPECT_EQ(out[4], 0x04);
+    EXPECT_EQ(out[5], 0x00);
+    EXPECT_EQ(out[6], 0x05);
+    EXPECT_EQ(out[7], 0x01);
+    EXPECT_EQ(out[30], 0xEF);
+    EXPECT_EQ(out[31], 0x01);
+}
@@ -0,0 +1,36 @@
+#include "common.h"
+#include "rsmem.h"
+
+// Charged bytes show up in the usage and the peak, and freed bytes come off the usage only.
+TEST(RsMemTest, ChargeTracksUsageAndPeak) {
+    long long used = rs_mem_get_used();
+
+    rs_mem_charge(4096);
+    EXPECT_EQ(rs_mem_get_used(), used + 4096);
+    EXPECT_GE(rs_mem_get_peak(), used + 4096);
+
+    rs_mem_charge(-4096);
+    EXPECT_EQ(rs_mem_get_used(), used);
+    EXPECT_GE(rs_mem_get_peak(), used + 4096);
+}
+
+// Lowest limit asked for stays, and usage over it is reported.
+TEST(RsMemTest, LimitIsLowestAskedFor) {
+    const long long limit = 1LL << 50;
+    const long long prevLimit = rs_mem_get_limit();
+
+    rs_mem_reset_limit(0);
+    rs_mem_set_limit(limit);
+    rs_mem_set_limit(limit * 2);
+    rs_mem_set_limit(0);
+    EXPECT_EQ(rs_mem_get_limit(), limit);
+    EXPECT_FALSE(rs_mem_over_limit());
+
+    rs_mem_charge(limit + 1);
+    EXPECT_TRUE(rs_mem_over_limit());
+    rs_mem_charge(-(limit + 1));
+    EXPECT_FALSE(rs_mem_over_limit());
+
+    rs_mem_reset_limit(prevLimit);
+    EXPECT_EQ(rs_mem_get_limit(), prevLimit);
+}
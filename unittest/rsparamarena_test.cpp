@@ -0,0 +1,76 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rsparamarena.h"
+#include <cstdint>
+
+// Allocations are aligned, zeroed by calloc and don't overlap.
+TEST(RsParamArenaTest, Alloc) {
+    RS_PARAM_ARENA arena;
+    char *p1 = (char *)arena.alloc(3);
+    char *p2 = (char *)arena.alloc(10);
+    int *pZeros = (int *)arena.calloc(100, sizeof(int));
+
+    ASSERT_NE(p1, nullptr);
+    ASSERT_NE(p2, nullptr);
+    ASSERT_NE(pZeros, nullptr);
+    EXPECT_EQ((uintptr_t)p2 % 8, 0u);
+    EXPECT_GE(p2 - p1, 3);
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(pZeros[i], 0);
+
+    char *pLarge = (char *)arena.alloc(RS_PARAM_ARENA_MIN_BLOCK * 3);
+    ASSERT_NE(pLarge, nullptr);
+    EXPECT_TRUE(pLarge + RS_PARAM_ARENA_MIN_BLOCK * 3 <= p1 || pLarge >= p2 + 10);
+}
+
+// After a reset the blocks are one block of the bytes used, which the same allocations fit in.
+TEST(RsParamArenaTest, ResetToHighWaterMark) {
+    RS_PARAM_ARENA arena;
+
+    for (int i = 0; i < 100; i++)
+        ASSERT_NE(arena.alloc(1000), nullptr);
+    arena.reset();
+
+    size_t cbHighWater = arena.getHighWaterMark();
+    size_t cbBlocks = arena.getBlockBytes();
+    EXPECT_GE(cbHighWater, 100u * 1000u);
+    EXPECT_EQ(cbBlocks, cbHighWater);
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 100; i++)
+            ASSERT_NE(arena.alloc(1000), nullptr);
+        arena.reset();
+        EXPECT_EQ(arena.getBlockBytes(), cbBlocks);
+    }
+}
+
+// Block much larger than the bytes used isn't kept.
+TEST(RsParamArenaTest, ReleaseIdleBlock) {
+    RS_PARAM_ARENA arena;
+
+    ASSERT_NE(arena.alloc(RS_PARAM_ARENA_MAX_IDLE_BLOCK * 2), nullptr);
+    arena.reset();
+    EXPECT_GT(arena.getBlockBytes(), (size_t)RS_PARAM_ARENA_MAX_IDLE_BLOCK);
+
+    ASSERT_NE(arena.alloc(100), nullptr);
+    arena.reset();
+    EXPECT_EQ(arena.getBlockBytes(), (size_t)RS_PARAM_ARENA_MIN_BLOCK);
+}
+
+// Parameter values longer than the array of the buffer are allocated in the arena.
+TEST(RsParamArenaTest, ParamValue) {
+    RS_PARAM_ARENA arena;
+    RS_BIND_PARAM_STR_BUF strBuf = {};
+    char value[] = "a value longer than a number";
+    SQLLEN cbInd = 10;
+
+    strBuf.pArena = &arena;
+    char *pVal = getParamVal(value, sizeof(value), &cbInd, SQL_C_CHAR, &strBuf, SQL_VARCHAR);
+
+    ASSERT_NE(pVal, nullptr);
+    EXPECT_STREQ(pVal, "a value lo");
+    EXPECT_EQ(strBuf.iAllocDataLen, 0);
+    arena.reset();
+    EXPECT_GT(arena.getHighWaterMark(), 0u);
+}
@@ -0,0 +1,128 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rspreparecache.h"
+extern "C" {
+#include "libpq-int.h"
+}
+#include <string>
+#include <vector>
+
+// Description of a prepared statement with one parameter of the type.
+static PGresult *makeDescribeParam(Oid type) {
+    PGresult *pgResult = PQmakeEmptyPGresult(NULL, PGRES_COMMAND_OK);
+    pgResult->numParameters = 1;
+    pgResult->paramDescs = (PGresParamDesc *)pqResultAlloc(pgResult, sizeof(PGresParamDesc), TRUE);
+    pgResult->paramDescs[0].typid = type;
+    return pgResult;
+}
+
+class RsPrepareCacheTest : public ::testing::Test {
+  protected:
+    PGresult *pgPrepare = nullptr;
+    PGresult *pgDescribeParam = nullptr;
+
+    void SetUp() override {
+        pgPrepare = PQmakeEmptyPGresult(NULL, PGRES_COMMAND_OK);
+        pgDescribeParam = makeDescribeParam(23);
+    }
+
+    void TearDown() override {
+        PQclear(pgPrepare);
+        PQclear(pgDescribeParam);
+    }
+
+    std::string add(RS_PREPARE_CACHE &cache, const std::string &key, std::vector<std::string> &deallocateNames) {
+        std::string name = cache.newName();
+        cache.add(key, name, pgPrepare, pgDescribeParam, NULL, deallocateNames);
+        return name;
+    }
+};
+
+// Same query with other parameter types is another statement.
+TEST_F(RsPrepareCacheTest, KeyHasParameterTypes) {
+    Oid intType[] = {23};
+    Oid textType[] = {25};
+
+    EXPECT_EQ(makePrepareCacheKey("select $1", 1, intType), makePrepareCacheKey("select $1", 1, intType));
+    EXPECT_NE(makePrepareCacheKey("select $1", 1, intType), makePrepareCacheKey("select $1", 1, textType));
+    EXPECT_NE(makePrepareCacheKey("select $1", 1, NULL), makePrepareCacheKey("select $1", 0, NULL));
+    EXPECT_NE(makePrepareCacheKey("select 1", 0, NULL), makePrepareCacheKey("select  1", 0, NULL));
+}
+
+// Found statement has the name and copies of the descriptions it was added with.
+TEST_F(RsPrepareCacheTest, FindAfterAdd) {
+    RS_PREPARE_CACHE cache(4);
+    std::vector<std::string> deallocateNames;
+    std::string key = makePrepareCacheKey("select $1", 0, NULL);
+    std::string name;
+    PGresult *pgFoundPrepare = NULL, *pgFoundParam = NULL, *pgFoundCol = NULL;
+
+    EXPECT_FALSE(cache.find(key, name, &pgFoundPrepare, &pgFoundParam, &pgFoundCol));
+
+    std::string addedName = add(cache, key, deallocateNames);
+    EXPECT_EQ(addedName.find("rs_ps_"), 0u);
+    EXPECT_FALSE(cache.release(addedName));
+
+    ASSERT_TRUE(cache.find(key, name, &pgFoundPrepare, &pgFoundParam, &pgFoundCol));
+    EXPECT_EQ(name, addedName);
+    ASSERT_NE(pgFoundParam, nullptr);
+    EXPECT_NE(pgFoundParam, pgDescribeParam);
+    EXPECT_EQ(PQnparams(pgFoundParam), 1);
+    EXPECT_EQ(PQparamtype(pgFoundParam, 0), 23u);
+    EXPECT_EQ(pgFoundCol, nullptr);
+    EXPECT_FALSE(cache.release(name));
+
+    PQclear(pgFoundPrepare);
+    PQclear(pgFoundParam);
+
+    long long hits = 0, misses = 0, evictions = 0, entries = 0;
+    cache.getStats(&hits, &misses, &evictions, &entries);
+    EXPECT_EQ(hits, 1);
+    EXPECT_EQ(misses, 1);
+    EXPECT_EQ(evictions, 0);
+    EXPECT_EQ(entries, 1);
+}
+
+// Least recently used statement is deallocated, when no statement uses it.
+TEST_F(RsPrepareCacheTest, EvictLeastRecentlyUsed) {
+    RS_PREPARE_CACHE cache(2);
+    std::vector<std::string> deallocateNames;
+    std::string name;
+    PGresult *pgFoundPrepare = NULL, *pgFoundParam = NULL, *pgFoundCol = NULL;
+
+    std::string name1 = add(cache, "q1", deallocateNames);
+    std::string name2 = add(cache, "q2", deallocateNames);
+    cache.release(name1);
+    cache.release(name2);
+
+    // q1 is used again, so q2 goes.
+    ASSERT_TRUE(cache.find("q1", name, &pgFoundPrepare, &pgFoundParam, &pgFoundCol));
+    PQclear(pgFoundPrepare);
+    PQclear(pgFoundParam);
+    cache.release(name);
+
+    std::string name3 = add(cache, "q3", deallocateNames);
+    ASSERT_EQ(deallocateNames.size(), 1u);
+    EXPECT_EQ(deallocateNames[0], name2);
+    EXPECT_FALSE(cache.find("q2", name, &pgFoundPrepare, &pgFoundParam, &pgFoundCol));
+    EXPECT_FALSE(cache.release(name3));
+}
+
+// Statement evicted while in use is deallocated by its last user.
+TEST_F(RsPrepareCacheTest, EvictInUse) {
+    RS_PREPARE_CACHE cache(1);
+    std::vector<std::string> deallocateNames;
+
+    std::string name1 = add(cache, "q1", deallocateNames);
+    std::string name2 = add(cache, "q2", deallocateNames);
+    EXPECT_TRUE(deallocateNames.empty());
+
+    EXPECT_TRUE(cache.release(name1));
+    EXPECT_FALSE(cache.release(name1));
+    EXPECT_FALSE(cache.release(name2));
+
+    long long evictions = 0, entries = 0;
+    cache.getStats(NULL, NULL, &evictions, &entries);
+    EXPECT_EQ(evictions, 1);
+    EXPECT_EQ(entries, 1);
+}
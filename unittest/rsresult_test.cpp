@@ -1,6 +1,9 @@
 #include "common.h"
 #include "rsodbc.h"
+#include "rsbatchfetch.h"
 #include <limits>
+#include <string>
+#include <vector>
 
 TEST(RSGetDataTest, PublicNullTargetValuePtrReturnsHY009) {
     RS_STMT_INFO stmt(nullptr);
@@ -16,4 +19,126 @@ TEST(RSGetDataTest, PublicNullTargetValuePtrReturnsHY009) {
     // it should return SQL_ERROR with SQLSTATE HY009 indicating invalid use of null pointer.
     EXPECT_STREQ(stmt.pErrorList->szSqlState, "HY009");
     EXPECT_EQ(indicator, 0);
-}
\ No newline at end of file
+}
+
+namespace {
+
+struct BatchCollector {
+    SQLINTEGER *pValues;
+    std::vector<int> values;
+    std::vector<SQLULEN> batchSizes;
+    int iStopAfter;
+};
+
+int SQL_API collectBatch(SQLPOINTER pContext, SQLULEN lRowsFetched) {
+    BatchCollector *pCollector = (BatchCollector *)pContext;
+
+    pCollector->batchSizes.push_back(lRowsFetched);
+    for (SQLULEN i = 0; i < lRowsFetched; i++)
+        pCollector->values.push_back(pCollector->pValues[i]);
+
+    return ((int)pCollector->batchSizes.size() == pCollector->iStopAfter)
+               ? RS_FETCH_BATCH_STOP
+               : RS_FETCH_BATCH_CONTINUE;
+}
+
+} // namespace
+
+// Five INTEGER rows bound column wise into a rowset of two rows.
+class RSFetchBatchesTest : public ::testing::Test {
+  protected:
+    RS_CONN_INFO conn{nullptr};
+    RS_STMT_INFO *pStmt = nullptr;
+    PGresult *pgResult = nullptr;
+    RS_DESC_REC irdRec;
+    RS_DESC_REC ardRec;
+    SQLINTEGER values[2];
+    SQLLEN indicators[2];
+
+    void SetUp() override {
+        conn.pConnAttr = new RS_CONN_ATTR_INFO();
+        conn.pConnectProps = new RS_CONNECT_PROPS_INFO();
+        pStmt = new RS_STMT_INFO(&conn);
+        pStmt->pIRD = new RS_DESC_INFO(&conn, RS_IRD, SQL_DESC_ALLOC_AUTO);
+        pStmt->pARD = new RS_DESC_INFO(&conn, RS_ARD, SQL_DESC_ALLOC_AUTO);
+        pStmt->pStmtAttr = new RS_STMT_ATTR_INFO(&conn, pStmt);
+
+        PGresAttDesc attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.name = (char *)"id";
+        attr.typid = INT4OID;
+        pgResult = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+        ASSERT_TRUE(PQsetResultAttrs(pgResult, 1, &attr));
+        for (int row = 0; row < 5; row++) {
+            std::string val = std::to_string((row + 1) * 10);
+            PQsetvalue(pgResult, row, 0, (char *)val.c_str(), (int)val.size());
+        }
+
+        irdRec = RS_DESC_REC();
+        irdRec.hRecNumber = 1;
+        irdRec.hType = SQL_INTEGER;
+        pStmt->pIRD->pDescRecHead = &irdRec;
+
+        ardRec = RS_DESC_REC();
+        ardRec.hRecNumber = 1;
+        ardRec.hType = SQL_C_LONG;
+        ardRec.pValue = values;
+        ardRec.cbLen = sizeof(SQLINTEGER);
+        ardRec.iOctetLen = sizeof(SQLINTEGER);
+        ardRec.pcbLenInd = indicators;
+        pStmt->pARD->pDescRecHead = &ardRec;
+        pStmt->pARD->pDescHeader.lArraySize = 2;
+
+        RS_RESULT_INFO *pResult = new RS_RESULT_INFO(pStmt, pgResult);
+        pResult->iNumberOfCols = 1;
+        pResult->iNumberOfRowsInMem = 5;
+        pStmt->pResultHead = pResult;
+    }
+
+    void TearDown() override {
+        delete pStmt->pResultHead;
+        PQclear(pgResult);
+        pStmt->pIRD->pDescRecHead = nullptr;
+        pStmt->pARD->pDescRecHead = nullptr;
+        delete pStmt->pIRD;
+        delete pStmt->pARD;
+        delete pStmt->pStmtAttr;
+        delete pStmt;
+        delete conn.pConnectProps;
+        delete conn.pConnAttr;
+    }
+};
+
+TEST_F(RSFetchBatchesTest, DeliversAllRowsets) {
+    BatchCollector collector{values, {}, {}, 0};
+    SQLULEN lTotalRows = 0;
+
+    EXPECT_EQ(RsFetchBatches(pStmt, collectBatch, &collector, &lTotalRows), SQL_SUCCESS);
+    EXPECT_EQ(lTotalRows, 5u);
+    EXPECT_EQ(collector.batchSizes, (std::vector<SQLULEN>{2, 2, 1}));
+    EXPECT_EQ(collector.values, (std::vector<int>{10, 20, 30, 40, 50}));
+
+    // Result is exhausted now
+    EXPECT_EQ(RsFetchBatches(pStmt, collectBatch, &collector, &lTotalRows), SQL_NO_DATA);
+    EXPECT_EQ(lTotalRows, 0u);
+}
+
+TEST_F(RSFetchBatchesTest, CallbackStopsAndFetchContinues) {
+    BatchCollector collector{values, {}, {}, 1};
+    SQLULEN lTotalRows = 0;
+
+    EXPECT_EQ(RsFetchBatches(pStmt, collectBatch, &collector, &lTotalRows), SQL_SUCCESS);
+    EXPECT_EQ(lTotalRows, 2u);
+    EXPECT_EQ(collector.values, (std::vector<int>{10, 20}));
+
+    // SQLFetch picks up with the next rowset
+    EXPECT_EQ(RS_STMT_INFO::RS_SQLFetchScroll(pStmt, SQL_FETCH_NEXT, 0), SQL_SUCCESS);
+    EXPECT_EQ(values[0], 30);
+    EXPECT_EQ(values[1], 40);
+}
+
+TEST_F(RSFetchBatchesTest, NullCallbackReturnsHY009) {
+    EXPECT_EQ(RsFetchBatches(pStmt, nullptr, nullptr, nullptr), SQL_ERROR);
+    ASSERT_NE(pStmt->pErrorList, nullptr);
+    EXPECT_STREQ(pStmt->pErrorList->szSqlState, "HY009");
+}
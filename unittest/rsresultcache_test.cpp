@@ -0,0 +1,171 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rsresultcache.h"
+#include <string>
+
+// One column, one row result.
+static PGresult *makeResult(const char *value) {
+    PGresAttDesc attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.name = (char *)"c";
+    attr.typid = 25; // TEXTOID
+
+    PGresult *pgResult = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+    EXPECT_TRUE(PQsetResultAttrs(pgResult, 1, &attr));
+    EXPECT_TRUE(PQsetvalue(pgResult, 0, 0, (char *)value, (int)strlen(value)));
+    return pgResult;
+}
+
+// Comments, white space and case outside of quotes don't make a different query.
+TEST(RsResultCacheTest, NormalizeKeepsQuotedText) {
+    EXPECT_EQ(normalizeSqlForResultCache("  SELECT *\n\tFROM  T -- all rows\n WHERE a = 'X  y';"),
+              "select * from t where a = 'X  y'");
+    EXPECT_EQ(normalizeSqlForResultCache("select /* hint */ \"Col A\" from t"),
+              "select \"Col A\" from t");
+    EXPECT_EQ(normalizeSqlForResultCache("SELECT $$A;  B$$, $1"), "select $$A;  B$$, $1");
+    EXPECT_EQ(normalizeSqlForResultCache("Select 1"), normalizeSqlForResultCache("select   1 ;"));
+}
+
+// Only single statement queries without writes are read only.
+TEST(RsResultCacheTest, ReadOnlyClassification) {
+    EXPECT_TRUE(isReadOnlyForResultCache(normalizeSqlForResultCache("SELECT a FROM t WHERE b = 'insert'")));
+    EXPECT_TRUE(isReadOnlyForResultCache(normalizeSqlForResultCache("WITH x AS (SELECT 1) SELECT * FROM x")));
+    EXPECT_FALSE(isReadOnlyForResultCache(normalizeSqlForResultCache("SELECT a INTO t2 FROM t")));
+    EXPECT_FALSE(isReadOnlyForResultCache(normalizeSqlForResultCache("SELECT 1; DELETE FROM t")));
+    EXPECT_FALSE(isReadOnlyForResultCache(normalizeSqlForResultCache("UPDATE t SET a = 1")));
+    EXPECT_TRUE(isSessionCommandForResultCache(normalizeSqlForResultCache("SET search_path TO s1")));
+    EXPECT_FALSE(isSessionCommandForResultCache(normalizeSqlForResultCache("SELECT 1")));
+}
+
+// Only queries calling known deterministic built in functions are deterministic.
+TEST(RsResultCacheTest, DeterministicClassification) {
+    auto isDeterministic = [](const char *pszSql) {
+        return isDeterministicForResultCache(normalizeSqlForResultCache(pszSql));
+    };
+
+    EXPECT_TRUE(isDeterministic("SELECT count(*), upper(a) FROM t WHERE b IN (SELECT c FROM u) GROUP BY a"));
+    EXPECT_TRUE(isDeterministic("SELECT CAST(a AS NUMERIC(10, 2)), coalesce(b, 'random()') FROM t"));
+    EXPECT_TRUE(isDeterministic("WITH x AS (SELECT 1) SELECT row_number() OVER (ORDER BY a) FROM x"));
+    EXPECT_FALSE(isDeterministic("SELECT getdate()"));
+    EXPECT_FALSE(isDeterministic("SELECT random() FROM t"));
+    EXPECT_FALSE(isDeterministic("SELECT a FROM t WHERE d < current_timestamp"));
+    EXPECT_FALSE(isDeterministic("SELECT my_udf(a) FROM t"));
+    EXPECT_FALSE(isDeterministic("SELECT s.upper(a) FROM t"));
+    EXPECT_FALSE(isDeterministic("SELECT a FROM #t"));
+}
+
+// Commands, which may create temporary objects of the session.
+TEST(RsResultCacheTest, SessionObjectCommands) {
+    auto isSessionObject = [](const char *pszSql) {
+        return isSessionObjectCommandForResultCache(normalizeSqlForResultCache(pszSql));
+    };
+
+    EXPECT_TRUE(isSessionObject("CREATE TEMP TABLE t (a int)"));
+    EXPECT_TRUE(isSessionObject("create temporary table t as select 1"));
+    EXPECT_TRUE(isSessionObject("CREATE TABLE #t (a int)"));
+    EXPECT_TRUE(isSessionObject("SELECT a INTO #t FROM u"));
+    EXPECT_TRUE(isSessionObject("CALL make_tables()"));
+    EXPECT_FALSE(isSessionObject("CREATE TABLE t (a int)"));
+    EXPECT_FALSE(isSessionObject("INSERT INTO t SELECT a FROM u"));
+    EXPECT_FALSE(isSessionObject("SELECT 'create temp' FROM t"));
+}
+
+// Only the last SET of each setting is in the session, RESET removes it.
+TEST(RsResultCacheTest, SessionKeepsLastSetOfSetting) {
+    std::map<std::string, std::string> session;
+    auto update = [&session](const char *pszSql) {
+        updateSessionForResultCache(session, normalizeSqlForResultCache(pszSql));
+    };
+
+    for (int i = 0; i < 100; i++)
+        update(i % 2 ? "SET search_path TO s1" : "SET search_path TO s2");
+    update("SET SESSION datestyle TO 'ISO'");
+    update("SET LOCAL timezone TO 'UTC'");
+    EXPECT_EQ(session.size(), 2u);
+    EXPECT_EQ(getSessionForResultCache(session),
+              "set session datestyle to 'ISO';set search_path to s1;");
+
+    update("RESET search_path");
+    EXPECT_EQ(getSessionForResultCache(session), "set session datestyle to 'ISO';");
+    update("RESET ALL");
+    EXPECT_TRUE(session.empty());
+}
+
+// NULL parameter is different from any value, and values can't run into each other.
+TEST(RsResultCacheTest, KeyHasParameterValues) {
+    const char *nullParam[] = {NULL};
+    const char *emptyParam[] = {""};
+    const char *twoParams[] = {"a", "b"};
+    const char *joinedParams[] = {"a\x1f" "V1:b"};
+
+    EXPECT_NE(makeResultCacheKey("h", "u", "", "select $1", 1, nullParam),
+              makeResultCacheKey("h", "u", "", "select $1", 1, emptyParam));
+    EXPECT_NE(makeResultCacheKey("h", "u", "", "select $1", 2, twoParams),
+              makeResultCacheKey("h", "u", "", "select $1", 1, joinedParams));
+    EXPECT_NE(makeResultCacheKey("h", "u1", "", "select 1", 0, NULL),
+              makeResultCacheKey("h", "u2", "", "select 1", 0, NULL));
+}
+
+// Results are found until they expire or are invalidated.
+TEST(RsResultCacheTest, FindAddInvalidate) {
+    std::string key = makeResultCacheKey("server1", "u", "", "select 1", 0, NULL);
+    PGresult *pgResult = makeResult("one");
+
+    invalidateResultCache("", "");
+    EXPECT_EQ(findResultCache(key, 60), nullptr);
+
+    addResultCache(key, "server1", "select 1", pgResult, 1024 * 1024);
+    PQclear(pgResult);
+
+    PGresult *pCopy = findResultCache(key, 60);
+    ASSERT_NE(pCopy, nullptr);
+    EXPECT_EQ(PQntuples(pCopy), 1);
+    EXPECT_STREQ(PQgetvalue(pCopy, 0, 0), "one");
+    PQclear(pCopy);
+
+    // Expired
+    EXPECT_EQ(findResultCache(key, 0), nullptr);
+    EXPECT_EQ(findResultCache(key, 60), nullptr);
+
+    pgResult = makeResult("one");
+    addResultCache(key, "server1", "select 1", pgResult, 1024 * 1024);
+    PQclear(pgResult);
+    invalidateResultCache("server2", "");
+    pCopy = findResultCache(key, 60);
+    ASSERT_NE(pCopy, nullptr);
+    PQclear(pCopy);
+
+    invalidateResultCache("server1", "select 1");
+    EXPECT_EQ(findResultCache(key, 60), nullptr);
+
+    long long llEntries = -1;
+    long long llUsed = -1;
+    getResultCacheStats(NULL, NULL, &llUsed, &llEntries);
+    EXPECT_EQ(llEntries, 0);
+    EXPECT_EQ(llUsed, 0);
+}
+
+// Lowest budget asked by a connection stays.
+TEST(RsResultCacheTest, LowestBudget) {
+    std::string key1 = makeResultCacheKey("server1", "u", "", "select 1", 0, NULL);
+    std::string key2 = makeResultCacheKey("server1", "u", "", "select 2", 0, NULL);
+    PGresult *pgResult = makeResult("one");
+    PGresult *pCopy;
+
+    invalidateResultCache("", "");
+    addResultCache(key1, "server1", "select 1", pgResult, 1024 * 1024);
+    pCopy = findResultCache(key1, 60);
+    ASSERT_NE(pCopy, nullptr);
+    PQclear(pCopy);
+
+    // Budget smaller than the result removes it
+    addResultCache(key2, "server1", "select 2", pgResult, 16);
+    EXPECT_EQ(findResultCache(key1, 60), nullptr);
+    EXPECT_EQ(findResultCache(key2, 60), nullptr);
+
+    // Larger budget doesn't raise it
+    addResultCache(key1, "server1", "select 1", pgResult, 1024 * 1024);
+    EXPECT_EQ(findResultCache(key1, 60), nullptr);
+
+    PQclear(pgResult);
+}
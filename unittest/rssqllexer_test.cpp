@@ -0,0 +1,62 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rssqllexer.h"
+#include <string>
+
+static RS_SQL_LEX lex(const std::string &sql) {
+    RS_SQL_LEX lex;
+    lexSql(sql.c_str(), sql.size(), lex, RS_SQL_LEX_ALL_TOKENS);
+    return lex;
+}
+
+// Markers and braces in quotes and comments aren't counted.
+TEST(RsSqlLexerTest, QuotesAndComments) {
+    EXPECT_EQ(lex("select ? from t where a = ? and b = '?{' and \"?\" = ?").iParamMarkers, 3);
+    EXPECT_EQ(lex("select ? -- ? {\n, ? /* ? /* nested ? */ ? */ , ?").iParamMarkers, 3);
+    EXPECT_EQ(lex("select 'it''s ?', 'it\\'s ?', 'a\\\\', ?").iParamMarkers, 1);
+    EXPECT_EQ(lex("select {fn ucase(?)}, '{'").iEscapeClauses, 1);
+    EXPECT_EQ(lex("select 'unterminated ?").iParamMarkers, 0);
+    EXPECT_EQ(lex("select /* unterminated ?").iParamMarkers, 0);
+}
+
+// Tokens are spans of the text, without whitespace and comments.
+TEST(RsSqlLexerTest, Tokens) {
+    std::string sql = "insert into t(a, \"b c\") /* x */ values (?, 'x y');";
+    RS_SQL_LEX l = lex(sql);
+    int types[] = {RS_SQL_TOKEN_WORD, RS_SQL_TOKEN_WORD, RS_SQL_TOKEN_WORD, RS_SQL_TOKEN_LEFT_PAREN,
+                   RS_SQL_TOKEN_WORD, RS_SQL_TOKEN_COMMA, RS_SQL_TOKEN_QUOTED_IDENT, RS_SQL_TOKEN_RIGHT_PAREN,
+                   RS_SQL_TOKEN_WORD, RS_SQL_TOKEN_LEFT_PAREN, RS_SQL_TOKEN_PARAM_MARKER, RS_SQL_TOKEN_COMMA,
+                   RS_SQL_TOKEN_STRING, RS_SQL_TOKEN_RIGHT_PAREN, RS_SQL_TOKEN_SEMI_COLON};
+
+    ASSERT_EQ(l.tokens.size(), sizeof(types) / sizeof(types[0]));
+    for (size_t i = 0; i < l.tokens.size(); i++)
+        EXPECT_EQ(l.tokens[i].iType, types[i]) << i;
+
+    EXPECT_EQ(sql.substr(l.tokens[6].iOffset, l.tokens[6].iLen), "\"b c\"");
+    EXPECT_EQ(sql.substr(l.tokens[12].iOffset, l.tokens[12].iLen), "'x y'");
+    EXPECT_TRUE(isSqlWord(l, 8, sql.c_str(), "VALUES"));
+    EXPECT_EQ(findSqlWord(l, sql.c_str(), "values"), 8);
+    EXPECT_EQ(findSqlMatchingParen(l, 9), 13);
+
+    RS_SQL_LEX first;
+    lexSql(sql.c_str(), sql.size(), first, 1);
+    ASSERT_EQ(first.tokens.size(), 1u);
+    EXPECT_TRUE(isSqlWord(first, 0, sql.c_str(), "INSERT"));
+}
+
+// Words in brackets, quotes or comments aren't found, and brackets match by depth.
+TEST(RsSqlLexerTest, FindWordAndParen) {
+    std::string sql = "insert into t select * from (values (1)) v where c = 'values' -- values";
+    RS_SQL_LEX l = lex(sql);
+
+    EXPECT_EQ(findSqlWord(l, sql.c_str(), "values"), -1);
+
+    sql = "insert into t values (?, f(?, (?)))";
+    l = lex(sql);
+    int values = findSqlWord(l, sql.c_str(), "VALUES");
+    ASSERT_EQ(values, 3);
+    int right = findSqlMatchingParen(l, values + 1);
+    ASSERT_GT(right, 0);
+    EXPECT_EQ((size_t)l.tokens[right].iOffset, sql.size() - 1);
+    EXPECT_EQ(findSqlMatchingParen(l, values), -1);
+}
@@ -0,0 +1,74 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rssqlrewritecache.h"
+#include <string>
+
+static std::shared_ptr<const RS_SQL_REWRITE> makeRewrite(const std::string &sql, int paramMarkers) {
+    std::shared_ptr<RS_SQL_REWRITE> rewrite = std::make_shared<RS_SQL_REWRITE>();
+    rewrite->sql = sql;
+    rewrite->iUnchanged = FALSE;
+    rewrite->iParamMarkers = paramMarkers;
+    rewrite->iFunctionCall = FALSE;
+    rewrite->iMultiInsert = 0;
+    return rewrite;
+}
+
+// Options the processing depends on make another key.
+TEST(RsSqlRewriteCacheTest, KeyHasOptions) {
+    const char *sql = "select ? from t";
+
+    EXPECT_EQ(makeSqlRewriteKey(sql, strlen(sql), TRUE, FALSE), makeSqlRewriteKey(sql, strlen(sql), TRUE, FALSE));
+    EXPECT_NE(makeSqlRewriteKey(sql, strlen(sql), TRUE, FALSE), makeSqlRewriteKey(sql, strlen(sql), FALSE, FALSE));
+    EXPECT_NE(makeSqlRewriteKey(sql, strlen(sql), TRUE, FALSE), makeSqlRewriteKey(sql, strlen(sql), TRUE, TRUE));
+    EXPECT_NE(makeSqlRewriteKey(sql, 8, TRUE, FALSE), makeSqlRewriteKey(sql, strlen(sql), TRUE, FALSE));
+    EXPECT_NE(makeMultiInsertKey(sql, strlen(sql), 10), makeMultiInsertKey(sql, strlen(sql), 100));
+    EXPECT_NE(makeMultiInsertKey(sql, strlen(sql), 1), makeSqlRewriteKey(sql, strlen(sql), TRUE, FALSE));
+}
+
+// Found rewrite is the one added, until evicted by newer entries.
+TEST(RsSqlRewriteCacheTest, FindAddEvict) {
+    RS_SQL_REWRITE_CACHE cache(2, RS_SQL_REWRITE_CACHE_MAX_BYTES);
+
+    EXPECT_EQ(cache.find("q1"), nullptr);
+    cache.add("q1", makeRewrite("select $1", 1));
+    cache.add("q2", makeRewrite("select $1, $2", 2));
+
+    std::shared_ptr<const RS_SQL_REWRITE> rewrite = cache.find("q1");
+    ASSERT_NE(rewrite, nullptr);
+    EXPECT_EQ(rewrite->sql, "select $1");
+    EXPECT_EQ(rewrite->iParamMarkers, 1);
+
+    // q1 is used again, so q2 goes.
+    cache.add("q3", makeRewrite("select 3", 0));
+    EXPECT_EQ(cache.find("q2"), nullptr);
+    EXPECT_NE(cache.find("q3"), nullptr);
+
+    // Evicted entry stays valid for its user.
+    cache.add("q4", makeRewrite("select 4", 0));
+    cache.add("q5", makeRewrite("select 5", 0));
+    EXPECT_EQ(cache.find("q1"), nullptr);
+    EXPECT_EQ(rewrite->sql, "select $1");
+
+    long long hits = 0, misses = 0, evictions = 0;
+    cache.getStats(&hits, &misses, &evictions, NULL);
+    EXPECT_EQ(hits, 2);
+    EXPECT_EQ(misses, 3);
+    EXPECT_EQ(evictions, 3);
+}
+
+// Bytes of the cache stay under the limit, and big SQL isn't kept.
+TEST(RsSqlRewriteCacheTest, ByteLimit) {
+    RS_SQL_REWRITE_CACHE cache(1000, 40000);
+
+    cache.add("big", makeRewrite(std::string(20000, 'x'), 0));
+    EXPECT_EQ(cache.find("big"), nullptr);
+
+    for (int i = 0; i < 10; i++)
+        cache.add("q" + std::to_string(i), makeRewrite(std::string(9000, 'y'), 0));
+
+    long long bytes = 0;
+    cache.getStats(NULL, NULL, NULL, &bytes);
+    EXPECT_LE(bytes, 40000);
+    EXPECT_NE(cache.find("q9"), nullptr);
+    EXPECT_EQ(cache.find("q0"), nullptr);
+}
@@ -3326,3 +3326,166 @@ INSTANTIATE_TEST_SUITE_P(
     [](const ::testing::TestParamInfo<DefaultCTypeParam> &info) {
         return std::string(info.param.name);
     });
+
+// --- NUMERIC/DECIMAL scaled integer conversions ---
+
+static std::string numericRoundTrip(const char *input, SQL_NUMERIC_STRUCT *pnVal) {
+    char inBuf[128];
+    char outBuf[128];
+    snprintf(inBuf, sizeof(inBuf), "%s", input);
+    convertNumericStringToScaledInteger(inBuf, pnVal);
+    convertScaledIntegerToNumericString(pnVal, outBuf, sizeof(outBuf));
+    return outBuf;
+}
+
+TEST(NUMERIC_CONVERSION_SUITE, RoundTripDecimal38_10) {
+    SQL_NUMERIC_STRUCT nVal;
+    EXPECT_EQ(numericRoundTrip("1234567890123456789012345678.0123456789", &nVal),
+              "1234567890123456789012345678.0123456789");
+    EXPECT_EQ(nVal.precision, 38);
+    EXPECT_EQ(nVal.scale, 10);
+    EXPECT_EQ(nVal.sign, 1);
+
+    EXPECT_EQ(numericRoundTrip("-0.0000000001", &nVal), "-0.0000000001");
+    EXPECT_EQ(nVal.sign, 0);
+    EXPECT_EQ(numericRoundTrip("-99999999999999999999999999999999999999", &nVal),
+              "-99999999999999999999999999999999999999");
+}
+
+TEST(NUMERIC_CONVERSION_SUITE, SmallPrecisionKeepsAllDigits) {
+    SQL_NUMERIC_STRUCT nVal;
+    // 18 digits used to round trip through a double
+    EXPECT_EQ(numericRoundTrip("123456789012345.678", &nVal), "123456789012345.678");
+    EXPECT_EQ(numericRoundTrip("0", &nVal), "0");
+    EXPECT_EQ(numericRoundTrip("+12.50", &nVal), "12.50");
+}
+
+TEST(NUMERIC_CONVERSION_SUITE, ExcessFractionDigitsAreRounded) {
+    SQL_NUMERIC_STRUCT nVal;
+    EXPECT_EQ(numericRoundTrip("1.99999999999999999999999999999999999999999", &nVal),
+              "2.0000000000000000000000000000000000000");
+    EXPECT_EQ(nVal.precision, 38);
+    EXPECT_EQ(nVal.scale, 37);
+}
+
+TEST(NUMERIC_CONVERSION_SUITE, OutputIsTruncatedToBuffer) {
+    SQL_NUMERIC_STRUCT nVal;
+    char inBuf[] = "-12345.678";
+    char outBuf[8];
+    convertNumericStringToScaledInteger(inBuf, &nVal);
+    convertScaledIntegerToNumericString(&nVal, outBuf, sizeof(outBuf));
+    EXPECT_STREQ(outBuf, "-12345.");
+}
+
+TEST(NUMERIC_CONVERSION_SUITE, BinaryNumericNegativeValues) {
+    SQL_NUMERIC_STRUCT nVal;
+    char outBuf[64];
+    // -987654321012 as 8 byte big endian
+    long long llVal = -987654321012LL;
+    char bin8[8];
+    for (int i = 0; i < 8; i++)
+        bin8[i] = (char)(llVal >> (56 - 8 * i));
+    convertBinaryNumericToScaledInteger(bin8, sizeof(bin8), 18, 2, &nVal);
+    convertScaledIntegerToNumericString(&nVal, outBuf, sizeof(outBuf));
+    EXPECT_STREQ(outBuf, "-9876543210.12");
+    EXPECT_EQ(nVal.sign, 0);
+
+    // -1 as 16 byte big endian
+    char bin16[16];
+    memset(bin16, 0xFF, sizeof(bin16));
+    convertBinaryNumericToScaledInteger(bin16, sizeof(bin16), 38, 10, &nVal);
+    convertScaledIntegerToNumericString(&nVal, outBuf, sizeof(outBuf));
+    EXPECT_STREQ(outBuf, "-0.0000000001");
+
+    // Zero is positive
+    memset(bin16, 0, sizeof(bin16));
+    convertBinaryNumericToScaledInteger(bin16, sizeof(bin16), 38, 2, &nVal);
+    convertScaledIntegerToNumericString(&nVal, outBuf, sizeof(outBuf));
+    EXPECT_STREQ(outBuf, "0.00");
+    EXPECT_EQ(nVal.sign, 1);
+}
+
+TEST(NUMERIC_CONVERSION_SUITE, ScaledIntegerToDouble) {
+    SQL_NUMERIC_STRUCT nVal;
+    char inBuf[64];
+    for (const char *input : {"123.456", "-0.1", "1234567890123456789012345678.0123456789"}) {
+        snprintf(inBuf, sizeof(inBuf), "%s", input);
+        convertNumericStringToScaledInteger(inBuf, &nVal);
+        EXPECT_EQ(convertScaledIntegerToDouble(&nVal), strtod(input, NULL)) << input;
+    }
+}
+
+TEST(MULTI_INSERT_SUITE, TotalMultiTuples) {
+    // Only the array size
+    EXPECT_EQ(getTotalMultiTuples(2, 10, 100, 0), 100);
+    // Parameter count
+    EXPECT_EQ(getTotalMultiTuples(3, 10, 100000, 0), PADB_MAX_PARAMETERS / 3);
+    // Statement size
+    EXPECT_EQ(getTotalMultiTuples(2, 100, 100000, 64 * 1024), 64 * 1024 / 100);
+    // At least one row
+    EXPECT_EQ(getTotalMultiTuples(2, 100, 100000, 10), 1);
+}
+
+TEST(MULTI_INSERT_SUITE, BatchRows) {
+    // Full batches while the rows and the bytes allow
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 100000, 50, 0), 1000);
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 1000, 50, 1000 * 50), 1000);
+    // Tail of the array gets powers of the factor
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 999, 50, 0), 256);
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 300, 50, 0), 256);
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 44, 50, 0), 16);
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 3, 50, 0), 1);
+    // Wide rows
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 100000, 1024 * 1024, 100 * 1024 * 1024), 64);
+    EXPECT_EQ(getMultiInsertBatchRows(1000, 100000, 1024 * 1024, 1024), 1);
+}
+
+TEST(MULTI_INSERT_SUITE, MakeMultiInsertCmd) {
+    char cmd[] = "insert into t(a, b) values (?, f(?, ')')) ;";
+    char *pMultiInsertCmd = makeMultiInsertCmd(cmd, SQL_NTS, 3);
+
+    ASSERT_NE(pMultiInsertCmd, nullptr);
+    EXPECT_STREQ(pMultiInsertCmd,
+                 "insert into t(a, b) values (?, f(?, ')')),(?, f(?, ')')),(?, f(?, ')')) ;");
+    rs_free(pMultiInsertCmd);
+
+    char select[] = "insert into t select * from (values (?)) v";
+    EXPECT_EQ(makeMultiInsertCmd(select, SQL_NTS, 3), nullptr);
+
+    char multiValues[] = "insert into t values (?), (?)";
+    EXPECT_EQ(makeMultiInsertCmd(multiValues, SQL_NTS, 3), nullptr);
+}
+
+// Pieces of a data-at-exec value are appended by length, with NULs in them kept.
+TEST(DATA_AT_EXEC_SUITE, AppendPieces) {
+    char piece[] = {'a', '\0', 'b'};
+    RS_DATA_AT_EXEC *pDataAtExec = allocateAndSetDataAtExec(piece, sizeof(piece));
+    ASSERT_NE(pDataAtExec, nullptr);
+    EXPECT_EQ(pDataAtExec->cbLen, 3);
+
+    std::string expected(piece, sizeof(piece));
+    for (int i = 0; i < 5000; i++) {
+        pDataAtExec = appendDataAtExec(pDataAtExec, piece, sizeof(piece));
+        ASSERT_NE(pDataAtExec, nullptr);
+        expected.append(piece, sizeof(piece));
+    }
+    pDataAtExec = appendDataAtExec(pDataAtExec, (char *)"xyz", SQL_NTS);
+    expected += "xyz";
+
+    ASSERT_EQ(pDataAtExec->cbLen, (SQLLEN)expected.size());
+    EXPECT_EQ(std::string(pDataAtExec->pValue, pDataAtExec->cbLen), expected);
+    EXPECT_EQ(pDataAtExec->pValue[pDataAtExec->cbLen], '\0');
+    EXPECT_LT(pDataAtExec->cbAlloc, 2 * pDataAtExec->cbLen + RS_DATA_AT_EXEC_MIN_ALLOC);
+    EXPECT_EQ(freeDataAtExec(pDataAtExec), nullptr);
+
+    pDataAtExec = allocateAndSetDataAtExec(NULL, SQL_NULL_DATA);
+    ASSERT_NE(pDataAtExec, nullptr);
+    EXPECT_EQ(pDataAtExec->pValue, nullptr);
+    freeDataAtExec(pDataAtExec);
+
+    pDataAtExec = allocateAndSetDataAtExec(piece, 0);
+    ASSERT_NE(pDataAtExec, nullptr);
+    ASSERT_NE(pDataAtExec->pValue, nullptr);
+    EXPECT_EQ(pDataAtExec->cbLen, 0);
+    freeDataAtExec(pDataAtExec);
+}
@@ -0,0 +1,81 @@
+#include "common.h"
+#include "rsodbc.h"
+#include "rsutil.h"
+#include "rsworkerpool.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// All the queued tasks run before the pool is destroyed.
+TEST(RsWorkerPoolTest, RunsAllTasks) {
+    std::atomic<int> iRan(0);
+
+    {
+        RS_WORKER_POOL pool(4, 60);
+        for (int i = 0; i < 100; i++)
+            ASSERT_TRUE(pool.submit([&iRan]() { iRan++; }));
+    }
+
+    EXPECT_EQ(iRan.load(), 100);
+}
+
+// Workers don't grow over the most workers. Tasks over them wait in the queue.
+TEST(RsWorkerPoolTest, BoundedWorkers) {
+    RS_WORKER_POOL pool(2, 60);
+    std::mutex lock;
+    std::condition_variable cv;
+    bool bRelease = false;
+    std::atomic<int> iRan(0);
+
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(pool.submit([&]() {
+            std::unique_lock<std::mutex> guard(lock);
+            cv.wait(guard, [&]() { return bRelease; });
+            iRan++;
+        }));
+    }
+
+    int iThreads, iQueued;
+    for (int i = 0; i < 100; i++) {
+        pool.getStats(&iThreads, NULL, &iQueued);
+        if (iQueued == 3)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(iThreads, 2);
+    EXPECT_EQ(iQueued, 3);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        bRelease = true;
+    }
+    cv.notify_all();
+
+    for (int i = 0; i < 100 && iRan.load() < 5; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(iRan.load(), 5);
+}
+
+// Idle workers exit after the idle time.
+TEST(RsWorkerPoolTest, IdleWorkersExit) {
+    RS_WORKER_POOL pool(4, 1);
+    std::atomic<int> iRan(0);
+
+    ASSERT_TRUE(pool.submit([&iRan]() { iRan++; }));
+
+    int iThreads = -1;
+    for (int i = 0; i < 300; i++) {
+        pool.getStats(&iThreads, NULL, NULL);
+        if (iThreads == 0)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(iRan.load(), 1);
+    EXPECT_EQ(iThreads, 0);
+
+    // A new task starts a worker again
+    ASSERT_TRUE(pool.submit([&iRan]() { iRan++; }));
+    for (int i = 0; i < 100 && iRan.load() < 2; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(iRan.load(), 2);
+}
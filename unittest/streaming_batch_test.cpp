@@ -0,0 +1,73 @@
+#include "common.h"
+#include "libpq-fe.h"
+extern "C" {
+#include "libpq-int.h"
+}
+#include "MessageLoopState.h"
+
+class StreamingBatchTest : public ::testing::Test {
+  protected:
+    CscStatementContext context;
+    PGresult *pgResult = nullptr;
+
+    void SetUp() override {
+        memset(&context, 0, sizeof(context));
+        pgResult = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+        pgResult->numAttributes = 2;
+    }
+
+    void TearDown() override { PQclear(pgResult); }
+
+    // Add rows of rowBytes bytes until the batch ends. Returns the rows of the batch.
+    int fillBatch(int rowBytes, int maxRows = 1000000) {
+        pgResult->totalntups = 0;
+        pgResult->mem_used = 0;
+        while (pgResult->totalntups < maxRows) {
+            pgResult->totalntups++;
+            pgResult->mem_used += rowBytes;
+            if (isEndOfStreamingCursorBatch(&context, pgResult))
+                return pgResult->totalntups;
+        }
+        return -1;
+    }
+};
+
+// Without a batch size, batches have StreamingCursorRows rows.
+TEST_F(StreamingBatchTest, RowCountBatches) {
+    setStreamingCursorRows(&context, 100);
+    setStreamingCursorBatchSize(&context, 0, 1);
+    EXPECT_EQ(fillBatch(50), 100);
+    EXPECT_EQ(fillBatch(50000), 100);
+}
+
+// With a batch size, narrow rows get more rows in a batch than wide rows.
+TEST_F(StreamingBatchTest, ByteBudgetBatches) {
+    setStreamingCursorRows(&context, 100);
+    setStreamingCursorBatchSize(&context, 1024 * 1024, 1);
+
+    int narrowRows = fillBatch(50);
+    int wideRows = fillBatch(50 * 1024);
+    EXPECT_GT(narrowRows, 10000);
+    EXPECT_LT(wideRows, 30);
+    EXPECT_GT(narrowRows, wideRows);
+
+    int batches = 0, minRows = 0, maxRows = 0, lastRows = 0;
+    getStreamingCursorBatchStats(&context, &batches, &minRows, &maxRows, &lastRows);
+    EXPECT_EQ(batches, 2);
+    EXPECT_EQ(minRows, wideRows);
+    EXPECT_EQ(maxRows, narrowRows);
+    EXPECT_EQ(lastRows, wideRows);
+}
+
+// Batches end at a multiple of the rowset size, even when it's more than the row count.
+TEST_F(StreamingBatchTest, BatchesAlignToRowset) {
+    setStreamingCursorRows(&context, 100);
+    setStreamingCursorBatchSize(&context, 0, 30);
+    EXPECT_EQ(fillBatch(50), 90);
+
+    setStreamingCursorBatchSize(&context, 0, 250);
+    EXPECT_EQ(fillBatch(50), 250);
+
+    setStreamingCursorBatchSize(&context, 1024 * 1024, 64);
+    EXPECT_EQ(fillBatch(50 * 1024) % 64, 0);
+}